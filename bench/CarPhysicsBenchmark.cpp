@@ -0,0 +1,167 @@
+﻿#include "AIDriver.h"
+#include "CarPhysics.h"
+#include "CarPhysicsWorld.h"
+#include "TrackDefinition.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @file CarPhysicsBenchmark.cpp
+ * @brief Mikrobenchmark fizyki wielu aut AI: obiekty `CarPhysics` po kolei względem `CarPhysicsWorld` (SoA, pula wątków).
+ *
+ * Program ustawia N aut w losowych miejscach linii jazdy toru kartingowego (`assets/karting/gp.track`), każde prowadzone przez `AIDriver`,
+ * i symuluje zadany czas trzema sposobami: `AIDriver::Update` na każdym obiekcie, `CarPhysicsWorld`
+ * na jednym wątku oraz `CarPhysicsWorld` z pulą wątków. Wypisywany jest czas jednego kroku
+ * (budżet 120 Hz to 8,33 ms) i liczba niezgodności stanu końcowego (wymagane 0 — wyniki bit w bit).
+ *
+ * Użycie: `Racing3D_bench_carphysics [auta] [sekundy] [wątki]` (uruchamiać z katalogu zawierającego `assets/`)
+ */
+
+ /**
+  * @brief Stan końcowy auta porównywany między wariantami.
+  */
+struct CarSnapshot {
+    /** @brief Pozycja. */
+    glm::vec3 Position;
+
+    /** @brief Prędkość. */
+    glm::vec3 Velocity;
+
+    /** @brief Yaw. */
+    float Yaw;
+};
+
+/**
+ * @brief Tworzy auta i kierowców w losowych punktach trasy z losowym rozrzutem parametrów.
+ * @param waypoints Linia jazdy AI.
+ * @param count Liczba aut.
+ * @param cars Wynikowe auta.
+ * @param drivers Wynikowi kierowcy.
+ */
+static void SetupCars(const std::vector<glm::vec3>& waypoints, size_t count, std::vector<CarPhysics>& cars, std::vector<AIDriver>& drivers) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> start(0, (int)waypoints.size() - 1);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> speed(0.95f, 1.05f);
+
+    cars.assign(count, CarPhysics());
+    drivers.assign(count, AIDriver());
+    for (size_t i = 0; i < count; ++i) {
+        int w = start(rng);
+        cars[i].Position = waypoints[w] + glm::vec3(jitter(rng), 0.0f, jitter(rng));
+        cars[i].PreviousPosition = cars[i].Position;
+        cars[i].MaxSpeed *= speed(rng);
+        drivers[i].Waypoints = waypoints;
+        drivers[i].CurrentWaypoint = (w + 1) % (int)waypoints.size();
+    }
+}
+
+/**
+ * @brief Wypisuje czas kroku i zwraca go.
+ * @param name Nazwa wariantu.
+ * @param seconds Czas całej symulacji.
+ * @param ticks Liczba kroków.
+ * @param carCount Liczba aut.
+ * @return Czas jednego kroku w ms.
+ */
+static double Report(const char* name, double seconds, int ticks, size_t carCount) {
+    double msPerTick = seconds * 1000.0 / ticks;
+    std::cout << "  " << name << ": " << msPerTick << " ms/krok, " << (carCount * (double)ticks / seconds / 1e6)
+        << " M krokow aut/s" << std::endl;
+    return msPerTick;
+}
+
+/**
+ * @brief Symuluje auta w `CarPhysicsWorld` tak jak `AIDriver::Update` (sterowanie, krok, limit prędkości).
+ * @param waypoints Linia jazdy AI.
+ * @param threads Liczba wątków puli.
+ * @param ticks Liczba kroków.
+ * @param stepSize Krok czasu.
+ * @param count Liczba aut.
+ * @param out Stan końcowy.
+ * @return Czas symulacji w sekundach.
+ */
+static double RunWorld(const std::vector<glm::vec3>& waypoints, unsigned int threads, int ticks, float stepSize, size_t count, std::vector<CarSnapshot>& out) {
+    std::vector<CarPhysics> cars;
+    std::vector<AIDriver> drivers;
+    SetupCars(waypoints, count, cars, drivers);
+
+    CarPhysicsWorld world;
+    world.SetThreadCount(threads);
+    for (const CarPhysics& car : cars) world.Add(car);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (size_t i = 0; i < count; ++i) drivers[i].Steer(world, i, stepSize);
+        world.Step(stepSize);
+        for (size_t i = 0; i < count; ++i) AIDriver::LimitSpeed(world, i);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i) out[i] = { world.GetPosition(i), world.GetVelocity(i), world.Yaw[i] };
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+/**
+ * @brief Liczy auta, których stan końcowy różni się od referencji (porównanie dokładne).
+ * @param a Stan referencyjny.
+ * @param b Stan porównywany.
+ * @return Liczba niezgodności.
+ */
+static size_t CountMismatches(const std::vector<CarSnapshot>& a, const std::vector<CarSnapshot>& b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].Position != b[i].Position || a[i].Velocity != b[i].Velocity || a[i].Yaw != b[i].Yaw) ++mismatches;
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    size_t carCount = argc > 1 ? (size_t)std::max(1, std::atoi(argv[1])) : 1000;
+    float simSeconds = argc > 2 ? (float)std::atof(argv[2]) : 10.0f;
+    unsigned int threads = argc > 3 ? (unsigned)std::max(0, std::atoi(argv[3])) : 0;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (simSeconds <= 0.0f) simSeconds = 10.0f;
+
+    const float stepSize = 1.0f / 120.0f;
+    const int ticks = std::max(1, (int)(simSeconds * 120.0f));
+
+    TrackDefinition track;
+    if (!track.LoadText("assets/karting/gp.track") || track.RacingLine.empty()) {
+        std::cout << "Nie mozna wczytac toru: assets/karting/gp.track" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Auta: " << carCount << ", kroki: " << ticks << " (120 Hz, budzet 8.333 ms/krok), watki: " << threads << std::endl;
+
+    // Referencja: obiekty po kolei, jak w grze i w Racing3D_sim bez parametru wątków.
+    std::vector<CarPhysics> cars;
+    std::vector<AIDriver> drivers;
+    SetupCars(track.RacingLine, carCount, cars, drivers);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t)
+        for (size_t i = 0; i < carCount; ++i) drivers[i].Update(cars[i], stepSize);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<CarSnapshot> reference(carCount);
+    for (size_t i = 0; i < carCount; ++i) reference[i] = { cars[i].Position, cars[i].Velocity, cars[i].Yaw };
+
+    double objects = Report("CarPhysics (obiekty)  ", std::chrono::duration<double>(t1 - t0).count(), ticks, carCount);
+
+    std::vector<CarSnapshot> single, pooled;
+    double world1 = Report("CarPhysicsWorld, 1 w. ", RunWorld(track.RacingLine, 1, ticks, stepSize, carCount, single), ticks, carCount);
+    double worldN = Report("CarPhysicsWorld, pula ", RunWorld(track.RacingLine, threads, ticks, stepSize, carCount, pooled), ticks, carCount);
+
+    size_t mismatches = CountMismatches(reference, single) + CountMismatches(reference, pooled);
+    std::cout << "Przyspieszenie: 1 watek x" << (objects / world1) << ", pula x" << (objects / worldN) << std::endl;
+    std::cout << "Niezgodnosci z obiektami: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
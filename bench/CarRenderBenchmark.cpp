@@ -0,0 +1,164 @@
+﻿#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "CarRenderer.h"
+#include "FrameUniforms.h"
+#include "MeshRegistry.h"
+#include "RaceCar.h"
+#include "Shader.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+/**
+ * @file CarRenderBenchmark.cpp
+ * @brief Czas CPU wysyłania rysowania aut na klatkę: `RaceCar::Draw` (5 wywołań na auto) vs. `CarRenderer` (instancje).
+ *
+ * Tworzy ukryte okno GLFW (kontekst OpenGL 3.3 core), wczytuje auto z garażu i dla 1, 8 i 32 aut mierzy
+ * czas samego wysłania komend (bez `glFinish`, który wykonywany jest poza pomiarem). Program należy
+ * uruchamiać z katalogu zawierającego `assets/` i `shaders/`.
+ *
+ * Użycie: `Racing3D_bench_carrender [klatki=300]`
+ */
+
+ /**
+  * @brief Wynik pomiaru jednej konfiguracji.
+  */
+struct SubmitResult {
+    /** @brief Średni czas CPU wysłania klatki w mikrosekundach. */
+    double submitUs;
+
+    /** @brief Liczba wywołań rysowania na klatkę. */
+    int drawCalls;
+};
+
+/**
+ * @brief Rozstawia auta w siatce i nadaje im różne obroty kół.
+ * @param cars Auta do rozstawienia.
+ */
+static void PlaceCars(std::vector<std::unique_ptr<RaceCar>>& cars) {
+    for (size_t i = 0; i < cars.size(); i++) {
+        RaceCar& c = *cars[i];
+        c.Position = glm::vec3((float)(i % 8) * 1.5f, 0.1f, (float)(i / 8) * 2.5f);
+        c.Yaw = (float)i * 15.0f;
+        c.WheelRotation = (float)i * 30.0f;
+        c.SnapRenderState();
+    }
+}
+
+/**
+ * @brief Mierzy ścieżkę bez instancjonowania (`RaceCar::Draw` dla każdego auta).
+ * @param cars Auta.
+ * @param shader Shader `phong`.
+ * @param frames Liczba klatek.
+ * @return Wynik pomiaru.
+ */
+static SubmitResult MeasureLegacy(const std::vector<std::unique_ptr<RaceCar>>& cars, Shader& shader, int frames) {
+    double total = 0.0;
+    for (int f = 0; f < frames; f++) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto t0 = std::chrono::steady_clock::now();
+        shader.use();
+        for (const auto& c : cars) c->Draw(shader);
+        auto t1 = std::chrono::steady_clock::now();
+        glFinish();
+        total += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }
+    return { total / frames, (int)cars.size() * 5 };
+}
+
+/**
+ * @brief Mierzy ścieżkę instancjonowaną (`RaceCar::Submit` + `CarRenderer::Flush`).
+ * @param cars Auta.
+ * @param renderer Kolektor instancji.
+ * @param shader Shader `phong_instanced`.
+ * @param frames Liczba klatek.
+ * @return Wynik pomiaru.
+ */
+static SubmitResult MeasureInstanced(const std::vector<std::unique_ptr<RaceCar>>& cars, CarRenderer& renderer, Shader& shader, int frames) {
+    double total = 0.0;
+    for (int f = 0; f < frames; f++) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto t0 = std::chrono::steady_clock::now();
+        renderer.Begin();
+        for (const auto& c : cars) c->Submit(renderer);
+        renderer.Flush(shader);
+        auto t1 = std::chrono::steady_clock::now();
+        glFinish();
+        total += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }
+    return { total / frames, renderer.GetLastDrawCalls() };
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 300;
+
+    if (!glfwInit()) { std::printf("Nie udalo sie zainicjalizowac GLFW\n"); return 1; }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(640, 360, "Racing3D_bench_carrender", nullptr, nullptr);
+    if (!window) { std::printf("Nie udalo sie utworzyc kontekstu OpenGL 3.3\n"); glfwTerminate(); return 1; }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { std::printf("Nie udalo sie wczytac GLAD\n"); return 1; }
+
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, 640, 360);
+
+    Shader phong("shaders/phong.vert", "shaders/phong.frag");
+    Shader phongInstanced("shaders/phong_instanced.vert", "shaders/phong.frag");
+
+    FrameUniforms frameUniforms;
+    frameUniforms.Init();
+    FrameUniformData frameData;
+    frameData.view = glm::lookAt(glm::vec3(5.0f, 8.0f, -8.0f), glm::vec3(5.0f, 0.0f, 4.0f), glm::vec3(0, 1, 0));
+    frameData.projection = glm::perspective(glm::radians(60.0f), 640.0f / 360.0f, 0.1f, 200.0f);
+    frameData.lightPos = glm::vec4(5.0f, 10.0f, 5.0f, 1.0f);
+    frameUniforms.Update(frameData);
+
+    CarRenderer renderer;
+    renderer.Init();
+
+    std::printf("Klatek na pomiar: %d\n", frames);
+    std::printf("%6s | %14s %8s | %14s %8s | %7s\n", "auta", "Draw [us]", "wywolan", "instancje [us]", "wywolan", "zysk");
+
+    const int carCounts[] = { 1, 8, 32 };
+    for (int count : carCounts) {
+        std::vector<std::unique_ptr<RaceCar>> cars;
+        for (int i = 0; i < count; i++) {
+            cars.push_back(std::make_unique<RaceCar>());
+            if (!cars.back()->loadAssets("assets/cars/OBJ format/race.obj", "assets/cars/OBJ format/wheel-racing.obj")) {
+                std::printf("Nie udalo sie wczytac modelu auta (uruchom z katalogu z assets/)\n");
+                return 1;
+            }
+        }
+        PlaceCars(cars);
+
+        // Rozgrzewka (kompilacja stanu w sterowniku, alokacja bufora instancji).
+        MeasureLegacy(cars, phong, 10);
+        MeasureInstanced(cars, renderer, phongInstanced, 10);
+
+        SubmitResult legacy = MeasureLegacy(cars, phong, frames);
+        SubmitResult instanced = MeasureInstanced(cars, renderer, phongInstanced, frames);
+        std::printf("%6d | %14.1f %8d | %14.1f %8d | %6.2fx\n", count,
+            legacy.submitUs, legacy.drawCalls, instanced.submitUs, instanced.drawCalls,
+            instanced.submitUs > 0.0 ? legacy.submitUs / instanced.submitUs : 0.0);
+
+        for (auto& c : cars) c->cleanup();
+    }
+    std::printf("Uploady siatek aut (MeshRegistry): %zu\n", MeshRegistry::GetUploadCount());
+
+    renderer.Release();
+    frameUniforms.Release();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
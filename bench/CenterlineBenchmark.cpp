@@ -0,0 +1,177 @@
+﻿#include "TrackDefinition.h"
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file CenterlineBenchmark.cpp
+ * @brief Mikrobenchmark rzutowania pozycji na linię środkową toru (`TrackCenterline::Project`).
+ *
+ * Program buduje linię środkową toru z pliku definicji (domyślnie kartingowego) i generuje trajektorie aut:
+ * punkty co `krok_m` wzdłuż linii z płynnie zmiennym odsunięciem w obrębie toru (jak kolejne kroki fizyki).
+ * Mierzona jest liczba zapytań na sekundę dla trzech wariantów:
+ * - z podpowiedzią z poprzedniego kroku (ścieżka używana co krok przez `LapCounter`),
+ * - bez podpowiedzi (sama siatka),
+ * - pełny przegląd wszystkich odcinków (referencja).
+ *
+ * Dystanse wszystkich wariantów są porównywane z referencją; na końcu sprawdzane jest, czy `UpdateProgress`
+ * po przejechaniu trajektorii daje przyrost dystansu wyścigu równy długości przejechanej trajektorii.
+ *
+ * Użycie: `Racing3D_bench_centerline [auta] [okrążenia] [krok_m] [tor]` (domyślnie `assets/karting/gp.track` —
+ * uruchamiać z katalogu zawierającego `assets/`).
+ */
+
+ /**
+  * @brief Referencyjny rzut: pełny przegląd wszystkich odcinków linii.
+  * @param centerline Linia środkowa.
+  * @param p Punkt (XZ).
+  * @return Dystans wzdłuż toru.
+  */
+static float BruteForceProject(const TrackCenterline& centerline, const glm::vec2& p) {
+    const auto& samples = centerline.GetSamples();
+    size_t n = samples.size();
+    float bestD2 = std::numeric_limits<float>::max();
+    float bestDistance = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const CenterlineSample& a = samples[i];
+        const CenterlineSample& b = samples[(i + 1) % n];
+        glm::vec2 ab = b.Position - a.Position;
+        float abLen2 = glm::dot(ab, ab);
+        float t = abLen2 > 1e-12f ? glm::clamp(glm::dot(p - a.Position, ab) / abLen2, 0.0f, 1.0f) : 0.0f;
+        glm::vec2 d = p - (a.Position + ab * t);
+        float d2 = glm::dot(d, d);
+        if (d2 < bestD2) {
+            bestD2 = d2;
+            float segLength = (i + 1 < n ? b.Distance : centerline.GetLength()) - a.Distance;
+            bestDistance = a.Distance + segLength * t;
+        }
+    }
+    return bestDistance < centerline.GetLength() ? bestDistance : 0.0f;
+}
+
+/**
+ * @brief Różnica dystansów wzdłuż zamkniętej linii (z zawinięciem przez linię startu/mety).
+ * @param a Pierwszy dystans.
+ * @param b Drugi dystans.
+ * @param length Długość okrążenia.
+ * @return Wartość bezwzględna najkrótszej różnicy.
+ */
+static float LoopDifference(float a, float b, float length) {
+    float d = std::fabs(a - b);
+    return std::min(d, length - d);
+}
+
+/**
+ * @brief Mierzy liczbę zapytań na sekundę i liczy niezgodności z referencją.
+ * @param name Nazwa wypisywana w raporcie.
+ * @param queries Punkty zapytań (kolejne kroki trajektorii).
+ * @param reference Dystanse referencyjne (puste = bez porównania).
+ * @param length Długość okrążenia.
+ * @param fn Funkcja zapytania zwracająca dystans.
+ * @return Liczba zapytań na sekundę.
+ */
+template <typename Fn>
+static double Measure(const char* name, const std::vector<glm::vec3>& queries, const std::vector<float>& reference, float length, Fn fn) {
+    std::vector<float> results(queries.size());
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i) results[i] = fn(i, queries[i]);
+    auto t1 = std::chrono::steady_clock::now();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < reference.size(); ++i)
+        if (LoopDifference(results[i], reference[i], length) > 1e-3f) ++mismatches;
+
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    double qps = seconds > 0.0 ? queries.size() / seconds : 0.0;
+    std::cout << "  " << name << ": " << (qps / 1e6) << " M zapytan/s, " << (qps > 0.0 ? 1e9 / qps : 0.0)
+        << " ns/zapytanie, niezgodnosci: " << mismatches << std::endl;
+    return qps;
+}
+
+int main(int argc, char** argv) {
+    int carCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    int laps = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    float step = argc > 3 ? (float)std::atof(argv[3]) : 0.15f;
+    if (step <= 0.0f) step = 0.15f;
+
+    std::string trackPath = argc > 4 ? argv[4] : "assets/karting/gp.track";
+
+    TrackDefinition track;
+    if (!track.LoadText(trackPath)) {
+        std::cout << "Nie mozna wczytac toru: " << trackPath << std::endl;
+        return 1;
+    }
+
+    TrackCenterline& centerline = track.Centerline;
+    auto b0 = std::chrono::steady_clock::now();
+    centerline.Build(track.LeftSide, track.RightSide, glm::vec2(track.Grid.Position.x, track.Grid.Position.z),
+        glm::vec2(track.Grid.Forward.x, track.Grid.Forward.z), track.CenterlineSpacing);
+    auto b1 = std::chrono::steady_clock::now();
+    if (centerline.Empty()) {
+        std::cout << "Brak linii srodkowej." << std::endl;
+        return 1;
+    }
+
+    float length = centerline.GetLength();
+    int stepsPerCar = (int)std::ceil(length * laps / step);
+    std::cout << "Linia srodkowa: " << centerline.GetSamples().size() << " probek, dlugosc " << length << " m, budowa "
+        << std::chrono::duration<double, std::milli>(b1 - b0).count() << " ms, pamiec " << centerline.GetMemoryBytes() << " B" << std::endl;
+    std::cout << "Auta: " << carCount << ", okrazenia: " << laps << ", krok: " << step << " m, zapytania: "
+        << (size_t)carCount * stepsPerCar << std::endl;
+
+    // Trajektorie: kolejne kroki aut ułożone auto po aucie, odsunięcie zmienia się sinusoidalnie w obrębie toru.
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> startDistance(0.0f, length);
+    std::vector<glm::vec3> queries;
+    queries.reserve((size_t)carCount * stepsPerCar);
+    for (int c = 0; c < carCount; ++c) {
+        float s0 = startDistance(rng);
+        float ph = phase(rng);
+        for (int k = 0; k < stepsPerCar; ++k) {
+            float s = s0 + step * k;
+            glm::vec2 p = centerline.PointAt(s);
+            glm::vec2 dir = centerline.DirectionAt(s);
+            float lateral = 0.8f * centerline.HalfWidthAt(s) * std::sin(ph + s * 0.2f);
+            queries.push_back(glm::vec3(p.x - dir.y * lateral, 0.0f, p.y + dir.x * lateral));
+        }
+    }
+
+    std::vector<float> reference(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) reference[i] = BruteForceProject(centerline, glm::vec2(queries[i].x, queries[i].z));
+
+    std::cout << "Project:" << std::endl;
+    int hint = -1;
+    double coherent = Measure("z podpowiedzia", queries, reference, length, [&](size_t i, const glm::vec3& q) {
+        if (i % stepsPerCar == 0) hint = -1;
+        return centerline.Project(q, hint);
+        });
+    double grid = Measure("siatka (bez podpowiedzi)", queries, reference, length, [&](size_t, const glm::vec3& q) {
+        int segment = -1;
+        return centerline.Project(q, segment);
+        });
+    double brute = Measure("pelny przeglad", queries, {}, length, [&](size_t, const glm::vec3& q) {
+        return BruteForceProject(centerline, glm::vec2(q.x, q.z));
+        });
+    std::cout << "Przyspieszenie wzgledem pelnego przegladu: z podpowiedzia x" << (brute > 0.0 ? coherent / brute : 0.0)
+        << ", siatka x" << (brute > 0.0 ? grid / brute : 0.0) << std::endl;
+
+    // Przyrost dystansu wyścigu po przejechaniu trajektorii (także przez linię startu/mety) ma równać się jej długości.
+    float maxError = 0.0f;
+    for (int c = 0; c < carCount; ++c) {
+        TrackProgress progress;
+        centerline.UpdateProgress(progress, queries[(size_t)c * stepsPerCar]);
+        float start = progress.RaceDistance;
+        for (int k = 1; k < stepsPerCar; ++k) centerline.UpdateProgress(progress, queries[(size_t)c * stepsPerCar + k]);
+        float expected = step * (stepsPerCar - 1);
+        maxError = std::max(maxError, std::fabs((progress.RaceDistance - start) - expected) / expected);
+    }
+    std::cout << "UpdateProgress: maks. wzgledny blad dystansu wyscigu: " << maxError << std::endl;
+    return 0;
+}
@@ -0,0 +1,334 @@
+﻿#define GLM_ENABLE_EXPERIMENTAL
+#include "TrackDefinition.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file CollisionBenchmark.cpp
+ * @brief Mikrobenchmark zapytań `TrackCollision` (siatka przestrzenna) względem pełnego przeglądu `walls`.
+ *
+ * Program buduje ściany toru z pliku definicji (domyślnie kartingowego), losuje punkty zapytań w obrębie toru i mierzy liczbę
+ * zapytań na sekundę dla `CheckCollision` i `FindCollisionPush` oraz dla referencyjnej pętli
+ * liniowej (dotychczasowa implementacja). Wyniki obu wariantów są porównywane.
+ *
+ * Dodatkowo mierzony jest `SweepCircle` dla losowych ruchów (do 1 m na krok) i sprawdzane, czy nie
+ * przeskakuje ścian: referencją jest gęste próbkowanie toru ruchu pełnym przeglądem odcinków. Błędem jest
+ * kontakt zgłoszony później niż w próbkowaniu albo brak kontaktu, gdy środek okręgu przecina ścianę.
+ *
+ * Na końcu wypiekane jest pole odległości (czas, pamięć), tor jest zapisywany do pliku `.r3dtrack` i wczytywany
+ * z niego (czas odczytu przez mapowanie), sprawdzany jest błąd `QueryDistance` wczytanego pola względem
+ * dokładnej odległości, a pomiary i porównania zapytań powtarzane są z polem z pliku.
+ *
+ * Użycie: `Racing3D_bench_collision [liczba_zapytań] [tor]` (domyślnie `assets/karting/gp.track` — uruchamiać
+ * z katalogu zawierającego `assets/`).
+ */
+
+ /**
+  * @brief Referencyjny test kolizji: pełny przegląd wszystkich odcinków.
+  * @param walls Lista odcinków.
+  * @param p Środek okręgu (XZ).
+  * @param radius Promień okręgu.
+  * @return `true` jeśli okrąg przecina dowolny odcinek.
+  */
+static bool BruteForceCheck(const std::vector<WallSegment>& walls, const glm::vec2& p, float radius) {
+    float r2 = radius * radius;
+    for (const auto& wall : walls) {
+        glm::vec2 ab = wall.end - wall.start;
+        float abLen2 = glm::dot(ab, ab);
+        if (abLen2 <= 1e-8f) continue;
+        float t = glm::clamp(glm::dot(p - wall.start, ab) / abLen2, 0.0f, 1.0f);
+        if (glm::length2(p - (wall.start + t * ab)) < r2) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Referencyjne wyznaczenie wypchnięcia: pełny przegląd wszystkich odcinków.
+ * @param walls Lista odcinków.
+ * @param p Środek okręgu (XZ).
+ * @param radius Promień okręgu.
+ * @param outPush Wynikowy wektor wypchnięcia.
+ * @return `true` jeśli wykryto kolizję.
+ */
+static bool BruteForcePush(const std::vector<WallSegment>& walls, const glm::vec2& p, float radius, glm::vec2& outPush) {
+    float r2 = radius * radius;
+    bool collided = false;
+    float minPenetration = std::numeric_limits<float>::max();
+    outPush = glm::vec2(0.0f);
+    for (const auto& wall : walls) {
+        glm::vec2 ab = wall.end - wall.start;
+        float abLen2 = glm::dot(ab, ab);
+        if (abLen2 <= 1e-8f) continue;
+        float t = glm::clamp(glm::dot(p - wall.start, ab) / abLen2, 0.0f, 1.0f);
+        glm::vec2 diff = p - (wall.start + t * ab);
+        float dist2 = glm::length2(diff);
+        if (dist2 < r2) {
+            float dist = std::sqrt(dist2);
+            if (dist <= 1e-6f) continue;
+            float penetration = radius - dist;
+            if (penetration < minPenetration) {
+                minPenetration = penetration;
+                outPush = diff / dist * penetration;
+            }
+            collided = true;
+        }
+    }
+    return collided;
+}
+
+/**
+ * @brief Sprawdza, czy odcinek ruchu środka okręgu przecina którykolwiek odcinek ściany.
+ * @param walls Lista odcinków.
+ * @param p Początek ruchu (XZ).
+ * @param q Koniec ruchu (XZ).
+ * @return `true` jeśli ruch przechodzi przez ścianę.
+ */
+static bool CrossesWall(const std::vector<WallSegment>& walls, const glm::vec2& p, const glm::vec2& q) {
+    auto cross = [](const glm::vec2& a, const glm::vec2& b) { return a.x * b.y - a.y * b.x; };
+    glm::vec2 r = q - p;
+    for (const auto& wall : walls) {
+        glm::vec2 s = wall.end - wall.start;
+        float denom = cross(r, s);
+        if (std::abs(denom) < 1e-12f) continue;
+        float t = cross(wall.start - p, s) / denom;
+        float u = cross(wall.start - p, r) / denom;
+        if (t >= 0.0f && t <= 1.0f && u >= 0.0f && u <= 1.0f) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Mierzy liczbę wywołań na sekundę dla zadanej funkcji zapytania.
+ * @param name Nazwa wypisywana w raporcie.
+ * @param queries Punkty zapytań.
+ * @param fn Funkcja zapytania zwracająca `true` przy kolizji.
+ * @return Liczba zapytań na sekundę.
+ */
+template <typename Fn>
+static double Measure(const char* name, const std::vector<glm::vec2>& queries, Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for (const auto& q : queries) hits += fn(q) ? 1 : 0;
+    auto t1 = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    double qps = seconds > 0.0 ? queries.size() / seconds : 0.0;
+    std::cout << "  " << name << ": " << (qps / 1e6) << " M zapytan/s (trafienia: " << hits << ")" << std::endl;
+    return qps;
+}
+
+int main(int argc, char** argv) {
+    size_t queryCount = argc > 1 ? (size_t)std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const float radius = 0.35f;
+
+    std::string trackPath = argc > 2 ? argv[2] : "assets/karting/gp.track";
+
+    TrackDefinition track;
+    if (!track.LoadText(trackPath)) {
+        std::cout << "Nie mozna wczytac toru: " << trackPath << std::endl;
+        return 1;
+    }
+    TrackCollision& collision = track.Collision;
+    collision.Init(track.LeftSide, track.RightSide, track.MinTrackWidth, track.GridCellSize);
+    const auto& walls = collision.GetWalls();
+    if (walls.empty()) {
+        std::cout << "Brak scian toru." << std::endl;
+        return 1;
+    }
+
+    glm::vec2 minP(std::numeric_limits<float>::max()), maxP(-std::numeric_limits<float>::max());
+    for (const auto& w : walls) {
+        minP = glm::min(minP, glm::min(w.start, w.end));
+        maxP = glm::max(maxP, glm::max(w.start, w.end));
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dx(minP.x - 1.0f, maxP.x + 1.0f);
+    std::uniform_real_distribution<float> dz(minP.y - 1.0f, maxP.y + 1.0f);
+    std::vector<glm::vec2> queries(queryCount);
+    for (auto& q : queries) q = glm::vec2(dx(rng), dz(rng));
+
+    std::cout << "Sciany toru: " << walls.size() << ", zapytania: " << queryCount << ", promien: " << radius
+        << ", jadro: " << TrackCollision::GetKernelName() << std::endl;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < std::min<size_t>(queries.size(), 200000); ++i) {
+        glm::vec3 pos(queries[i].x, 0.0f, queries[i].y);
+        glm::vec2 pushGrid, pushRef;
+        bool a = collision.FindCollisionPush(pos, radius, pushGrid);
+        bool b = BruteForcePush(walls, queries[i], radius, pushRef);
+        if (a != b || collision.CheckCollision(pos, radius) != BruteForceCheck(walls, queries[i], radius)
+            || glm::length(pushGrid - pushRef) > 1e-4f) {
+            ++mismatches;
+        }
+    }
+    std::cout << "Niezgodnosci siatka vs. pelny przeglad: " << mismatches << std::endl;
+
+    std::cout << "CheckCollision:" << std::endl;
+    double bruteCheck = Measure("pelny przeglad", queries, [&](const glm::vec2& q) { return BruteForceCheck(walls, q, radius); });
+    double gridCheck = Measure("siatka        ", queries, [&](const glm::vec2& q) { return collision.CheckCollision(glm::vec3(q.x, 0.0f, q.y), radius); });
+
+    std::cout << "FindCollisionPush:" << std::endl;
+    glm::vec2 push;
+    double brutePush = Measure("pelny przeglad", queries, [&](const glm::vec2& q) { return BruteForcePush(walls, q, radius, push); });
+    double gridPush = Measure("siatka        ", queries, [&](const glm::vec2& q) { return collision.FindCollisionPush(glm::vec3(q.x, 0.0f, q.y), radius, push); });
+
+    std::cout << "Przyspieszenie: CheckCollision x" << (gridCheck / bruteCheck)
+        << ", FindCollisionPush x" << (gridPush / brutePush) << std::endl;
+
+    // API wsadowe: wszystkie pozycje w jednym wywołaniu, wynik musi zgadzać się z pojedynczymi zapytaniami.
+    std::vector<glm::vec3> positions(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) positions[i] = glm::vec3(queries[i].x, 0.0f, queries[i].y);
+    std::vector<glm::vec2> batchPush;
+    std::vector<unsigned char> batchHit;
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t batchHits = collision.FindCollisionPushBatch(positions, radius, batchPush, batchHit);
+    auto t1 = std::chrono::steady_clock::now();
+    double batchSeconds = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "FindCollisionPushBatch: " << (batchSeconds > 0.0 ? queries.size() / batchSeconds / 1e6 : 0.0)
+        << " M zapytan/s (trafienia: " << batchHits << ")" << std::endl;
+
+    size_t batchMismatches = 0;
+    for (size_t i = 0; i < std::min<size_t>(queries.size(), 200000); ++i) {
+        glm::vec2 pushRef;
+        bool b = BruteForcePush(walls, queries[i], radius, pushRef);
+        if ((batchHit[i] != 0) != b || glm::length(batchPush[i] - pushRef) > 1e-4f) ++batchMismatches;
+    }
+    std::cout << "Niezgodnosci wsad vs. pelny przeglad: " << batchMismatches << std::endl;
+    mismatches += batchMismatches;
+
+    // Ciągłe wykrywanie kolizji: żaden ruch, który w próbkowaniu trafia w ścianę, nie może jej przeskoczyć.
+    size_t sweepCount = std::min<size_t>(queries.size(), 200000);
+    std::uniform_real_distribution<float> move(-1.0f, 1.0f);
+    std::vector<glm::vec2> moves(sweepCount);
+    for (auto& m : moves) m = glm::vec2(move(rng), move(rng));
+
+    size_t tunnels = 0, grazes = 0, endOnlyMisses = 0;
+    const int samples = 64;
+    for (size_t i = 0; i < std::min<size_t>(sweepCount, 20000); ++i) {
+        int firstHit = -1;
+        for (int k = 0; k <= samples && firstHit < 0; ++k)
+            if (BruteForceCheck(walls, queries[i] + moves[i] * ((float)k / samples), radius)) firstHit = k;
+        if (firstHit <= 0) continue;
+
+        glm::vec2 to = queries[i] + moves[i];
+        if (!BruteForceCheck(walls, to, radius)) ++endOnlyMisses;
+
+        float t;
+        glm::vec2 normal;
+        bool hit = collision.SweepCircle(glm::vec3(queries[i].x, 0.0f, queries[i].y), glm::vec3(to.x, 0.0f, to.y), radius, t, normal);
+        if (hit ? t > (float)firstHit / samples + 1e-4f : CrossesWall(walls, queries[i], to)) ++tunnels;
+        else if (!hit) ++grazes;
+    }
+    std::cout << "SweepCircle: przeskoczone sciany: " << tunnels << ", pominiete muskniecia (bez kontaktu na koncu ruchu): " << grazes
+        << " (sam test konca ruchu pominalby: " << endOnlyMisses << ")" << std::endl;
+    mismatches += tunnels;
+
+    size_t sweepHits = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sweepCount; ++i) {
+        float t;
+        glm::vec2 normal;
+        glm::vec2 to = queries[i] + moves[i] * 0.05f;
+        sweepHits += collision.SweepCircle(glm::vec3(queries[i].x, 0.0f, queries[i].y), glm::vec3(to.x, 0.0f, to.y), radius, t, normal) ? 1 : 0;
+    }
+    t1 = std::chrono::steady_clock::now();
+    double sweepSeconds = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "SweepCircle (ruch do 5 cm, jak krok 120 Hz): " << (sweepSeconds > 0.0 ? sweepCount / sweepSeconds / 1e6 : 0.0)
+        << " M zapytan/s (trafienia: " << sweepHits << ")" << std::endl;
+
+    sweepHits = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sweepCount; ++i) {
+        float t;
+        glm::vec2 normal;
+        glm::vec2 to = queries[i] + moves[i];
+        sweepHits += collision.SweepCircle(glm::vec3(queries[i].x, 0.0f, queries[i].y), glm::vec3(to.x, 0.0f, to.y), radius, t, normal) ? 1 : 0;
+    }
+    t1 = std::chrono::steady_clock::now();
+    sweepSeconds = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "SweepCircle (ruch do 1 m): " << (sweepSeconds > 0.0 ? sweepCount / sweepSeconds / 1e6 : 0.0)
+        << " M zapytan/s (trafienia: " << sweepHits << ")" << std::endl;
+
+    // Pole odległości: wypiekanie, plik, dokładność i zapytania rozstrzygane bez przeglądania odcinków.
+    t0 = std::chrono::steady_clock::now();
+    collision.BakeDistanceField();
+    t1 = std::chrono::steady_clock::now();
+    std::cout << "Pole odleglosci: wypiekanie " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+        << " ms, pamiec kolizji: " << (collision.GetMemoryBytes() / 1024) << " KiB, tolerancja: "
+        << collision.GetDistanceFieldTolerance() << std::endl;
+
+    // Plik toru: zapis, odczyt przez mapowanie; dalsze pomiary używają kolizji wczytanej z pliku.
+    const std::string binaryPath = "bench_collision.r3dtrack";
+    track.Centerline.Build(track.LeftSide, track.RightSide, glm::vec2(track.Grid.Position.x, track.Grid.Position.z),
+        glm::vec2(track.Grid.Forward.x, track.Grid.Forward.z), track.CenterlineSpacing);
+    bool saved = track.SaveBinary(binaryPath, 0);
+    TrackDefinition loadedTrack;
+    t0 = std::chrono::steady_clock::now();
+    bool loaded = saved && loadedTrack.LoadBinary(binaryPath);
+    t1 = std::chrono::steady_clock::now();
+    std::remove(binaryPath.c_str());
+    std::cout << "  plik toru: zapis " << (saved ? "ok" : "blad") << ", odczyt " << (loaded ? "ok" : "blad") << " ("
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms)" << std::endl;
+    if (!loaded || !loadedTrack.Collision.HasDistanceField()) return 1;
+    const TrackCollision& fieldCollision = loadedTrack.Collision;
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < std::min<size_t>(queries.size(), 20000); ++i) {
+        float exact = std::numeric_limits<float>::max();
+        for (const auto& wall : walls) {
+            glm::vec2 ab = wall.end - wall.start;
+            float t = glm::clamp(glm::dot(queries[i] - wall.start, ab) / glm::dot(ab, ab), 0.0f, 1.0f);
+            exact = std::min(exact, glm::length(queries[i] - (wall.start + t * ab)));
+        }
+        float distance;
+        glm::vec2 normal;
+        fieldCollision.QueryDistance(glm::vec3(queries[i].x, 0.0f, queries[i].y), distance, normal);
+        if (exact < TrackCollision::DistanceFieldRange) maxError = std::max(maxError, std::abs(distance - exact));
+    }
+    std::cout << "  maks. blad QueryDistance: " << maxError << std::endl;
+    if (maxError > fieldCollision.GetDistanceFieldTolerance()) ++mismatches;
+
+    size_t fieldMismatches = 0;
+    for (size_t i = 0; i < std::min<size_t>(queries.size(), 200000); ++i) {
+        glm::vec3 pos(queries[i].x, 0.0f, queries[i].y);
+        glm::vec2 pushField, pushRef;
+        bool a = fieldCollision.FindCollisionPush(pos, radius, pushField);
+        bool b = BruteForcePush(walls, queries[i], radius, pushRef);
+        if (a != b || fieldCollision.CheckCollision(pos, radius) != BruteForceCheck(walls, queries[i], radius)
+            || glm::length(pushField - pushRef) > 1e-4f) {
+            ++fieldMismatches;
+        }
+    }
+    std::cout << "  niezgodnosci pole vs. pelny przeglad: " << fieldMismatches << std::endl;
+    mismatches += fieldMismatches;
+
+    double fieldCheck = Measure("CheckCollision (pole + siatka)    ", queries, [&](const glm::vec2& q) { return fieldCollision.CheckCollision(glm::vec3(q.x, 0.0f, q.y), radius); });
+    double fieldPush = Measure("FindCollisionPush (pole + siatka)", queries, [&](const glm::vec2& q) { return fieldCollision.FindCollisionPush(glm::vec3(q.x, 0.0f, q.y), radius, push); });
+    std::cout << "  przyspieszenie wzgledem samej siatki: CheckCollision x" << (fieldCheck / gridCheck)
+        << ", FindCollisionPush x" << (fieldPush / gridPush) << std::endl;
+
+    sweepHits = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sweepCount; ++i) {
+        float t;
+        glm::vec2 normal;
+        glm::vec2 to = queries[i] + moves[i] * 0.05f;
+        sweepHits += fieldCollision.SweepCircle(glm::vec3(queries[i].x, 0.0f, queries[i].y), glm::vec3(to.x, 0.0f, to.y), radius, t, normal) ? 1 : 0;
+    }
+    t1 = std::chrono::steady_clock::now();
+    sweepSeconds = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "  SweepCircle (ruch do 5 cm): " << (sweepSeconds > 0.0 ? sweepCount / sweepSeconds / 1e6 : 0.0)
+        << " M zapytan/s (trafienia: " << sweepHits << ")" << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
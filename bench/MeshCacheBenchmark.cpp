@@ -0,0 +1,107 @@
+﻿#include "Garage.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+/**
+ * @file MeshCacheBenchmark.cpp
+ * @brief Porównanie czasu wczytania modeli aut z garażu: parsowanie OBJ vs. binarny cache `.r3dmesh`.
+ *
+ * Dla każdego wpisu w `garage` (karoseria + koła, tak jak w `RaceCar::loadAssets`) mierzony jest
+ * czas wczytania bez cache (parsowanie tekstowego OBJ i `MeshOptimizer::Optimize`, jak przy braku cache
+ * w `MeshCache::LoadOrParse`) oraz czas odczytu cache. Obie ścieżki muszą dać identyczne siatki.
+ * Cache jest tworzony przy pierwszym przebiegu. Program należy uruchamiać z katalogu zawierającego `assets/`.
+ *
+ * Użycie: `Racing3D_bench_meshcache [powtórzenia]`
+ */
+
+ /**
+  * @brief Jedna część modelu wczytywana przez `RaceCar::loadAssets`.
+  */
+struct CarPart {
+    /** @brief Ścieżka do pliku OBJ. */
+    std::string path;
+
+    /** @brief Czy parsować jako karoserię (bez obiektów „wheel”). */
+    bool isBody;
+};
+
+/**
+ * @brief Mierzy średni czas wczytania wszystkich części auta.
+ * @param parts Części auta.
+ * @param repeats Liczba powtórzeń.
+ * @param fromCache `true` = odczyt cache, `false` = parsowanie OBJ i optymalizacja.
+ * @param outMeshes Siatki części z ostatniego powtórzenia (do porównania obu ścieżek).
+ * @return Średni czas w milisekundach lub wartość ujemna przy błędzie.
+ */
+static double MeasureLoad(const std::vector<CarPart>& parts, int repeats, bool fromCache, std::vector<MeshData>& outMeshes) {
+    outMeshes.assign(parts.size(), MeshData());
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < parts.size(); ++i) {
+            MeshData mesh;
+            bool ok = fromCache ? MeshCache::Load(parts[i].path, parts[i].isBody, mesh) : MeshCache::ParseObj(parts[i].path, parts[i].isBody, mesh);
+            if (!ok) return -1.0;
+            if (!fromCache) MeshOptimizer::Optimize(mesh);
+            outMeshes[i] = std::move(mesh);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / repeats;
+}
+
+int main(int argc, char** argv) {
+    int repeats = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(14) << "auto" << std::right << std::setw(14) << "OBJ+opt [ms]"
+        << std::setw(12) << "cache [ms]" << std::setw(10) << "zysk" << std::setw(12) << "dane [KB]" << std::endl;
+
+    double totalObj = 0.0, totalCache = 0.0;
+    for (const auto& entry : garage) {
+        std::vector<CarPart> parts = {
+            { entry.bodyPath, true },
+            { entry.wheelFrontPath, false },
+            { entry.wheelBackPath.empty() ? entry.wheelFrontPath : entry.wheelBackPath, false }
+        };
+
+        // Zapewnienie aktualnego cache przed pomiarem (pierwsze uruchomienie go tworzy).
+        for (const auto& part : parts) {
+            MeshData mesh;
+            if (!MeshCache::LoadOrParse(part.path, part.isBody, mesh)) {
+                std::cout << "Nie mozna wczytac: " << part.path << std::endl;
+                return 1;
+            }
+        }
+
+        std::vector<MeshData> objMeshes, cacheMeshes;
+        double objMs = MeasureLoad(parts, repeats, false, objMeshes);
+        double cacheMs = MeasureLoad(parts, repeats, true, cacheMeshes);
+        bool same = objMs >= 0.0 && cacheMs >= 0.0;
+        size_t bytes = 0;
+        for (size_t i = 0; same && i < parts.size(); ++i) {
+            same = objMeshes[i].vertices == cacheMeshes[i].vertices && objMeshes[i].indices == cacheMeshes[i].indices;
+            bytes += cacheMeshes[i].vertices.size() * sizeof(float) + cacheMeshes[i].indices.size() * sizeof(unsigned int);
+        }
+        if (!same) {
+            std::cout << entry.id << ": blad odczytu lub niezgodne dane cache" << std::endl;
+            return 1;
+        }
+
+        totalObj += objMs;
+        totalCache += cacheMs;
+        std::cout << std::left << std::setw(14) << entry.id << std::right << std::setw(14) << objMs
+            << std::setw(12) << cacheMs << std::setw(9) << (cacheMs > 0.0 ? objMs / cacheMs : 0.0) << "x"
+            << std::setw(12) << (bytes / 1024.0) << std::endl;
+    }
+
+    std::cout << "Razem: OBJ+opt " << totalObj << " ms, cache " << totalCache << " ms, zysk x"
+        << (totalCache > 0.0 ? totalObj / totalCache : 0.0) << std::endl;
+    return 0;
+}
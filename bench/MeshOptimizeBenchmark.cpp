@@ -0,0 +1,91 @@
+﻿#include "Garage.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @file MeshOptimizeBenchmark.cpp
+ * @brief Raport rozmiaru VBO i liczby wywołań vertex shadera przed/po optymalizacji siatek.
+ *
+ * Dla modeli aut z `garage` (karoseria i koła) oraz modelu miasta porównywane są:
+ * - siatka w postaci z parsera (jeden wierzchołek na narożnik ściany),
+ * - siatka po `MeshOptimizer::Optimize` (spawanie + Forsyth + kolejność wierzchołków).
+ *
+ * Wywołania vertex shadera szacowane są symulacją cache FIFO o 16 i 32 wpisach.
+ * Program należy uruchamiać z katalogu zawierającego `assets/`.
+ *
+ * Użycie: `Racing3D_bench_meshopt [ścieżka_OBJ_miasta]`
+ */
+
+ /**
+  * @brief Wypisuje wiersz raportu dla jednej siatki.
+  * @param name Nazwa siatki.
+  * @param path Ścieżka do OBJ.
+  * @param skipWheels Wariant parsowania (karoseria).
+  * @param totalBefore Suma bajtów VBO przed optymalizacją (akumulowana).
+  * @param totalAfter Suma bajtów VBO po optymalizacji (akumulowana).
+  * @return `false` jeśli nie udało się wczytać pliku.
+  */
+static bool Report(const std::string& name, const std::string& path, bool skipWheels, size_t& totalBefore, size_t& totalAfter) {
+    MeshData mesh;
+    if (!MeshCache::ParseObj(path, skipWheels, mesh)) {
+        std::cout << std::left << std::setw(28) << name << " brak pliku: " << path << std::endl;
+        return false;
+    }
+
+    size_t vboBefore = mesh.vertices.size() * sizeof(float);
+    size_t vertsBefore = mesh.VertexCount();
+    size_t vs16Before = MeshOptimizer::SimulateVertexCache(mesh.indices, 16);
+    size_t vs32Before = MeshOptimizer::SimulateVertexCache(mesh.indices, 32);
+
+    MeshOptimizer::Optimize(mesh);
+
+    size_t vboAfter = mesh.vertices.size() * sizeof(float);
+    size_t vs16After = MeshOptimizer::SimulateVertexCache(mesh.indices, 16);
+    size_t vs32After = MeshOptimizer::SimulateVertexCache(mesh.indices, 32);
+    double tris = mesh.indices.size() / 3.0;
+
+    totalBefore += vboBefore;
+    totalAfter += vboAfter;
+
+    std::cout << std::left << std::setw(28) << name << std::right
+        << std::setw(9) << vertsBefore << " -> " << std::setw(7) << mesh.VertexCount()
+        << std::setw(10) << (vboBefore / 1024.0) << " -> " << std::setw(8) << (vboAfter / 1024.0) << " KB"
+        << std::setw(9) << vs16Before << " -> " << std::setw(7) << vs16After
+        << "  (ACMR16 " << (tris > 0 ? vs16Before / tris : 0.0) << " -> " << (tris > 0 ? vs16After / tris : 0.0)
+        << ", ACMR32 " << (tris > 0 ? vs32Before / tris : 0.0) << " -> " << (tris > 0 ? vs32After / tris : 0.0) << ")"
+        << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string cityPath = argc > 1 ? argv[1] : "assets/city/desert city.obj";
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(28) << "siatka" << std::right << std::setw(20) << "wierzcholki"
+        << std::setw(24) << "VBO" << std::setw(22) << "wywolania VS (FIFO16)" << std::endl;
+
+    size_t totalBefore = 0, totalAfter = 0;
+    std::set<std::string> seen;
+    for (const auto& entry : garage) {
+        std::string back = entry.wheelBackPath.empty() ? entry.wheelFrontPath : entry.wheelBackPath;
+        Report(entry.id + " (karoseria)", entry.bodyPath, true, totalBefore, totalAfter);
+
+        // Modele kół są współdzielone między autami — raportowane raz.
+        for (const std::string& wheel : { entry.wheelFrontPath, back }) {
+            if (!seen.insert(wheel).second) continue;
+            std::string file = wheel.substr(wheel.find_last_of('/') + 1);
+            Report(file, wheel, false, totalBefore, totalAfter);
+        }
+    }
+    Report("miasto", cityPath, false, totalBefore, totalAfter);
+
+    std::cout << "Razem VBO: " << (totalBefore / 1024.0) << " KB -> " << (totalAfter / 1024.0) << " KB (x"
+        << (totalAfter > 0 ? (double)totalBefore / totalAfter : 0.0) << ")" << std::endl;
+    return 0;
+}
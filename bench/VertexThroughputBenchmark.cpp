@@ -0,0 +1,157 @@
+﻿#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "City.h"
+#include "FrameUniforms.h"
+#include "Shader.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @file VertexThroughputBenchmark.cpp
+ * @brief Przepustowość wierzchołków sceny miasta: macierz normalnych liczona w vertex shaderze vs. raz na CPU.
+ *
+ * Tworzy ukryte okno GLFW (kontekst OpenGL 3.3 core) i rysuje siatkę miasta przez `City::Draw` dwoma programami:
+ * - `bench/phong_inverse.vert` — poprzednia wersja `phong.vert` (`mat3(transpose(inverse(model)))` na wierzchołek),
+ * - `shaders/phong.vert` — macierz normalnych z uniformu `normalMatrix` (`Shader::setModelMatrix`).
+ *
+ * Widok ma kilka pikseli, a kamera patrzy na całe miasto, więc fragmentów jest niewiele. Każdy program
+ * mierzony jest dwa razy: pełne rysowanie oraz rysowanie z `glCullFace(GL_FRONT_AND_BACK)`, w którym
+ * rasteryzacja odpada i zostaje sama praca vertex shadera — różnica jest najlepiej widoczna na programowym
+ * GL (Mesa llvmpipe). Pomiar obejmuje `glFinish`. Gdy modelu miasta nie ma, rysowana jest wygenerowana
+ * gęsta siatka terenu.
+ * Program należy uruchamiać z katalogu zawierającego `shaders/` i `bench/`.
+ *
+ * Użycie: `Racing3D_bench_vertex [klatki=50] [ścieżka_OBJ_miasta]`
+ */
+
+ /**
+  * @brief Buduje pofalowaną siatkę terenu `n` x `n` wierzchołków (pos3 + normal3 + uv2).
+  * @param n Liczba wierzchołków na bok.
+  * @param out Siatka wynikowa.
+  */
+static void BuildGrid(int n, MeshData& out) {
+    out.vertices.clear();
+    out.indices.clear();
+    out.vertices.reserve((size_t)n * n * MeshData::FloatsPerVertex);
+    out.indices.reserve((size_t)(n - 1) * (n - 1) * 6);
+
+    const float size = 100.0f;
+    for (int z = 0; z < n; z++) {
+        for (int x = 0; x < n; x++) {
+            float u = (float)x / (n - 1), v = (float)z / (n - 1);
+            float px = (u - 0.5f) * size, pz = (v - 0.5f) * size;
+            float py = std::sin(px * 0.3f) * std::cos(pz * 0.3f);
+            glm::vec3 normal = glm::normalize(glm::vec3(
+                -0.3f * std::cos(px * 0.3f) * std::cos(pz * 0.3f), 1.0f,
+                0.3f * std::sin(px * 0.3f) * std::sin(pz * 0.3f)));
+            float vertex[MeshData::FloatsPerVertex] = { px, py, pz, normal.x, normal.y, normal.z, u, v };
+            out.vertices.insert(out.vertices.end(), vertex, vertex + MeshData::FloatsPerVertex);
+        }
+    }
+    for (int z = 0; z + 1 < n; z++) {
+        for (int x = 0; x + 1 < n; x++) {
+            unsigned int i = (unsigned int)(z * n + x);
+            unsigned int quad[6] = { i, i + (unsigned int)n, i + 1, i + 1, i + (unsigned int)n, i + (unsigned int)n + 1 };
+            out.indices.insert(out.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+/**
+ * @brief Mierzy średni czas klatki (rysowanie + `glFinish`) dla jednego programu.
+ * @param city Scena.
+ * @param shader Program.
+ * @param frames Liczba klatek.
+ * @param vertexOnly Odrzuca wszystkie trójkąty przed rasteryzacją (mierzy sam etap wierzchołków).
+ * @return Średni czas klatki w milisekundach.
+ */
+static double MeasureFrameMs(const City& city, Shader& shader, int frames, bool vertexOnly) {
+    if (vertexOnly) { glEnable(GL_CULL_FACE); glCullFace(GL_FRONT_AND_BACK); }
+    double total = 0.0;
+    for (int f = 0; f < frames; f++) {
+        auto t0 = std::chrono::steady_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.use();
+        city.Draw(shader);
+        glFinish();
+        auto t1 = std::chrono::steady_clock::now();
+        total += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+    if (vertexOnly) { glDisable(GL_CULL_FACE); glCullFace(GL_BACK); }
+    return total / frames;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    std::string cityPath = argc > 2 ? argv[2] : "";
+
+    if (!glfwInit()) { std::printf("Nie udalo sie zainicjalizowac GLFW\n"); return 1; }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "Racing3D_bench_vertex", nullptr, nullptr);
+    if (!window) { std::printf("Nie udalo sie utworzyc kontekstu OpenGL 3.3\n"); glfwTerminate(); return 1; }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { std::printf("Nie udalo sie wczytac GLAD\n"); return 1; }
+
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, 8, 8);
+
+    Shader inverseShader("bench/phong_inverse.vert", "shaders/phong.frag");
+    Shader normalMatrixShader("shaders/phong.vert", "shaders/phong.frag");
+
+    CityMeshData data;
+    std::string source = "miasto (OBJ)";
+    if (!City::LoadMeshData(cityPath, data)) {
+        BuildGrid(512, data.mesh);
+        source = "siatka 512x512";
+    }
+    size_t vertexCount = data.mesh.VertexCount();
+    size_t triangleCount = data.mesh.indices.size() / 3;
+
+    City city(glm::vec3(0.0f));
+    city.Yaw = 30.0f;
+    city.UploadMesh(std::move(data));
+
+    FrameUniforms frameUniforms;
+    frameUniforms.Init();
+    FrameUniformData frameData;
+    frameData.view = glm::lookAt(glm::vec3(0.0f, 120.0f, -120.0f), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+    frameData.projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 1000.0f);
+    frameData.viewPos = glm::vec4(0.0f, 120.0f, -120.0f, 1.0f);
+    frameData.lightPos = glm::vec4(5.0f, 10.0f, 5.0f, 1.0f);
+    frameData.lightColor = glm::vec4(1.0f);
+    frameUniforms.Update(frameData);
+
+    // Rozgrzewka (kompilacja shaderów w sterowniku, pierwsze użycie buforów).
+    MeasureFrameMs(city, inverseShader, 3, false);
+    MeasureFrameMs(city, normalMatrixShader, 3, false);
+
+    auto mverts = [&](double ms) { return ms > 0.0 ? (double)triangleCount * 3.0 / (ms * 1000.0) : 0.0; };
+    std::printf("Renderer: %s\n", (const char*)glGetString(GL_RENDERER));
+    std::printf("Scena: %s, %zu wierzcholkow, %zu trojkatow, %d klatek na pomiar\n", source.c_str(), vertexCount, triangleCount, frames);
+    std::printf("%-14s | %16s %12s | %16s %12s | %6s\n", "tryb", "inverse() [ms]", "Mwierzch./s", "normalMatrix [ms]", "Mwierzch./s", "zysk");
+
+    const bool modes[] = { false, true };
+    for (bool vertexOnly : modes) {
+        double inverseMs = MeasureFrameMs(city, inverseShader, frames, vertexOnly);
+        double normalMatrixMs = MeasureFrameMs(city, normalMatrixShader, frames, vertexOnly);
+        std::printf("%-14s | %16.2f %12.1f | %16.2f %12.1f | %5.2fx\n", vertexOnly ? "same wierzch." : "pelne",
+            inverseMs, mverts(inverseMs), normalMatrixMs, mverts(normalMatrixMs),
+            normalMatrixMs > 0.0 ? inverseMs / normalMatrixMs : 0.0);
+    }
+
+    city.Release();
+    frameUniforms.Release();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,246 @@
+﻿#define GLM_ENABLE_EXPERIMENTAL
+#include "TrackDefinition.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * @file WallBuildBenchmark.cpp
+ * @brief Mikrobenchmark budowy ścian `TrackCollision::BuildWalls` z gęstych polilinii (np. skanów toru).
+ *
+ * Program zagęszcza obie strony toru kartingowego do zadanej liczby punktów (interpolacja liniowa
+ * po długości łuku) i dodaje szum o zadanej amplitudzie, udając pomiar w wysokiej rozdzielczości.
+ * Mierzony jest czas `BuildWalls` (drzewo k-d + RDP w miejscu) oraz, opcjonalnie, dotychczasowej
+ * implementacji (pełny przegląd przeciwnej strony dla każdego odcinka + rekurencyjny RDP z kopiami).
+ * Wyniki obu wariantów muszą być identyczne.
+ *
+ * Użycie: `Racing3D_bench_walls [punkty_na_stronę] [szum_m] [referencja 0/1]` (strony toru z `assets/karting/gp.track` —
+ * uruchamiać z katalogu zawierającego `assets/`)
+ */
+
+ /**
+  * @brief Zagęszcza polilinię do `count` punktów równo rozłożonych po długości i dodaje szum.
+  * @param raw Polilinia źródłowa.
+  * @param count Liczba punktów wyniku.
+  * @param noise Amplituda szumu (jednostajny w [-noise, noise] na oś).
+  * @param rng Generator liczb losowych.
+  * @return Zagęszczona polilinia.
+  */
+static std::vector<Point> Densify(const std::vector<Point>& raw, size_t count, float noise, std::mt19937& rng) {
+    std::vector<float> length(raw.size(), 0.0f);
+    for (size_t i = 1; i < raw.size(); ++i)
+        length[i] = length[i - 1] + glm::distance(glm::vec2(raw[i].x, raw[i].y), glm::vec2(raw[i - 1].x, raw[i - 1].y));
+
+    std::uniform_real_distribution<float> jitter(-noise, noise);
+    std::vector<Point> out(count);
+    size_t seg = 1;
+    for (size_t k = 0; k < count; ++k) {
+        float s = length.back() * (float)k / (float)(count - 1);
+        while (seg + 1 < raw.size() && length[seg] < s) ++seg;
+        float span = length[seg] - length[seg - 1];
+        float t = span > 0.0f ? glm::clamp((s - length[seg - 1]) / span, 0.0f, 1.0f) : 0.0f;
+        out[k].x = raw[seg - 1].x + (raw[seg].x - raw[seg - 1].x) * t + jitter(rng);
+        out[k].y = raw[seg - 1].y + (raw[seg].y - raw[seg - 1].y) * t + jitter(rng);
+    }
+    return out;
+}
+
+/**
+ * @brief Referencja: filtr bliskich punktów (jak w `TrackCollision`).
+ * @param pts Polilinia (modyfikowana).
+ * @param minDist Minimalny dystans między kolejnymi punktami.
+ */
+static void LegacyRemoveClosePoints(std::vector<glm::vec2>& pts, float minDist) {
+    if (pts.empty()) return;
+    std::vector<glm::vec2> out;
+    out.reserve(pts.size());
+    out.push_back(pts[0]);
+    for (size_t i = 1; i < pts.size(); ++i)
+        if (glm::distance2(pts[i], out.back()) > minDist * minDist) out.push_back(pts[i]);
+    pts.swap(out);
+}
+
+/**
+ * @brief Referencja: ruchoma średnia z oknem 3 punktów.
+ * @param pts Polilinia (modyfikowana).
+ */
+static void LegacySmooth(std::vector<glm::vec2>& pts) {
+    if (pts.size() < 3) return;
+    std::vector<glm::vec2> tmp = pts;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        glm::vec2 sum(0.0f);
+        for (int k = -1; k <= 1; ++k) sum += tmp[glm::clamp((int)i + k, 0, (int)pts.size() - 1)];
+        pts[i] = sum / 3.0f;
+    }
+}
+
+/**
+ * @brief Referencja: odległość punktu od odcinka.
+ * @param a Początek odcinka.
+ * @param b Koniec odcinka.
+ * @param p Punkt.
+ * @return Odległość.
+ */
+static float LegacyPerpDist(const glm::vec2& a, const glm::vec2& b, const glm::vec2& p) {
+    glm::vec2 ab = b - a;
+    float ab2 = glm::dot(ab, ab);
+    if (ab2 == 0.0f) return glm::length(p - a);
+    float t = glm::clamp(glm::dot(p - a, ab) / ab2, 0.0f, 1.0f);
+    return glm::length(p - (a + t * ab));
+}
+
+/**
+ * @brief Referencja: rekurencyjny RDP kopiujący podzakresy (poprzednia implementacja).
+ * @param pts Polilinia wejściowa.
+ * @param eps Tolerancja.
+ * @param out Wynik.
+ */
+static void LegacyRDP(const std::vector<glm::vec2>& pts, float eps, std::vector<glm::vec2>& out) {
+    if (pts.size() < 2) { out = pts; return; }
+    float maxd = 0.0f;
+    size_t idx = 0;
+    for (size_t i = 1; i + 1 < pts.size(); ++i) {
+        float d = LegacyPerpDist(pts.front(), pts.back(), pts[i]);
+        if (d > maxd) { maxd = d; idx = i; }
+    }
+    if (maxd > eps) {
+        std::vector<glm::vec2> left, right;
+        std::vector<glm::vec2> a(pts.begin(), pts.begin() + idx + 1);
+        std::vector<glm::vec2> b(pts.begin() + idx, pts.end());
+        LegacyRDP(a, eps, left);
+        LegacyRDP(b, eps, right);
+        out = left;
+        out.insert(out.end(), right.begin() + 1, right.end());
+    }
+    else {
+        out.clear();
+        out.push_back(pts.front());
+        out.push_back(pts.back());
+    }
+}
+
+/**
+ * @brief Referencja: poprzednia budowa ścian (pełny przegląd przeciwnej strony dla każdego odcinka).
+ * @param leftRaw Lewa strona.
+ * @param rightRaw Prawa strona.
+ * @param minTrackWidth Minimalna szerokość toru.
+ * @param outWalls Wynikowe odcinki.
+ */
+static void LegacyBuildWalls(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+    float minTrackWidth, std::vector<WallSegment>& outWalls) {
+    outWalls.clear();
+    std::vector<glm::vec2> left, right;
+    for (const auto& p : leftRaw) left.emplace_back(p.x, p.y);
+    for (const auto& p : rightRaw) right.emplace_back(p.x, p.y);
+    LegacyRemoveClosePoints(left, 1e-5f);
+    LegacyRemoveClosePoints(right, 1e-5f);
+    LegacySmooth(left);
+    LegacySmooth(right);
+
+    std::vector<glm::vec2> leftS, rightS;
+    LegacyRDP(left, 0.02f, leftS);
+    LegacyRDP(right, 0.02f, rightS);
+
+    auto nearest = [](const glm::vec2& mid, const std::vector<glm::vec2>& other, float& outDist) {
+        glm::vec2 best(0.0f);
+        float minD2 = std::numeric_limits<float>::max();
+        for (const auto& p : other) {
+            float d2 = glm::distance2(mid, p);
+            if (d2 < minD2) { minD2 = d2; best = p; }
+        }
+        outDist = other.empty() ? std::numeric_limits<float>::max() : std::sqrt(minD2);
+        return best;
+        };
+
+    for (size_t i = 0; i + 1 < leftS.size(); ++i) {
+        glm::vec2 a = leftS[i], b = leftS[i + 1], mid = (a + b) * 0.5f;
+        float d;
+        glm::vec2 toOther = nearest(mid, rightS, d) - mid;
+        if (d > minTrackWidth * 0.5f && d < 100.0f) {
+            glm::vec2 ab = b - a;
+            float len = glm::length(ab);
+            if (len > 1e-6f) {
+                glm::vec2 perp(-ab.y / len, ab.x / len);
+                float side = glm::dot(perp, toOther) >= 0.0f ? 1.0f : -1.0f;
+                a += perp * (-side * 0.30f);
+                b += perp * (-side * 0.30f);
+            }
+            outWalls.push_back({ a, b });
+        }
+    }
+    for (size_t i = 0; i + 1 < rightS.size(); ++i) {
+        float d;
+        nearest((rightS[i] + rightS[i + 1]) * 0.5f, leftS, d);
+        if (d > minTrackWidth * 0.5f && d < 100.0f) outWalls.push_back({ rightS[i], rightS[i + 1] });
+    }
+
+    std::vector<WallSegment> filtered;
+    for (auto& s : outWalls)
+        if (glm::distance(s.start, s.end) > 1e-4f) filtered.push_back(s);
+    outWalls.swap(filtered);
+}
+
+/**
+ * @brief Porównuje dwie listy odcinków bit w bit.
+ * @param a Pierwsza lista.
+ * @param b Druga lista.
+ * @return `true` jeśli listy są identyczne.
+ */
+static bool SameWalls(const std::vector<WallSegment>& a, const std::vector<WallSegment>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].start != b[i].start || a[i].end != b[i].end) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::max<size_t>(2, (size_t)std::strtoull(argv[1], nullptr, 10)) : 100000;
+    float noise = argc > 2 ? (float)std::atof(argv[2]) : 0.02f;
+    bool reference = argc > 3 ? std::atoi(argv[3]) != 0 : true;
+    const float minTrackWidth = 2.0f;
+
+    TrackDefinition track;
+    if (!track.LoadText("assets/karting/gp.track")) {
+        std::cout << "Nie mozna wczytac toru: assets/karting/gp.track" << std::endl;
+        return 1;
+    }
+
+    size_t mismatches = 0;
+
+    // Dane toru z gry: wynik nowej budowy musi być taki sam jak poprzedniej.
+    std::vector<WallSegment> walls, legacy;
+    TrackCollision::BuildWalls(track.LeftSide, track.RightSide, minTrackWidth, walls);
+    LegacyBuildWalls(track.LeftSide, track.RightSide, minTrackWidth, legacy);
+    std::cout << "Tor kartingowy: " << walls.size() << " scian, zgodnosc z poprzednia implementacja: "
+        << (SameWalls(walls, legacy) ? "tak" : "NIE") << std::endl;
+    if (!SameWalls(walls, legacy)) ++mismatches;
+
+    std::mt19937 rng(1234);
+    std::vector<Point> left = Densify(track.LeftSide, count, noise, rng);
+    std::vector<Point> right = Densify(track.RightSide, count, noise, rng);
+    std::cout << "Gesty skan: " << count << " punktow na strone, szum: " << noise << " m" << std::endl;
+
+    auto t0 = std::chrono::steady_clock::now();
+    TrackCollision::BuildWalls(left, right, minTrackWidth, walls);
+    auto t1 = std::chrono::steady_clock::now();
+    double fast = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    std::cout << "  BuildWalls (k-d + RDP w miejscu): " << fast << " ms, scian: " << walls.size() << std::endl;
+
+    if (reference) {
+        t0 = std::chrono::steady_clock::now();
+        LegacyBuildWalls(left, right, minTrackWidth, legacy);
+        t1 = std::chrono::steady_clock::now();
+        double slow = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        bool same = SameWalls(walls, legacy);
+        std::cout << "  poprzednia implementacja: " << slow << " ms, scian: " << legacy.size()
+            << ", przyspieszenie x" << (fast > 0.0 ? slow / fast : 0.0) << ", zgodnosc: " << (same ? "tak" : "NIE") << std::endl;
+        if (!same) ++mismatches;
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+﻿#version 330 core
+// Poprzednia wersja shaders/phong.vert (macierz normalnych liczona na wierzchołek) — punkt odniesienia dla Racing3D_bench_vertex.
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords; // Added Texture Coords
+
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+
+uniform mat4 model;
+
+// Dane klatki (UBO, std140) — układ musi odpowiadać FrameUniformData (src/FrameUniforms.h).
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 timeParams;
+};
+
+void main()
+{
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    TexCoords = aTexCoords; // Pass to fragment shader
+    
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
\ No newline at end of file
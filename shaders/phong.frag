@@ -6,28 +6,35 @@ in vec3 FragPos;
 in vec2 TexCoords;
 
 uniform sampler2D texture_diffuse1; // The Texture
-uniform vec3 lightColor;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+
+// Dane klatki (UBO, std140) — układ musi odpowiadać FrameUniformData (src/FrameUniforms.h).
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 timeParams;
+};
 
 void main()
 {
     // 1. Ambient
     float ambientStrength = 0.3;
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.rgb;
 
     // 2. Diffuse
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.rgb;
 
     // 3. Specular
     float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 reflectDir = reflect(-lightDir, norm);  
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;  
+    vec3 specular = specularStrength * spec * lightColor.rgb;  
 
     // 4. Texture sample
     vec4 texColor = texture(texture_diffuse1, TexCoords);
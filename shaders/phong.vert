@@ -8,13 +8,22 @@ out vec3 FragPos;
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix; // transpose(inverse(mat3(model))), liczona raz na obiekt na CPU
+
+// Dane klatki (UBO, std140) — układ musi odpowiadać FrameUniformData (src/FrameUniforms.h).
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 timeParams;
+};
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = normalMatrix * aNormal;
     TexCoords = aTexCoords; // Pass to fragment shader
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -0,0 +1,29 @@
+﻿#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in mat4 aInstanceModel; // Per-instance model matrix (locations 3-6)
+layout (location = 7) in mat3 aInstanceNormal; // Per-instance normal matrix (locations 7-9)
+
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+
+// Dane klatki (UBO, std140) — układ musi odpowiadać FrameUniformData (src/FrameUniforms.h).
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 timeParams;
+};
+
+void main()
+{
+    FragPos = vec3(aInstanceModel * vec4(aPos, 1.0));
+    Normal = aInstanceNormal * aNormal;
+    TexCoords = aTexCoords;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
\ No newline at end of file
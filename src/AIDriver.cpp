@@ -0,0 +1,118 @@
+﻿#include "AIDriver.h"
+#include "CarPhysics.h"
+#include "CarPhysicsWorld.h"
+#include <cmath>
+
+/**
+ * @file AIDriver.cpp
+ * @brief Implementacja sterowania AI po waypointach.
+ */
+
+ /**
+  * @brief Ustawia AI z powrotem na pierwszy waypoint.
+  */
+void AIDriver::Reset() {
+    CurrentWaypoint = 0;
+}
+
+/**
+ * @brief Wybiera waypoint i wylicza wejście sterujące oraz nowy yaw.
+ * @param position Pozycja auta.
+ * @param velocity Prędkość auta.
+ * @param turnRate Prędkość skrętu auta.
+ * @param yaw Yaw auta.
+ * @param steeringInput Wyjście: skręt.
+ * @param throttleInput Wyjście: gaz.
+ * @param deltaTime Krok czasu w sekundach.
+ * @return `true` gdy yaw został zmieniony.
+ */
+bool AIDriver::steer(const glm::vec3& position, const glm::vec3& velocity, float turnRate,
+                     float& yaw, float& steeringInput, float& throttleInput, float deltaTime) {
+    glm::vec3 target = Waypoints[CurrentWaypoint];
+    glm::vec3 toTarget = target - position;
+    float distance = glm::length(toTarget);
+
+    // Gdy AI jest blisko waypointu, przechodzi na następny.
+    if (distance < WaypointRadius) {
+        CurrentWaypoint++;
+        if (CurrentWaypoint >= (int)Waypoints.size())
+            CurrentWaypoint = 0;
+    }
+
+    float desiredYaw = glm::degrees(atan2(toTarget.x, toTarget.z));
+    float yawDiff = desiredYaw - yaw;
+
+    // Normalizacja różnicy yaw do zakresu [-180, 180].
+    while (yawDiff > 180.0f) yawDiff -= 360.0f;
+    while (yawDiff < -180.0f) yawDiff += 360.0f;
+
+    // Sterowanie skrętem.
+    steeringInput = glm::clamp(yawDiff / 25.0f, -1.0f, 1.0f);
+
+    // Sterowanie gazem zależnie od „ostrości” zakrętu.
+    float absYaw = fabs(yawDiff);
+    if (absYaw > 60.0f)
+        throttleInput = 0.4f;
+    else if (absYaw > 30.0f)
+        throttleInput = 0.7f;
+    else
+        throttleInput = 1.0f;
+
+    // Aktualizacja yaw (tylko gdy AI ma sensowną prędkość).
+    float speed = glm::length(velocity);
+    if (speed > 0.1f) {
+        float turnAmount = turnRate * deltaTime * 50.0f;
+        yaw += turnAmount * steeringInput;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Steruje autem przez jeden krok symulacji.
+ * @param car Sterowane auto.
+ * @param deltaTime Krok czasu w sekundach.
+ */
+void AIDriver::Update(CarPhysics& car, float deltaTime) {
+    if (Waypoints.empty()) return;
+
+    if (steer(car.Position, car.Velocity, car.TurnRate, car.Yaw, car.SteeringInput, car.ThrottleInput, deltaTime)) {
+        car.FrontVector = glm::normalize(glm::vec3(
+            sin(glm::radians(car.Yaw)),
+            0.0f,
+            cos(glm::radians(car.Yaw))
+        ));
+    }
+
+    car.Update(deltaTime);
+
+    float aiSpeed = glm::length(car.Velocity);
+    if (aiSpeed > car.MaxSpeed)
+        car.Velocity = glm::normalize(car.Velocity) * car.MaxSpeed;
+}
+
+/**
+ * @brief Ustawia wejście i yaw auta w zbiorze aut.
+ * @param world Zbiór aut.
+ * @param index Indeks sterowanego auta.
+ * @param deltaTime Krok czasu w sekundach.
+ */
+void AIDriver::Steer(CarPhysicsWorld& world, size_t index, float deltaTime) {
+    if (Waypoints.empty()) return;
+
+    // `FrontVector` nie jest tu odświeżany — krok fizyki i tak wylicza go z `Yaw`.
+    steer(world.GetPosition(index), world.GetVelocity(index), world.Params[index].TurnRate,
+          world.Yaw[index], world.SteeringInput[index], world.ThrottleInput[index], deltaTime);
+}
+
+/**
+ * @brief Ogranicza prędkość auta do jego `MaxSpeed`.
+ * @param world Zbiór aut.
+ * @param index Indeks auta.
+ */
+void AIDriver::LimitSpeed(CarPhysicsWorld& world, size_t index) {
+    glm::vec3 velocity = world.GetVelocity(index);
+    float maxSpeed = world.Params[index].MaxSpeed;
+    if (glm::length(velocity) > maxSpeed)
+        world.SetVelocity(index, glm::normalize(velocity) * maxSpeed);
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file AIDriver.h
+ * @brief Deklaracja kierowcy AI jadącego po liście waypointów.
+ */
+
+class CarPhysics;
+class CarPhysicsWorld;
+
+/**
+ * @brief Kierowca AI: wybiera waypoint, steruje skrętem i gazem, wykonuje krok fizyki auta.
+ *
+ * AI jedzie w kierunku bieżącego punktu:
+ * - jeśli jest wystarczająco blisko (`WaypointRadius`), przechodzi do następnego,
+ * - skręt wynika z różnicy yaw względem celu,
+ * - gaz jest redukowany przy ostrych zakrętach.
+ *
+ * Klasa nie zależy od OpenGL — używa jej gra oraz symulacja bez renderingu.
+ */
+class AIDriver {
+public:
+    /** @brief Pętla punktów trasy (po ostatnim AI wraca do pierwszego). */
+    std::vector<glm::vec3> Waypoints;
+
+    /** @brief Indeks bieżącego celu w `Waypoints`. */
+    int CurrentWaypoint = 0;
+
+    /** @brief Odległość, poniżej której waypoint uznawany jest za osiągnięty. */
+    float WaypointRadius = 2.7f;
+
+    /**
+     * @brief Ustawia AI z powrotem na pierwszy waypoint.
+     */
+    void Reset();
+
+    /**
+     * @brief Steruje autem przez jeden krok symulacji i wykonuje `car.Update`.
+     *
+     * Po kroku fizyki prędkość jest ograniczana do `car.MaxSpeed`.
+     *
+     * @param car Sterowane auto.
+     * @param deltaTime Krok czasu w sekundach.
+     */
+    void Update(CarPhysics& car, float deltaTime);
+
+    /**
+     * @brief Ustawia wejście i yaw auta `index` w `world` (bez kroku fizyki — ten wykonuje `world.Step`).
+     *
+     * Po `world.Step` należy wywołać `LimitSpeed`, aby wynik był identyczny z `Update(CarPhysics&)`.
+     *
+     * @param world Zbiór aut.
+     * @param index Indeks sterowanego auta.
+     * @param deltaTime Krok czasu w sekundach.
+     */
+    void Steer(CarPhysicsWorld& world, size_t index, float deltaTime);
+
+    /**
+     * @brief Ogranicza prędkość auta `index` do jego `MaxSpeed` (jak `Update` po kroku fizyki).
+     * @param world Zbiór aut.
+     * @param index Indeks auta.
+     */
+    static void LimitSpeed(CarPhysicsWorld& world, size_t index);
+
+private:
+    /**
+     * @brief Wybiera waypoint i wylicza wejście sterujące oraz nowy yaw.
+     * @param position Pozycja auta.
+     * @param velocity Prędkość auta.
+     * @param turnRate Prędkość skrętu auta.
+     * @param yaw Yaw auta (aktualizowany przy prędkości > 0.1).
+     * @param steeringInput Wyjście: skręt.
+     * @param throttleInput Wyjście: gaz.
+     * @param deltaTime Krok czasu w sekundach.
+     * @return `true` gdy yaw został zmieniony.
+     */
+    bool steer(const glm::vec3& position, const glm::vec3& velocity, float turnRate,
+               float& yaw, float& steeringInput, float& throttleInput, float deltaTime);
+};
@@ -0,0 +1,147 @@
+﻿#include "AssetLoader.h"
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+/**
+ * @file AssetLoader.cpp
+ * @brief Implementacja puli wątków wczytujących zasoby i kolejki uploadu.
+ */
+
+ /**
+  * @brief Tworzy wątki robocze.
+  * @param threadCount Liczba wątków (0 = liczba rdzeni - 1).
+  */
+AssetLoader::AssetLoader(unsigned int threadCount) {
+    if (threadCount == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1) ? hw - 1 : 1;
+    }
+    for (unsigned int i = 0; i < threadCount; i++)
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+/**
+ * @brief Zatrzymuje i dołącza wątki robocze.
+ */
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        stopping = true;
+        tasks.clear();
+    }
+    taskCv.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+/**
+ * @brief Dodaje zadanie do kolejki i budzi jeden wątek roboczy.
+ * @param name Nazwa zasobu.
+ * @param load Część CPU zasobu.
+ */
+void AssetLoader::Enqueue(const std::string& name, LoadFn load) {
+    total++;
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.push_back({ name, std::move(load) });
+    }
+    taskCv.notify_one();
+}
+
+/**
+ * @brief Pętla wątku: pobiera zadanie, wykonuje część CPU i odkłada upload do kolejki GL.
+ *
+ * Wyjątek z zadania jest logowany, a zasób liczony jako ukończony (bez uploadu),
+ * żeby ekran ładowania nie zawisł.
+ */
+void AssetLoader::workerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            taskCv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        UploadFn upload;
+        try {
+            upload = task.load();
+        }
+        catch (const std::exception& e) {
+            std::cout << "AssetLoader: blad wczytywania " << task.name << ": " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+            uploads.push_back({ std::move(task.name), std::move(upload) });
+        }
+        uploadCv.notify_all();
+    }
+}
+
+/**
+ * @brief Wykonuje uploady z kolejki w ramach budżetu czasu.
+ * @param budgetMs Budżet czasu w milisekundach.
+ * @return Liczba wykonanych uploadów.
+ */
+int AssetLoader::ProcessUploads(float budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    int done = 0;
+    for (;;) {
+        Upload item;
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+            if (uploads.empty()) break;
+            item = std::move(uploads.front());
+            uploads.pop_front();
+        }
+
+        if (item.upload) item.upload();
+        done++;
+
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+            lastCompleted = std::move(item.name);
+        }
+        completed++;
+
+        float elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+        if (elapsedMs >= budgetMs) break;
+    }
+    return done;
+}
+
+/**
+ * @brief Czeka na wszystkie zadania i wykonuje wszystkie uploady bez limitu czasu.
+ */
+void AssetLoader::WaitAll() {
+    while (!IsDone()) {
+        {
+            std::unique_lock<std::mutex> lock(uploadMutex);
+            uploadCv.wait(lock, [this] { return !uploads.empty() || completed.load() >= total.load(); });
+        }
+        ProcessUploads(1.0e9f);
+    }
+}
+
+/**
+ * @brief Zwraca postęp ładowania.
+ * @return Ułamek ukończonych zasobów (1 gdy nic nie dodano).
+ */
+float AssetLoader::GetProgress() const {
+    int t = total.load();
+    return (t > 0) ? (float)completed.load() / (float)t : 1.0f;
+}
+
+/**
+ * @brief Zwraca nazwę ostatnio ukończonego zasobu.
+ * @return Nazwa zasobu (pusta, jeśli żaden nie jest jeszcze gotowy).
+ */
+std::string AssetLoader::GetLastCompletedName() const {
+    std::lock_guard<std::mutex> lock(uploadMutex);
+    return lastCompleted;
+}
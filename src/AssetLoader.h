@@ -0,0 +1,114 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file AssetLoader.h
+ * @brief Pula wątków wczytujących zasoby (I/O, dekodowanie, parsowanie) z kolejką uploadu na wątku GL.
+ */
+
+ /**
+  * @brief Asynchroniczny loader zasobów w dwóch etapach.
+  *
+  * Zadanie (`LoadFn`) wykonuje się na wątku roboczym: czyta pliki, dekoduje obrazy, parsuje
+  * siatki — bez wywołań OpenGL. Zwraca funkcję uploadu (`UploadFn`), która trafia do kolejki
+  * opróżnianej na wątku GL przez `ProcessUploads()` w ramach budżetu czasu na klatkę
+  * (tworzenie VAO/VBO, tekstur). Zadanie bez części GPU może zwrócić pustą funkcję.
+  *
+  * Postęp (`GetProgress()`) liczy zasoby, których upload już się zakończył.
+  */
+class AssetLoader {
+public:
+    /** @brief Część GPU zasobu — wykonywana na wątku GL. */
+    using UploadFn = std::function<void()>;
+
+    /** @brief Część CPU zasobu — wykonywana na wątku roboczym, zwraca część GPU (lub pustą). */
+    using LoadFn = std::function<UploadFn()>;
+
+    /**
+     * @brief Uruchamia pulę wątków roboczych.
+     * @param threadCount Liczba wątków (0 = `hardware_concurrency() - 1`, co najmniej 1).
+     */
+    explicit AssetLoader(unsigned int threadCount = 0);
+
+    /** @brief Kończy pracę wątków (zadania jeszcze nierozpoczęte są porzucane). */
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief Dodaje zasób do kolejki wczytywania.
+     * @param name Nazwa zasobu (wyświetlana na ekranie ładowania).
+     * @param load Część CPU zasobu.
+     */
+    void Enqueue(const std::string& name, LoadFn load);
+
+    /**
+     * @brief Wykonuje oczekujące uploady na wątku GL, dopóki nie zostanie przekroczony budżet.
+     *
+     * W każdym wywołaniu wykonywany jest co najmniej jeden upload (jeśli jakiś czeka),
+     * więc pojedynczy duży zasób nie blokuje kolejki na zawsze.
+     *
+     * @param budgetMs Budżet czasu w milisekundach.
+     * @return Liczba wykonanych uploadów.
+     */
+    int ProcessUploads(float budgetMs);
+
+    /**
+     * @brief Blokuje, aż wszystkie zadania zostaną wczytane, i wykonuje wszystkie uploady (wątek GL).
+     */
+    void WaitAll();
+
+    /** @brief Liczba zasobów dodanych do kolejki. */
+    int GetTotalCount() const { return total.load(); }
+
+    /** @brief Liczba zasobów w pełni gotowych (po uploadzie). */
+    int GetCompletedCount() const { return completed.load(); }
+
+    /** @brief Postęp w zakresie [0, 1] (1 gdy kolejka jest pusta). */
+    float GetProgress() const;
+
+    /** @brief Czy wszystkie dodane zasoby są gotowe. */
+    bool IsDone() const { return completed.load() >= total.load(); }
+
+    /** @brief Nazwa ostatnio ukończonego zasobu. */
+    std::string GetLastCompletedName() const;
+
+private:
+    /** @brief Zadanie wczytywania z nazwą. */
+    struct Task {
+        std::string name;
+        LoadFn load;
+    };
+
+    /** @brief Wczytany zasób czekający na upload. */
+    struct Upload {
+        std::string name;
+        UploadFn upload;
+    };
+
+    /** @brief Pętla wątku roboczego. */
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+
+    std::mutex taskMutex;
+    std::condition_variable taskCv;
+    std::deque<Task> tasks;
+    bool stopping = false;
+
+    mutable std::mutex uploadMutex;
+    std::condition_variable uploadCv;
+    std::deque<Upload> uploads;
+    std::string lastCompleted;
+
+    std::atomic<int> total{ 0 };
+    std::atomic<int> completed{ 0 };
+};
@@ -0,0 +1,266 @@
+﻿#include "CarCollision.h"
+#include "CarPhysics.h"
+#include "CarPhysicsWorld.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file CarCollision.cpp
+ * @brief Implementacja kolizji auto–auto (siatka jednorodna + test osi rozdzielającej OBB + impuls).
+ */
+
+ /**
+  * @brief Buduje kształt z prostokąta otaczającego siatki.
+  * @param boundsMin Minimum AABB siatki.
+  * @param boundsMax Maksimum AABB siatki.
+  * @param scale Skala modelu.
+  * @return Kształt kolizyjny.
+  */
+CarShape CarShape::FromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax, float scale) {
+    CarShape shape;
+    shape.HalfExtents = glm::vec2(boundsMax.x - boundsMin.x, boundsMax.z - boundsMin.z) * (0.5f * scale);
+    shape.Center = glm::vec2(boundsMax.x + boundsMin.x, boundsMax.z + boundsMin.z) * (0.5f * scale);
+    return shape;
+}
+
+/**
+ * @brief Rozwiązuje kolizje między autami-obiektami.
+ * @param cars Auta.
+ * @param shapes Kształty aut lub pusty wektor.
+ * @return Liczba kontaktów.
+ */
+size_t CarCollision::Resolve(const std::vector<CarPhysics*>& cars, const std::vector<CarShape>& shapes) {
+    static const CarShape defaultShape;
+
+    bodies.clear();
+    for (size_t i = 0; i < cars.size(); i++) {
+        if (!cars[i]) continue;
+        Body body;
+        body.position = glm::vec2(cars[i]->Position.x, cars[i]->Position.z);
+        body.velocity = glm::vec2(cars[i]->Velocity.x, cars[i]->Velocity.z);
+        body.source = i;
+        prepareBody(body, cars[i]->Yaw, shapes.empty() ? defaultShape : shapes[i]);
+        bodies.push_back(body);
+    }
+
+    size_t count = solve();
+
+    for (const Body& body : bodies) {
+        CarPhysics& car = *cars[body.source];
+        car.Position.x = body.position.x; car.Position.z = body.position.y;
+        car.Velocity.x = body.velocity.x; car.Velocity.z = body.velocity.y;
+    }
+    return count;
+}
+
+/**
+ * @brief Rozwiązuje kolizje między włączonymi autami `CarPhysicsWorld`.
+ * @param world Zbiór aut.
+ * @param shapes Kształty aut lub pusty wektor.
+ * @return Liczba kontaktów.
+ */
+size_t CarCollision::Resolve(CarPhysicsWorld& world, const std::vector<CarShape>& shapes) {
+    static const CarShape defaultShape;
+
+    bodies.clear();
+    for (size_t i = 0; i < world.Size(); i++) {
+        if (!world.Enabled[i]) continue;
+        Body body;
+        body.position = glm::vec2(world.PositionX[i], world.PositionZ[i]);
+        body.velocity = glm::vec2(world.VelocityX[i], world.VelocityZ[i]);
+        body.source = i;
+        prepareBody(body, world.Yaw[i], shapes.empty() ? defaultShape : shapes[i]);
+        bodies.push_back(body);
+    }
+
+    size_t count = solve();
+
+    for (const Body& body : bodies) {
+        world.PositionX[body.source] = body.position.x; world.PositionZ[body.source] = body.position.y;
+        world.VelocityX[body.source] = body.velocity.x; world.VelocityZ[body.source] = body.velocity.y;
+    }
+    return count;
+}
+
+/**
+ * @brief Wylicza osie prostokąta, środek w świecie i jego AABB.
+ * @param body Auto.
+ * @param yaw Yaw w stopniach.
+ * @param shape Kształt auta.
+ */
+void CarCollision::prepareBody(Body& body, float yaw, const CarShape& shape) {
+    float s = std::sin(glm::radians(yaw));
+    float c = std::cos(glm::radians(yaw));
+
+    // Obrót wokół Y jak w macierzy modelu: lokalne +Z to `FrontVector` (sin, cos).
+    body.axisX = glm::vec2(c, -s);
+    body.axisZ = glm::vec2(s, c);
+    body.halfExtents = shape.HalfExtents;
+    body.center = shape.Center;
+    body.inverseMass = shape.Mass > 0.0f ? 1.0f / shape.Mass : 0.0f;
+
+    glm::vec2 center = body.position + body.axisX * shape.Center.x + body.axisZ * shape.Center.y;
+    float extentX = shape.HalfExtents.x * std::abs(c) + shape.HalfExtents.y * std::abs(s);
+    float extentZ = shape.HalfExtents.x * std::abs(s) + shape.HalfExtents.y * std::abs(c);
+    body.minX = center.x - extentX; body.maxX = center.x + extentX;
+    body.minZ = center.y - extentZ; body.maxZ = center.y + extentZ;
+}
+
+/**
+ * @brief Test nachodzenia dwóch prostokątów (4 osie rozdzielające).
+ * @param a Pierwsze auto.
+ * @param b Drugie auto.
+ * @param outNormal Normalna najmniejszego wniknięcia (od A do B).
+ * @param outDepth Głębokość wniknięcia.
+ * @return `true` jeśli prostokąty nachodzą na siebie.
+ */
+bool CarCollision::overlapBoxes(const Body& a, const Body& b, glm::vec2& outNormal, float& outDepth) {
+    glm::vec2 centerA = a.position + a.axisX * a.center.x + a.axisZ * a.center.y;
+    glm::vec2 centerB = b.position + b.axisX * b.center.x + b.axisZ * b.center.y;
+    glm::vec2 d = centerB - centerA;
+
+    const glm::vec2 axes[4] = { a.axisX, a.axisZ, b.axisX, b.axisZ };
+    outDepth = 0.0f;
+    for (int k = 0; k < 4; k++) {
+        const glm::vec2& axis = axes[k];
+        float rA = a.halfExtents.x * std::abs(glm::dot(a.axisX, axis)) + a.halfExtents.y * std::abs(glm::dot(a.axisZ, axis));
+        float rB = b.halfExtents.x * std::abs(glm::dot(b.axisX, axis)) + b.halfExtents.y * std::abs(glm::dot(b.axisZ, axis));
+        float distance = glm::dot(d, axis);
+        float overlap = rA + rB - std::abs(distance);
+        if (overlap <= 0.0f) return false;
+
+        if (k == 0 || overlap < outDepth) {
+            outDepth = overlap;
+            outNormal = distance < 0.0f ? -axis : axis;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Klucz komórki siatki broadphase (kolumna X w starszych bitach, więc sąsiedzi w X leżą obok siebie).
+ * @param ix Kolumna komórki.
+ * @param iz Wiersz komórki.
+ * @return Klucz sortowania.
+ */
+static unsigned long long CellKey(int ix, int iz) {
+    return ((unsigned long long)(unsigned int)(ix + 0x40000000) << 32) | (unsigned int)(iz + 0x40000000);
+}
+
+/**
+ * @brief Testuje parę aut i przy nachodzeniu rozsuwa je oraz wymienia impuls.
+ * @param a Pierwsze auto.
+ * @param b Drugie auto.
+ */
+void CarCollision::resolvePair(Body& a, Body& b) {
+    if (b.minX > a.maxX || b.maxX < a.minX || b.minZ > a.maxZ || b.maxZ < a.minZ) return;
+
+    ++pairTests;
+    glm::vec2 normal;
+    float depth;
+    if (!overlapBoxes(a, b, normal, depth)) return;
+
+    float inverseMassSum = a.inverseMass + b.inverseMass;
+    if (inverseMassSum <= 0.0f) return;
+
+    // Rozsunięcie proporcjonalne do odwrotności mas.
+    float correction = std::max(depth - Slop, 0.0f) / inverseMassSum;
+    a.position -= normal * (correction * a.inverseMass);
+    b.position += normal * (correction * b.inverseMass);
+
+    // Impuls tylko przy zbliżaniu się aut wzdłuż normalnej.
+    float approach = glm::dot(b.velocity - a.velocity, normal);
+    if (approach < 0.0f) {
+        float impulse = -(1.0f + Restitution) * approach / inverseMassSum;
+        a.velocity -= normal * (impulse * a.inverseMass);
+        b.velocity += normal * (impulse * b.inverseMass);
+    }
+
+    CarContact contact;
+    contact.A = a.source; contact.B = b.source;
+    contact.Normal = normal; contact.Depth = depth;
+    contacts.push_back(contact);
+}
+
+/**
+ * @brief Testuje wszystkie pary aut z dwóch różnych komórek.
+ * @param a Pierwsza komórka.
+ * @param b Druga komórka.
+ */
+void CarCollision::resolveCells(const Cell& a, const Cell& b) {
+    for (unsigned int i = a.begin; i < a.end; i++)
+        for (unsigned int j = b.begin; j < b.end; j++)
+            resolvePair(bodies[order[i]], bodies[order[j]]);
+}
+
+/**
+ * @brief Broadphase na siatce jednorodnej, test par i odpowiedź impulsowa.
+ * @return Liczba kontaktów.
+ */
+size_t CarCollision::solve() {
+    contacts.clear();
+    pairTests = 0;
+
+    const size_t n = bodies.size();
+    if (n < 2) return 0;
+
+    // Komórka nie mniejsza niż największy AABB: środki nachodzących aut leżą w sąsiednich komórkach.
+    float cellSize = 1e-3f;
+    for (const Body& body : bodies) cellSize = std::max(cellSize, std::max(body.maxX - body.minX, body.maxZ - body.minZ));
+    const float inverseCell = 1.0f / cellSize;
+    for (Body& body : bodies) {
+        body.cellX = (int)std::floor((body.minX + body.maxX) * 0.5f * inverseCell);
+        body.cellZ = (int)std::floor((body.minZ + body.maxZ) * 0.5f * inverseCell);
+        body.cell = CellKey(body.cellX, body.cellZ);
+    }
+
+    auto byCell = [this](unsigned int a, unsigned int b) { return bodies[a].cell < bodies[b].cell; };
+    if (order.size() != n) {
+        order.resize(n);
+        for (size_t i = 0; i < n; i++) order[i] = (unsigned int)i;
+        std::sort(order.begin(), order.end(), byCell);
+    }
+    else {
+        // Sort przez wstawianie: auta rzadko zmieniają komórkę, więc przy kolejności z poprzedniego kroku prawie liniowy.
+        for (size_t i = 1; i < n; i++) {
+            unsigned int index = order[i];
+            size_t j = i;
+            while (j > 0 && byCell(index, order[j - 1])) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = index;
+        }
+    }
+
+    cells.clear();
+    for (size_t i = 0; i < n; i++) {
+        unsigned long long key = bodies[order[i]].cell;
+        if (cells.empty() || cells.back().key != key) cells.push_back({ key, (unsigned int)i, (unsigned int)i });
+        cells.back().end = (unsigned int)i + 1;
+    }
+
+    // Klucze sąsiadów rosną razem z kluczem komórki, więc kursor `next` przesuwa się tylko do przodu.
+    size_t next = 0;
+    for (size_t c = 0; c < cells.size(); c++) {
+        const Cell& cell = cells[c];
+        const Body& first = bodies[order[cell.begin]];
+
+        // Pary wewnątrz komórki.
+        for (unsigned int i = cell.begin; i < cell.end; i++)
+            for (unsigned int j = i + 1; j < cell.end; j++)
+                resolvePair(bodies[order[i]], bodies[order[j]]);
+
+        // Połowa sąsiedztwa (każda para komórek raz): (x, z+1) — następna komórka, jeśli istnieje…
+        if (c + 1 < cells.size() && cells[c + 1].key == CellKey(first.cellX, first.cellZ + 1))
+            resolveCells(cell, cells[c + 1]);
+
+        // …oraz (x+1, z-1..z+1).
+        unsigned long long lowKey = CellKey(first.cellX + 1, first.cellZ - 1);
+        unsigned long long highKey = CellKey(first.cellX + 1, first.cellZ + 1);
+        while (next < cells.size() && cells[next].key < lowKey) next++;
+        for (size_t k = next; k < cells.size() && cells[k].key <= highKey; k++)
+            resolveCells(cell, cells[k]);
+    }
+    return contacts.size();
+}
@@ -0,0 +1,176 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file CarCollision.h
+ * @brief Kolizje auto–auto: prostokąty zorientowane (OBB) w płaszczyźnie XZ, broadphase na siatce jednorodnej, odpowiedź impulsowa.
+ */
+
+class CarPhysics;
+class CarPhysicsWorld;
+
+ /**
+  * @brief Kształt kolizyjny auta: prostokąt w układzie auta (X — bok, Z — przód) i masa.
+  */
+struct CarShape {
+    /** @brief Połowy wymiarów prostokąta (X — szerokość, Y — długość wzdłuż osi Z auta). Domyślnie `race.obj` w skali 0.15. */
+    glm::vec2 HalfExtents = glm::vec2(0.0975f, 0.192f);
+
+    /** @brief Przesunięcie środka prostokąta względem `Position` w układzie auta (X, Z). */
+    glm::vec2 Center = glm::vec2(0.0f);
+
+    /** @brief Masa (tylko proporcje między autami mają znaczenie; <= 0 = auto nieruchome). */
+    float Mass = 1.0f;
+
+    /**
+     * @brief Buduje kształt z prostokąta otaczającego siatki w jej układzie lokalnym.
+     * @param boundsMin Minimum AABB siatki.
+     * @param boundsMax Maksimum AABB siatki.
+     * @param scale Skala modelu (jak w macierzy modelu auta).
+     * @return Kształt kolizyjny.
+     */
+    static CarShape FromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax, float scale);
+};
+
+/**
+ * @brief Kontakt dwóch aut wykryty w ostatnim `Resolve()`.
+ */
+struct CarContact {
+    /** @brief Indeksy aut (w kolejności przekazanej do `Resolve()`). */
+    size_t A = 0, B = 0;
+
+    /** @brief Normalna kontaktu w XZ (od A do B). */
+    glm::vec2 Normal = glm::vec2(0.0f);
+
+    /** @brief Głębokość wzajemnego wniknięcia przed rozsunięciem. */
+    float Depth = 0.0f;
+};
+
+/**
+ * @brief Rozwiązywanie kolizji między autami po kroku fizyki.
+ *
+ * Każde auto to prostokąt zorientowany zgodnie z `Yaw`. Broadphase przypisuje auta do komórek siatki
+ * o boku równym największemu AABB auta i sortuje je po kluczu komórki (sort przez wstawianie po kolejności
+ * z poprzedniego wywołania — auto zmienia komórkę co kilkanaście kroków). Testowane są tylko pary z tej samej
+ * lub sąsiedniej komórki, których AABB nachodzą na siebie, więc koszt rośnie praktycznie liniowo z liczbą aut
+ * niezależnie od kształtu toru (w przeciwieństwie do sort-and-sweep po jednej osi na prostych wzdłuż tej osi).
+ *
+ * Para nachodzących prostokątów (test osi rozdzielającej, 4 osie) jest rozsuwana wzdłuż normalnej
+ * proporcjonalnie do odwrotności mas, a prędkość względna wzdłuż normalnej odbijana ze współczynnikiem
+ * `Restitution`. Pozycja i prędkość zmieniają się tylko w XZ; yaw pozostaje pod kontrolą sterowania.
+ *
+ * Obiekt przechowuje kolejność sortowania i bufory robocze, więc każdy zbiór aut (gra, wyścig
+ * w symulacji) powinien mieć własną instancję.
+ */
+class CarCollision {
+public:
+    /** @brief Współczynnik odbicia w kontakcie (0 — bez odbicia, 1 — sprężyste). */
+    float Restitution = 0.3f;
+
+    /** @brief Głębokość wniknięcia pozostawiana bez korekty (stabilizuje stykające się auta). */
+    float Slop = 0.001f;
+
+    /**
+     * @brief Rozwiązuje kolizje między autami-obiektami.
+     * @param cars Auta (wskaźniki `nullptr` są pomijane).
+     * @param shapes Kształty aut (ten sam rozmiar co `cars`) albo pusty wektor = domyślny `CarShape`.
+     * @return Liczba kontaktów.
+     */
+    size_t Resolve(const std::vector<CarPhysics*>& cars, const std::vector<CarShape>& shapes = {});
+
+    /**
+     * @brief Rozwiązuje kolizje między włączonymi autami `CarPhysicsWorld` (`Enabled != 0`).
+     * @param world Zbiór aut.
+     * @param shapes Kształty aut (indeksowane jak w `world`) albo pusty wektor = domyślny `CarShape`.
+     * @return Liczba kontaktów.
+     */
+    size_t Resolve(CarPhysicsWorld& world, const std::vector<CarShape>& shapes = {});
+
+    /**
+     * @brief Zwraca kontakty z ostatniego `Resolve()`.
+     * @return Lista kontaktów.
+     */
+    const std::vector<CarContact>& GetContacts() const { return contacts; }
+
+    /**
+     * @brief Zwraca liczbę par z nachodzącymi AABB (przekazanych do testu OBB) w ostatnim `Resolve()`.
+     * @return Liczba testowanych par.
+     */
+    size_t GetPairTests() const { return pairTests; }
+
+private:
+    /** @brief Stan auta w buforze roboczym. */
+    struct Body {
+        glm::vec2 position;
+        glm::vec2 velocity;
+        glm::vec2 axisX, axisZ;
+        glm::vec2 halfExtents;
+        glm::vec2 center;
+        float inverseMass;
+        float minX, maxX, minZ, maxZ;
+        int cellX, cellZ;
+        unsigned long long cell;
+        size_t source;
+    };
+
+    /** @brief Niepusta komórka siatki: zakres `order` z autami o danym kluczu. */
+    struct Cell {
+        unsigned long long key;
+        unsigned int begin, end;
+    };
+
+    /**
+     * @brief Broadphase, test par i odpowiedź na buforze `bodies`.
+     * @return Liczba kontaktów.
+     */
+    size_t solve();
+
+    /**
+     * @brief Testuje parę aut (AABB, potem OBB) i przy nachodzeniu rozsuwa je oraz wymienia impuls.
+     * @param a Pierwsze auto.
+     * @param b Drugie auto.
+     */
+    void resolvePair(Body& a, Body& b);
+
+    /**
+     * @brief Testuje wszystkie pary aut z dwóch różnych komórek.
+     * @param a Pierwsza komórka.
+     * @param b Druga komórka.
+     */
+    void resolveCells(const Cell& a, const Cell& b);
+
+    /**
+     * @brief Wypełnia pola wyliczane z pozycji i yaw (osie, środek, AABB).
+     * @param body Auto.
+     * @param yaw Yaw w stopniach.
+     * @param shape Kształt auta.
+     */
+    static void prepareBody(Body& body, float yaw, const CarShape& shape);
+
+    /**
+     * @brief Test nachodzenia dwóch prostokątów (twierdzenie o osi rozdzielającej, 4 osie).
+     * @param a Pierwsze auto.
+     * @param b Drugie auto.
+     * @param outNormal Normalna najmniejszego wniknięcia (od A do B).
+     * @param outDepth Głębokość wniknięcia.
+     * @return `true` jeśli prostokąty nachodzą na siebie.
+     */
+    static bool overlapBoxes(const Body& a, const Body& b, glm::vec2& outNormal, float& outDepth);
+
+    /** @brief Bufor roboczy aut biorących udział w kolizjach. */
+    std::vector<Body> bodies;
+
+    /** @brief Indeksy `bodies` posortowane po kluczu komórki (zachowywane między wywołaniami). */
+    std::vector<unsigned int> order;
+
+    /** @brief Niepuste komórki w kolejności kluczy. */
+    std::vector<Cell> cells;
+
+    /** @brief Kontakty z ostatniego wywołania. */
+    std::vector<CarContact> contacts;
+
+    /** @brief Liczba testów OBB w ostatnim wywołaniu. */
+    size_t pairTests = 0;
+};
@@ -0,0 +1,175 @@
+﻿#include "CarPhysics.h"
+#include <cmath>
+
+/**
+ * @file CarPhysics.cpp
+ * @brief Implementacja fizyki samochodu (model jazdy, interpolacja stanu renderu).
+ */
+
+ /**
+  * @brief Konstruktor fizyki samochodu.
+  * @param startPosition Pozycja startowa w świecie.
+  */
+CarPhysics::CarPhysics(glm::vec3 startPosition) : Position(startPosition), PreviousPosition(startPosition), Velocity(0.0f), Yaw(0.0f),
+    TickStartPosition(startPosition), RenderPosition(startPosition) { FrontVector = glm::vec3(0, 0, 1); }
+
+/**
+ * @brief Aktualizuje fizykę samochodu.
+ * @param deltaTime Czas między klatkami w sekundach.
+ */
+void CarPhysics::Update(float deltaTime) {
+    CarMotionState state = GetMotionState();
+    Integrate(state, GetMotionParams(), deltaTime);
+    SetMotionState(state);
+}
+
+/**
+ * @brief Wykonuje krok modelu jazdy na stanie niezależnym od obiektu.
+ * @param state Stan i wejście auta.
+ * @param params Parametry ruchu.
+ * @param deltaTime Krok czasu w sekundach.
+ */
+void CarPhysics::Integrate(CarMotionState& state, const CarMotionParams& params, float deltaTime) {
+    state.PreviousPosition = state.Position;
+
+    state.FrontVector.x = sin(glm::radians(state.Yaw));
+    state.FrontVector.z = cos(glm::radians(state.Yaw));
+    state.FrontVector.y = 0.0f;
+    state.FrontVector = glm::normalize(state.FrontVector);
+
+    float tResponse = glm::clamp(params.ThrottleResponse * deltaTime, 0.0f, 1.0f);
+    state.Throttle = glm::mix(state.Throttle, state.ThrottleInput, tResponse);
+
+    glm::vec3 forward = state.FrontVector;
+
+    float forwardSpeed = glm::dot(state.Velocity, forward);
+    glm::vec3 velLong = forward * forwardSpeed;
+    glm::vec3 velLat = state.Velocity - velLong;
+
+    if (state.Throttle > 0.01f && !state.Handbrake) {
+        forwardSpeed += (state.Throttle * params.Acceleration) * deltaTime;
+    }
+    else if (state.Throttle < -0.01f) {
+        forwardSpeed -= (-state.Throttle * params.Braking) * deltaTime;
+    }
+
+    forwardSpeed = glm::clamp(forwardSpeed, -params.MaxSpeed, params.MaxSpeed);
+    velLong = forward * forwardSpeed;
+
+    float effectiveGrip = params.Grip;
+    if (state.Handbrake) {
+        forwardSpeed *= powf(params.HandbrakeDeceleration, deltaTime * 60.0f);
+        velLong = forward * forwardSpeed;
+
+        effectiveGrip *= (1.0f - params.HandbrakeGripReduction);
+
+        glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0, 1, 0)));
+        float slideForce = (-state.SteeringInput) * 0.5f * (glm::clamp(std::abs(forwardSpeed), 0.0f, params.MaxSpeed) / params.MaxSpeed);
+        velLat += right * slideForce * 10.0f * deltaTime;
+    }
+
+    state.Velocity = velLong + velLat;
+    float currentSpeed = glm::length(state.Velocity);
+
+    if (currentSpeed > 0.001f) {
+        state.Velocity += (-glm::normalize(state.Velocity) * (params.AerodynamicDrag * currentSpeed * currentSpeed)) * deltaTime;
+    }
+    state.Velocity -= state.Velocity * params.RollingResistance * deltaTime;
+
+    velLong = forward * glm::dot(state.Velocity, forward);
+    velLat = state.Velocity - velLong;
+    velLat *= (1.0f - glm::clamp(effectiveGrip * deltaTime * 2.0f, 0.0f, 1.0f));
+    state.Velocity = velLong + velLat;
+
+    currentSpeed = glm::length(state.Velocity);
+    if (currentSpeed > 0.5f && !state.Handbrake) {
+        float alignFactor = params.SteeringResponsiveness * deltaTime * glm::clamp(params.Grip * (1.0f - currentSpeed / (params.MaxSpeed + 0.1f)), 0.0f, 1.0f);
+        glm::vec3 velDir = glm::normalize(state.Velocity);
+        state.Velocity = glm::normalize(glm::mix(velDir, forward, alignFactor)) * currentSpeed * 0.99f;
+    }
+
+    if (glm::length(state.Velocity) > params.MaxSpeed) {
+        state.Velocity = glm::normalize(state.Velocity) * params.MaxSpeed;
+    }
+
+    state.Position += state.Velocity * deltaTime;
+    state.Position.y = 0.0f;
+
+    // Prosta kolizja z granicą świata: cofnięcie do pozycji sprzed kroku.
+    if (glm::length(state.Position) > 500.0f) {
+        state.Position = state.PreviousPosition;
+        state.Velocity = glm::vec3(0);
+    }
+
+    state.WheelRotation += glm::dot(state.Velocity, forward) * deltaTime * 10.0f;
+}
+
+/**
+ * @brief Kopiuje parametry ruchu z pól obiektu.
+ * @return Parametry ruchu.
+ */
+CarMotionParams CarPhysics::GetMotionParams() const {
+    CarMotionParams p;
+    p.MaxSpeed = MaxSpeed; p.Acceleration = Acceleration; p.Braking = Braking; p.TurnRate = TurnRate; p.Grip = Grip;
+    p.AerodynamicDrag = AerodynamicDrag; p.RollingResistance = RollingResistance; p.SteeringResponsiveness = SteeringResponsiveness;
+    p.HandbrakeGripReduction = HandbrakeGripReduction; p.HandbrakeDeceleration = HandbrakeDeceleration; p.ThrottleResponse = ThrottleResponse;
+    return p;
+}
+
+/**
+ * @brief Kopiuje stan i wejście z pól obiektu.
+ * @return Stan ruchu.
+ */
+CarMotionState CarPhysics::GetMotionState() const {
+    CarMotionState s;
+    s.Position = Position; s.PreviousPosition = PreviousPosition; s.Velocity = Velocity; s.FrontVector = FrontVector;
+    s.Yaw = Yaw; s.Throttle = Throttle; s.WheelRotation = WheelRotation;
+    s.SteeringInput = SteeringInput; s.ThrottleInput = ThrottleInput; s.Handbrake = Handbrake;
+    return s;
+}
+
+/**
+ * @brief Zapisuje stan i wejście do pól obiektu.
+ * @param state Stan ruchu.
+ */
+void CarPhysics::SetMotionState(const CarMotionState& state) {
+    Position = state.Position; PreviousPosition = state.PreviousPosition; Velocity = state.Velocity; FrontVector = state.FrontVector;
+    Yaw = state.Yaw; Throttle = state.Throttle; WheelRotation = state.WheelRotation;
+    SteeringInput = state.SteeringInput; ThrottleInput = state.ThrottleInput; Handbrake = state.Handbrake;
+}
+
+/**
+ * @brief Zapamiętuje pozycję i obrót sprzed kroku fizyki.
+ */
+void CarPhysics::BeginTick() {
+    TickStartPosition = Position;
+    TickStartYaw = Yaw;
+}
+
+/**
+ * @brief Interpoluje stan renderu między początkiem a końcem ostatniego kroku fizyki.
+ * @param alpha Współczynnik interpolacji [0, 1].
+ */
+void CarPhysics::InterpolateRender(float alpha) {
+    alpha = glm::clamp(alpha, 0.0f, 1.0f);
+    RenderPosition = glm::mix(TickStartPosition, Position, alpha);
+    RenderYaw = glm::mix(TickStartYaw, Yaw, alpha);
+}
+
+/**
+ * @brief Synchronizuje stan renderu z bieżącym stanem fizyki (bez interpolacji).
+ */
+void CarPhysics::SnapRenderState() {
+    TickStartPosition = Position;
+    TickStartYaw = Yaw;
+    RenderPosition = Position;
+    RenderYaw = Yaw;
+}
+
+/**
+ * @brief Zwraca wektor przodu wyliczony z `RenderYaw`.
+ * @return Znormalizowany wektor przodu.
+ */
+glm::vec3 CarPhysics::GetRenderFrontVector() const {
+    return glm::vec3(sin(glm::radians(RenderYaw)), 0.0f, cos(glm::radians(RenderYaw)));
+}
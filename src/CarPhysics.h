@@ -0,0 +1,240 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @file CarPhysics.h
+ * @brief Deklaracja stanu i fizyki samochodu niezależnej od renderingu (bez OpenGL).
+ */
+
+ /**
+  * @brief Parametry ruchu auta czytane przez krok fizyki (znaczenie jak w polach `CarPhysics`).
+  */
+struct CarMotionParams {
+    /** @brief Maksymalna prędkość w m/s. */
+    float MaxSpeed = 5.0f;
+
+    /** @brief Współczynnik przyspieszenia. */
+    float Acceleration = 8.0f;
+
+    /** @brief Siła hamowania. */
+    float Braking = 10.0f;
+
+    /** @brief Prędkość skrętu (używana przez sterowanie, nie przez sam krok). */
+    float TurnRate = 2.5f;
+
+    /** @brief Przyczepność opon. */
+    float Grip = 1.5f;
+
+    /** @brief Opór aerodynamiczny. */
+    float AerodynamicDrag = 0.02f;
+
+    /** @brief Opór toczenia. */
+    float RollingResistance = 0.5f;
+
+    /** @brief Responsywność skrętu. */
+    float SteeringResponsiveness = 2.0f;
+
+    /** @brief Redukcja przyczepności na hamulcu ręcznym. */
+    float HandbrakeGripReduction = 0.6f;
+
+    /** @brief Wytracanie prędkości na hamulcu ręcznym. */
+    float HandbrakeDeceleration = 0.95f;
+
+    /** @brief Szybkość reakcji przepustnicy. */
+    float ThrottleResponse = 5.0f;
+};
+
+/**
+ * @brief Stan i wejście auta dla jednego kroku fizyki (znaczenie jak w polach `CarPhysics`).
+ */
+struct CarMotionState {
+    /** @brief Pozycja w świecie. */
+    glm::vec3 Position = glm::vec3(0.0f);
+
+    /** @brief Pozycja sprzed kroku. */
+    glm::vec3 PreviousPosition = glm::vec3(0.0f);
+
+    /** @brief Wektor prędkości. */
+    glm::vec3 Velocity = glm::vec3(0.0f);
+
+    /** @brief Wektor przodu (wyliczany w kroku z `Yaw`). */
+    glm::vec3 FrontVector = glm::vec3(0.0f, 0.0f, 1.0f);
+
+    /** @brief Obrót wokół osi Y (w stopniach). */
+    float Yaw = 0.0f;
+
+    /** @brief Wygładzona przepustnica. */
+    float Throttle = 0.0f;
+
+    /** @brief Kąt obrotu kół. */
+    float WheelRotation = 0.0f;
+
+    /** @brief Wejście skrętu [-1, 1]. */
+    float SteeringInput = 0.0f;
+
+    /** @brief Wejście gazu/hamulca [-1, 1]. */
+    float ThrottleInput = 0.0f;
+
+    /** @brief Czy hamulec ręczny jest aktywny. */
+    bool Handbrake = false;
+};
+
+/**
+ * @brief Fizyka samochodu: parametry ruchu, wejście sterujące i krok symulacji.
+  *
+  * Klasa nie zależy od OpenGL ani okna, dzięki czemu jest współdzielona przez grę (`RaceCar`)
+  * oraz symulację bez renderingu (`Racing3D_sim`).
+  */
+class CarPhysics {
+public:
+    /** @brief Aktualna pozycja samochodu w świecie. */
+    glm::vec3 Position;
+
+    /** @brief Pozycja z poprzedniej klatki (używana do prostego cofania przy kolizji). */
+    glm::vec3 PreviousPosition;
+
+    /** @brief Aktualny wektor prędkości (kierunek i wartość). */
+    glm::vec3 Velocity;
+
+    /** @brief Znormalizowany wektor wskazujący przód samochodu. */
+    glm::vec3 FrontVector;
+
+    /** @brief Kąt obrotu wokół osi Y (w stopniach). */
+    float Yaw;
+
+    /** @brief Maksymalna prędkość w m/s. */
+    float MaxSpeed = 5.0f;
+
+    /** @brief Współczynnik przyspieszenia (moc „silnika”). */
+    float Acceleration = 8.0f;
+
+    /** @brief Siła hamowania. */
+    float Braking = 10.0f;
+
+    /** @brief Prędkość skrętu (wpływa na zmianę `Yaw`). */
+    float TurnRate = 2.5f;
+
+    /** @brief Kąt obrotu kół (animacja toczenia). */
+    float WheelRotation = 0.0f;
+
+    /** @brief Przyczepność opon (wpływa na redukcję poślizgu bocznego). */
+    float Grip = 1.5f;
+
+    /** @brief Opór aerodynamiczny (zależny od kwadratu prędkości). */
+    float AerodynamicDrag = 0.02f;
+
+    /** @brief Opór toczenia (liniowy). */
+    float RollingResistance = 0.5f;
+
+    /** @brief Responsywność skrętu (jak szybko prędkość „wyrównuje się” do przodu auta). */
+    float SteeringResponsiveness = 2.0f;
+
+    /** @brief Czy hamulec ręczny jest aktywny. */
+    bool Handbrake = false;
+
+    /** @brief Redukcja przyczepności podczas hamulca ręcznego. */
+    float HandbrakeGripReduction = 0.6f;
+
+    /** @brief Współczynnik wytracania prędkości na ręcznym (<1.0 hamuje). */
+    float HandbrakeDeceleration = 0.95f;
+
+    /** @brief Wejście skrętu (np. A/D) w zakresie [-1, 1]. */
+    float SteeringInput = 0.0f;
+
+    /** @brief Wejście gazu/hamulca (np. W/S) w zakresie [-1, 1]. */
+    float ThrottleInput = 0.0f;
+
+    /** @brief Wygładzona wartość przepustnicy (dla płynności). */
+    float Throttle = 0.0f;
+
+    /** @brief Szybkość reakcji `Throttle` na `ThrottleInput`. */
+    float ThrottleResponse = 5.0f;
+
+    /** @brief Pozycja przednich kół na osi X. */
+    float WheelFrontX = 0.45f;
+
+    /** @brief Pozycja tylnych kół na osi X. */
+    float WheelBackX = 0.45f;
+
+    /** @brief Położenie osi kół względem środka na osi Z. */
+    float WheelZ = 0.42f;
+
+    /** @brief Pozycja na początku bieżącego kroku fizyki (punkt startowy interpolacji renderu). */
+    glm::vec3 TickStartPosition;
+
+    /** @brief Yaw na początku bieżącego kroku fizyki (w stopniach). */
+    float TickStartYaw = 0.0f;
+
+    /** @brief Pozycja używana do renderu i kamery (interpolowana między krokami fizyki). */
+    glm::vec3 RenderPosition;
+
+    /** @brief Yaw używany do renderu i kamery (interpolowany między krokami fizyki). */
+    float RenderYaw = 0.0f;
+
+    /**
+     * @brief Tworzy samochód w zadanej pozycji, z prędkością zerową i przodem wzdłuż +Z.
+     * @param startPosition Pozycja początkowa w świecie.
+     */
+    CarPhysics(glm::vec3 startPosition = glm::vec3(0.0f, 0.2f, 0.0f));
+
+    /** @brief Wirtualny destruktor (klasa bazowa `RaceCar`). */
+    virtual ~CarPhysics() = default;
+
+    /**
+     * @brief Aktualizuje fizykę samochodu w czasie.
+     * @param deltaTime Czas między klatkami w sekundach.
+     */
+    void Update(float deltaTime);
+
+    /**
+     * @brief Krok fizyki jednego auta na danych niezależnych od obiektu (wspólny dla `Update` i `CarPhysicsWorld`).
+     *
+     * Zmienia `Position`, `PreviousPosition`, `Velocity`, `FrontVector`, `Throttle` i `WheelRotation`.
+     * Obejmuje też prostą kolizję z granicą świata (cofnięcie do `PreviousPosition` poza promieniem 500 m).
+     *
+     * @param state Stan i wejście auta.
+     * @param params Parametry ruchu.
+     * @param deltaTime Krok czasu w sekundach.
+     */
+    static void Integrate(CarMotionState& state, const CarMotionParams& params, float deltaTime);
+
+    /**
+     * @brief Kopiuje parametry ruchu z pól obiektu.
+     * @return Parametry ruchu.
+     */
+    CarMotionParams GetMotionParams() const;
+
+    /**
+     * @brief Kopiuje stan i wejście z pól obiektu.
+     * @return Stan ruchu.
+     */
+    CarMotionState GetMotionState() const;
+
+    /**
+     * @brief Zapisuje stan i wejście do pól obiektu.
+     * @param state Stan ruchu.
+     */
+    void SetMotionState(const CarMotionState& state);
+
+    /**
+     * @brief Zapamiętuje stan sprzed kroku fizyki (wywoływane przed każdym `Update`).
+     */
+    void BeginTick();
+
+    /**
+     * @brief Wylicza stan renderu jako interpolację między początkiem a końcem ostatniego kroku.
+     * @param alpha Współczynnik interpolacji z zegara symulacji, zakres [0, 1].
+     */
+    void InterpolateRender(float alpha);
+
+    /**
+     * @brief Ustawia stan renderu i początek kroku na bieżącą pozycję (np. po teleportacji na start).
+     */
+    void SnapRenderState();
+
+    /**
+     * @brief Zwraca wektor przodu wyliczony z `RenderYaw` (dla kamery).
+     * @return Znormalizowany wektor przodu w płaszczyźnie XZ.
+     */
+    glm::vec3 GetRenderFrontVector() const;
+};
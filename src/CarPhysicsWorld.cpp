@@ -0,0 +1,200 @@
+﻿#include "CarPhysicsWorld.h"
+#include <algorithm>
+
+/**
+ * @file CarPhysicsWorld.cpp
+ * @brief Implementacja wsadowego kroku fizyki wielu aut (kolumny SoA + stała pula wątków).
+ */
+
+ /**
+  * @brief Zatrzymuje pulę wątków.
+  */
+CarPhysicsWorld::~CarPhysicsWorld() {
+    stopWorkers();
+}
+
+/**
+ * @brief Dopisuje auto na koniec wszystkich kolumn.
+ * @param car Auto źródłowe.
+ * @return Indeks auta.
+ */
+size_t CarPhysicsWorld::Add(const CarPhysics& car) {
+    size_t index = Size();
+    size_t n = index + 1;
+    for (auto* column : { &PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ,
+                          &VelocityX, &VelocityY, &VelocityZ, &FrontX, &FrontZ,
+                          &Yaw, &Throttle, &WheelRotation, &SteeringInput, &ThrottleInput })
+        column->resize(n);
+    Handbrake.resize(n);
+    Enabled.resize(n, 1);
+    Params.resize(n);
+
+    Load(index, car);
+    return index;
+}
+
+/**
+ * @brief Czyści wszystkie kolumny.
+ */
+void CarPhysicsWorld::Clear() {
+    for (auto* column : { &PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ,
+                          &VelocityX, &VelocityY, &VelocityZ, &FrontX, &FrontZ,
+                          &Yaw, &Throttle, &WheelRotation, &SteeringInput, &ThrottleInput })
+        column->clear();
+    Handbrake.clear();
+    Enabled.clear();
+    Params.clear();
+}
+
+/**
+ * @brief Kopiuje stan i parametry obiektu do kolumn auta `index`.
+ * @param index Indeks auta.
+ * @param car Auto źródłowe.
+ */
+void CarPhysicsWorld::Load(size_t index, const CarPhysics& car) {
+    SetPosition(index, car.Position);
+    PreviousX[index] = car.PreviousPosition.x; PreviousY[index] = car.PreviousPosition.y; PreviousZ[index] = car.PreviousPosition.z;
+    SetVelocity(index, car.Velocity);
+    FrontX[index] = car.FrontVector.x; FrontZ[index] = car.FrontVector.z;
+    Yaw[index] = car.Yaw;
+    Throttle[index] = car.Throttle;
+    WheelRotation[index] = car.WheelRotation;
+    SteeringInput[index] = car.SteeringInput;
+    ThrottleInput[index] = car.ThrottleInput;
+    Handbrake[index] = car.Handbrake ? 1 : 0;
+    Params[index] = car.GetMotionParams();
+}
+
+/**
+ * @brief Kopiuje stan auta `index` do obiektu.
+ * @param index Indeks auta.
+ * @param car Auto docelowe.
+ */
+void CarPhysicsWorld::Store(size_t index, CarPhysics& car) const {
+    car.Position = GetPosition(index);
+    car.PreviousPosition = glm::vec3(PreviousX[index], PreviousY[index], PreviousZ[index]);
+    car.Velocity = GetVelocity(index);
+    car.FrontVector = glm::vec3(FrontX[index], 0.0f, FrontZ[index]);
+    car.Yaw = Yaw[index];
+    car.Throttle = Throttle[index];
+    car.WheelRotation = WheelRotation[index];
+    car.SteeringInput = SteeringInput[index];
+    car.ThrottleInput = ThrottleInput[index];
+    car.Handbrake = Handbrake[index] != 0;
+}
+
+/**
+ * @brief Odtwarza pulę wątków o zadanej liczności.
+ * @param threadCount Liczba wątków łącznie z wołającym (0 = `hardware_concurrency()`).
+ */
+void CarPhysicsWorld::SetThreadCount(unsigned int threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount == GetThreadCount()) return;
+
+    stopWorkers();
+    stopping = false;
+    for (unsigned int slot = 1; slot < threadCount; slot++)
+        workers.emplace_back(&CarPhysicsWorld::workerLoop, this, slot);
+}
+
+/**
+ * @brief Dzieli auta na zakresy i liczy je równolegle (zakres 0 na wątku wołającym).
+ * @param deltaTime Krok czasu w sekundach.
+ */
+void CarPhysicsWorld::Step(float deltaTime) {
+    const size_t count = Size();
+    unsigned int slots = (unsigned int)std::min<size_t>(GetThreadCount(), std::max<size_t>(1, count / MinCarsPerThread));
+    if (slots <= 1) {
+        stepRange(0, count, deltaTime);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        activeSlots = slots;
+        pending = slots - 1;
+        stepDeltaTime = deltaTime;
+        generation++;
+    }
+    stepReady.notify_all();
+
+    stepRange(0, count / slots, deltaTime);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    stepDone.wait(lock, [this]() { return pending == 0; });
+}
+
+/**
+ * @brief Wykonuje `CarPhysics::Integrate` dla kolejnych aut zakresu.
+ * @param begin Pierwszy indeks.
+ * @param end Indeks za ostatnim.
+ * @param deltaTime Krok czasu.
+ */
+void CarPhysicsWorld::stepRange(size_t begin, size_t end, float deltaTime) {
+    CarMotionState s;
+    for (size_t i = begin; i < end; i++) {
+        if (!Enabled[i]) continue;
+
+        s.Position = glm::vec3(PositionX[i], PositionY[i], PositionZ[i]);
+        s.Velocity = glm::vec3(VelocityX[i], VelocityY[i], VelocityZ[i]);
+        s.Yaw = Yaw[i];
+        s.Throttle = Throttle[i];
+        s.WheelRotation = WheelRotation[i];
+        s.SteeringInput = SteeringInput[i];
+        s.ThrottleInput = ThrottleInput[i];
+        s.Handbrake = Handbrake[i] != 0;
+
+        CarPhysics::Integrate(s, Params[i], deltaTime);
+
+        PositionX[i] = s.Position.x; PositionY[i] = s.Position.y; PositionZ[i] = s.Position.z;
+        PreviousX[i] = s.PreviousPosition.x; PreviousY[i] = s.PreviousPosition.y; PreviousZ[i] = s.PreviousPosition.z;
+        VelocityX[i] = s.Velocity.x; VelocityY[i] = s.Velocity.y; VelocityZ[i] = s.Velocity.z;
+        FrontX[i] = s.FrontVector.x; FrontZ[i] = s.FrontVector.z;
+        Throttle[i] = s.Throttle;
+        WheelRotation[i] = s.WheelRotation;
+    }
+}
+
+/**
+ * @brief Czeka na kolejne kroki i liczy zakres `slot` (o ile krok go obejmuje).
+ * @param slot Numer zakresu.
+ */
+void CarPhysicsWorld::workerLoop(unsigned int slot) {
+    unsigned long long seen = 0;
+    while (true) {
+        float deltaTime;
+        unsigned int slots;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stepReady.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            deltaTime = stepDeltaTime;
+            slots = activeSlots;
+        }
+        if (slot >= slots) continue;
+
+        const size_t count = Size();
+        stepRange(count * slot / slots, count * (slot + 1) / slots, deltaTime);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) stepDone.notify_one();
+    }
+}
+
+/**
+ * @brief Budzi pulę z poleceniem zakończenia, łączy wątki i zeruje licznik kroków.
+ */
+void CarPhysicsWorld::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stepReady.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+
+    // Nowe wątki zaczynają od `seen = 0` — bez zerowania obudziłyby się od razu na poprzednim kroku.
+    generation = 0;
+    pending = 0;
+}
@@ -0,0 +1,188 @@
+﻿#pragma once
+#include "CarPhysics.h"
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file CarPhysicsWorld.h
+ * @brief Fizyka wielu aut naraz: stan w tablicach SoA i krok wszystkich aut jednym wywołaniem (bez OpenGL).
+ */
+
+/**
+ * @brief Zbiór aut symulowanych wsadowo — te same równania co `CarPhysics::Update`, inny układ danych.
+ *
+ * Każde pole stanu zmieniane przez krok fizyki lub sterowanie ma tu własną tablicę (kolumnę),
+ * indeksowaną numerem auta z `Add()`; parametry ruchu, czytane tylko razem, leżą obok siebie
+ * w `Params`. Pętla kroku przechodzi kolumny sekwencyjnie (bez obiektów rozproszonych po stercie
+ * i wirtualnych wywołań), a obliczenia wykonuje `CarPhysics::Integrate` — ta sama funkcja co
+ * `CarPhysics::Update`, więc wyniki są identyczne bit w bit.
+ *
+ * Przy `SetThreadCount(n)` > 1 auta dzielone są na n równych zakresów: jeden liczy wątek wołający,
+ * pozostałe stała pula wątków (bez tworzenia wątków w każdym kroku). Auta są od siebie niezależne,
+ * więc wynik nie zależy od liczby wątków.
+ *
+ * Przeznaczenie: duże wyścigi AI i trening offline (`Racing3D_sim`); w grze auta pozostają obiektami
+ * `RaceCar`, a `Load()`/`Store()` pozwalają przenosić stan między oboma reprezentacjami.
+ */
+class CarPhysicsWorld {
+public:
+    /** @brief Minimalna liczba aut na wątek — mniejsze zakresy liczone są na wątku wołającym. */
+    static constexpr size_t MinCarsPerThread = 256;
+
+    /** @brief Pozycje aut (kolumny X/Y/Z). */
+    std::vector<float> PositionX, PositionY, PositionZ;
+
+    /** @brief Pozycje sprzed ostatniego kroku. */
+    std::vector<float> PreviousX, PreviousY, PreviousZ;
+
+    /** @brief Prędkości aut. */
+    std::vector<float> VelocityX, VelocityY, VelocityZ;
+
+    /** @brief Wektor przodu w płaszczyźnie XZ (składowa Y zawsze 0), wyliczany w kroku z `Yaw`. */
+    std::vector<float> FrontX, FrontZ;
+
+    /** @brief Obrót wokół osi Y (w stopniach) — zmieniany przez sterowanie. */
+    std::vector<float> Yaw;
+
+    /** @brief Wygładzona przepustnica. */
+    std::vector<float> Throttle;
+
+    /** @brief Kąt obrotu kół. */
+    std::vector<float> WheelRotation;
+
+    /** @brief Wejście skrętu [-1, 1]. */
+    std::vector<float> SteeringInput;
+
+    /** @brief Wejście gazu/hamulca [-1, 1]. */
+    std::vector<float> ThrottleInput;
+
+    /** @brief Hamulec ręczny (0/1). */
+    std::vector<unsigned char> Handbrake;
+
+    /** @brief Auta z zerem są pomijane przez `Step` (np. po ukończeniu wyścigu). */
+    std::vector<unsigned char> Enabled;
+
+    /** @brief Parametry ruchu aut (tylko do odczytu w `Step`). */
+    std::vector<CarMotionParams> Params;
+
+    CarPhysicsWorld() = default;
+
+    /** @brief Zatrzymuje pulę wątków. */
+    ~CarPhysicsWorld();
+
+    CarPhysicsWorld(const CarPhysicsWorld&) = delete;
+    CarPhysicsWorld& operator=(const CarPhysicsWorld&) = delete;
+
+    /**
+     * @brief Dodaje auto (kopiuje jego stan i parametry).
+     * @param car Auto źródłowe.
+     * @return Indeks auta w kolumnach.
+     */
+    size_t Add(const CarPhysics& car);
+
+    /**
+     * @brief Usuwa wszystkie auta (pula wątków pozostaje).
+     */
+    void Clear();
+
+    /**
+     * @brief Zwraca liczbę aut.
+     * @return Liczba aut.
+     */
+    size_t Size() const { return PositionX.size(); }
+
+    /**
+     * @brief Nadpisuje stan i parametry auta `index` danymi z obiektu.
+     * @param index Indeks auta.
+     * @param car Auto źródłowe.
+     */
+    void Load(size_t index, const CarPhysics& car);
+
+    /**
+     * @brief Zapisuje stan auta `index` (pola zmieniane przez krok i wejście) do obiektu.
+     * @param index Indeks auta.
+     * @param car Auto docelowe.
+     */
+    void Store(size_t index, CarPhysics& car) const;
+
+    /** @brief Zwraca pozycję auta. */
+    glm::vec3 GetPosition(size_t index) const { return glm::vec3(PositionX[index], PositionY[index], PositionZ[index]); }
+
+    /** @brief Ustawia pozycję auta. */
+    void SetPosition(size_t index, const glm::vec3& p) { PositionX[index] = p.x; PositionY[index] = p.y; PositionZ[index] = p.z; }
+
+    /** @brief Zwraca prędkość auta. */
+    glm::vec3 GetVelocity(size_t index) const { return glm::vec3(VelocityX[index], VelocityY[index], VelocityZ[index]); }
+
+    /** @brief Ustawia prędkość auta. */
+    void SetVelocity(size_t index, const glm::vec3& v) { VelocityX[index] = v.x; VelocityY[index] = v.y; VelocityZ[index] = v.z; }
+
+    /**
+     * @brief Ustawia liczbę wątków kroku (łącznie z wołającym); 0 = `hardware_concurrency()`.
+     * @param threadCount Liczba wątków.
+     */
+    void SetThreadCount(unsigned int threadCount);
+
+    /**
+     * @brief Zwraca liczbę wątków kroku (łącznie z wołającym).
+     * @return Liczba wątków.
+     */
+    unsigned int GetThreadCount() const { return (unsigned int)workers.size() + 1; }
+
+    /**
+     * @brief Wykonuje krok fizyki wszystkich włączonych aut (`CarPhysics::Update` dla każdego).
+     * @param deltaTime Krok czasu w sekundach.
+     */
+    void Step(float deltaTime);
+
+private:
+    /**
+     * @brief Krok fizyki aut z zakresu [begin, end).
+     * @param begin Pierwszy indeks.
+     * @param end Indeks za ostatnim.
+     * @param deltaTime Krok czasu.
+     */
+    void stepRange(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Pętla wątku puli: czeka na kolejny krok i liczy swój zakres.
+     * @param slot Numer zakresu (1..n-1; zakres 0 liczy wątek wołający).
+     */
+    void workerLoop(unsigned int slot);
+
+    /**
+     * @brief Zatrzymuje i łączy wątki puli oraz zeruje licznik kroków (nowe wątki startują od zera).
+     */
+    void stopWorkers();
+
+    /** @brief Wątki puli (bez wątku wołającego). */
+    std::vector<std::thread> workers;
+
+    /** @brief Chroni pola synchronizacji puli. */
+    std::mutex mutex;
+
+    /** @brief Budzi wątki puli na nowy krok. */
+    std::condition_variable stepReady;
+
+    /** @brief Sygnalizuje zakończenie zakresów przez pulę. */
+    std::condition_variable stepDone;
+
+    /** @brief Numer kroku (zmiana budzi pulę). */
+    unsigned long long generation = 0;
+
+    /** @brief Liczba zakresów puli jeszcze nieukończonych w bieżącym kroku. */
+    unsigned int pending = 0;
+
+    /** @brief Liczba zakresów bieżącego kroku (może być mniejsza niż liczba wątków). */
+    unsigned int activeSlots = 0;
+
+    /** @brief Krok czasu bieżącego kroku. */
+    float stepDeltaTime = 0.0f;
+
+    /** @brief Polecenie zakończenia dla puli. */
+    bool stopping = false;
+};
@@ -0,0 +1,123 @@
+﻿#include "CarRenderer.h"
+#include "Shader.h"
+#include <glad/glad.h>
+#include <cstddef>
+
+/**
+ * @file CarRenderer.cpp
+ * @brief Implementacja instancjonowanego renderingu samochodów.
+ */
+
+ /** @brief Uchwyt uniformu przełączającego teksturę. */
+static const ShaderUniform uUseTexture("useTexture");
+
+/**
+ * @brief Tworzy pusty bufor instancji.
+ */
+void CarRenderer::Init() {
+    if (instanceVBO == 0) glGenBuffers(1, &instanceVBO);
+}
+
+/**
+ * @brief Usuwa bufor instancji.
+ */
+void CarRenderer::Release() {
+    if (instanceVBO != 0) glDeleteBuffers(1, &instanceVBO);
+    instanceVBO = 0;
+    instanceCapacity = 0;
+}
+
+/**
+ * @brief Czyści grupy poprzedniej klatki (wektory macierzy zachowują pojemność).
+ */
+void CarRenderer::Begin() {
+    for (size_t i = 0; i < activeBatches; i++) batches[i].instances.clear();
+    activeBatches = 0;
+}
+
+/**
+ * @brief Dodaje instancję do grupy o tym samym kluczu siatki i teksturze (liniowe wyszukiwanie — grup jest kilka).
+ * @param meshKey Klucz zawartości siatki (0 = VAO).
+ * @param vao VAO siatki.
+ * @param indexCount Liczba indeksów.
+ * @param texture Tekstura.
+ * @param model Macierz modelu.
+ */
+void CarRenderer::Add(size_t meshKey, unsigned int vao, int indexCount, unsigned int texture, const glm::mat4& model) {
+    if (vao == 0 || indexCount <= 0) return;
+    size_t key = (meshKey != 0) ? meshKey : (size_t)vao;
+    Instance instance{ model, NormalMatrix(model) };
+
+    for (size_t i = 0; i < activeBatches; i++) {
+        Batch& b = batches[i];
+        if (b.key == key && b.texture == texture) { b.instances.push_back(instance); return; }
+    }
+
+    if (activeBatches == batches.size()) batches.emplace_back();
+    Batch& b = batches[activeBatches++];
+    b.key = key;
+    b.vao = vao;
+    b.indexCount = indexCount;
+    b.texture = texture;
+    b.instances.clear();
+    b.instances.push_back(instance);
+}
+
+/**
+ * @brief Wysyła dane instancji wszystkich grup jednym uploadem i rysuje każdą grupę jednym wywołaniem.
+ * @param shader Program instancjonowany.
+ */
+void CarRenderer::Flush(Shader& shader) {
+    lastDrawCalls = 0;
+    lastInstances = 0;
+    if (activeBatches == 0 || instanceVBO == 0) return;
+
+    staging.clear();
+    for (size_t i = 0; i < activeBatches; i++)
+        staging.insert(staging.end(), batches[i].instances.begin(), batches[i].instances.end());
+
+    if (staging.size() > instanceCapacity) instanceCapacity = staging.size() * 2;
+
+    // Orphaning: nowy magazyn co klatkę, bez czekania na GPU czytające poprzednią.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(instanceCapacity * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(staging.size() * sizeof(Instance)), staging.data());
+
+    shader.use();
+    shader.setBool(uUseTexture, true);
+    glActiveTexture(GL_TEXTURE0);
+
+    size_t offset = 0;
+    // Wartość, której nie ma żadna tekstura — pierwsza grupa zawsze wiąże swoją (także 0), zamiast dziedziczyć
+    // teksturę zostawioną na jednostce 0 przez poprzednie rysowanie.
+    unsigned int boundTexture = ~0u;
+    for (size_t i = 0; i < activeBatches; i++) {
+        const Batch& b = batches[i];
+        if (b.texture != boundTexture) { glBindTexture(GL_TEXTURE_2D, b.texture); boundTexture = b.texture; }
+
+        glBindVertexArray(b.vao);
+        size_t base = offset * sizeof(Instance);
+        for (unsigned int c = 0; c < 4; c++) {
+            GLuint loc = InstanceAttribLocation + c;
+            glEnableVertexAttribArray(loc);
+            glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                (void*)(base + offsetof(Instance, model) + c * sizeof(glm::vec4)));
+            glVertexAttribDivisor(loc, 1);
+        }
+        for (unsigned int c = 0; c < 3; c++) {
+            GLuint loc = InstanceNormalAttribLocation + c;
+            glEnableVertexAttribArray(loc);
+            glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                (void*)(base + offsetof(Instance, normal) + c * sizeof(glm::vec3)));
+            glVertexAttribDivisor(loc, 1);
+        }
+
+        glDrawElementsInstanced(GL_TRIANGLES, b.indexCount, GL_UNSIGNED_INT, 0, (GLsizei)b.instances.size());
+        offset += b.instances.size();
+        lastDrawCalls++;
+    }
+    lastInstances = (int)offset;
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,103 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * @file CarRenderer.h
+ * @brief Instancjonowany rendering samochodów: jeden bufor macierzy instancji i jedno wywołanie na unikalną siatkę.
+ */
+
+class Shader;
+
+/**
+ * @brief Zbiera części samochodów (karoseria, koła) z całej klatki i rysuje je instancjonowanie.
+ *
+ * Części są grupowane według klucza źródła siatki (ta sama ścieżka OBJ = ta sama zawartość,
+ * nawet jeśli każde auto ma własne VAO) i tekstury. `Flush()` wysyła wszystkie macierze
+ * jednym uploadem do wspólnego VBO instancji, a następnie dla każdej grupy wykonuje jedno
+ * `glDrawElementsInstanced` — liczba wywołań nie rośnie z liczbą aut, tylko z liczbą unikalnych siatek.
+ *
+ * Macierz instancji trafia do atrybutów 3–6 (`aInstanceModel` w `phong_instanced.vert`),
+ * a macierz normalnych — liczona raz na instancję w `Add()` — do atrybutów 7–9 (`aInstanceNormal`).
+ * GL 3.3 nie ma `baseInstance`, więc przed każdym wywołaniem atrybuty są przestawiane
+ * na przesunięcie grupy w buforze.
+ */
+class CarRenderer {
+public:
+    /** @brief Pierwsza lokalizacja atrybutu macierzy instancji (zajmuje 4 kolejne). */
+    static constexpr unsigned int InstanceAttribLocation = 3;
+
+    /** @brief Pierwsza lokalizacja atrybutu macierzy normalnych instancji (zajmuje 3 kolejne). */
+    static constexpr unsigned int InstanceNormalAttribLocation = 7;
+
+    CarRenderer() = default;
+    CarRenderer(const CarRenderer&) = delete;
+    CarRenderer& operator=(const CarRenderer&) = delete;
+
+    /**
+     * @brief Tworzy bufor instancji (wątek GL).
+     */
+    void Init();
+
+    /**
+     * @brief Usuwa bufor instancji.
+     */
+    void Release();
+
+    /**
+     * @brief Rozpoczyna zbieranie nowej klatki (czyści grupy, zachowując pamięć).
+     */
+    void Begin();
+
+    /**
+     * @brief Dodaje instancję siatki.
+     * @param meshKey Klucz zawartości siatki (0 = grupowanie tylko po VAO).
+     * @param vao VAO siatki (grupa rysowana jest VAO pierwszej dodanej instancji).
+     * @param indexCount Liczba indeksów siatki.
+     * @param texture Tekstura 2D (jednostka 0).
+     * @param model Macierz modelu instancji.
+     */
+    void Add(size_t meshKey, unsigned int vao, int indexCount, unsigned int texture, const glm::mat4& model);
+
+    /**
+     * @brief Wysyła dane instancji i rysuje wszystkie grupy.
+     * @param shader Program instancjonowany (np. `phong_instanced.vert` + `phong.frag`); zostaje aktywny.
+     */
+    void Flush(Shader& shader);
+
+    /** @brief Liczba wywołań rysowania w ostatnim `Flush()`. */
+    int GetLastDrawCalls() const { return lastDrawCalls; }
+
+    /** @brief Liczba instancji w ostatnim `Flush()`. */
+    int GetLastInstances() const { return lastInstances; }
+
+private:
+    /** @brief Dane jednej instancji w buforze (układ odpowiada atrybutom 3–9). */
+    struct Instance {
+        glm::mat4 model;
+        glm::mat3 normal;
+    };
+
+    /** @brief Grupa instancji jednej siatki z jedną teksturą. */
+    struct Batch {
+        size_t key;
+        unsigned int vao;
+        int indexCount;
+        unsigned int texture;
+        std::vector<Instance> instances;
+    };
+
+    /** @brief Grupy bieżącej klatki (pierwsze `activeBatches` są w użyciu). */
+    std::vector<Batch> batches;
+    size_t activeBatches = 0;
+
+    /** @brief Instancje wszystkich grup sklejone przed uploadem. */
+    std::vector<Instance> staging;
+
+    /** @brief Bufor instancji i jego pojemność (w instancjach). */
+    unsigned int instanceVBO = 0;
+    size_t instanceCapacity = 0;
+
+    int lastDrawCalls = 0;
+    int lastInstances = 0;
+};
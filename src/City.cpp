@@ -1,8 +1,7 @@
 ﻿#include "City.h"
 #include "Shader.h"
-#include <fstream>
-#include <sstream>
 #include <iostream>
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 
 /**
@@ -10,120 +9,123 @@
  * @brief Implementacja klasy `City` (wczytywanie OBJ, przygotowanie siatki, renderowanie).
  */
 
- /**
-  * @brief Konstruktor inicjalizujący transformację i uchwyty OpenGL.
-  * @param startPosition Pozycja początkowa modelu miasta.
-  */
+ /** @brief Uchwyt uniformu używanego w `City::Draw`. */
+static const ShaderUniform uUseTexture("useTexture");
+
+/**
+ * @brief Konstruktor inicjalizujący transformację i uchwyty OpenGL.
+ * @param startPosition Pozycja początkowa modelu miasta.
+ */
 City::City(glm::vec3 startPosition)
     : Position(startPosition), Scale(glm::vec3(1.0f)), Yaw(0.0f), VAO(0), VBO(0), EBO(0) {
 }
 
 /**
  * @brief Wczytuje model miasta z pliku OBJ i przygotowuje dane do renderingu.
+ *
+ * Pierwsze wczytanie parsuje OBJ, spawa identyczne wierzchołki, układa trójkąty pod cache
+ * wierzchołków GPU i zapisuje binarny cache obok pliku; kolejne czytają cache. Następnie siatka
+ * dzielona jest na fragmenty przestrzenne z AABB (patrz `BuildChunks()`).
+ *
  * @param path Ścieżka do pliku OBJ; jeśli pusta, użyty zostanie domyślny plik.
  * @return `true` jeśli wczytanie się powiodło; inaczej `false`.
  */
 bool City::loadModel(const std::string& path) {
+    CityMeshData data;
+    if (!LoadMeshData(path, data)) return false;
+
+    UploadMesh(std::move(data));
+    return true;
+}
+
+/**
+ * @brief Wczytuje siatkę miasta (przez binarny cache) i dzieli ją na fragmenty bez tworzenia zasobów OpenGL.
+ * @param path Ścieżka do pliku OBJ; jeśli pusta, użyty zostanie domyślny plik.
+ * @param out Siatka wynikowa z fragmentami.
+ * @return `true` jeśli wczytanie się powiodło.
+ */
+bool City::LoadMeshData(const std::string& path, CityMeshData& out) {
     std::string modelFile = path.empty() ? "assets/city/desert city.obj" : path;
 
-    std::ifstream file(modelFile);
-    if (!file.is_open()) {
+    if (!MeshCache::LoadOrParse(modelFile, false, out.mesh)) {
         std::cout << "Nie mogк otworzyж pliku: " << modelFile << std::endl;
         return false;
     }
 
-    std::vector<glm::vec3> temp_vertices;
-    std::vector<glm::vec3> temp_normals;
-    std::vector<glm::vec2> temp_texcoords;
-
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-
-        if (prefix == "v") {
-            glm::vec3 vertex;
-            iss >> vertex.x >> vertex.y >> vertex.z;
-            temp_vertices.push_back(vertex);
-        }
-        else if (prefix == "vn") {
-            glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            temp_normals.push_back(normal);
-        }
-        else if (prefix == "vt") {
-            glm::vec2 texcoord;
-            iss >> texcoord.x >> texcoord.y;
-            temp_texcoords.push_back(texcoord);
-        }
-        else if (prefix == "f") {
-            std::string v1, v2, v3, v4;
-            iss >> v1 >> v2 >> v3 >> v4;
-
-            std::vector<std::string> faceVertices = { v1, v2, v3 };
-            if (!v4.empty()) {
-                faceVertices = { v1, v2, v3, v1, v3, v4 };
-            }
-
-            for (const auto& v : faceVertices) {
-                std::istringstream viss(v);
-                std::string v_str, vt_str, vn_str;
-                std::getline(viss, v_str, '/');
-                std::getline(viss, vt_str, '/');
-                std::getline(viss, vn_str, '/');
-
-                int vi = (v_str.empty()) ? 0 : std::stoi(v_str) - 1;
-                int vti = (vt_str.empty()) ? 0 : std::stoi(vt_str) - 1;
-                int vni = (vn_str.empty()) ? 0 : std::stoi(vn_str) - 1;
-
-                vertices.push_back(vi >= 0 && vi < temp_vertices.size() ? temp_vertices[vi] : glm::vec3(0.0f));
-                normals.push_back(vni >= 0 && vni < temp_normals.size() ? temp_normals[vni] : glm::vec3(0.0f, 1.0f, 0.0f));
-                texCoords.push_back(vti >= 0 && vti < temp_texcoords.size() ? temp_texcoords[vti] : glm::vec2(0.0f));
-
-                indices.push_back(indices.size());
-            }
-        }
-    }
-    file.close();
-
-    if (normals.empty() || normals.size() != vertices.size()) {
-        calculateNormals();
-    }
-
-    setupMesh();
-    std::cout << "Zaіadowano model miasta: " << vertices.size() << " wierzchoіkуw" << std::endl;
+    std::cout << "Zaіadowano model miasta: " << out.mesh.VertexCount() << " wierzchoіkуw" << std::endl;
+    BuildChunks(out.mesh, out.chunks);
     return true;
 }
 
 /**
- * @brief Wylicza normalne wierzchołków na podstawie trójkątów indeksowanych w `indices`.
+ * @brief Przypisuje trójkąty do komórek siatki XZ (po środku trójkąta) i układa indeksy komórkami.
+ * @param mesh Siatka (indeksy są przestawiane).
+ * @param chunks Fragmenty wynikowe.
  */
-void City::calculateNormals() {
-    normals.resize(vertices.size(), glm::vec3(0.0f));
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        if (i + 2 >= indices.size()) break;
-        glm::vec3 v0 = vertices[indices[i]];
-        glm::vec3 v1 = vertices[indices[i + 1]];
-        glm::vec3 v2 = vertices[indices[i + 2]];
-        glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-        normals[indices[i]] += normal;
-        normals[indices[i + 1]] += normal;
-        normals[indices[i + 2]] += normal;
+void City::BuildChunks(MeshData& mesh, std::vector<CityChunk>& chunks) {
+    chunks.clear();
+    size_t triangleCount = mesh.indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    auto position = [&mesh](unsigned int index) {
+        const float* v = &mesh.vertices[(size_t)index * MeshData::FloatsPerVertex];
+        return glm::vec3(v[0], v[1], v[2]);
+        };
+
+    BoundingBox all;
+    for (unsigned int index : mesh.indices) all.Expand(position(index));
+    glm::vec3 size = glm::max(all.max - all.min, glm::vec3(1e-4f));
+
+    const int cellCount = ChunkGrid * ChunkGrid;
+    std::vector<unsigned int> cellOf(triangleCount);
+    std::vector<unsigned int> start(cellCount + 1, 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        glm::vec3 c = (position(mesh.indices[t * 3]) + position(mesh.indices[t * 3 + 1]) + position(mesh.indices[t * 3 + 2])) / 3.0f;
+        int cx = std::clamp((int)((c.x - all.min.x) / size.x * ChunkGrid), 0, ChunkGrid - 1);
+        int cz = std::clamp((int)((c.z - all.min.z) / size.z * ChunkGrid), 0, ChunkGrid - 1);
+        cellOf[t] = (unsigned int)(cz * ChunkGrid + cx);
+        start[cellOf[t] + 1]++;
     }
-    for (auto& n : normals) {
-        if (glm::length(n) > 0.0f)
-            n = glm::normalize(n);
-        else
-            n = glm::vec3(0.0f, 1.0f, 0.0f);
+    for (int c = 0; c < cellCount; c++) start[c + 1] += start[c];
+
+    // Stabilne sortowanie przez zliczanie: trójkąty komórki zachowują wzajemną kolejność.
+    std::vector<unsigned int> sorted(mesh.indices.size());
+    std::vector<unsigned int> cursor(start.begin(), start.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        size_t dst = (size_t)cursor[cellOf[t]]++ * 3;
+        sorted[dst] = mesh.indices[t * 3];
+        sorted[dst + 1] = mesh.indices[t * 3 + 1];
+        sorted[dst + 2] = mesh.indices[t * 3 + 2];
     }
+    mesh.indices.swap(sorted);
+
+    for (int c = 0; c < cellCount; c++) {
+        if (start[c + 1] == start[c]) continue;
+        CityChunk chunk;
+        chunk.firstIndex = start[c] * 3;
+        chunk.indexCount = (start[c + 1] - start[c]) * 3;
+        for (unsigned int i = chunk.firstIndex; i < chunk.firstIndex + chunk.indexCount; i++)
+            chunk.bounds.Expand(position(mesh.indices[i]));
+        chunks.push_back(chunk);
+    }
+}
+
+/**
+ * @brief Przejmuje siatkę i fragmenty, a następnie przesyła siatkę na GPU.
+ * @param data Dane z `LoadMeshData()` (bez fragmentów są one budowane tutaj).
+ */
+void City::UploadMesh(CityMeshData&& data) {
+    if (data.chunks.empty()) BuildChunks(data.mesh, data.chunks);
+    mesh = std::move(data.mesh);
+    chunks = std::move(data.chunks);
+    setupMesh();
 }
 
 /**
  * @brief Tworzy VAO/VBO/EBO oraz konfiguruje atrybuty wierzchołków (pozycja, normalna, UV).
  */
 void City::setupMesh() {
-    if (vertices.empty()) return;
+    if (mesh.vertices.empty()) return;
 
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -131,25 +133,11 @@ void City::setupMesh() {
 
     glBindVertexArray(VAO);
 
-    std::vector<float> vertexData;
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        vertexData.push_back(vertices[i].x);
-        vertexData.push_back(vertices[i].y);
-        vertexData.push_back(vertices[i].z);
-
-        vertexData.push_back(normals[i].x);
-        vertexData.push_back(normals[i].y);
-        vertexData.push_back(normals[i].z);
-
-        vertexData.push_back(texCoords[i].x);
-        vertexData.push_back(texCoords[i].y);
-    }
-
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -163,6 +151,31 @@ void City::setupMesh() {
     glBindVertexArray(0);
 }
 
+/**
+ * @brief Usuwa VAO/VBO/EBO miasta i bazowego toru oraz zwalnia siatkę.
+ */
+void City::Release() {
+    Track::Release();
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+    mesh = MeshData();
+    chunks.clear();
+}
+
+/**
+ * @brief Zwraca rozmiar VBO + EBO miasta (z bazowym torem).
+ * @return Liczba bajtów.
+ */
+size_t City::GetGpuMemoryBytes() const {
+    size_t bytes = Track::GetGpuMemoryBytes();
+    if (VAO != 0) bytes += mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int);
+    return bytes;
+}
+
 /**
  * @brief Oblicza macierz modelu miasta (translacja -> rotacja -> skala).
  * @return Macierz modelu.
@@ -191,10 +204,49 @@ void City::Draw(const Shader& shader, glm::vec3 pos, float yaw) const {
         model = glm::scale(model, Scale);
     }
 
-    shader.setMat4("model", model);
-    shader.setBool("useTexture", true);
+    drawChunks(shader, model, Frustum());
+}
+
+/**
+ * @brief Renderuje fragmenty miasta widoczne w ostrosłupie kamery.
+ * @param shader Shader używany do renderowania.
+ * @param frustum Ostrosłup widzenia w przestrzeni świata.
+ */
+void City::Draw(const Shader& shader, const Frustum& frustum) const {
+    if (VAO == 0) return;
+    drawChunks(shader, GetModelMatrix(), frustum);
+}
+
+/**
+ * @brief Testuje AABB fragmentów i rysuje widoczne; kolejne widoczne fragmenty tworzą jeden zakres.
+ * @param shader Shader używany do renderowania.
+ * @param model Macierz modelu.
+ * @param frustum Ostrosłup widzenia w przestrzeni świata.
+ */
+void City::drawChunks(const Shader& shader, const glm::mat4& model, const Frustum& frustum) const {
+    cullStats.Reset();
+    shader.setModelMatrix(model);
+    shader.setBool(uUseTexture, true);
 
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    unsigned int rangeStart = 0, rangeCount = 0;
+    auto flush = [&]() {
+        if (rangeCount == 0) return;
+        glDrawElements(GL_TRIANGLES, (GLsizei)rangeCount, GL_UNSIGNED_INT, (void*)(rangeStart * sizeof(unsigned int)));
+        cullStats.drawCalls++;
+        rangeCount = 0;
+        };
+
+    for (const CityChunk& chunk : chunks) {
+        if (!frustum.IsVisible(chunk.bounds.Transformed(model))) {
+            cullStats.culled++;
+            flush();
+            continue;
+        }
+        cullStats.drawn++;
+        if (rangeCount != 0 && rangeStart + rangeCount == chunk.firstIndex) rangeCount += chunk.indexCount;
+        else { flush(); rangeStart = chunk.firstIndex; rangeCount = chunk.indexCount; }
+    }
+    flush();
     glBindVertexArray(0);
 }
\ No newline at end of file
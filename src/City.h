@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include "Track.h"
+#include "MeshCache.h"
+#include "Frustum.h"
 
 /**
  * @file City.h
@@ -13,19 +15,47 @@
 
 class Shader;
 
+/**
+ * @brief Fragment przestrzenny siatki miasta: ciągły zakres indeksów i jego AABB (przestrzeń modelu).
+ */
+struct CityChunk {
+    /** @brief AABB trójkątów fragmentu. */
+    BoundingBox bounds;
+
+    /** @brief Pierwszy indeks zakresu w EBO. */
+    unsigned int firstIndex = 0;
+
+    /** @brief Liczba indeksów zakresu. */
+    unsigned int indexCount = 0;
+};
+
+/**
+ * @brief Wynik etapu CPU ładowania miasta: siatka z indeksami ułożonymi fragmentami oraz opis fragmentów.
+ */
+struct CityMeshData {
+    /** @brief Siatka (indeksy posortowane według fragmentów). */
+    MeshData mesh;
+
+    /** @brief Fragmenty w kolejności ich zakresów w `mesh.indices`. */
+    std::vector<CityChunk> chunks;
+};
+
 /**
  * @brief Klasa reprezentująca model miasta wczytywany z pliku OBJ i renderowany przez OpenGL.
  *
  * Klasa dziedziczy po `Track`, aby mogła być używana jako alternatywny typ „sceny/toru”.
  * Odpowiada za:
- * - wczytanie geometrii OBJ (wierzchołki, normalne, UV, faces),
- * - ewentualne wyliczenie normalnych (gdy brak w pliku),
+ * - wczytanie geometrii OBJ przez `MeshCache` (parsowanie, spawanie wierzchołków, binarny cache),
+ * - podział siatki na fragmenty siatki `ChunkGrid` x `ChunkGrid` w płaszczyźnie XZ,
  * - konfigurację VAO/VBO/EBO,
- * - renderowanie przy użyciu shadera.
+ * - renderowanie przy użyciu shadera z odrzucaniem fragmentów spoza ostrosłupa kamery.
  */
 class City : public Track {
 
 public:
+    /** @brief Liczba fragmentów na bok siatki podziału (w płaszczyźnie XZ). */
+    static constexpr int ChunkGrid = 8;
+
     /** @brief Pozycja modelu miasta w świecie. */
     glm::vec3 Position;
 
@@ -51,6 +81,30 @@ public:
      */
     bool loadModel(const std::string& modelPath = "assets/city/desert city.obj");
 
+    /**
+     * @brief Etap CPU ładowania: wczytuje siatkę miasta przez `MeshCache` i dzieli ją na fragmenty. Nie używa OpenGL.
+     * @param modelPath Ścieżka do pliku OBJ (pusta = plik domyślny).
+     * @param out Siatka wynikowa z fragmentami.
+     * @return `true` jeśli wczytanie się powiodło.
+     */
+    static bool LoadMeshData(const std::string& modelPath, CityMeshData& out);
+
+    /**
+     * @brief Układa indeksy siatki fragmentami (według środka trójkąta w siatce XZ) i liczy AABB fragmentów.
+     *
+     * Sortowanie jest stabilne, więc w obrębie fragmentu zostaje kolejność z `MeshOptimizer`.
+     *
+     * @param mesh Siatka (indeksy są przestawiane).
+     * @param chunks Fragmenty wynikowe (puste fragmenty są pomijane).
+     */
+    static void BuildChunks(MeshData& mesh, std::vector<CityChunk>& chunks);
+
+    /**
+     * @brief Etap GPU ładowania: przejmuje siatkę i tworzy bufory OpenGL (tylko wątek GL).
+     * @param data Dane z `LoadMeshData()` (przenoszone); bez fragmentów są one budowane tutaj.
+     */
+    void UploadMesh(CityMeshData&& data);
+
     /**
      * @brief Renderuje model miasta.
      *
@@ -63,6 +117,33 @@ public:
      */
     void Draw(const Shader& shader, glm::vec3 pos = glm::vec3(0.0f), float yaw = 0.0f) const;
 
+    /**
+     * @brief Renderuje fragmenty miasta widoczne w ostrosłupie kamery (macierz z `GetModelMatrix()`).
+     *
+     * Sąsiednie widoczne fragmenty są łączone w jedno wywołanie rysowania.
+     *
+     * @param shader Shader używany do renderowania.
+     * @param frustum Ostrosłup widzenia w przestrzeni świata.
+     */
+    void Draw(const Shader& shader, const Frustum& frustum) const;
+
+    /**
+     * @brief Zwraca liczniki odrzucania z ostatniego `Draw()`.
+     * @return Narysowane / odrzucone fragmenty i liczba wywołań rysowania.
+     */
+    const CullStats& GetCullStats() const { return cullStats; }
+
+    /**
+     * @brief Zwalnia bufory OpenGL miasta (oraz bazowego `Track`) i siatkę w RAM.
+     */
+    void Release();
+
+    /**
+     * @brief Zwraca rozmiar danych miasta przesłanych na GPU (razem z bazowym `Track`).
+     * @return Liczba bajtów.
+     */
+    size_t GetGpuMemoryBytes() const;
+
     /**
      * @brief Zwraca macierz modelu (translacja -> rotacja -> skala).
      * @return Macierz modelu.
@@ -76,21 +157,21 @@ private:
     void setupMesh();
 
     /**
-     * @brief Wylicza normalne na podstawie trójkątów, gdy brak kompletnych danych normalnych.
+     * @brief Rysuje fragmenty widoczne w ostrosłupie, łącząc sąsiednie zakresy indeksów.
+     * @param shader Shader używany do renderowania.
+     * @param model Macierz modelu.
+     * @param frustum Ostrosłup widzenia w przestrzeni świata.
      */
-    void calculateNormals();
-
-    /** @brief Pozycje wierzchołków siatki. */
-    std::vector<glm::vec3> vertices;
+    void drawChunks(const Shader& shader, const glm::mat4& model, const Frustum& frustum) const;
 
-    /** @brief Normalne wierzchołków siatki. */
-    std::vector<glm::vec3> normals;
+    /** @brief Wierzchołki interleaved (pozycja, normalna, UV) i indeksy trójkątów (EBO). */
+    MeshData mesh;
 
-    /** @brief Współrzędne UV wierzchołków siatki. */
-    std::vector<glm::vec2> texCoords;
+    /** @brief Fragmenty przestrzenne (zakresy w `mesh.indices`). */
+    std::vector<CityChunk> chunks;
 
-    /** @brief Indeksy wierzchołków (EBO), tworzące trójkąty. */
-    std::vector<unsigned int> indices;
+    /** @brief Liczniki odrzucania z ostatniego `Draw()`. */
+    mutable CullStats cullStats;
 
     /** @brief Bufory OpenGL: VAO, VBO oraz EBO. */
     unsigned int VAO, VBO, EBO;
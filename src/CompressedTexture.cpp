@@ -0,0 +1,486 @@
+﻿#include "CompressedTexture.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * @file CompressedTexture.cpp
+ * @brief Implementacja odczytu DDS/KTX, zapisu DDS i odwracania bloków BCn w pionie.
+ */
+
+/** @brief Buduje kod FourCC z czterech znaków. */
+static constexpr uint32_t FourCC(char a, char b, char c, char d) {
+    return (uint32_t)(unsigned char)a | ((uint32_t)(unsigned char)b << 8) |
+        ((uint32_t)(unsigned char)c << 16) | ((uint32_t)(unsigned char)d << 24);
+}
+
+/** @brief Nagłówek DDS (bez magicznego `DDS `), układ zgodny z `DDS_HEADER`. */
+struct DdsHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    uint32_t pfSize;
+    uint32_t pfFlags;
+    uint32_t pfFourCC;
+    uint32_t pfRGBBitCount;
+    uint32_t pfMasks[4];
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+/** @brief Rozszerzenie nagłówka DDS dla FourCC `DX10`. */
+struct DdsHeaderDx10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+/** @brief Nagłówek KTX 1.1 (po 12-bajtowym identyfikatorze). */
+struct KtxHeader {
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DdsHeader musi mieć 124 bajty");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DdsHeaderDx10 musi mieć 20 bajtów");
+static_assert(sizeof(KtxHeader) == 52, "KtxHeader musi mieć 52 bajty");
+
+static const uint32_t kDdsMagic = FourCC('D', 'D', 'S', ' ');
+static const uint32_t kDdsFlagsDimensions = 0x2 | 0x4; // HEIGHT | WIDTH
+static const uint32_t kDdsFlagsRequired = 0x1 | kDdsFlagsDimensions | 0x1000; // CAPS | HEIGHT | WIDTH | PIXELFORMAT
+static const uint32_t kDdsFlagMipMapCount = 0x20000;
+static const uint32_t kDdsFlagLinearSize = 0x80000;
+static const uint32_t kDdsPixelFormatFourCC = 0x4;
+static const uint32_t kDdsCapsComplex = 0x8;
+static const uint32_t kDdsCapsTexture = 0x1000;
+static const uint32_t kDdsCapsMipMap = 0x400000;
+static const uint32_t kDdsCaps2CubeMap = 0x200;
+static const uint32_t kDdsCaps2Volume = 0x200000;
+
+static const unsigned char kKtxIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+/**
+ * @brief Wczytuje cały plik do pamięci.
+ * @param path Ścieżka do pliku.
+ * @param out Zawartość pliku.
+ * @return `true` jeśli plik udało się otworzyć i przeczytać.
+ */
+static bool ReadFileBytes(const std::string& path, std::vector<unsigned char>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+    out.resize((size_t)size);
+    file.seekg(0);
+    return (bool)file.read(reinterpret_cast<char*>(out.data()), size);
+}
+
+/**
+ * @brief Mapuje FourCC nagłówka DX9 na format bloków.
+ * @param fourCC Kod z `DDS_PIXELFORMAT`.
+ * @param out Format wynikowy.
+ * @return `false` dla nieobsługiwanych formatów.
+ */
+static bool BlockFormatFromFourCC(uint32_t fourCC, BlockFormat& out) {
+    if (fourCC == FourCC('D', 'X', 'T', '1')) { out = BlockFormat::BC1; return true; }
+    if (fourCC == FourCC('D', 'X', 'T', '5')) { out = BlockFormat::BC3; return true; }
+    if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U')) { out = BlockFormat::BC5; return true; }
+    return false;
+}
+
+/**
+ * @brief Mapuje `DXGI_FORMAT` nagłówka DX10 na format bloków (warianty TYPELESS/UNORM/SRGB).
+ * @param dxgiFormat Wartość `DXGI_FORMAT`.
+ * @param out Format wynikowy.
+ * @return `false` dla nieobsługiwanych formatów (w tym BC5_SNORM).
+ */
+static bool BlockFormatFromDxgi(uint32_t dxgiFormat, BlockFormat& out) {
+    if (dxgiFormat >= 70 && dxgiFormat <= 72) { out = BlockFormat::BC1; return true; }
+    if (dxgiFormat >= 76 && dxgiFormat <= 78) { out = BlockFormat::BC3; return true; }
+    if (dxgiFormat == 82 || dxgiFormat == 83) { out = BlockFormat::BC5; return true; }
+    return false;
+}
+
+/**
+ * @brief Mapuje `glInternalFormat` z KTX na format bloków.
+ * @param internalFormat Stała OpenGL formatu skompresowanego.
+ * @param out Format wynikowy.
+ * @return `false` dla nieobsługiwanych formatów.
+ */
+static bool BlockFormatFromGl(uint32_t internalFormat, BlockFormat& out) {
+    switch (internalFormat) {
+    case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    case 0x83F1: // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+        out = BlockFormat::BC1; return true;
+    case 0x83F3: // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+        out = BlockFormat::BC3; return true;
+    case 0x8DBD: // GL_COMPRESSED_RG_RGTC2
+        out = BlockFormat::BC5; return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Wypełnia opisy poziomów leżących jeden za drugim od `offset` i sprawdza, czy mieszczą się w pliku.
+ * @param image Obraz z ustawionym formatem i wymiarami (wypełniane są `mips`).
+ * @param levels Liczba poziomów.
+ * @param offset Początek danych poziomu 0 w pliku.
+ * @param fileSize Rozmiar pliku.
+ * @return `true` jeśli wszystkie poziomy mieszczą się w pliku.
+ */
+static bool LayoutContiguousMips(CompressedImage& image, int levels, size_t offset, size_t fileSize) {
+    image.mips.clear();
+    int w = image.width, h = image.height;
+    size_t pos = offset;
+    for (int i = 0; i < levels; i++) {
+        CompressedMip mip;
+        mip.width = w; mip.height = h;
+        mip.offset = pos - offset;
+        mip.size = GetCompressedLevelSize(image.format, w, h);
+        if (pos + mip.size > fileSize) return false;
+        image.mips.push_back(mip);
+        pos += mip.size;
+        if (w == 1 && h == 1) break;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return !image.mips.empty();
+}
+
+/**
+ * @brief Parsuje plik DDS (nagłówek DX9 lub DX10, tekstura 2D bez tablic i cubemap).
+ * @param bytes Zawartość pliku.
+ * @param out Obraz wynikowy (od górnego wiersza).
+ * @return `true` przy powodzeniu.
+ */
+static bool ParseDds(std::vector<unsigned char>& bytes, CompressedImage& out) {
+    if (bytes.size() < 4 + sizeof(DdsHeader)) return false;
+    uint32_t magic;
+    std::memcpy(&magic, bytes.data(), 4);
+    if (magic != kDdsMagic) return false;
+
+    DdsHeader header;
+    std::memcpy(&header, bytes.data() + 4, sizeof(header));
+    if (header.size != sizeof(DdsHeader) || (header.flags & kDdsFlagsDimensions) != kDdsFlagsDimensions) return false;
+    if (!(header.pfFlags & kDdsPixelFormatFourCC)) return false;
+    if (header.caps2 & (kDdsCaps2CubeMap | kDdsCaps2Volume)) return false;
+
+    size_t offset = 4 + sizeof(DdsHeader);
+    if (header.pfFourCC == FourCC('D', 'X', '1', '0')) {
+        if (bytes.size() < offset + sizeof(DdsHeaderDx10)) return false;
+        DdsHeaderDx10 dx10;
+        std::memcpy(&dx10, bytes.data() + offset, sizeof(dx10));
+        offset += sizeof(DdsHeaderDx10);
+        if (dx10.resourceDimension != 3 || dx10.arraySize > 1) return false; // 3 = TEXTURE2D
+        if (!BlockFormatFromDxgi(dx10.dxgiFormat, out.format)) return false;
+    }
+    else if (!BlockFormatFromFourCC(header.pfFourCC, out.format)) {
+        return false;
+    }
+
+    out.width = (int)header.width;
+    out.height = (int)header.height;
+    if (out.width <= 0 || out.height <= 0) return false;
+
+    int levels = ((header.flags & kDdsFlagMipMapCount) && header.mipMapCount > 0) ? (int)header.mipMapCount : 1;
+    if (!LayoutContiguousMips(out, levels, offset, bytes.size())) return false;
+
+    const CompressedMip& last = out.mips.back();
+    bytes.erase(bytes.begin() + offset + last.offset + last.size, bytes.end());
+    bytes.erase(bytes.begin(), bytes.begin() + offset);
+    out.data = std::move(bytes);
+    return true;
+}
+
+/**
+ * @brief Parsuje plik KTX 1.1 (tekstura 2D, format skompresowany, kolejność bajtów zgodna z maszyną).
+ * @param bytes Zawartość pliku.
+ * @param out Obraz wynikowy.
+ * @param bottomUp Ustawiane na `true`, gdy `KTXorientation` deklaruje wiersze od dołu (`T=u`).
+ * @return `true` przy powodzeniu.
+ */
+static bool ParseKtx(const std::vector<unsigned char>& bytes, CompressedImage& out, bool& bottomUp) {
+    if (bytes.size() < sizeof(kKtxIdentifier) + sizeof(KtxHeader)) return false;
+    if (std::memcmp(bytes.data(), kKtxIdentifier, sizeof(kKtxIdentifier)) != 0) return false;
+
+    KtxHeader header;
+    std::memcpy(&header, bytes.data() + sizeof(kKtxIdentifier), sizeof(header));
+    if (header.endianness != 0x04030201) return false;
+    if (header.glType != 0 || header.pixelDepth > 1 || header.numberOfArrayElements > 0 || header.numberOfFaces != 1) return false;
+    if (!BlockFormatFromGl(header.glInternalFormat, out.format)) return false;
+
+    out.width = (int)header.pixelWidth;
+    out.height = (int)header.pixelHeight;
+    if (out.width <= 0 || out.height <= 0) return false;
+
+    size_t pos = sizeof(kKtxIdentifier) + sizeof(KtxHeader);
+    size_t kvEnd = pos + header.bytesOfKeyValueData;
+    if (kvEnd > bytes.size()) return false;
+
+    bottomUp = false;
+    while (pos + 4 <= kvEnd) {
+        uint32_t kvSize;
+        std::memcpy(&kvSize, bytes.data() + pos, 4);
+        pos += 4;
+        if (pos + kvSize > kvEnd) return false;
+        std::string kv(reinterpret_cast<const char*>(bytes.data() + pos), kvSize);
+        size_t nul = kv.find('\0');
+        if (nul != std::string::npos && kv.compare(0, nul, "KTXorientation") == 0)
+            bottomUp = kv.find("T=u", nul) != std::string::npos;
+        pos += (kvSize + 3) & ~3u;
+    }
+    pos = kvEnd;
+
+    // Każdy poziom poprzedza uint32 z jego rozmiarem; dane bloków mają już wyrównanie do 4 bajtów.
+    int levels = std::max(1u, header.numberOfMipmapLevels);
+    int w = out.width, h = out.height;
+    out.mips.clear();
+    out.data.clear();
+    for (int i = 0; i < levels; i++) {
+        if (pos + 4 > bytes.size()) return false;
+        uint32_t imageSize;
+        std::memcpy(&imageSize, bytes.data() + pos, 4);
+        pos += 4;
+
+        CompressedMip mip;
+        mip.width = w; mip.height = h;
+        mip.offset = out.data.size();
+        mip.size = GetCompressedLevelSize(out.format, w, h);
+        if (imageSize != mip.size || pos + mip.size > bytes.size()) return false;
+
+        out.data.insert(out.data.end(), bytes.begin() + pos, bytes.begin() + pos + mip.size);
+        out.mips.push_back(mip);
+        pos += (mip.size + 3) & ~(size_t)3;
+
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return true;
+}
+
+/**
+ * @brief Odwraca kolejność pierwszych `rows` wierszy indeksów bloku BC1 (bajty 4..7, jeden wiersz na bajt).
+ * @param block Blok BC1.
+ * @param rows Liczba ważnych wierszy w bloku (1..4).
+ */
+static void FlipBC1Block(unsigned char* block, int rows) {
+    std::reverse(block + 4, block + 4 + rows);
+}
+
+/**
+ * @brief Odwraca kolejność pierwszych `rows` wierszy indeksów bloku BC4 (48 bitów, 12 bitów na wiersz).
+ * @param block Blok BC4 (alfa BC3 lub kanał BC5).
+ * @param rows Liczba ważnych wierszy w bloku (1..4).
+ */
+static void FlipBC4Block(unsigned char* block, int rows) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (8 * i);
+
+    uint64_t flipped = bits;
+    for (int r = 0; r < rows; r++) {
+        uint64_t row = (bits >> (12 * r)) & 0xFFF;
+        int dst = rows - 1 - r;
+        flipped &= ~((uint64_t)0xFFF << (12 * dst));
+        flipped |= row << (12 * dst);
+    }
+    for (int i = 0; i < 6; i++) block[2 + i] = (unsigned char)(flipped >> (8 * i));
+}
+
+/**
+ * @brief Odwraca poziom w pionie: zamienia wiersze bloków i wiersze pikseli wewnątrz bloków.
+ * @param format Format bloków.
+ * @param data Dane poziomu.
+ * @param width Szerokość poziomu.
+ * @param height Wysokość poziomu.
+ * @return `false`, gdy wysokość > 4 nie jest wielokrotnością 4 (bloki brzegowe nie dają się przestawić bez dekompresji).
+ */
+static bool FlipLevel(BlockFormat format, unsigned char* data, int width, int height) {
+    if (height > 4 && (height % 4) != 0) return false;
+
+    const size_t blockBytes = GetBlockBytes(format);
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t rowBytes = blockBytes * blocksX;
+    const int rows = std::min(height, 4);
+
+    std::vector<unsigned char> tmp(rowBytes);
+    for (int y = 0; y < blocksY / 2; y++) {
+        unsigned char* a = data + rowBytes * y;
+        unsigned char* b = data + rowBytes * (blocksY - 1 - y);
+        std::memcpy(tmp.data(), a, rowBytes);
+        std::memcpy(a, b, rowBytes);
+        std::memcpy(b, tmp.data(), rowBytes);
+    }
+
+    const size_t blockCount = (size_t)blocksX * blocksY;
+    for (size_t i = 0; i < blockCount; i++) {
+        unsigned char* block = data + blockBytes * i;
+        switch (format) {
+        case BlockFormat::BC1: FlipBC1Block(block, rows); break;
+        case BlockFormat::BC3: FlipBC4Block(block, rows); FlipBC1Block(block + 8, rows); break;
+        case BlockFormat::BC5: FlipBC4Block(block, rows); FlipBC4Block(block + 8, rows); break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sumuje rozmiary poziomów.
+ * @return Liczba bajtów.
+ */
+size_t CompressedImage::GetByteSize() const {
+    size_t total = 0;
+    for (const CompressedMip& mip : mips) total += mip.size;
+    return total;
+}
+
+/**
+ * @brief Zwraca rozmiar bloku formatu.
+ * @param format Format bloków.
+ * @return Liczba bajtów na blok.
+ */
+size_t GetBlockBytes(BlockFormat format) {
+    return (format == BlockFormat::BC1) ? 8 : 16;
+}
+
+/**
+ * @brief Liczy rozmiar poziomu w blokach 4x4.
+ * @param format Format bloków.
+ * @param width Szerokość.
+ * @param height Wysokość.
+ * @return Liczba bajtów.
+ */
+size_t GetCompressedLevelSize(BlockFormat format, int width, int height) {
+    size_t blocksX = (size_t)std::max(1, (width + 3) / 4);
+    size_t blocksY = (size_t)std::max(1, (height + 3) / 4);
+    return blocksX * blocksY * GetBlockBytes(format);
+}
+
+/**
+ * @brief Porównuje rozszerzenie (bez rozróżniania wielkości liter) z `.dds`/`.ktx`.
+ * @param path Ścieżka do pliku.
+ * @return `true` dla plików skompresowanych.
+ */
+bool IsCompressedImagePath(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".dds" || ext == ".ktx";
+}
+
+/**
+ * @brief Podmienia rozszerzenie na `.dds`.
+ * @param sourcePath Ścieżka obrazu źródłowego.
+ * @return Ścieżka wersji wypieczonej.
+ */
+std::string GetBakedTexturePath(const std::string& sourcePath) {
+    return std::filesystem::path(sourcePath).replace_extension(".dds").string();
+}
+
+/**
+ * @brief Zwraca wersję wypieczoną, jeśli istnieje i jest nie starsza niż źródło.
+ * @param sourcePath Ścieżka obrazu źródłowego.
+ * @return Ścieżka DDS lub pusty napis.
+ */
+std::string FindBakedTexture(const std::string& sourcePath) {
+    std::string baked = GetBakedTexturePath(sourcePath);
+    if (baked == sourcePath) return std::string();
+
+    std::error_code ec;
+    auto bakedTime = std::filesystem::last_write_time(baked, ec);
+    if (ec) return std::string();
+    auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (!ec && bakedTime < sourceTime) return std::string();
+    return baked;
+}
+
+/**
+ * @brief Wczytuje DDS/KTX i w razie potrzeby odwraca poziomy w pionie.
+ * @param path Ścieżka do pliku.
+ * @param flipVertically Czy odwrócić obraz w pionie.
+ * @param out Obraz wynikowy.
+ * @return `true` przy powodzeniu.
+ */
+bool LoadCompressedImage(const std::string& path, bool flipVertically, CompressedImage& out) {
+    out = CompressedImage();
+    std::vector<unsigned char> bytes;
+    if (!ReadFileBytes(path, bytes)) return false;
+
+    bool bottomUp = false;
+    bool ok = (bytes.size() >= 4 && std::memcmp(bytes.data(), "DDS ", 4) == 0)
+        ? ParseDds(bytes, out)
+        : ParseKtx(bytes, out, bottomUp);
+    if (!ok) { out = CompressedImage(); return false; }
+
+    if (flipVertically != bottomUp) {
+        for (size_t i = 0; i < out.mips.size(); i++) {
+            const CompressedMip& mip = out.mips[i];
+            if (!FlipLevel(out.format, out.data.data() + mip.offset, mip.width, mip.height)) {
+                if (i == 0) { out = CompressedImage(); return false; }
+                out.mips.resize(i);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Zapisuje nagłówek DDS i kolejne poziomy.
+ * @param path Ścieżka pliku docelowego.
+ * @param image Obraz do zapisu.
+ * @return `true` przy powodzeniu.
+ */
+bool SaveDdsFile(const std::string& path, const CompressedImage& image) {
+    if (image.mips.empty()) return false;
+
+    DdsHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.size = sizeof(DdsHeader);
+    header.flags = kDdsFlagsRequired | kDdsFlagLinearSize | kDdsFlagMipMapCount;
+    header.height = (uint32_t)image.height;
+    header.width = (uint32_t)image.width;
+    header.pitchOrLinearSize = (uint32_t)image.mips[0].size;
+    header.mipMapCount = (uint32_t)image.mips.size();
+    header.pfSize = 32;
+    header.pfFlags = kDdsPixelFormatFourCC;
+    switch (image.format) {
+    case BlockFormat::BC1: header.pfFourCC = FourCC('D', 'X', 'T', '1'); break;
+    case BlockFormat::BC3: header.pfFourCC = FourCC('D', 'X', 'T', '5'); break;
+    case BlockFormat::BC5: header.pfFourCC = FourCC('A', 'T', 'I', '2'); break;
+    }
+    header.caps = kDdsCapsTexture;
+    if (image.mips.size() > 1) header.caps |= kDdsCapsComplex | kDdsCapsMipMap;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&kDdsMagic), 4);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const CompressedMip& mip : image.mips)
+        file.write(reinterpret_cast<const char*>(image.data.data() + mip.offset), (std::streamsize)mip.size);
+    return (bool)file;
+}
@@ -0,0 +1,126 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @file CompressedTexture.h
+ * @brief Tekstury skompresowane blokowo (BC1/BC3/BC5) z gotowym łańcuchem mipmap — odczyt DDS/KTX i zapis DDS.
+ *
+ * Moduł nie zależy od OpenGL: pliki czytane są na wątkach roboczych, a wysyłka poziomów
+ * (`glCompressedTexImage2D`) odbywa się w `TextureCache`. Z zapisu korzysta narzędzie `Racing3D_texbake`.
+ */
+
+ /**
+  * @brief Format bloków 4x4.
+  */
+enum class BlockFormat {
+    /** @brief RGB (+ 1-bitowa alfa), 8 bajtów na blok (DXT1). */
+    BC1,
+    /** @brief RGBA z interpolowaną alfą, 16 bajtów na blok (DXT5). */
+    BC3,
+    /** @brief Dwa kanały (RG), 16 bajtów na blok (ATI2) — mapy normalnych. */
+    BC5
+};
+
+/**
+ * @brief Jeden poziom mipmapy w buforze `CompressedImage::data`.
+ */
+struct CompressedMip {
+    /** @brief Szerokość poziomu w pikselach. */
+    int width = 0;
+
+    /** @brief Wysokość poziomu w pikselach. */
+    int height = 0;
+
+    /** @brief Przesunięcie danych poziomu w buforze. */
+    size_t offset = 0;
+
+    /** @brief Rozmiar danych poziomu w bajtach. */
+    size_t size = 0;
+};
+
+/**
+ * @brief Obraz skompresowany blokowo z łańcuchem mipmap (poziom 0 pierwszy).
+ */
+struct CompressedImage {
+    /** @brief Format bloków. */
+    BlockFormat format = BlockFormat::BC1;
+
+    /** @brief Szerokość poziomu 0. */
+    int width = 0;
+
+    /** @brief Wysokość poziomu 0. */
+    int height = 0;
+
+    /** @brief Poziomy mipmap. */
+    std::vector<CompressedMip> mips;
+
+    /** @brief Dane wszystkich poziomów. */
+    std::vector<unsigned char> data;
+
+    /**
+     * @brief Zwraca łączny rozmiar poziomów (tyle zajmie tekstura na GPU).
+     * @return Liczba bajtów.
+     */
+    size_t GetByteSize() const;
+};
+
+/**
+ * @brief Zwraca rozmiar bloku 4x4 w bajtach.
+ * @param format Format bloków.
+ * @return 8 (BC1) lub 16 (BC3, BC5).
+ */
+size_t GetBlockBytes(BlockFormat format);
+
+/**
+ * @brief Zwraca rozmiar poziomu o podanych wymiarach (bloki niepełne na krawędziach liczą się w całości).
+ * @param format Format bloków.
+ * @param width Szerokość w pikselach.
+ * @param height Wysokość w pikselach.
+ * @return Liczba bajtów.
+ */
+size_t GetCompressedLevelSize(BlockFormat format, int width, int height);
+
+/**
+ * @brief Sprawdza po rozszerzeniu, czy plik jest teksturą skompresowaną (`.dds`, `.ktx`).
+ * @param path Ścieżka do pliku.
+ * @return `true` dla obsługiwanych rozszerzeń.
+ */
+bool IsCompressedImagePath(const std::string& path);
+
+/**
+ * @brief Zwraca ścieżkę wersji wypieczonej przez `Racing3D_texbake` (to samo miejsce, rozszerzenie `.dds`).
+ * @param sourcePath Ścieżka obrazu źródłowego (np. PNG).
+ * @return Ścieżka pliku DDS.
+ */
+std::string GetBakedTexturePath(const std::string& sourcePath);
+
+/**
+ * @brief Szuka aktualnej wersji wypieczonej obrazu (plik DDS nie starszy niż źródło).
+ * @param sourcePath Ścieżka obrazu źródłowego.
+ * @return Ścieżka pliku DDS lub pusty napis, gdy go nie ma albo jest nieaktualny.
+ */
+std::string FindBakedTexture(const std::string& sourcePath);
+
+/**
+ * @brief Wczytuje plik DDS lub KTX (1.1) w formacie BC1/BC3/BC5. Bezpieczne do wywołania z dowolnego wątku.
+ *
+ * DDS przechowuje obraz od górnego wiersza; KTX według klucza `KTXorientation` (domyślnie też od góry).
+ * Przy `flipVertically` bloki są odwracane w pionie bez dekompresji. Poziomy, których nie da się odwrócić
+ * dokładnie (wysokość > 4 niebędąca wielokrotnością 4), obcinają łańcuch mipmap.
+ *
+ * @param path Ścieżka do pliku.
+ * @param flipVertically Czy odwrócić obraz w pionie (jak `stbi_set_flip_vertically_on_load`).
+ * @param out Struktura docelowa.
+ * @return `true` jeśli plik wczytano (i ewentualnie odwrócono poziom 0).
+ */
+bool LoadCompressedImage(const std::string& path, bool flipVertically, CompressedImage& out);
+
+/**
+ * @brief Zapisuje obraz jako DDS (nagłówek DX9 z FourCC `DXT1`/`DXT5`/`ATI2`).
+ * @param path Ścieżka pliku docelowego.
+ * @param image Obraz zapisany od górnego wiersza.
+ * @return `true` przy powodzeniu.
+ */
+bool SaveDdsFile(const std::string& path, const CompressedImage& image);
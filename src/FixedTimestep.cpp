@@ -0,0 +1,84 @@
+﻿#include "FixedTimestep.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file FixedTimestep.cpp
+ * @brief Implementacja zegara symulacji o stałym kroku.
+ */
+
+ /**
+  * @brief Najdłuższy czas klatki brany pod uwagę (np. po zatrzymaniu okna lub breakpoincie).
+  */
+static const float MAX_FRAME_TIME = 0.25f;
+
+/**
+ * @brief Konstruktor zegara.
+ * @param tickRate Częstotliwość kroków w Hz.
+ * @param maxStepsPerFrame Limit kroków na klatkę.
+ */
+FixedTimestep::FixedTimestep(float tickRate, int maxStepsPerFrame)
+    : MaxStepsPerFrame(maxStepsPerFrame), stepSize(1.0f / 120.0f), accumulator(0.0f) {
+    SetTickRate(tickRate);
+}
+
+/**
+ * @brief Ustawia częstotliwość kroków.
+ * @param tickRate Częstotliwość w Hz.
+ */
+void FixedTimestep::SetTickRate(float tickRate) {
+    if (tickRate <= 0.0f) return;
+    stepSize = 1.0f / tickRate;
+    accumulator = std::min(accumulator, stepSize);
+}
+
+/**
+ * @brief Zwraca częstotliwość kroków.
+ * @return Częstotliwość w Hz.
+ */
+float FixedTimestep::GetTickRate() const {
+    return 1.0f / stepSize;
+}
+
+/**
+ * @brief Zwraca długość kroku.
+ * @return Długość kroku w sekundach.
+ */
+float FixedTimestep::GetStepSize() const {
+    return stepSize;
+}
+
+/**
+ * @brief Akumuluje czas klatki i wylicza liczbę kroków fizyki.
+ * @param frameTime Czas klatki w sekundach.
+ * @return Liczba kroków do wykonania.
+ */
+int FixedTimestep::Advance(float frameTime) {
+    if (frameTime < 0.0f) frameTime = 0.0f;
+    accumulator += std::min(frameTime, MAX_FRAME_TIME);
+
+    int steps = (int)std::floor(accumulator / stepSize);
+    if (steps > MaxStepsPerFrame) {
+        steps = MaxStepsPerFrame;
+        accumulator = std::fmod(accumulator, stepSize);
+    }
+    else {
+        accumulator -= steps * stepSize;
+    }
+    return steps;
+}
+
+/**
+ * @brief Zwraca współczynnik interpolacji renderu.
+ * @return Wartość z zakresu [0, 1).
+ */
+float FixedTimestep::GetAlpha() const {
+    return std::clamp(accumulator / stepSize, 0.0f, 1.0f);
+}
+
+/**
+ * @brief Zeruje akumulator.
+ */
+void FixedTimestep::Reset() {
+    accumulator = 0.0f;
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+/**
+ * @file FixedTimestep.h
+ * @brief Deklaracja zegara symulacji o stałym kroku (akumulator + limit kroków nadrabiania).
+ */
+
+ /**
+  * @brief Zegar symulacji o stałym kroku czasowym, niezależny od liczby klatek renderu.
+  *
+  * Czas klatki jest dodawany do akumulatora, a fizyka jest wykonywana w krokach o stałej długości
+  * (`GetStepSize()`). Dzięki temu:
+  * - wolna klatka nie powoduje jednego dużego kroku (brak „przeskakiwania” ścian),
+  * - szybka klatka (V-Sync wyłączony) nie zwiększa kosztu fizyki,
+  * - czasy okrążeń są powtarzalne na różnych maszynach.
+  *
+  * Pozostała część akumulatora (`GetAlpha()`) służy do interpolacji stanu renderu między
+  * poprzednim a bieżącym krokiem fizyki.
+  */
+class FixedTimestep {
+public:
+    /** @brief Maksymalna liczba kroków fizyki wykonywanych w jednej klatce (ochrona przed „spiralą śmierci”). */
+    int MaxStepsPerFrame;
+
+    /**
+     * @brief Tworzy zegar o zadanej częstotliwości kroków.
+     * @param tickRate Liczba kroków fizyki na sekundę (Hz).
+     * @param maxStepsPerFrame Limit kroków nadrabianych w jednej klatce.
+     */
+    FixedTimestep(float tickRate = 120.0f, int maxStepsPerFrame = 5);
+
+    /**
+     * @brief Zmienia częstotliwość kroków fizyki.
+     * @param tickRate Nowa częstotliwość w Hz (wartości <= 0 są ignorowane).
+     */
+    void SetTickRate(float tickRate);
+
+    /**
+     * @brief Zwraca częstotliwość kroków fizyki.
+     * @return Częstotliwość w Hz.
+     */
+    float GetTickRate() const;
+
+    /**
+     * @brief Zwraca długość pojedynczego kroku fizyki.
+     * @return Długość kroku w sekundach.
+     */
+    float GetStepSize() const;
+
+    /**
+     * @brief Dodaje czas klatki do akumulatora i zwraca liczbę kroków do wykonania.
+     *
+     * Jeśli zaległość przekracza `MaxStepsPerFrame`, nadmiar jest odrzucany (symulacja „zwalnia”
+     * zamiast próbować nadrobić wszystko naraz).
+     *
+     * @param frameTime Czas klatki w sekundach.
+     * @return Liczba kroków fizyki do wykonania w tej klatce.
+     */
+    int Advance(float frameTime);
+
+    /**
+     * @brief Zwraca współczynnik interpolacji między poprzednim a bieżącym krokiem.
+     * @return Wartość z zakresu [0, 1).
+     */
+    float GetAlpha() const;
+
+    /**
+     * @brief Zeruje akumulator (np. po zmianie stanu gry lub teleportacji aut).
+     */
+    void Reset();
+
+private:
+    /** @brief Długość kroku fizyki w sekundach. */
+    float stepSize;
+
+    /** @brief Niewykorzystany czas przeniesiony do następnej klatki. */
+    float accumulator;
+};
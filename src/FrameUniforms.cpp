@@ -0,0 +1,49 @@
+﻿#include "FrameUniforms.h"
+#include <glad/glad.h>
+
+/**
+ * @file FrameUniforms.cpp
+ * @brief Implementacja bufora uniformów klatki (UBO).
+ */
+
+ /**
+  * @brief Tworzy UBO o rozmiarze `FrameUniformData` i podpina go pod punkt wiązania.
+  */
+void FrameUniforms::Init() {
+    if (ubo != 0) return;
+
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, BindingPoint, ubo);
+}
+
+/**
+ * @brief Aktualizuje zawartość UBO.
+ * @param data Dane klatki.
+ */
+void FrameUniforms::Update(const FrameUniformData& data) {
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/**
+ * @brief Usuwa UBO.
+ */
+void FrameUniforms::Release() {
+    if (ubo == 0) return;
+    glDeleteBuffers(1, &ubo);
+    ubo = 0;
+}
+
+/**
+ * @brief Ustawia punkt wiązania bloku `FrameData` w programie.
+ * @param program Program OpenGL.
+ */
+void FrameUniforms::BindProgram(unsigned int program) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, BlockName);
+    if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, blockIndex, BindingPoint);
+}
@@ -0,0 +1,86 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @file FrameUniforms.h
+ * @brief Wspólny dla wszystkich programów bufor uniformów (UBO, std140) z danymi kamery, światła i pory dnia.
+ */
+
+ /**
+  * @brief Dane bloku `FrameData` w układzie std140 (pola vec3 dopełnione do vec4).
+  *
+  * Musi odpowiadać deklaracji w shaderach:
+  * @code
+  * layout(std140) uniform FrameData {
+  *     mat4 view;
+  *     mat4 projection;
+  *     vec4 viewPos;     // xyz
+  *     vec4 lightPos;    // xyz
+  *     vec4 lightColor;  // rgb
+  *     vec4 timeParams;  // x = pora dnia [0, 1], y = czas od startu (s)
+  * };
+  * @endcode
+  */
+struct FrameUniformData {
+    /** @brief Macierz widoku kamery. */
+    glm::mat4 view{ 1.0f };
+
+    /** @brief Macierz projekcji. */
+    glm::mat4 projection{ 1.0f };
+
+    /** @brief Pozycja kamery (xyz). */
+    glm::vec4 viewPos{ 0.0f };
+
+    /** @brief Pozycja światła (xyz). */
+    glm::vec4 lightPos{ 0.0f };
+
+    /** @brief Kolor światła (rgb). */
+    glm::vec4 lightColor{ 1.0f };
+
+    /** @brief Parametry czasu: x = pora dnia, y = czas od startu w sekundach. */
+    glm::vec4 timeParams{ 0.0f };
+};
+
+static_assert(sizeof(FrameUniformData) == 2 * 64 + 4 * 16, "FrameUniformData musi mieć układ std140 (bez dodatkowego paddingu)");
+
+/**
+ * @brief Bufor UBO z danymi `FrameUniformData`, aktualizowany raz na klatkę.
+ *
+ * Bufor jest podpięty pod stały punkt wiązania `BindingPoint`; każdy program z blokiem
+ * `FrameData` jest do niego przypinany przez `BindProgram()` (robi to konstruktor `Shader`),
+ * więc nowe shadery nie wymagają żadnego kodu ustawiającego te uniformy co klatkę.
+ */
+class FrameUniforms {
+public:
+    /** @brief Punkt wiązania UBO (`glBindBufferBase(GL_UNIFORM_BUFFER, ...)`). */
+    static constexpr unsigned int BindingPoint = 0;
+
+    /** @brief Nazwa bloku uniformów w GLSL. */
+    static constexpr const char* BlockName = "FrameData";
+
+    /**
+     * @brief Tworzy bufor i podpina go pod `BindingPoint`.
+     */
+    void Init();
+
+    /**
+     * @brief Przesyła dane klatki do bufora (jedno `glBufferSubData`).
+     * @param data Dane klatki.
+     */
+    void Update(const FrameUniformData& data);
+
+    /**
+     * @brief Usuwa bufor.
+     */
+    void Release();
+
+    /**
+     * @brief Przypina blok `FrameData` programu (jeśli go ma) do `BindingPoint`.
+     * @param program Zlinkowany program OpenGL.
+     */
+    static void BindProgram(unsigned int program);
+
+private:
+    /** @brief Uchwyt bufora UBO. */
+    unsigned int ubo = 0;
+};
@@ -0,0 +1,87 @@
+﻿#include "Frustum.h"
+#include <cmath>
+
+/**
+ * @file Frustum.cpp
+ * @brief Implementacja testów brył otaczających względem ostrosłupa widzenia.
+ */
+
+ /**
+  * @brief Przekształca AABB macierzą afiniczną (metoda Arvo: środek + |M| * połowa rozmiaru).
+  * @param m Macierz przekształcenia.
+  * @return Prostopadłościan po przekształceniu.
+  */
+BoundingBox BoundingBox::Transformed(const glm::mat4& m) const {
+    if (!Valid()) return *this;
+
+    glm::vec3 center = glm::vec3(m * glm::vec4(Center(), 1.0f));
+    glm::vec3 extents = Extents();
+    glm::vec3 newExtents(0.0f);
+    for (int col = 0; col < 3; col++)
+        for (int row = 0; row < 3; row++)
+            newExtents[row] += std::abs(m[col][row]) * extents[col];
+
+    BoundingBox out;
+    out.min = center - newExtents;
+    out.max = center + newExtents;
+    return out;
+}
+
+/**
+ * @brief Ostrosłup bez ograniczeń: każda płaszczyzna przepuszcza wszystko.
+ */
+Frustum::Frustum() {
+    for (glm::vec4& p : planes) p = glm::vec4(0.0f, 0.0f, 0.0f, FLT_MAX);
+}
+
+/**
+ * @brief Wyciąga płaszczyzny z wierszy macierzy `projection * view`.
+ * @param viewProjection Macierz `projection * view`.
+ * @return Ostrosłup w przestrzeni świata.
+ */
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection) {
+    // glm przechowuje macierze kolumnami: wiersz i to (m[0][i], m[1][i], m[2][i], m[3][i]).
+    glm::mat4 t = glm::transpose(viewProjection);
+    Frustum f;
+    f.planes[0] = t[3] + t[0];
+    f.planes[1] = t[3] - t[0];
+    f.planes[2] = t[3] + t[1];
+    f.planes[3] = t[3] - t[1];
+    f.planes[4] = t[3] + t[2];
+    f.planes[5] = t[3] - t[2];
+
+    for (glm::vec4& p : f.planes) {
+        float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) p /= len;
+    }
+    return f;
+}
+
+/**
+ * @brief Sprawdza sferę względem wszystkich płaszczyzn.
+ * @param sphere Sfera.
+ * @return `false` gdy sfera leży całkowicie poza ostrosłupem.
+ */
+bool Frustum::Intersects(const BoundingSphere& sphere) const {
+    for (const glm::vec4& p : planes) {
+        if (glm::dot(glm::vec3(p), sphere.center) + p.w < -sphere.radius) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sprawdza AABB: dla każdej płaszczyzny testowany jest narożnik najdalej w stronę jej normalnej.
+ * @param box Prostopadłościan.
+ * @return `false` gdy prostopadłościan leży całkowicie poza ostrosłupem.
+ */
+bool Frustum::Intersects(const BoundingBox& box) const {
+    if (!box.Valid()) return false;
+    for (const glm::vec4& p : planes) {
+        glm::vec3 positive(
+            p.x >= 0.0f ? box.max.x : box.min.x,
+            p.y >= 0.0f ? box.max.y : box.min.y,
+            p.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(p), positive) + p.w < 0.0f) return false;
+    }
+    return true;
+}
@@ -0,0 +1,137 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+#include <cfloat>
+
+/**
+ * @file Frustum.h
+ * @brief Bryły otaczające (AABB, sfera), ostrosłup widzenia kamery i statystyki odrzucania.
+ */
+
+ /**
+  * @brief Prostopadłościan otaczający wyrównany do osi (AABB).
+  *
+  * Domyślnie pusty (`min` > `max`); rozszerzany punktami przez `Expand()`.
+  */
+struct BoundingBox {
+    /** @brief Minimalny narożnik. */
+    glm::vec3 min{ FLT_MAX };
+
+    /** @brief Maksymalny narożnik. */
+    glm::vec3 max{ -FLT_MAX };
+
+    /**
+     * @brief Rozszerza prostopadłościan tak, aby zawierał punkt.
+     * @param p Punkt.
+     */
+    void Expand(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+
+    /**
+     * @brief Rozszerza prostopadłościan tak, aby zawierał inny prostopadłościan.
+     * @param other Prostopadłościan.
+     */
+    void Expand(const BoundingBox& other) { min = glm::min(min, other.min); max = glm::max(max, other.max); }
+
+    /** @brief Czy prostopadłościan zawiera choć jeden punkt. */
+    bool Valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    /** @brief Środek prostopadłościanu. */
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+
+    /** @brief Połowa rozmiaru w każdej osi. */
+    glm::vec3 Extents() const { return (max - min) * 0.5f; }
+
+    /**
+     * @brief Zwraca AABB prostopadłościanu po przekształceniu macierzą (przybliżenie zachowawcze).
+     * @param m Macierz przekształcenia (afiniczna).
+     * @return Prostopadłościan w przestrzeni docelowej.
+     */
+    BoundingBox Transformed(const glm::mat4& m) const;
+};
+
+/**
+ * @brief Sfera otaczająca.
+ */
+struct BoundingSphere {
+    /** @brief Środek sfery. */
+    glm::vec3 center{ 0.0f };
+
+    /** @brief Promień sfery. */
+    float radius = 0.0f;
+
+    /**
+     * @brief Zwraca sferę opisaną na prostopadłościanie.
+     * @param box Prostopadłościan.
+     * @return Sfera o środku w środku `box` i promieniu do narożnika.
+     */
+    static BoundingSphere FromBox(const BoundingBox& box) { return { box.Center(), glm::length(box.Extents()) }; }
+};
+
+/**
+ * @brief Liczniki odrzucania dla jednego wywołania rysowania obiektu (albo sumy z klatki).
+ */
+struct CullStats {
+    /** @brief Liczba części (siatek/chunków) narysowanych. */
+    int drawn = 0;
+
+    /** @brief Liczba części odrzuconych testem z ostrosłupem. */
+    int culled = 0;
+
+    /** @brief Liczba wywołań `glDraw*`. */
+    int drawCalls = 0;
+
+    /** @brief Zeruje liczniki. */
+    void Reset() { *this = CullStats(); }
+
+    /**
+     * @brief Dodaje liczniki innego obiektu.
+     * @param other Liczniki do dodania.
+     */
+    void Add(const CullStats& other) { drawn += other.drawn; culled += other.culled; drawCalls += other.drawCalls; }
+};
+
+/**
+ * @brief Ostrosłup widzenia: 6 płaszczyzn wyciągniętych z macierzy `projection * view`.
+ *
+ * Płaszczyzny są znormalizowane i skierowane do wnętrza, więc odległość punktu wewnątrz jest dodatnia.
+ */
+class Frustum {
+public:
+    /**
+     * @brief Tworzy ostrosłup obejmujący całą przestrzeń (nic nie jest odrzucane).
+     */
+    Frustum();
+
+    /**
+     * @brief Wyznacza płaszczyzny z macierzy widoku i projekcji (metoda Gribba–Hartmanna).
+     * @param viewProjection Macierz `projection * view`.
+     * @return Ostrosłup w przestrzeni świata.
+     */
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Sprawdza, czy sfera przecina ostrosłup lub leży w nim.
+     * @param sphere Sfera w przestrzeni świata.
+     * @return `false` tylko gdy sfera leży całkowicie poza którąś płaszczyzną.
+     */
+    bool Intersects(const BoundingSphere& sphere) const;
+
+    /**
+     * @brief Sprawdza, czy AABB przecina ostrosłup lub leży w nim (test wierzchołka „p”).
+     * @param box Prostopadłościan w przestrzeni świata.
+     * @return `false` tylko gdy prostopadłościan leży całkowicie poza którąś płaszczyzną.
+     */
+    bool Intersects(const BoundingBox& box) const;
+
+    /**
+     * @brief Test dwustopniowy: najpierw tania sfera, potem AABB.
+     * @param box Prostopadłościan w przestrzeni świata.
+     * @return `true` gdy obiekt może być widoczny.
+     */
+    bool IsVisible(const BoundingBox& box) const {
+        return Intersects(BoundingSphere::FromBox(box)) && Intersects(box);
+    }
+
+private:
+    /** @brief Płaszczyzny (xyz = normalna do wnętrza, w = odległość): lewa, prawa, dół, góra, bliska, daleka. */
+    glm::vec4 planes[6];
+};
@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @file Garage.h
+ * @brief Baza danych samochodów dostępnych w garażu (nagłówek bez zależności od OpenGL).
+ */
+
+ /**
+  * @brief Struktura przechowująca pełną konfigurację pojedynczego samochodu.
+  *
+  * Służy jako baza danych garażu (menu w `main.cpp`, benchmarki):
+  * - `id` jest kluczem logicznym (zapis w profilu),
+  * - `name` jest nazwą wyświetlaną w UI,
+  * - ścieżki `*.obj` wskazują modele do ładowania przez `RaceCar::loadAssets`,
+  * - `price` i parametry kół wspierają sklep i ustawienia wizualne.
+  */
+struct CarData {
+    std::string id;
+    std::string name;
+    std::string bodyPath;
+    std::string wheelFrontPath;
+    std::string wheelBackPath;
+    int price;
+    float wheelFrontX;
+    float wheelBackX;
+    float wheelZ;
+};
+
+/**
+ * @brief Baza danych samochodów w garażu.
+ *
+ * Wartości `wheelFrontX`, `wheelBackX` i `wheelZ` są wykorzystywane do poprawnego ustawienia
+ * pozycji kół względem nadwozia w klasie `RaceCar`.
+ *
+ * @note `wheelBackPath` może być pusty (np. tylko jeden model koła dla przodu i tyłu).
+ */
+inline std::vector<CarData> garage = {
+    {"race", "Racer GT", "assets/cars/OBJ format/race.obj", "assets/cars/OBJ format/wheel-racing.obj", "", 0, 0.45f, 0.45f, 0.48f},
+    {"police", "Police Car", "assets/cars/OBJ format/police.obj", "assets/cars/OBJ format/wheel-default.obj", "", 1000, 0.48f, 0.48f, 0.83f},
+    {"ambulance", "Ambulance", "assets/cars/OBJ format/ambulance.obj", "assets/cars/OBJ format/wheel-default.obj", "", 1200, 0.52f, 0.52f, 0.95f},
+    {"taxi", "Taxi", "assets/cars/OBJ format/taxi.obj", "assets/cars/OBJ format/wheel-default.obj", "", 800, 0.48f, 0.48f, 0.75f},
+    {"van", "Cargo Van", "assets/cars/OBJ format/van.obj", "assets/cars/OBJ format/wheel-truck.obj", "", 900, 0.52f, 0.52f, 0.78f},
+    {"truck", "Heavy Truck", "assets/cars/OBJ format/truck.obj", "assets/cars/OBJ format/wheel-truck.obj", "", 1500, 0.54f, 0.54f, 0.82f},
+    {"hatchback", "Sport Hatch", "assets/cars/OBJ format/hatchback-sports.obj", "assets/cars/OBJ format/wheel-racing.obj", "", 500, 0.45f, 0.45f, 0.82f},
+    {"tractor", "Tractor 500", "assets/cars/OBJ format/tractor.obj", "assets/cars/OBJ format/wheel-tractor-front.obj", "assets/cars/OBJ format/wheel-tractor-back.obj", 2000, 0.55f, 0.75f, 0.60f}
+};
@@ -0,0 +1,51 @@
+﻿#include "ImageData.h"
+#include "stb_image.h"
+
+/**
+ * @file ImageData.cpp
+ * @brief Implementacja dekodowania obrazów do pamięci RAM.
+ */
+
+ /**
+  * @brief Dekoduje plik obrazu przez `stbi_load` z ustawieniem odwracania lokalnym dla wątku.
+  * @param path Ścieżka do pliku.
+  * @param flipVertically Czy odwrócić obraz w pionie.
+  * @param out Wynik (wymiary, kanały i piksele).
+  * @return `true` przy powodzeniu.
+  */
+bool LoadImageFile(const std::string& path, bool flipVertically, ImageData& out) {
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+
+    int w = 0, h = 0, n = 0;
+    unsigned char* data = stbi_load(path.c_str(), &w, &h, &n, 0);
+    if (!data) { out = ImageData(); return false; }
+
+    out.width = w; out.height = h; out.channels = n;
+    out.pixels = std::shared_ptr<unsigned char>(data, [](unsigned char* p) { stbi_image_free(p); });
+    return true;
+}
+
+/**
+ * @brief Wczytuje DDS/KTX (bezpośrednio lub jako wersję wypieczoną), a w ostateczności dekoduje źródło.
+ * @param path Ścieżka do pliku.
+ * @param flipVertically Czy odwrócić obraz w pionie.
+ * @param out Wynik.
+ * @return `true` przy powodzeniu.
+ */
+bool LoadTextureImage(const std::string& path, bool flipVertically, ImageData& out) {
+    bool direct = IsCompressedImagePath(path);
+    std::string compressedPath = direct ? path : FindBakedTexture(path);
+
+    if (!compressedPath.empty()) {
+        auto image = std::make_shared<CompressedImage>();
+        if (LoadCompressedImage(compressedPath, flipVertically, *image)) {
+            out = ImageData();
+            out.width = image->width; out.height = image->height;
+            out.channels = (image->format == BlockFormat::BC5) ? 2 : 4;
+            out.compressed = std::move(image);
+            return true;
+        }
+        if (direct) { out = ImageData(); return false; }
+    }
+    return LoadImageFile(path, flipVertically, out);
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+#include "CompressedTexture.h"
+#include <memory>
+#include <string>
+
+/**
+ * @file ImageData.h
+ * @brief Obraz zdekodowany w pamięci RAM (bez zasobów OpenGL) — do wczytywania na wątkach roboczych.
+ */
+
+ /**
+  * @brief Piksele obrazu zdekodowane przez `stb_image` wraz z wymiarami.
+  *
+  * Bufor pikseli jest współdzielony (`shared_ptr` z `stbi_image_free` jako deleterem),
+  * więc strukturę można tanio kopiować do domknięć kolejki uploadu.
+  * Obraz z pliku DDS/KTX ma zamiast pikseli gotowy łańcuch bloków BCn w `compressed`.
+  */
+struct ImageData {
+    /** @brief Szerokość w pikselach. */
+    int width = 0;
+
+    /** @brief Wysokość w pikselach. */
+    int height = 0;
+
+    /** @brief Liczba kanałów (1, 3 lub 4). */
+    int channels = 0;
+
+    /** @brief Zdekodowane piksele (`nullptr`, gdy wczytanie się nie powiodło albo obraz jest skompresowany). */
+    std::shared_ptr<unsigned char> pixels;
+
+    /** @brief Poziomy skompresowane blokowo (`nullptr` dla obrazów zdekodowanych do pikseli). */
+    std::shared_ptr<const CompressedImage> compressed;
+
+    /**
+     * @brief Sprawdza, czy obraz zawiera piksele lub dane skompresowane.
+     * @return `true` gdy jest co wysłać na GPU.
+     */
+    bool Valid() const { return pixels != nullptr || compressed != nullptr; }
+};
+
+/**
+ * @brief Dekoduje plik obrazu do pamięci RAM. Bezpieczne do wywołania z dowolnego wątku.
+ *
+ * Odwracanie w pionie ustawiane jest per wątek (`stbi_set_flip_vertically_on_load_thread`),
+ * dzięki czemu równoległe wczytywania z różnymi ustawieniami nie wpływają na siebie.
+ *
+ * @param path Ścieżka do pliku obrazu.
+ * @param flipVertically Czy odwrócić obraz w pionie.
+ * @param out Struktura docelowa.
+ * @return `true` jeśli obraz zdekodowano poprawnie.
+ */
+bool LoadImageFile(const std::string& path, bool flipVertically, ImageData& out);
+
+/**
+ * @brief Wczytuje obraz tekstury, preferując dane skompresowane. Bezpieczne do wywołania z dowolnego wątku.
+ *
+ * Pliki `.dds`/`.ktx` są czytane bezpośrednio. Dla pozostałych używana jest aktualna wersja wypieczona
+ * przez `Racing3D_texbake` (`FindBakedTexture()`), a gdy jej nie ma lub nie da się jej wczytać —
+ * dekodowanie `LoadImageFile()`.
+ *
+ * @param path Ścieżka do pliku obrazu.
+ * @param flipVertically Czy odwrócić obraz w pionie.
+ * @param out Struktura docelowa (`pixels` albo `compressed`).
+ * @return `true` jeśli obraz wczytano.
+ */
+bool LoadTextureImage(const std::string& path, bool flipVertically, ImageData& out);
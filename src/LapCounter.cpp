@@ -0,0 +1,37 @@
+﻿#include "LapCounter.h"
+#include <cmath>
+
+/**
+ * @file LapCounter.cpp
+ * @brief Implementacja licznika okrążeń.
+ */
+
+ /**
+  * @brief Zeruje licznik i ustala postęp dla pozycji startowej.
+  * @param centerline Linia środkowa toru.
+  * @param startPosition Pozycja startowa auta.
+  */
+void LapCounter::Reset(const TrackCenterline& centerline, const glm::vec3& startPosition) {
+    Centerline = &centerline;
+    Progress = TrackProgress();
+    CurrentLap = 1;
+    Centerline->UpdateProgress(Progress, startPosition);
+}
+
+/**
+ * @brief Aktualizuje postęp i zalicza okrążenie po przekroczeniu kolejnej wielokrotności długości toru.
+ * @param position Pozycja auta.
+ * @param allowCount Czy okrążenie może zostać zaliczone.
+ * @return `true` jeśli w tym kroku zaliczono okrążenie.
+ */
+bool LapCounter::Update(const glm::vec3& position, bool allowCount) {
+    if (!Centerline || Centerline->Empty()) return false;
+
+    Centerline->UpdateProgress(Progress, position);
+    int completed = (int)std::floor(Progress.RaceDistance / Centerline->GetLength());
+    if (allowCount && completed >= CurrentLap) {
+        CurrentLap++;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+#include "TrackCenterline.h"
+
+/**
+ * @file LapCounter.h
+ * @brief Deklaracja licznika okrążeń opartego o dystans wzdłuż linii środkowej toru.
+ */
+
+ /**
+  * @brief Licznik okrążeń dla jednego auta.
+  *
+  * Pozycja auta jest co krok rzutowana na linię środkową (`TrackCenterline::UpdateProgress`), a `Progress.RaceDistance`
+  * rośnie w sposób ciągły także przy przejeździe przez linię startu/mety (dystans 0 linii).
+  * Okrążenie jest zaliczane, kiedy `RaceDistance` przekroczy kolejną wielokrotność długości toru.
+  *
+  * Jazda wstecz zmniejsza `RaceDistance`, więc cofnięcie się za linię i ponowny przejazd nie nalicza okrążenia,
+  * a skrót przez środek toru nie jest mylony z metą (jak przy dawnej strefie wokół punktu startu).
+  */
+class LapCounter {
+public:
+    /** @brief Linia środkowa toru (ustawiana w `Reset`). */
+    const TrackCenterline* Centerline = nullptr;
+
+    /** @brief Postęp auta wzdłuż toru (dystans w okrążeniu, odsunięcie, dystans wyścigu). */
+    TrackProgress Progress;
+
+    /** @brief Licznik pomocniczy: zaczyna od 1, liczba ukończonych okrążeń to `CurrentLap - 1`. */
+    int CurrentLap = 1;
+
+    /**
+     * @brief Zeruje licznik i ustala postęp dla pozycji startowej.
+     *
+     * Auto ustawione za linią startu/mety zaczyna z ujemnym `RaceDistance`.
+     *
+     * @param centerline Linia środkowa toru (musi żyć dłużej niż licznik).
+     * @param startPosition Pozycja startowa auta.
+     */
+    void Reset(const TrackCenterline& centerline, const glm::vec3& startPosition);
+
+    /**
+     * @brief Aktualizuje postęp dla bieżącej pozycji auta.
+     * @param position Pozycja auta.
+     * @param allowCount Czy okrążenie może zostać zaliczone (np. wyścig trwa, auto jedzie do przodu).
+     * @return `true` jeśli w tym kroku zaliczono okrążenie.
+     */
+    bool Update(const glm::vec3& position, bool allowCount = true);
+};
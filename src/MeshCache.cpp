@@ -0,0 +1,257 @@
+﻿#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+/**
+ * @file MeshCache.cpp
+ * @brief Implementacja parsera OBJ i binarnego cache siatek `.r3dmesh`.
+ */
+
+static_assert(sizeof(MeshCacheHeader) == 48, "MeshCacheHeader musi mieć stały rozmiar 48 bajtów");
+
+/** @brief Flaga nagłówka: parsowanie z pominięciem obiektów „wheel”. */
+static const uint32_t kFlagSkipWheels = 1u;
+
+/**
+ * @brief Odczytuje rozmiar i czas modyfikacji pliku.
+ * @param path Ścieżka do pliku.
+ * @param outSize Rozmiar w bajtach.
+ * @param outMtime Czas modyfikacji (licznik zegara systemu plików).
+ * @return `true` jeśli plik istnieje.
+ */
+static bool StatFile(const std::string& path, uint64_t& outSize, int64_t& outMtime) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+
+    outSize = (uint64_t)size;
+    outMtime = (int64_t)mtime.time_since_epoch().count();
+    return true;
+}
+
+/**
+ * @brief Parsuje plik OBJ do siatki interleaved.
+ * @param path Ścieżka do pliku OBJ.
+ * @param skipWheels Jeśli `true`, pomija obiekty zawierające „wheel”.
+ * @param out Wynikowa siatka.
+ * @return `true` jeśli wczytanie się powiodło; inaczej `false`.
+ */
+bool MeshCache::ParseObj(const std::string& path, bool skipWheels, MeshData& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    out.vertices.clear();
+    out.indices.clear();
+
+    std::vector<glm::vec3> t_v; std::vector<glm::vec3> t_vn; std::vector<glm::vec2> t_vt;
+    std::string line;
+    bool skipPart = false;
+
+    while (std::getline(file, line)) {
+        std::stringstream ss(line); std::string pr; ss >> pr;
+
+        if (pr == "o" || pr == "g") {
+            std::string name; ss >> name; std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            skipPart = (skipWheels && (name.find("wheel") != std::string::npos));
+        }
+
+        if (pr == "v") { glm::vec3 v; ss >> v.x >> v.y >> v.z; t_v.push_back(v); }
+        else if (pr == "vn") { glm::vec3 vn; ss >> vn.x >> vn.y >> vn.z; t_vn.push_back(vn); }
+        else if (pr == "vt") { glm::vec2 vt; ss >> vt.x >> vt.y; t_vt.push_back(vt); }
+
+        else if (pr == "f") {
+            if (skipPart) continue;
+
+            std::string v_s; std::vector<std::string> face;
+            while (ss >> v_s) face.push_back(v_s);
+            if (face.size() < 3) continue;
+
+            for (size_t i = 1; i < face.size() - 1; i++) {
+                std::string tri[] = { face[0], face[i], face[i + 1] };
+                for (auto& f_str : tri) {
+                    std::stringstream fss(f_str); std::string seg; std::vector<int> ids;
+                    while (std::getline(fss, seg, '/')) {
+                        try { ids.push_back(seg.empty() ? 0 : std::stoi(seg)); }
+                        catch (...) { ids.push_back(0); }
+                    }
+                    if (!ids.empty()) {
+                        int v_idx = ids[0];
+                        if (v_idx < 0) v_idx = (int)t_v.size() + v_idx + 1;
+
+                        if (v_idx > 0 && v_idx <= (int)t_v.size()) {
+                            glm::vec3 p = t_v[v_idx - 1];
+                            glm::vec2 uv = (ids.size() > 1 && ids[1] > 0 && ids[1] <= (int)t_vt.size()) ? t_vt[ids[1] - 1] : glm::vec2(0);
+                            glm::vec3 n = (ids.size() > 2 && ids[2] > 0 && ids[2] <= (int)t_vn.size()) ? t_vn[ids[2] - 1] : glm::vec3(0, 1, 0);
+
+                            out.indices.push_back((unsigned int)out.VertexCount());
+                            out.vertices.insert(out.vertices.end(), { p.x, p.y, p.z, n.x, n.y, n.z, uv.x, uv.y });
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Zwraca ścieżkę pliku cache dla danego OBJ.
+ * @param objPath Ścieżka do pliku OBJ.
+ * @param skipWheels Wariant parsowania.
+ * @return Ścieżka pliku `.r3dmesh`.
+ */
+std::string MeshCache::CachePath(const std::string& objPath, bool skipWheels) {
+    return objPath + (skipWheels ? ".body.r3dmesh" : ".r3dmesh");
+}
+
+/**
+ * @brief Liczy skrót FNV-1a (64 bit) zawartości pliku.
+ * @param path Ścieżka do pliku.
+ * @param outHash Wynikowy skrót.
+ * @return `true` jeśli plik udało się odczytać.
+ */
+bool MeshCache::HashFile(const std::string& path, uint64_t& outHash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint64_t hash = 1469598103934665603ull;
+    char buffer[64 * 1024];
+    while (file) {
+        file.read(buffer, sizeof(buffer));
+        std::streamsize n = file.gcount();
+        for (std::streamsize i = 0; i < n; ++i) {
+            hash ^= (unsigned char)buffer[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    outHash = hash;
+    return true;
+}
+
+/**
+ * @brief Wczytuje siatkę z cache (jeden odczyt całego pliku), jeśli cache jest aktualny.
+ * @param objPath Ścieżka do pliku OBJ.
+ * @param skipWheels Wariant parsowania.
+ * @param out Wynikowa siatka.
+ * @return `true` jeśli cache istniał i był aktualny; inaczej `false`.
+ */
+bool MeshCache::Load(const std::string& objPath, bool skipWheels, MeshData& out) {
+    uint64_t srcSize; int64_t srcMtime;
+    if (!StatFile(objPath, srcSize, srcMtime)) return false;
+
+    std::string cachePath = CachePath(objPath, skipWheels);
+    std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    std::streamsize fileSize = file.tellg();
+    if (fileSize < (std::streamsize)sizeof(MeshCacheHeader)) return false;
+
+    std::vector<char> blob((size_t)fileSize);
+    file.seekg(0);
+    if (!file.read(blob.data(), fileSize)) return false;
+    file.close();
+
+    MeshCacheHeader header{};
+    std::memcpy(&header, blob.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, "R3DM", 4) != 0 || header.version != Version) return false;
+    if (header.flags != (skipWheels ? kFlagSkipWheels : 0u) || header.floatsPerVertex != MeshData::FloatsPerVertex) return false;
+
+    size_t vertexBytes = (size_t)header.vertexCount * header.floatsPerVertex * sizeof(float);
+    size_t indexBytes = (size_t)header.indexCount * sizeof(unsigned int);
+    if ((size_t)fileSize != sizeof(header) + vertexBytes + indexBytes) return false;
+
+    // Rozmiar musi się zgadzać; inny czas modyfikacji (np. checkout) rozstrzyga skrót zawartości.
+    if (header.sourceSize != srcSize) return false;
+    if (header.sourceMtime != srcMtime) {
+        uint64_t hash;
+        if (!HashFile(objPath, hash) || hash != header.sourceHash) return false;
+
+        // Źródło bez zmian — aktualizacja czasu w nagłówku, aby kolejne uruchomienia nie liczyły skrótu.
+        header.sourceMtime = srcMtime;
+        std::fstream patch(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        if (patch.is_open()) patch.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    out.vertices.resize((size_t)header.vertexCount * header.floatsPerVertex);
+    out.indices.resize(header.indexCount);
+    if (vertexBytes) std::memcpy(out.vertices.data(), blob.data() + sizeof(header), vertexBytes);
+    if (indexBytes) std::memcpy(out.indices.data(), blob.data() + sizeof(header) + vertexBytes, indexBytes);
+    return true;
+}
+
+/**
+ * @brief Zapisuje siatkę do cache obok pliku OBJ (plik tymczasowy + zmiana nazwy).
+ * @param objPath Ścieżka do pliku OBJ.
+ * @param skipWheels Wariant parsowania.
+ * @param mesh Siatka do zapisania.
+ * @return `true` jeśli zapis się powiódł.
+ */
+bool MeshCache::Save(const std::string& objPath, bool skipWheels, const MeshData& mesh) {
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, "R3DM", 4);
+    header.version = Version;
+    header.flags = skipWheels ? kFlagSkipWheels : 0u;
+    header.floatsPerVertex = MeshData::FloatsPerVertex;
+    header.vertexCount = (uint32_t)mesh.VertexCount();
+    header.indexCount = (uint32_t)mesh.indices.size();
+    if (!StatFile(objPath, header.sourceSize, header.sourceMtime)) return false;
+    if (!HashFile(objPath, header.sourceHash)) return false;
+
+    std::string cachePath = CachePath(objPath, skipWheels);
+    // Plik tymczasowy per wątek: ten sam OBJ może być zapisywany równolegle przez loader zasobów.
+    std::string tmpPath = cachePath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(mesh.vertices.data()), (std::streamsize)(header.vertexCount * MeshData::FloatsPerVertex * sizeof(float)));
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), (std::streamsize)(mesh.indices.size() * sizeof(unsigned int)));
+        if (!file) {
+            // Niepełny plik tymczasowy tego wątku nie może zostać obok OBJ.
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Wczytuje siatkę z cache lub parsuje i optymalizuje OBJ, a następnie zapisuje cache.
+ * @param objPath Ścieżka do pliku OBJ.
+ * @param skipWheels Wariant parsowania.
+ * @param out Wynikowa siatka.
+ * @param fromCache Opcjonalnie: czy siatka pochodzi z cache.
+ * @return `true` jeśli siatkę wczytano; inaczej `false`.
+ */
+bool MeshCache::LoadOrParse(const std::string& objPath, bool skipWheels, MeshData& out, bool* fromCache) {
+    if (Load(objPath, skipWheels, out)) {
+        if (fromCache) *fromCache = true;
+        return true;
+    }
+
+    if (fromCache) *fromCache = false;
+    if (!ParseObj(objPath, skipWheels, out)) return false;
+
+    MeshOptimizer::Optimize(out);
+    Save(objPath, skipWheels, out);
+    return true;
+}
@@ -0,0 +1,134 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file MeshCache.h
+ * @brief Deklaracja binarnego cache siatek OBJ (nagłówek + blob wierzchołków + blob indeksów).
+ */
+
+ /**
+  * @brief Siatka gotowa do wysłania na GPU: wierzchołki interleaved i indeksy.
+  *
+  * Układ wierzchołka: pozycja (3), normalna (3), UV (2) — `FloatsPerVertex` floatów.
+  */
+struct MeshData {
+    /** @brief Liczba floatów na wierzchołek (pos3 + normal3 + uv2). */
+    static constexpr unsigned int FloatsPerVertex = 8;
+
+    /** @brief Wierzchołki w układzie interleaved. */
+    std::vector<float> vertices;
+
+    /** @brief Indeksy trójkątów. */
+    std::vector<unsigned int> indices;
+
+    /**
+     * @brief Zwraca liczbę wierzchołków.
+     * @return `vertices.size() / FloatsPerVertex`.
+     */
+    size_t VertexCount() const { return vertices.size() / FloatsPerVertex; }
+};
+
+/**
+ * @brief Nagłówek pliku cache `.r3dmesh` (zapisywany bez paddingu między polami 4/8-bajtowymi).
+ *
+ * Za nagłówkiem znajduje się blob `vertexCount * floatsPerVertex` floatów,
+ * a po nim blob `indexCount` indeksów `uint32`.
+ */
+struct MeshCacheHeader {
+    /** @brief Sygnatura pliku: `R3DM`. */
+    char magic[4];
+
+    /** @brief Wersja formatu (zmiana parsera OBJ = nowa wersja). */
+    uint32_t version;
+
+    /** @brief Flagi parsowania (bit 0: pominięte obiekty „wheel”). */
+    uint32_t flags;
+
+    /** @brief Liczba floatów na wierzchołek. */
+    uint32_t floatsPerVertex;
+
+    /** @brief Rozmiar pliku źródłowego OBJ w bajtach. */
+    uint64_t sourceSize;
+
+    /** @brief Czas modyfikacji pliku źródłowego (jednostki zegara systemu plików). */
+    int64_t sourceMtime;
+
+    /** @brief Skrót FNV-1a (64 bit) zawartości pliku źródłowego. */
+    uint64_t sourceHash;
+
+    /** @brief Liczba wierzchołków. */
+    uint32_t vertexCount;
+
+    /** @brief Liczba indeksów. */
+    uint32_t indexCount;
+};
+
+/**
+ * @brief Parsowanie OBJ oraz binarny cache siatek zapisywany obok pliku `.obj`.
+ *
+ * Przy pierwszym wczytaniu OBJ jest parsowany, optymalizowany (spawanie wierzchołków, kolejność
+ * pod cache GPU) i zapisywany jako `<plik>.obj[.body].r3dmesh`.
+ * Kolejne wczytania sprawdzają rozmiar i czas modyfikacji źródła; jeśli czas się zmienił,
+ * a rozmiar nie, o ważności decyduje skrót zawartości. Poprawny cache jest czytany jednym
+ * odczytem całego pliku.
+ */
+class MeshCache {
+public:
+    /** @brief Aktualna wersja formatu `.r3dmesh` (2: siatki po `MeshOptimizer::Optimize`). */
+    static constexpr uint32_t Version = 2;
+
+    /**
+     * @brief Parsuje plik OBJ (triangulacja wielokątów, jeden wierzchołek na narożnik ściany).
+     * @param path Ścieżka do pliku OBJ.
+     * @param skipWheels Jeśli `true`, pomija obiekty zawierające „wheel” w nazwie (karoseria).
+     * @param out Wynikowa siatka.
+     * @return `true` jeśli plik udało się otworzyć; inaczej `false`.
+     */
+    static bool ParseObj(const std::string& path, bool skipWheels, MeshData& out);
+
+    /**
+     * @brief Zwraca ścieżkę pliku cache dla danego OBJ.
+     * @param objPath Ścieżka do pliku OBJ.
+     * @param skipWheels Wariant parsowania (karoseria ma osobny plik cache).
+     * @return Ścieżka pliku `.r3dmesh`.
+     */
+    static std::string CachePath(const std::string& objPath, bool skipWheels);
+
+    /**
+     * @brief Wczytuje siatkę z cache, jeśli jest aktualny względem pliku OBJ.
+     * @param objPath Ścieżka do pliku OBJ.
+     * @param skipWheels Wariant parsowania.
+     * @param out Wynikowa siatka.
+     * @return `true` jeśli cache istniał i był aktualny; inaczej `false`.
+     */
+    static bool Load(const std::string& objPath, bool skipWheels, MeshData& out);
+
+    /**
+     * @brief Zapisuje siatkę do cache obok pliku OBJ.
+     * @param objPath Ścieżka do pliku OBJ.
+     * @param skipWheels Wariant parsowania.
+     * @param mesh Siatka do zapisania.
+     * @return `true` jeśli zapis się powiódł (np. katalog tylko do odczytu = `false`).
+     */
+    static bool Save(const std::string& objPath, bool skipWheels, const MeshData& mesh);
+
+    /**
+     * @brief Wczytuje siatkę z cache lub parsuje OBJ, optymalizuje ją (`MeshOptimizer`) i zapisuje cache.
+     * @param objPath Ścieżka do pliku OBJ.
+     * @param skipWheels Wariant parsowania.
+     * @param out Wynikowa siatka.
+     * @param fromCache Opcjonalnie: czy siatka pochodzi z cache.
+     * @return `true` jeśli siatkę wczytano; inaczej `false`.
+     */
+    static bool LoadOrParse(const std::string& objPath, bool skipWheels, MeshData& out, bool* fromCache = nullptr);
+
+    /**
+     * @brief Liczy skrót FNV-1a (64 bit) zawartości pliku (także klucz ważności innych plików cache, np. `.r3dtrack`).
+     * @param path Ścieżka do pliku.
+     * @param outHash Wynikowy skrót.
+     * @return `true` jeśli plik udało się odczytać.
+     */
+    static bool HashFile(const std::string& path, uint64_t& outHash);
+};
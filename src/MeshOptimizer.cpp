@@ -0,0 +1,262 @@
+﻿#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+/**
+ * @file MeshOptimizer.cpp
+ * @brief Implementacja spawania wierzchołków, algorytmu Forsytha i symulacji cache wierzchołków.
+ */
+
+ /**
+  * @brief Klucz wierzchołka do spawania: bity wszystkich atrybutów.
+  */
+struct WeldKey {
+    /** @brief Bity floatów wierzchołka (pos3, normal3, uv2). */
+    uint32_t bits[MeshData::FloatsPerVertex];
+
+    bool operator==(const WeldKey& o) const { return std::memcmp(bits, o.bits, sizeof(bits)) == 0; }
+};
+
+/**
+ * @brief Skrót FNV-1a klucza wierzchołka.
+ */
+struct WeldKeyHash {
+    size_t operator()(const WeldKey& k) const {
+        uint64_t h = 1469598103934665603ull;
+        for (uint32_t b : k.bits) {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+        return (size_t)h;
+    }
+};
+
+/**
+ * @brief Łączy identyczne wierzchołki i przepisuje indeksy.
+ * @param mesh Siatka modyfikowana w miejscu.
+ * @return Liczba usuniętych wierzchołków.
+ */
+size_t MeshOptimizer::WeldVertices(MeshData& mesh) {
+    const unsigned int fpv = MeshData::FloatsPerVertex;
+    size_t vertexCount = mesh.VertexCount();
+    if (vertexCount == 0) return 0;
+
+    std::unordered_map<WeldKey, unsigned int, WeldKeyHash> unique;
+    unique.reserve(vertexCount);
+
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<float> welded;
+    welded.reserve(mesh.vertices.size());
+
+    for (size_t v = 0; v < vertexCount; ++v) {
+        WeldKey key;
+        for (unsigned int c = 0; c < fpv; ++c) {
+            // +0.0f zamienia -0.0f na 0.0f, aby oba warianty trafiały w ten sam klucz.
+            float f = mesh.vertices[v * fpv + c] + 0.0f;
+            std::memcpy(&key.bits[c], &f, sizeof(float));
+        }
+
+        auto it = unique.find(key);
+        if (it != unique.end()) {
+            remap[v] = it->second;
+            continue;
+        }
+
+        unsigned int newIndex = (unsigned int)(welded.size() / fpv);
+        unique.emplace(key, newIndex);
+        remap[v] = newIndex;
+        welded.insert(welded.end(), mesh.vertices.begin() + v * fpv, mesh.vertices.begin() + (v + 1) * fpv);
+    }
+
+    for (auto& idx : mesh.indices) idx = remap[idx];
+
+    size_t removed = vertexCount - welded.size() / fpv;
+    mesh.vertices.swap(welded);
+    return removed;
+}
+
+/**
+ * @brief Ocena wierzchołka w algorytmie Forsytha.
+ * @param cachePos Pozycja w modelowanym cache LRU (-1 = poza cache).
+ * @param remaining Liczba jeszcze niewyemitowanych trójkątów używających wierzchołka.
+ * @return Ocena (większa = lepiej emitować trójkąty z tym wierzchołkiem).
+ */
+static float ForsythVertexScore(int cachePos, unsigned int remaining) {
+    if (remaining == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        // Trzy ostatnie wierzchołki mają stałą ocenę: użyte właśnie trójkątem.
+        if (cachePos < 3) score = 0.75f;
+        else {
+            float scaler = 1.0f / (MeshOptimizer::ForsythCacheSize - 3);
+            score = powf(1.0f - (cachePos - 3) * scaler, 1.5f);
+        }
+    }
+
+    // Premia dla wierzchołków z małą liczbą pozostałych trójkątów (unikanie „osieroconych” trójkątów).
+    score += 2.0f * powf((float)remaining, -0.5f);
+    return score;
+}
+
+/**
+ * @brief Zmienia kolejność trójkątów algorytmem Forsytha.
+ * @param indices Indeksy trójkątów (modyfikowane w miejscu).
+ * @param vertexCount Liczba wierzchołków siatki.
+ */
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0 || vertexCount == 0) return;
+
+    // Listy trójkątów dla każdego wierzchołka (CSR); `remaining` = długość aktywnej części listy.
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i) remaining[indices[i]]++;
+
+    std::vector<unsigned int> triStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) triStart[v + 1] = triStart[v] + remaining[v];
+
+    std::vector<unsigned int> vertTris(triCount * 3);
+    {
+        std::vector<unsigned int> fill(triStart.begin(), triStart.end() - 1);
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) vertTris[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+        }
+    }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vScore[v] = ForsythVertexScore(-1, remaining[v]);
+
+    std::vector<float> tScore(triCount);
+    std::vector<unsigned char> emittedTri(triCount, 0);
+    int best = 0;
+    for (size_t t = 0; t < triCount; ++t) {
+        tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+        if (tScore[t] > tScore[best]) best = (int)t;
+    }
+
+    std::vector<unsigned int> out;
+    out.reserve(triCount * 3);
+
+    unsigned int cache[ForsythCacheSize + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;
+
+    for (size_t emitted = 0; emitted < triCount; ++emitted) {
+        if (best < 0) {
+            // Brak kandydatów w cache — następny niewyemitowany trójkąt w kolejności pierwotnej.
+            while (emittedTri[scanCursor]) ++scanCursor;
+            best = (int)scanCursor;
+        }
+
+        emittedTri[best] = 1;
+
+        unsigned int newCache[ForsythCacheSize + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = indices[best * 3 + k];
+            out.push_back(v);
+            newCache[newCount++] = v;
+
+            // Usunięcie trójkąta z aktywnej listy wierzchołka.
+            unsigned int* list = &vertTris[triStart[v]];
+            for (unsigned int i = 0; i < remaining[v]; ++i) {
+                if (list[i] == (unsigned int)best) {
+                    list[i] = list[remaining[v] - 1];
+                    remaining[v]--;
+                    break;
+                }
+            }
+        }
+
+        for (int i = 0; i < cacheCount; ++i) {
+            unsigned int v = cache[i];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) newCache[newCount++] = v;
+        }
+
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            cachePos[v] = i < ForsythCacheSize ? i : -1;
+            vScore[v] = ForsythVertexScore(cachePos[v], remaining[v]);
+        }
+
+        // Nowy najlepszy trójkąt szukany tylko wśród trójkątów wierzchołków z (byłego) cache.
+        best = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            const unsigned int* list = &vertTris[triStart[v]];
+            for (unsigned int j = 0; j < remaining[v]; ++j) {
+                unsigned int t = list[j];
+                tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+                if (tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best = (int)t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, ForsythCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices.swap(out);
+}
+
+/**
+ * @brief Numeruje wierzchołki w kolejności pierwszego użycia.
+ * @param mesh Siatka modyfikowana w miejscu.
+ */
+void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh) {
+    const unsigned int fpv = MeshData::FloatsPerVertex;
+    const unsigned int unused = 0xFFFFFFFFu;
+
+    std::vector<unsigned int> remap(mesh.VertexCount(), unused);
+    std::vector<float> ordered;
+    ordered.reserve(mesh.vertices.size());
+
+    for (auto& idx : mesh.indices) {
+        if (remap[idx] == unused) {
+            remap[idx] = (unsigned int)(ordered.size() / fpv);
+            ordered.insert(ordered.end(), mesh.vertices.begin() + (size_t)idx * fpv, mesh.vertices.begin() + ((size_t)idx + 1) * fpv);
+        }
+        idx = remap[idx];
+    }
+
+    mesh.vertices.swap(ordered);
+}
+
+/**
+ * @brief Pełna optymalizacja siatki.
+ * @param mesh Siatka modyfikowana w miejscu.
+ */
+void MeshOptimizer::Optimize(MeshData& mesh) {
+    WeldVertices(mesh);
+    OptimizeVertexCache(mesh.indices, mesh.VertexCount());
+    OptimizeVertexFetch(mesh);
+}
+
+/**
+ * @brief Symuluje cache FIFO po transformacji i zlicza wywołania vertex shadera.
+ * @param indices Indeksy trójkątów.
+ * @param cacheSize Rozmiar cache.
+ * @return Liczba chybień cache.
+ */
+size_t MeshOptimizer::SimulateVertexCache(const std::vector<unsigned int>& indices, unsigned int cacheSize) {
+    if (cacheSize == 0) return indices.size();
+
+    std::vector<unsigned int> fifo(cacheSize, 0xFFFFFFFFu);
+    unsigned int head = 0;
+    size_t misses = 0;
+
+    for (unsigned int idx : indices) {
+        if (std::find(fifo.begin(), fifo.end(), idx) != fifo.end()) continue;
+        fifo[head] = idx;
+        head = (head + 1) % cacheSize;
+        ++misses;
+    }
+    return misses;
+}
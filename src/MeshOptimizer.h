@@ -0,0 +1,56 @@
+﻿#pragma once
+#include "MeshCache.h"
+#include <vector>
+
+/**
+ * @file MeshOptimizer.h
+ * @brief Deklaracja optymalizacji siatek: spawanie wierzchołków i kolejność pod cache wierzchołków GPU.
+ */
+
+ /**
+  * @brief Optymalizacje siatek trójkątów wykonywane raz, przed zapisem do cache i wysłaniem na GPU.
+  *
+  * - `WeldVertices` łączy identyczne krotki (pozycja, normalna, UV) w jeden wierzchołek,
+  * - `OptimizeVertexCache` układa trójkąty algorytmem Forsytha („Linear-Speed Vertex Cache
+  *   Optimisation”), aby kolejne trójkąty korzystały z wierzchołków już przetworzonych przez shader,
+  * - `OptimizeVertexFetch` numeruje wierzchołki w kolejności pierwszego użycia (lokalność odczytu VBO).
+  */
+class MeshOptimizer {
+public:
+    /** @brief Rozmiar modelowanego cache po transformacji (LRU) używany przez algorytm Forsytha. */
+    static constexpr int ForsythCacheSize = 32;
+
+    /**
+     * @brief Łączy wierzchołki o identycznych bitowo atrybutach i przepisuje indeksy.
+     * @param mesh Siatka modyfikowana w miejscu.
+     * @return Liczba usuniętych wierzchołków.
+     */
+    static size_t WeldVertices(MeshData& mesh);
+
+    /**
+     * @brief Zmienia kolejność trójkątów pod cache wierzchołków po transformacji (Forsyth).
+     * @param indices Indeksy trójkątów (modyfikowane w miejscu).
+     * @param vertexCount Liczba wierzchołków siatki.
+     */
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    /**
+     * @brief Numeruje wierzchołki w kolejności pierwszego użycia przez indeksy; nieużyte są usuwane.
+     * @param mesh Siatka modyfikowana w miejscu.
+     */
+    static void OptimizeVertexFetch(MeshData& mesh);
+
+    /**
+     * @brief Wykonuje pełną optymalizację: spawanie, kolejność trójkątów i kolejność wierzchołków.
+     * @param mesh Siatka modyfikowana w miejscu.
+     */
+    static void Optimize(MeshData& mesh);
+
+    /**
+     * @brief Szacuje liczbę wywołań vertex shadera symulując cache FIFO po transformacji.
+     * @param indices Indeksy trójkątów.
+     * @param cacheSize Rozmiar symulowanego cache (typowo 16–32 wpisy).
+     * @return Liczba chybień cache, czyli wywołań vertex shadera.
+     */
+    static size_t SimulateVertexCache(const std::vector<unsigned int>& indices, unsigned int cacheSize = 16);
+};
@@ -0,0 +1,170 @@
+﻿#include "MeshRegistry.h"
+#include <glad/glad.h>
+#include <filesystem>
+#include <iostream>
+
+/**
+ * @file MeshRegistry.cpp
+ * @brief Implementacja rejestru siatek aut z licznikiem referencji.
+ */
+
+std::unordered_map<std::string, MeshRegistry::Entry> MeshRegistry::entries;
+std::unordered_map<const CarMesh*, std::string> MeshRegistry::keyOf;
+size_t MeshRegistry::uploadCount = 0;
+std::mutex MeshRegistry::mutex;
+
+/**
+ * @brief Tworzy VAO/VBO/EBO siatki, przesyła dane na GPU i wylicza prostokąt otaczający.
+ * @param data Siatka źródłowa (niepusta).
+ * @param mesh Siatka docelowa.
+ */
+static void CreateBuffers(const MeshData& data, CarMesh& mesh) {
+    glGenVertexArrays(1, &mesh.VAO); glGenBuffers(1, &mesh.VBO); glGenBuffers(1, &mesh.EBO);
+
+    glBindVertexArray(mesh.VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(data.vertices.size() * sizeof(float)), data.vertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(data.indices.size() * sizeof(unsigned int)), data.indices.data(), GL_STATIC_DRAW);
+
+    const GLsizei stride = MeshData::FloatsPerVertex * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0); glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    mesh.indexCount = (int)data.indices.size();
+
+    mesh.boundsMin = glm::vec3(data.vertices[0], data.vertices[1], data.vertices[2]);
+    mesh.boundsMax = mesh.boundsMin;
+    for (size_t i = 0; i < data.vertices.size(); i += MeshData::FloatsPerVertex) {
+        glm::vec3 p(data.vertices[i], data.vertices[i + 1], data.vertices[i + 2]);
+        mesh.boundsMin = glm::min(mesh.boundsMin, p);
+        mesh.boundsMax = glm::max(mesh.boundsMax, p);
+    }
+}
+
+/**
+ * @brief Usuwa bufory OpenGL siatki.
+ * @param mesh Siatka.
+ */
+static void DeleteBuffers(const CarMesh& mesh) {
+    glDeleteVertexArrays(1, &mesh.VAO);
+    glDeleteBuffers(1, &mesh.VBO);
+    glDeleteBuffers(1, &mesh.EBO);
+}
+
+/**
+ * @brief Kanonizuje ścieżkę (także nieistniejącą) i dokleja tryb parsowania.
+ * @param path Ścieżka do pliku OBJ.
+ * @param skipWheels Tryb parsowania.
+ * @return Klucz rejestru.
+ */
+std::string MeshRegistry::MakeKey(const std::string& path, bool skipWheels) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::path(path), ec);
+    std::string key = ec ? std::filesystem::path(path).lexically_normal().generic_string() : canonical.generic_string();
+    key += skipWheels ? "|body" : "|full";
+    return key;
+}
+
+/**
+ * @brief Sprawdza obecność siatki pod kluczem.
+ * @param path Ścieżka do pliku OBJ.
+ * @param skipWheels Tryb parsowania.
+ * @return `true` gdy siatka jest w rejestrze.
+ */
+bool MeshRegistry::Contains(const std::string& path, bool skipWheels) {
+    std::string key = MakeKey(path, skipWheels);
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.find(key) != entries.end();
+}
+
+/**
+ * @brief Zwiększa licznik istniejącej siatki albo tworzy nową.
+ * @param path Ścieżka do pliku OBJ.
+ * @param skipWheels Tryb parsowania.
+ * @param data Siatka wczytana wcześniej (może być pusta); zwalniana po uploadzie.
+ * @return Siatka lub `nullptr`.
+ */
+const CarMesh* MeshRegistry::Acquire(const std::string& path, bool skipWheels, MeshData& data) {
+    std::string key = MakeKey(path, skipWheels);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->second.refCount++;
+            data = MeshData();
+            return it->second.mesh.get();
+        }
+    }
+
+    // Wątek roboczy mógł pominąć wczytanie, bo siatka była w rejestrze — a zdążyła zostać zwolniona.
+    if (data.vertices.empty() && (!MeshCache::LoadOrParse(path, skipWheels, data) || data.vertices.empty())) {
+        std::cout << "Mesh failed to load at path: " << path << std::endl;
+        data = MeshData();
+        return nullptr;
+    }
+
+    auto mesh = std::make_unique<CarMesh>();
+    CreateBuffers(data, *mesh);
+    mesh->sourceKey = std::hash<std::string>()(key);
+    data = MeshData();
+
+    const CarMesh* handle = mesh.get();
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[key];
+    entry.mesh = std::move(mesh);
+    entry.refCount = 1;
+    keyOf[handle] = key;
+    uploadCount++;
+    return handle;
+}
+
+/**
+ * @brief Zmniejsza licznik siatki i usuwa ją przy zerze.
+ * @param mesh Siatka.
+ */
+void MeshRegistry::Release(const CarMesh* mesh) {
+    if (!mesh) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto k = keyOf.find(mesh);
+    if (k == keyOf.end()) return;
+
+    auto it = entries.find(k->second);
+    if (it != entries.end() && --it->second.refCount > 0) return;
+
+    DeleteBuffers(*mesh);
+    keyOf.erase(k);
+    if (it != entries.end()) entries.erase(it);
+}
+
+/**
+ * @brief Usuwa wszystkie siatki.
+ */
+void MeshRegistry::ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& kv : entries) DeleteBuffers(*kv.second.mesh);
+    entries.clear();
+    keyOf.clear();
+}
+
+/**
+ * @brief Zwraca liczbę siatek w rejestrze.
+ * @return Liczba siatek.
+ */
+size_t MeshRegistry::GetMeshCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**
+ * @brief Zwraca liczbę uploadów od startu.
+ * @return Liczba uploadów.
+ */
+size_t MeshRegistry::GetUploadCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return uploadCount;
+}
@@ -0,0 +1,119 @@
+﻿#pragma once
+#include "MeshCache.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file MeshRegistry.h
+ * @brief Wspólny dla całego procesu rejestr niezmiennych siatek aut na GPU z licznikiem referencji.
+ */
+
+ /**
+  * @brief Siatka części samochodu na GPU — same uchwyty buforów, bez kopii wierzchołków w RAM.
+  *
+  * Obiekty tworzy i niszczy wyłącznie `MeshRegistry`; auta trzymają do nich wskaźniki tylko do odczytu.
+  * Układ wierzchołka jak w `MeshData` (pozycja, normalna, UV) w atrybutach 0–2.
+  */
+struct CarMesh {
+    /** @brief Uchwyty buforów OpenGL: VAO, VBO, EBO. */
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+
+    /** @brief Liczba indeksów dla `glDrawElements`. */
+    int indexCount = 0;
+
+    /** @brief Prostokąt otaczający wierzchołki w układzie modelu (np. dla kształtu kolizyjnego auta). */
+    glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+
+    /**
+     * @brief Klucz źródła siatki (skrót klucza rejestru).
+     *
+     * Auta z tym samym plikiem OBJ dzielą tę samą `CarMesh`, więc `CarRenderer` rysuje
+     * wszystkie ich instancje jednym wywołaniem.
+     */
+    size_t sourceKey = 0;
+};
+
+/**
+ * @brief Rejestr siatek aut kluczowany kanoniczną ścieżką OBJ i trybem parsowania.
+ *
+ * Każde `Acquire()` zwiększa licznik referencji siatki, a `Release()` go zmniejsza; przy zerze
+ * bufory są usuwane. Dzięki temu N aut z tym samym `CarData` (np. gracz i AI na `race.obj`)
+ * kosztuje jeden upload, a koła przednie i tylne z tego samego pliku — jeden obiekt.
+ * Dane wierzchołków zwalniane są zaraz po uploadzie; kolizje aut korzystają tylko z `CarMesh::boundsMin/boundsMax`.
+ *
+ * `Acquire()` i `Release()` wolno wołać tylko z wątku GL; `Contains()` i `MakeKey()` z dowolnego
+ * (wątki robocze mogą pominąć wczytanie siatki, która jest już na GPU).
+ */
+class MeshRegistry {
+public:
+    /**
+     * @brief Buduje klucz rejestru: kanoniczna ścieżka (`weakly_canonical`, separatory `/`) + tryb parsowania.
+     * @param path Ścieżka do pliku OBJ.
+     * @param skipWheels Czy siatka powstała z pominięciem obiektów „wheel” (karoseria).
+     * @return Klucz rejestru.
+     */
+    static std::string MakeKey(const std::string& path, bool skipWheels);
+
+    /**
+     * @brief Sprawdza, czy siatka jest już na GPU.
+     * @param path Ścieżka do pliku OBJ.
+     * @param skipWheels Tryb parsowania.
+     * @return `true` gdy siatka istnieje w chwili wywołania.
+     */
+    static bool Contains(const std::string& path, bool skipWheels);
+
+    /**
+     * @brief Zwraca siatkę z rejestru albo tworzy ją z `data` (wczytywanych tutaj przez `MeshCache`, gdy puste).
+     * @param path Ścieżka do pliku OBJ.
+     * @param skipWheels Tryb parsowania.
+     * @param data Siatka wczytana wcześniej (np. na wątku roboczym); po wywołaniu pusta.
+     * @return Siatka (referencja do zwolnienia przez `Release()`) lub `nullptr`, gdy siatki nie da się wczytać.
+     */
+    static const CarMesh* Acquire(const std::string& path, bool skipWheels, MeshData& data);
+
+    /**
+     * @brief Oddaje referencję; przy ostatniej usuwa bufory OpenGL.
+     * @param mesh Siatka zwrócona przez `Acquire()` (`nullptr` jest ignorowany).
+     */
+    static void Release(const CarMesh* mesh);
+
+    /**
+     * @brief Usuwa wszystkie siatki niezależnie od liczników (zamknięcie programu).
+     */
+    static void ReleaseAll();
+
+    /**
+     * @brief Zwraca liczbę siatek w rejestrze.
+     * @return Liczba siatek.
+     */
+    static size_t GetMeshCount();
+
+    /**
+     * @brief Zwraca liczbę uploadów siatek od startu programu (do weryfikacji współdzielenia).
+     * @return Liczba utworzonych siatek.
+     */
+    static size_t GetUploadCount();
+
+private:
+    /** @brief Wpis rejestru. */
+    struct Entry {
+        std::unique_ptr<CarMesh> mesh;
+        int refCount = 0;
+    };
+
+    /** @brief Siatki według klucza. */
+    static std::unordered_map<std::string, Entry> entries;
+
+    /** @brief Odwzorowanie siatka -> klucz (dla `Release()`). */
+    static std::unordered_map<const CarMesh*, std::string> keyOf;
+
+    /** @brief Liczba uploadów od startu. */
+    static size_t uploadCount;
+
+    /** @brief Chroni mapy przed `Contains()` z wątków roboczych. */
+    static std::mutex mutex;
+};
@@ -1,23 +1,19 @@
 ﻿#include "Model.h"
+#include "TextureCache.h"
+#include <algorithm>
 #include <iostream>
-
-#include "stb_image.h"
+#include <unordered_map>
 
 /**
  * @file Model.cpp
  * @brief Implementacja ładowania modeli (Assimp), siatek (OpenGL) oraz tekstur (stb_image).
  */
 
- /**
-  * @brief Ładuje teksturę z pliku i tworzy zasób OpenGL.
-  * @param path Ścieżka tekstury wg materiału (zwykle względna).
-  * @param directory Katalog bazowy modelu, do którego doklejany jest `path`.
-  * @return Identyfikator tekstury OpenGL.
-  */
-unsigned int TextureFromFile(const char* path, const std::string& directory);
+ /** @brief Parametry wczytania tekstur modeli (odwrócenie w pionie jak dotychczasowy stan stb_image po wczytaniu aut). */
+static const TextureParams ModelTextureParams{ true };
 
 /**
- * @brief Konstruktor siatki; zapisuje dane i tworzy bufory OpenGL.
+ * @brief Konstruktor siatki; zapisuje dane (bufory OpenGL tworzy `Upload()`).
  * @param vertices Wierzchołki siatki.
  * @param indices Indeksy siatki.
  * @param textures Tekstury siatki.
@@ -27,7 +23,44 @@ Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std:
     this->vertices = vertices;
     this->indices = indices;
     this->textures = textures;
-    setupMesh();
+
+    unsigned int diffuseNr = 1;
+    for (const Texture& tex : this->textures)
+    {
+        std::string number;
+        if (tex.type == "texture_diffuse")
+            number = std::to_string(diffuseNr++);
+        samplerUniforms.emplace_back(tex.type + number);
+    }
+}
+
+/**
+ * @brief Tworzy bufory OpenGL siatki, jeśli jeszcze nie istnieją.
+ */
+void Mesh::Upload()
+{
+    if (VAO == 0 && !vertices.empty() && !indices.empty()) setupMesh();
+}
+
+/**
+ * @brief Usuwa VAO/VBO/EBO siatki.
+ */
+void Mesh::Release()
+{
+    if (VAO == 0) return;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+}
+
+/**
+ * @brief Zwraca rozmiar VBO + EBO siatki.
+ * @return Liczba bajtów.
+ */
+size_t Mesh::GetGpuMemoryBytes() const
+{
+    return (VAO != 0) ? vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int) : 0;
 }
 
 /**
@@ -62,16 +95,10 @@ void Mesh::setupMesh()
  */
 void Mesh::Draw(const Shader& shader)
 {
-    unsigned int diffuseNr = 1;
     for (unsigned int i = 0; i < textures.size(); i++)
     {
         glActiveTexture(GL_TEXTURE0 + i);
-        std::string number;
-        std::string name = textures[i].type;
-        if (name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-
-        shader.setInt((name + number).c_str(), i);
+        shader.setInt(samplerUniforms[i], (int)i);
         glBindTexture(GL_TEXTURE_2D, textures[i].id);
     }
 
@@ -82,29 +109,96 @@ void Mesh::Draw(const Shader& shader)
 }
 
 /**
- * @brief Konstruktor modelu; wczytuje model z pliku.
+ * @brief Konstruktor modelu; wczytuje model z pliku i od razu tworzy zasoby OpenGL.
  * @param path Ścieżka do pliku modelu.
  */
 Model::Model(const std::string& path)
 {
-    loadModel(path);
+    if (LoadFromFile(path)) Upload();
+}
+
+/**
+ * @brief Pobiera tekstury z `TextureCache` (tworząc brakujące z obrazów z `LoadFromFile()`) i tworzy bufory siatek.
+ */
+void Model::Upload()
+{
+    for (size_t i = 0; i < textures_loaded.size(); i++)
+    {
+        if (textures_loaded[i].id != 0) continue;
+        const ImageData& image = (i < pendingImages.size()) ? pendingImages[i] : ImageData();
+        textures_loaded[i].id = TextureCache::Acquire(directory + '/' + textures_loaded[i].path, ModelTextureParams, image);
+        textureBytes += TextureCache::GetTextureBytes(textures_loaded[i].id);
+    }
+    pendingImages.clear();
+
+    for (Mesh& mesh : meshes)
+    {
+        for (Texture& tex : mesh.textures)
+        {
+            auto it = textureIndex.find(tex.path);
+            if (it != textureIndex.end()) tex.id = textures_loaded[it->second].id;
+        }
+        mesh.Upload();
+    }
 }
 
 /**
- * @brief Renderuje wszystkie siatki modelu.
+ * @brief Usuwa tekstury modelu i bufory wszystkich siatek.
+ */
+void Model::Release()
+{
+    for (Texture& tex : textures_loaded)
+    {
+        TextureCache::Release(tex.id);
+        tex.id = 0;
+    }
+    for (Mesh& mesh : meshes)
+    {
+        mesh.Release();
+        for (Texture& tex : mesh.textures) tex.id = 0;
+    }
+    textureBytes = 0;
+}
+
+/**
+ * @brief Sumuje rozmiary buforów siatek i tekstur.
+ * @return Liczba bajtów.
+ */
+size_t Model::GetGpuMemoryBytes() const
+{
+    size_t bytes = textureBytes;
+    for (const Mesh& mesh : meshes) bytes += mesh.GetGpuMemoryBytes();
+    return bytes;
+}
+
+/**
+ * @brief Renderuje siatki modelu, pomijając te, których AABB leży poza ostrosłupem.
  * @param shader Shader używany do renderowania.
+ * @param model Macierz modelu.
+ * @param frustum Ostrosłup widzenia w przestrzeni świata.
  */
-void Model::Draw(const Shader& shader)
+void Model::Draw(const Shader& shader, const glm::mat4& model, const Frustum& frustum)
 {
-    for (unsigned int i = 0; i < meshes.size(); i++)
-        meshes[i].Draw(shader);
+    cullStats.Reset();
+    shader.setModelMatrix(model);
+
+    renderQueue.Clear();
+    for (const Mesh& mesh : meshes)
+    {
+        if (!frustum.IsVisible(mesh.bounds.Transformed(model))) { cullStats.culled++; continue; }
+        renderQueue.Add(shader, mesh);
+        cullStats.drawn++;
+    }
+    renderQueue.Submit();
+    cullStats.drawCalls = renderQueue.GetStats().drawCalls;
 }
 
 /**
  * @brief Wczytuje scenę Assimp, ustala katalog bazowy i przetwarza drzewo węzłów.
  * @param path Ścieżka do pliku modelu.
+ * @return `true` jeśli scena jest kompletna.
  */
-void Model::loadModel(std::string path)
+bool Model::LoadFromFile(const std::string& path)
 {
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
@@ -112,7 +206,7 @@ void Model::loadModel(std::string path)
     if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
     {
         std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
-        return;
+        return false;
     }
     directory = path.substr(0, path.find_last_of('/'));
 
@@ -121,6 +215,55 @@ void Model::loadModel(std::string path)
     }
 
     processNode(scene->mRootNode, scene);
+    mergeMeshesByMaterial();
+    return true;
+}
+
+/**
+ * @brief Scala siatki o identycznym zestawie tekstur (typ + ścieżka) w obrębie komórki siatki XZ.
+ *
+ * Komórka ustalana jest po środku AABB siatki w granicach całego modelu, więc scalone siatki
+ * pozostają zwarte przestrzennie i nadal dają się odrzucać.
+ */
+void Model::mergeMeshesByMaterial()
+{
+    if (meshes.size() < 2) return;
+
+    BoundingBox all;
+    for (const Mesh& mesh : meshes) all.Expand(mesh.bounds);
+    if (!all.Valid()) return;
+    glm::vec3 size = glm::max(all.max - all.min, glm::vec3(1e-4f));
+
+    std::unordered_map<std::string, size_t> groupOf;
+    std::vector<Mesh> merged;
+    merged.reserve(meshes.size());
+
+    for (Mesh& mesh : meshes)
+    {
+        glm::vec3 c = mesh.bounds.Center();
+        int cx = std::clamp((int)((c.x - all.min.x) / size.x * MergeGrid), 0, MergeGrid - 1);
+        int cz = std::clamp((int)((c.z - all.min.z) / size.z * MergeGrid), 0, MergeGrid - 1);
+        std::string key = std::to_string(cz * MergeGrid + cx);
+        for (const Texture& tex : mesh.textures) key += '|' + tex.type + ':' + tex.path;
+
+        auto it = groupOf.find(key);
+        if (it == groupOf.end())
+        {
+            groupOf.emplace(key, merged.size());
+            merged.push_back(std::move(mesh));
+            continue;
+        }
+
+        Mesh& target = merged[it->second];
+        unsigned int base = (unsigned int)target.vertices.size();
+        target.vertices.insert(target.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        target.indices.reserve(target.indices.size() + mesh.indices.size());
+        for (unsigned int index : mesh.indices) target.indices.push_back(base + index);
+        target.bounds.Expand(mesh.bounds);
+    }
+
+    std::cout << "Model: scalono " << meshes.size() << " siatek w " << merged.size() << std::endl;
+    meshes = std::move(merged);
 }
 
 /**
@@ -152,11 +295,13 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
+    BoundingBox bounds;
 
     for (unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
         Vertex vertex;
         vertex.Position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+        bounds.Expand(vertex.Position);
 
         if (mesh->HasNormals())
             vertex.Normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
@@ -185,7 +330,9 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
         textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
     }
 
-    return Mesh(vertices, indices, textures);
+    Mesh result(vertices, indices, textures);
+    result.bounds = bounds;
+    return result;
 }
 
 /**
@@ -202,68 +349,28 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType
     {
         aiString str;
         mat->GetTexture(type, i, &str);
-        bool skip = false;
-        for (unsigned int j = 0; j < textures_loaded.size(); j++)
+        auto it = textureIndex.find(str.C_Str());
+        if (it != textureIndex.end())
         {
-            if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-            {
-                textures.push_back(textures_loaded[j]);
-                skip = true;
-                break;
-            }
+            textures.push_back(textures_loaded[it->second]);
+            continue;
         }
-        if (!skip)
-        {
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), this->directory);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);
-        }
-    }
-    return textures;
-}
 
-/**
- * @brief Wczytuje obraz i tworzy teksturę OpenGL.
- * @param path Ścieżka do pliku w kontekście `directory`.
- * @param directory Katalog bazowy modeli/tekstur.
- * @return Identyfikator tekstury OpenGL.
- */
-unsigned int TextureFromFile(const char* path, const std::string& directory)
-{
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
-
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << filename << std::endl;
-        stbi_image_free(data);
+        // Id tekstury uzupełnia Upload(); tutaj tylko dekodujemy obraz — chyba że jest już
+        // w TextureCache (np. trasa wczytana ponownie, zanim jej tekstury zostały zwolnione).
+        std::string filename = this->directory + '/' + str.C_Str();
+        ImageData image;
+        if (!TextureCache::Contains(filename, ModelTextureParams) &&
+            !LoadTextureImage(filename, ModelTextureParams.flipVertically, image))
+            std::cout << "Texture failed to load at path: " << filename << std::endl;
+
+        Texture texture;
+        texture.type = typeName;
+        texture.path = str.C_Str();
+        textures.push_back(texture);
+        textureIndex.emplace(texture.path, textures_loaded.size());
+        textures_loaded.push_back(texture);
+        pendingImages.push_back(image);
     }
-
-    return textureID;
+    return textures;
 }
\ No newline at end of file
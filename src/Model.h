@@ -7,8 +7,12 @@
 #include <assimp/postprocess.h>
 
 #include "Shader.h"
+#include "ImageData.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -49,8 +53,8 @@ struct Texture {
 /**
  * @brief Pojedyncza siatka (mesh) modelu: geometria + tekstury + obiekty OpenGL.
  *
- * `Mesh` przechowuje wierzchołki i indeksy oraz konfiguruje VAO/VBO/EBO.
- * Renderowanie odbywa się przez `Draw()`.
+ * `Mesh` przechowuje wierzchołki i indeksy; VAO/VBO/EBO tworzy dopiero `Upload()` (wątek GL),
+ * dzięki czemu siatkę można zbudować na wątku roboczym. Renderowanie odbywa się przez `Draw()`.
  */
 class Mesh {
 public:
@@ -63,24 +67,56 @@ public:
     /** @brief Lista tekstur przypisanych do siatki. */
     std::vector<Texture>      textures;
 
+    /** @brief AABB siatki w przestrzeni modelu (liczony przy wczytywaniu w `Model::processMesh`). */
+    BoundingBox               bounds;
+
     /**
-     * @brief Tworzy siatkę i inicjalizuje bufory OpenGL.
+     * @brief Tworzy siatkę (bez zasobów OpenGL — patrz `Upload()`).
      * @param vertices Wierzchołki siatki.
      * @param indices Indeksy siatki.
      * @param textures Tekstury przypisane do siatki.
      */
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
 
+    /**
+     * @brief Tworzy bufory OpenGL siatki (tylko wątek GL; kolejne wywołania nic nie robią).
+     */
+    void Upload();
+
+    /**
+     * @brief Usuwa bufory OpenGL siatki.
+     */
+    void Release();
+
+    /**
+     * @brief Zwraca rozmiar danych siatki przesłanych na GPU.
+     * @return Liczba bajtów (VBO + EBO) lub 0, gdy siatka nie jest wysłana.
+     */
+    size_t GetGpuMemoryBytes() const;
+
     /**
      * @brief Renderuje siatkę, ustawiając tekstury i wywołując `glDrawElements`.
      * @param shader Shader używany do renderowania (ustawiane są uniformy samplerów).
      */
     void Draw(const Shader& shader);
 
+    /** @brief VAO siatki (0 przed `Upload()`). */
+    unsigned int GetVAO() const { return VAO; }
+
+    /**
+     * @brief Zwraca uchwyt uniformu samplera dla tekstury `i`.
+     * @param i Indeks tekstury w `textures`.
+     * @return Uchwyt uniformu (np. `texture_diffuse1`).
+     */
+    const ShaderUniform& GetSamplerUniform(size_t i) const { return samplerUniforms[i]; }
+
 private:
     /** @brief Bufory OpenGL siatki. */
     unsigned int VAO = 0, VBO = 0, EBO = 0;
 
+    /** @brief Uchwyty samplerów (`texture_diffuse1`, ...) dla kolejnych tekstur — nazwy budowane raz w konstruktorze. */
+    std::vector<ShaderUniform> samplerUniforms;
+
     /**
      * @brief Tworzy VAO/VBO/EBO i konfiguruje atrybuty wierzchołka (pos/norm/uv).
      */
@@ -92,20 +128,72 @@ private:
  *
  * `Model` wczytuje scenę z pliku (np. OBJ), iteruje po węzłach i siatkach Assimp,
  * buduje obiekty `Mesh` oraz ładuje tekstury materiałów (z cache).
+ *
+ * Wczytywanie jest dwuetapowe: `LoadFromFile()` (Assimp + dekodowanie tekstur, bez OpenGL —
+ * można wołać z wątku roboczego) i `Upload()` (bufory i tekstury OpenGL, wątek GL).
+ *
+ * Po wczytaniu siatki o tym samym zestawie tekstur, leżące w tej samej komórce siatki
+ * `MergeGrid` x `MergeGrid` (XZ), są scalane w jeden bufor i jedno wywołanie rysowania.
+ * Rysowanie idzie przez `RenderQueue`, która sortuje siatki po stanie.
  */
 class Model {
 public:
+    /** @brief Liczba komórek na bok siatki scalania (większa = mniej scalania, dokładniejsze odrzucanie). */
+    static constexpr int MergeGrid = 4;
+
+    /** @brief Tworzy pusty model (do wczytania przez `LoadFromFile()` + `Upload()`). */
+    Model() = default;
+
     /**
-     * @brief Tworzy model i wczytuje dane z pliku.
+     * @brief Tworzy model i wczytuje dane z pliku (synchronicznie: `LoadFromFile()` + `Upload()`).
      * @param path Ścieżka do pliku modelu (np. OBJ).
      */
     Model(const std::string& path);
 
     /**
-     * @brief Renderuje wszystkie siatki modelu.
+     * @brief Etap CPU: wczytuje scenę Assimp i dekoduje tekstury materiałów. Nie używa OpenGL.
+     * @param path Ścieżka do pliku modelu.
+     * @return `true` jeśli scenę wczytano poprawnie.
+     */
+    bool LoadFromFile(const std::string& path);
+
+    /**
+     * @brief Etap GPU: tworzy tekstury z zdekodowanych obrazów oraz bufory wszystkich siatek.
+     *
+     * Zwalnia zdekodowane piksele po utworzeniu tekstur.
+     */
+    void Upload();
+
+    /**
+     * @brief Zwalnia tekstury i bufory OpenGL wszystkich siatek (tylko wątek GL).
+     */
+    void Release();
+
+    /**
+     * @brief Zwraca szacowany rozmiar zasobów GPU modelu (bufory + tekstury z mipmapami).
+     * @return Liczba bajtów.
+     */
+    size_t GetGpuMemoryBytes() const;
+
+    /**
+     * @brief Renderuje siatki modelu widoczne w ostrosłupie kamery.
      * @param shader Shader używany do renderowania.
+     * @param model Macierz modelu (wraz z macierzą normalnych ustawiana raz dla wszystkich siatek).
+     * @param frustum Ostrosłup widzenia w przestrzeni świata (domyślny = bez odrzucania).
      */
-    void Draw(const Shader& shader);
+    void Draw(const Shader& shader, const glm::mat4& model = glm::mat4(1.0f), const Frustum& frustum = Frustum());
+
+    /**
+     * @brief Zwraca liczniki odrzucania z ostatniego `Draw()`.
+     * @return Narysowane / odrzucone siatki i liczba wywołań rysowania.
+     */
+    const CullStats& GetCullStats() const { return cullStats; }
+
+    /**
+     * @brief Zwraca liczniki zmian stanu z ostatniego `Draw()`.
+     * @return Wywołania rysowania oraz przełączenia programu, tekstur i VAO.
+     */
+    const RenderQueueStats& GetQueueStats() const { return renderQueue.GetStats(); }
 
 private:
     /** @brief Lista siatek zbudowanych na podstawie sceny Assimp. */
@@ -114,14 +202,28 @@ private:
     /** @brief Katalog bazowy modelu służący do wyszukiwania tekstur. */
     std::string directory;
 
-    /** @brief Cache wczytanych tekstur (żeby nie ładować duplikatów). */
+    /** @brief Tekstury modelu, każda ścieżka raz (obiekty OpenGL współdzielone przez `TextureCache`). */
     std::vector<Texture> textures_loaded;
 
+    /** @brief Indeks w `textures_loaded` według ścieżki z materiału. */
+    std::unordered_map<std::string, size_t> textureIndex;
+
+    /** @brief Obrazy zdekodowane w `LoadFromFile()`, czekające na `Upload()` (równoległe do `textures_loaded`). */
+    std::vector<ImageData> pendingImages;
+
+    /** @brief Szacowany rozmiar tekstur utworzonych w `Upload()` (z mipmapami). */
+    size_t textureBytes = 0;
+
+    /** @brief Liczniki odrzucania z ostatniego `Draw()`. */
+    CullStats cullStats;
+
+    /** @brief Kolejka rysowania siatek widocznych w bieżącym `Draw()`. */
+    RenderQueue renderQueue;
+
     /**
-     * @brief Wczytuje model przez Assimp i rozpoczyna przetwarzanie drzewa węzłów.
-     * @param path Ścieżka do pliku modelu.
+     * @brief Scala siatki o tym samym zestawie tekstur leżące w tej samej komórce `MergeGrid` (etap CPU).
      */
-    void loadModel(std::string path);
+    void mergeMeshesByMaterial();
 
     /**
      * @brief Rekurencyjnie przetwarza węzeł Assimp i jego dzieci, dodając siatki do `meshes`.
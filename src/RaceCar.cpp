@@ -1,285 +1,187 @@
 ﻿#include "RaceCar.h"
 #include "Shader.h"
-#include "stb_image.h" 
-#include <fstream>
-#include <sstream>
+#include "CarRenderer.h"
+#include "TextureCache.h"
 #include <iostream>
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 
 /**
  * @file RaceCar.cpp
- * @brief Implementacja logiki renderingu i fizyki samochodu wyścigowego oraz parsowania modeli OBJ.
+ * @brief Implementacja renderingu samochodu wyścigowego oraz parsowania modeli OBJ (fizyka: `CarPhysics.cpp`).
  */
 
- /**
-  * @brief Konfiguruje VAO/VBO/EBO dla siatki oraz przesyła dane na GPU.
-  */
-void CarMesh::setupMesh() {
-    if (vertices.empty()) return;
+ /** @brief Uchwyt uniformu używanego w `RaceCar::Draw` (rozwiązywany raz na program). */
+static const ShaderUniform uUseTexture("useTexture");
 
-    if (VAO != 0) { glDeleteVertexArrays(1, &VAO); glDeleteBuffers(1, &VBO); glDeleteBuffers(1, &EBO); }
+/** @brief Paleta kolorów wspólna dla wszystkich modeli aut (UV siatek wskazują w nią kolory). */
+static const char* const CarTexturePath = "assets/cars/OBJ format/Textures/colormap.png";
 
-    glGenVertexArrays(1, &VAO); glGenBuffers(1, &VBO); glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    std::vector<float> data;
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        data.push_back(vertices[i].x); data.push_back(vertices[i].y); data.push_back(vertices[i].z);
-        data.push_back(normals[i].x);  data.push_back(normals[i].y);  data.push_back(normals[i].z);
-        data.push_back(texCoords[i].x); data.push_back(texCoords[i].y);
-    }
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(data.size() * sizeof(float)), data.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
-}
+/** @brief Parametry wczytania palety (odwrócona w pionie jak UV z OBJ). */
+static const TextureParams CarTextureParams{ true };
 
 /**
  * @brief Konstruktor samochodu.
  * @param startPosition Pozycja startowa w świecie.
  */
-RaceCar::RaceCar(glm::vec3 startPosition) : Position(startPosition), PreviousPosition(startPosition), Velocity(0.0f), Yaw(0.0f), textureID(0) { FrontVector = glm::vec3(0, 0, 1); }
+RaceCar::RaceCar(glm::vec3 startPosition) : CarPhysics(startPosition), textureID(0) {}
 
 /**
- * @brief Zwalnia zasoby OpenGL i czyści dane siatek.
+ * @brief Oddaje referencje siatek i tekstury.
  */
 void RaceCar::cleanup() {
-    auto del = [](CarMesh& m) {
-        if (m.VAO) { glDeleteVertexArrays(1, &m.VAO); glDeleteBuffers(1, &m.VBO); glDeleteBuffers(1, &m.EBO); m.VAO = 0; }
-        m.vertices.clear(); m.indices.clear(); m.normals.clear(); m.texCoords.clear();
-        };
-    del(bodyMesh); del(wheelFrontMesh); del(wheelBackMesh);
+    MeshRegistry::Release(bodyMesh);
+    MeshRegistry::Release(wheelFrontMesh);
+    MeshRegistry::Release(wheelBackMesh);
+    bodyMesh = wheelFrontMesh = wheelBackMesh = nullptr;
+
+    TextureCache::Release(textureID);
+    textureID = 0;
 }
 
 /**
- * @brief Ładuje modele oraz teksturę samochodu.
+ * @brief Ładuje modele oraz teksturę samochodu (synchronicznie: `LoadAssetData()` + `UploadAssets()`).
  * @param bodyPath Ścieżka do OBJ karoserii.
  * @param wheelFrontPath Ścieżka do OBJ przednich kół.
  * @param wheelBackPath Ścieżka do OBJ tylnych kół (opcjonalnie).
  * @return `true` gdy wszystkie części wczytano poprawnie; w przeciwnym razie `false`.
  */
 bool RaceCar::loadAssets(const std::string& bodyPath, const std::string& wheelFrontPath, const std::string& wheelBackPath) {
-    cleanup();
-
-    if (textureID == 0) textureID = loadTexture("assets/cars/OBJ format/Textures/colormap.png");
-
-    if (!loadObj(bodyPath, bodyMesh, true)) return false;
-    if (!loadObj(wheelFrontPath, wheelFrontMesh, false)) return false;
-
-    std::string bPath = wheelBackPath.empty() ? wheelFrontPath : wheelBackPath;
-    if (!loadObj(bPath, wheelBackMesh, false)) return false;
-
-    return true;
+    CarAssetData data;
+    bool ok = LoadAssetData(bodyPath, wheelFrontPath, wheelBackPath, data);
+    UploadAssets(data);
+    return ok;
 }
 
 /**
- * @brief Aktualizuje fizykę samochodu.
- * @param deltaTime Czas między klatkami w sekundach.
+ * @brief Wczytuje siatki części samochodu (przez binarny cache) i dekoduje teksturę.
+ *
+ * Pierwsze wczytanie parsuje OBJ i zapisuje obok niego binarny cache; kolejne czytają cache
+ * (patrz `MeshCache`).
+ *
+ * @param bodyPath Ścieżka do OBJ karoserii.
+ * @param wheelFrontPath Ścieżka do OBJ przednich kół.
+ * @param wheelBackPath Ścieżka do OBJ tylnych kół (puste = przednie).
+ * @param out Dane wynikowe.
+ * @return `true` gdy wszystkie części wczytano poprawnie.
  */
-void RaceCar::Update(float deltaTime) {
-    PreviousPosition = Position;
-
-    FrontVector.x = sin(glm::radians(Yaw));
-    FrontVector.z = cos(glm::radians(Yaw));
-    FrontVector.y = 0.0f;
-    FrontVector = glm::normalize(FrontVector);
-
-    float tResponse = glm::clamp(ThrottleResponse * deltaTime, 0.0f, 1.0f);
-    Throttle = glm::mix(Throttle, ThrottleInput, tResponse);
-
-    glm::vec3 forward = FrontVector;
-
-    float forwardSpeed = glm::dot(Velocity, forward);
-    glm::vec3 velLong = forward * forwardSpeed;
-    glm::vec3 velLat = Velocity - velLong;
-
-    if (Throttle > 0.01f && !Handbrake) {
-        forwardSpeed += (Throttle * Acceleration) * deltaTime;
-    }
-    else if (Throttle < -0.01f) {
-        forwardSpeed -= (-Throttle * Braking) * deltaTime;
-    }
-
-    forwardSpeed = glm::clamp(forwardSpeed, -MaxSpeed, MaxSpeed);
-    velLong = forward * forwardSpeed;
-
-    float effectiveGrip = Grip;
-    if (Handbrake) {
-        forwardSpeed *= powf(HandbrakeDeceleration, deltaTime * 60.0f);
-        velLong = forward * forwardSpeed;
-
-        effectiveGrip *= (1.0f - HandbrakeGripReduction);
-
-        glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0, 1, 0)));
-        float slideForce = (-SteeringInput) * 0.5f * (glm::clamp(std::abs(forwardSpeed), 0.0f, MaxSpeed) / MaxSpeed);
-        velLat += right * slideForce * 10.0f * deltaTime;
-    }
-
-    Velocity = velLong + velLat;
-    float currentSpeed = glm::length(Velocity);
-
-    if (currentSpeed > 0.001f) {
-        Velocity += (-glm::normalize(Velocity) * (AerodynamicDrag * currentSpeed * currentSpeed)) * deltaTime;
-    }
-    Velocity -= Velocity * RollingResistance * deltaTime;
-
-    velLong = forward * glm::dot(Velocity, forward);
-    velLat = Velocity - velLong;
-    velLat *= (1.0f - glm::clamp(effectiveGrip * deltaTime * 2.0f, 0.0f, 1.0f));
-    Velocity = velLong + velLat;
-
-    currentSpeed = glm::length(Velocity);
-    if (currentSpeed > 0.5f && !Handbrake) {
-        float alignFactor = SteeringResponsiveness * deltaTime * glm::clamp(Grip * (1.0f - currentSpeed / (MaxSpeed + 0.1f)), 0.0f, 1.0f);
-        glm::vec3 velDir = glm::normalize(Velocity);
-        Velocity = glm::normalize(glm::mix(velDir, forward, alignFactor)) * currentSpeed * 0.99f;
-    }
-
-    if (glm::length(Velocity) > MaxSpeed) {
-        Velocity = glm::normalize(Velocity) * MaxSpeed;
-    }
-
-    Position += Velocity * deltaTime;
-    Position.y = 0.0f;
-    HandleCollision();
-
-    WheelRotation += glm::dot(Velocity, forward) * deltaTime * 10.0f;
+bool RaceCar::LoadAssetData(const std::string& bodyPath, const std::string& wheelFrontPath, const std::string& wheelBackPath, CarAssetData& out) {
+    // Paleta jest zwykle już w cache (pierwsze auto), więc nie dekodujemy jej ponownie.
+    out.texturePath = CarTexturePath;
+    if (!TextureCache::Contains(out.texturePath, CarTextureParams))
+        LoadTextureImage(out.texturePath, CarTextureParams.flipVertically, out.texture);
+
+    out.bodyPath = bodyPath;
+    out.wheelFrontPath = wheelFrontPath;
+    out.wheelBackPath = wheelBackPath.empty() ? wheelFrontPath : wheelBackPath;
+
+    // Siatki już obecne na GPU (np. AI na tym samym modelu co gracz) dostaną tylko nową referencję.
+    auto load = [](const std::string& path, bool skipWheels, MeshData& mesh) {
+        return MeshRegistry::Contains(path, skipWheels) || MeshCache::LoadOrParse(path, skipWheels, mesh);
+        };
+    if (!load(out.bodyPath, true, out.body)) return false;
+    if (!load(out.wheelFrontPath, false, out.wheelFront)) return false;
+    // Tylne koła z tego samego pliku co przednie: UploadAssets() weźmie siatkę przednich z rejestru.
+    return out.wheelBackPath == out.wheelFrontPath || load(out.wheelBackPath, false, out.wheelBack);
 }
 
 /**
- * @brief Prosta obsługa kolizji z granicą świata.
+ * @brief Zastępuje siatki samochodu nowymi danymi i tworzy zasoby OpenGL.
+ * @param data Dane z `LoadAssetData()`.
  */
-void RaceCar::HandleCollision() {
-    if (glm::length(Position) > 500.0f) {
-        Position = PreviousPosition;
-        Velocity = glm::vec3(0);
-    }
+void RaceCar::UploadAssets(CarAssetData& data) {
+    // Nowa referencja przed zwolnieniem starej: przy zmianie auta tekstura nie jest usuwana i tworzona od nowa.
+    // Jeden obiekt tekstury dla wszystkich aut pozwala też CarRenderer łączyć je w jedno wywołanie rysowania.
+    // To samo dotyczy siatek: ponowne wczytanie tego samego auta nie tworzy buforów od nowa.
+    unsigned int texture = TextureCache::Acquire(data.texturePath.empty() ? CarTexturePath : data.texturePath, CarTextureParams, data.texture);
+    const CarMesh* body = MeshRegistry::Acquire(data.bodyPath, true, data.body);
+    const CarMesh* wheelFront = MeshRegistry::Acquire(data.wheelFrontPath, false, data.wheelFront);
+    const CarMesh* wheelBack = MeshRegistry::Acquire(data.wheelBackPath, false, data.wheelBack);
+    cleanup();
+    textureID = texture;
+    bodyMesh = body;
+    wheelFrontMesh = wheelFront;
+    wheelBackMesh = wheelBack;
 }
 
 /**
- * @brief Zwraca macierz modelu samochodu.
+ * @brief Zwraca macierz modelu samochodu dla interpolowanego stanu renderu.
  * @return Macierz modelu (translacja + rotacja + skala).
  */
 glm::mat4 RaceCar::GetModelMatrix() const {
-    glm::mat4 m = glm::translate(glm::mat4(1.0f), Position);
-    m = glm::rotate(m, glm::radians(Yaw), glm::vec3(0, 1, 0));
-    return glm::scale(m, glm::vec3(0.15f));
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), RenderPosition);
+    m = glm::rotate(m, glm::radians(RenderYaw), glm::vec3(0, 1, 0));
+    return glm::scale(m, glm::vec3(ModelScale));
 }
 
 /**
- * @brief Renderuje samochód (karoseria + koła).
- * @param shader Shader używany do renderowania.
+ * @brief Zwraca kształt kolizyjny z prostokąta otaczającego karoserię.
+ * @return Kształt kolizyjny.
+ */
+CarShape RaceCar::GetCollisionShape() const {
+    if (!bodyMesh) return CarShape();
+    return CarShape::FromBounds(bodyMesh->boundsMin, bodyMesh->boundsMax, ModelScale);
+}
+
+/**
+ * @brief Zwraca macierz karoserii (podgląd w menu albo interpolowany stan renderu).
  * @param pos Opcjonalne nadpisanie pozycji.
  * @param yaw Opcjonalne nadpisanie obrotu.
+ * @return Macierz modelu karoserii.
  */
-void RaceCar::Draw(const Shader& shader, glm::vec3 pos, float yaw) const {
-    glm::mat4 m = (glm::length(pos) > 0.001f) ? glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), pos), glm::radians(yaw), glm::vec3(0, 1, 0)), glm::vec3(0.15f)) : GetModelMatrix();
-
-    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, textureID);
-    shader.setBool("useTexture", true); shader.setMat4("model", m);
+glm::mat4 RaceCar::getBodyMatrix(glm::vec3 pos, float yaw) const {
+    if (glm::length(pos) > 0.001f)
+        return glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), pos), glm::radians(yaw), glm::vec3(0, 1, 0)), glm::vec3(ModelScale));
+    return GetModelMatrix();
+}
 
-    glBindVertexArray(bodyMesh.VAO); glDrawElements(GL_TRIANGLES, (GLsizei)bodyMesh.indices.size(), GL_UNSIGNED_INT, 0);
+/**
+ * @brief Zwraca macierz koła (przesunięcie osi + obrót toczenia).
+ * @param body Macierz karoserii.
+ * @param i Indeks koła (0–1 przednie, 2–3 tylne).
+ * @return Macierz modelu koła.
+ */
+glm::mat4 RaceCar::getWheelMatrix(const glm::mat4& body, int i) const {
+    const glm::vec3 wOffs[] = { {WheelFrontX, 0.25f, WheelZ}, {-WheelFrontX, 0.25f, WheelZ}, {WheelBackX, 0.25f, -WheelZ}, {-WheelBackX, 0.25f, -WheelZ} };
+    return glm::rotate(glm::translate(body, wOffs[i]), glm::radians(WheelRotation), glm::vec3(1, 0, 0));
+}
 
-    glm::vec3 wOffs[] = { {WheelFrontX, 0.25f, WheelZ}, {-WheelFrontX, 0.25f, WheelZ}, {WheelBackX, 0.25f, -WheelZ}, {-WheelBackX, 0.25f, -WheelZ} };
+/**
+ * @brief Dodaje części samochodu jako instancje do `CarRenderer`.
+ * @param renderer Kolektor instancji.
+ * @param pos Opcjonalne nadpisanie pozycji.
+ * @param yaw Opcjonalne nadpisanie obrotu.
+ */
+void RaceCar::Submit(CarRenderer& renderer, glm::vec3 pos, float yaw) const {
+    glm::mat4 m = getBodyMatrix(pos, yaw);
+    if (bodyMesh) renderer.Add(bodyMesh->sourceKey, bodyMesh->VAO, bodyMesh->indexCount, textureID, m);
 
     for (int i = 0; i < 4; i++) {
-        const CarMesh& currentWheel = (i < 2) ? wheelFrontMesh : wheelBackMesh;
-        if (currentWheel.VAO == 0) continue;
-
-        glm::mat4 wM = glm::rotate(glm::translate(m, wOffs[i]), glm::radians(WheelRotation), glm::vec3(1, 0, 0));
-
-        shader.setMat4("model", wM);
-        glBindVertexArray(currentWheel.VAO); glDrawElements(GL_TRIANGLES, (GLsizei)currentWheel.indices.size(), GL_UNSIGNED_INT, 0);
+        const CarMesh* wheel = (i < 2) ? wheelFrontMesh : wheelBackMesh;
+        if (wheel) renderer.Add(wheel->sourceKey, wheel->VAO, wheel->indexCount, textureID, getWheelMatrix(m, i));
     }
-    glBindVertexArray(0);
 }
 
 /**
- * @brief Ładuje dane z pliku OBJ do struktury `CarMesh`.
- * @param path Ścieżka do pliku OBJ.
- * @param mesh Siatka docelowa.
- * @param isBody Jeśli `true`, pomija obiekty zawierające „wheel”.
- * @return `true` jeśli wczytanie się powiodło; inaczej `false`.
+ * @brief Renderuje samochód (karoseria + koła).
+ * @param shader Shader używany do renderowania.
+ * @param pos Opcjonalne nadpisanie pozycji.
+ * @param yaw Opcjonalne nadpisanie obrotu.
  */
-bool RaceCar::loadObj(const std::string& path, CarMesh& mesh, bool isBody) {
-    std::ifstream file(path);
-    if (!file.is_open()) return false;
-
-    std::vector<glm::vec3> t_v; std::vector<glm::vec3> t_vn; std::vector<glm::vec2> t_vt;
-    std::string line;
-    bool skipPart = false;
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line); std::string pr; ss >> pr;
-
-        if (pr == "o" || pr == "g") {
-            std::string name; ss >> name; std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            skipPart = (isBody && (name.find("wheel") != std::string::npos));
-        }
-
-        if (pr == "v") { glm::vec3 v; ss >> v.x >> v.y >> v.z; t_v.push_back(v); }
-        else if (pr == "vn") { glm::vec3 vn; ss >> vn.x >> vn.y >> vn.z; t_vn.push_back(vn); }
-        else if (pr == "vt") { glm::vec2 vt; ss >> vt.x >> vt.y; t_vt.push_back(vt); }
+void RaceCar::Draw(const Shader& shader, glm::vec3 pos, float yaw) const {
+    glm::mat4 m = getBodyMatrix(pos, yaw);
 
-        else if (pr == "f") {
-            if (skipPart) continue;
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, textureID);
+    shader.setBool(uUseTexture, true); shader.setModelMatrix(m);
 
-            std::string v_s; std::vector<std::string> face;
-            while (ss >> v_s) face.push_back(v_s);
-            if (face.size() < 3) continue;
+    if (bodyMesh) { glBindVertexArray(bodyMesh->VAO); glDrawElements(GL_TRIANGLES, (GLsizei)bodyMesh->indexCount, GL_UNSIGNED_INT, 0); }
 
-            for (size_t i = 1; i < face.size() - 1; i++) {
-                std::string tri[] = { face[0], face[i], face[i + 1] };
-                for (auto& f_str : tri) {
-                    std::stringstream fss(f_str); std::string seg; std::vector<int> ids;
-                    while (std::getline(fss, seg, '/')) {
-                        try { ids.push_back(seg.empty() ? 0 : std::stoi(seg)); }
-                        catch (...) { ids.push_back(0); }
-                    }
-                    if (!ids.empty()) {
-                        int v_idx = ids[0];
-                        if (v_idx < 0) v_idx = (int)t_v.size() + v_idx + 1;
+    for (int i = 0; i < 4; i++) {
+        const CarMesh* currentWheel = (i < 2) ? wheelFrontMesh : wheelBackMesh;
+        if (!currentWheel) continue;
 
-                        if (v_idx > 0 && v_idx <= (int)t_v.size()) {
-                            mesh.vertices.push_back(t_v[v_idx - 1]);
-                            mesh.texCoords.push_back((ids.size() > 1 && ids[1] > 0 && ids[1] <= (int)t_vt.size()) ? t_vt[ids[1] - 1] : glm::vec2(0));
-                            mesh.normals.push_back((ids.size() > 2 && ids[2] > 0 && ids[2] <= (int)t_vn.size()) ? t_vn[ids[2] - 1] : glm::vec3(0, 1, 0));
-                            mesh.indices.push_back((unsigned int)mesh.indices.size());
-                        }
-                    }
-                }
-            }
-        }
+        shader.setModelMatrix(getWheelMatrix(m, i));
+        glBindVertexArray(currentWheel->VAO); glDrawElements(GL_TRIANGLES, (GLsizei)currentWheel->indexCount, GL_UNSIGNED_INT, 0);
     }
-
-    mesh.setupMesh(); return true;
+    glBindVertexArray(0);
 }
-
-/**
- * @brief Wczytuje teksturę i tworzy zasób OpenGL.
- * @param path Ścieżka do pliku tekstury.
- * @return Identyfikator tekstury OpenGL.
- */
-unsigned int RaceCar::loadTexture(const char* path) {
-    unsigned int id; glGenTextures(1, &id); int w, h, nrComponents;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path, &w, &h, &nrComponents, 0);
-    if (data) {
-        GLenum format = (nrComponents == 4) ? GL_RGBA : GL_RGB;
-        glBindTexture(GL_TEXTURE_2D, id);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        stbi_image_free(data);
-    }
-    return id;
-}
\ No newline at end of file
@@ -1,5 +1,10 @@
 ﻿#pragma once
 #include <glm/glm.hpp>
+#include "CarCollision.h"
+#include "CarPhysics.h"
+#include "MeshCache.h"
+#include "MeshRegistry.h"
+#include "ImageData.h"
 #include <glad/glad.h>
 #include <vector>
 #include <string>
@@ -11,116 +16,45 @@
 
  /** @brief Deklaracja zapowiadająca klasy `Shader` w celu uniknięcia zależności cyklicznych. */
 class Shader;
+class CarRenderer;
 
 /**
- * @brief Struktura przechowująca dane geometryczne (siatkę) pojedynczej części modelu samochodu.
+ * @brief Dane samochodu wczytane do pamięci RAM (siatki i tekstura), gotowe do wysłania na GPU.
  *
- * Struktura zawiera dane wierzchołków, normalnych, współrzędnych UV, indeksów oraz uchwyty buforów OpenGL
- * (VAO/VBO/EBO) niezbędne do renderowania metodą `glDrawElements`.
+ * Wypełniane przez `RaceCar::LoadAssetData()` (bez OpenGL — można na wątku roboczym),
+ * konsumowane przez `RaceCar::UploadAssets()` na wątku GL. Siatki, które są już w `MeshRegistry`,
+ * nie są wczytywane i zostają puste.
  */
-struct CarMesh {
-    /** @brief Pozycje wierzchołków w przestrzeni modelu. */
-    std::vector<glm::vec3> vertices;
+struct CarAssetData {
+    /** @brief Siatka karoserii (bez obiektów „wheel”; pusta, gdy była już w `MeshRegistry`). */
+    MeshData body;
 
-    /** @brief Wektory normalne wierzchołków, wykorzystywane do oświetlenia. */
-    std::vector<glm::vec3> normals;
+    /** @brief Siatka przednich kół (pusta, gdy była już w `MeshRegistry`). */
+    MeshData wheelFront;
 
-    /** @brief Współrzędne UV przypisane do wierzchołków. */
-    std::vector<glm::vec2> texCoords;
+    /** @brief Siatka tylnych kół (pusta, gdy była już w `MeshRegistry` lub to ten sam plik co przednie). */
+    MeshData wheelBack;
 
-    /** @brief Indeksy wierzchołków wykorzystywane przez `glDrawElements`. */
-    std::vector<unsigned int> indices;
+    /** @brief Zdekodowana tekstura wspólna dla wszystkich części (pusta, gdy była już w `TextureCache`). */
+    ImageData texture;
 
-    /** @brief Uchwyty buforów OpenGL: VAO, VBO, EBO. */
-    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    /** @brief Ścieżka tekstury (klucz w `TextureCache`). */
+    std::string texturePath;
 
-    /**
-     * @brief Konfiguruje bufory OpenGL dla siatki.
-     *
-     * Tworzy (lub odtwarza) VAO/VBO/EBO oraz przesyła dane z `vertices/normals/texCoords/indices`
-     * do pamięci GPU w układzie interleaved.
-     */
-    void setupMesh();
+    /** @brief Ścieżki źródłowe części (karoseria, przednie koła, tylne koła) — do kluczy siatek. */
+    std::string bodyPath, wheelFrontPath, wheelBackPath;
 };
 
 /**
- * @brief Klasa reprezentująca samochód wyścigowy w grze (fizyka, logika ruchu, rendering).
+ * @brief Klasa reprezentująca samochód wyścigowy w grze (fizyka z `CarPhysics` + rendering).
  *
- * Klasa przechowuje parametry ruchu, wejście gracza, dane do renderingu i podstawową obsługę kolizji.
+ * Parametry ruchu, wejście i krok fizyki dziedziczone są z `CarPhysics`; klasa dokłada siatki,
+ * teksturę i rysowanie.
  */
-class RaceCar {
+class RaceCar : public CarPhysics {
 public:
-    /** @brief Aktualna pozycja samochodu w świecie. */
-    glm::vec3 Position;
-
-    /** @brief Pozycja z poprzedniej klatki (używana do prostego cofania przy kolizji). */
-    glm::vec3 PreviousPosition;
-
-    /** @brief Aktualny wektor prędkości (kierunek i wartość). */
-    glm::vec3 Velocity;
-
-    /** @brief Znormalizowany wektor wskazujący przód samochodu. */
-    glm::vec3 FrontVector;
-
-    /** @brief Kąt obrotu wokół osi Y (w stopniach). */
-    float Yaw;
-
-    /** @brief Maksymalna prędkość w m/s. */
-    float MaxSpeed = 5.0f;
-
-    /** @brief Współczynnik przyspieszenia (moc „silnika”). */
-    float Acceleration = 8.0f;
-
-    /** @brief Siła hamowania. */
-    float Braking = 10.0f;
-
-    /** @brief Prędkość skrętu (wpływa na zmianę `Yaw`). */
-    float TurnRate = 2.5f;
-
-    /** @brief Kąt obrotu kół (animacja toczenia). */
-    float WheelRotation = 0.0f;
-
-    /** @brief Przyczepność opon (wpływa na redukcję poślizgu bocznego). */
-    float Grip = 1.5f;
-
-    /** @brief Opór aerodynamiczny (zależny od kwadratu prędkości). */
-    float AerodynamicDrag = 0.02f;
-
-    /** @brief Opór toczenia (liniowy). */
-    float RollingResistance = 0.5f;
-
-    /** @brief Responsywność skrętu (jak szybko prędkość „wyrównuje się” do przodu auta). */
-    float SteeringResponsiveness = 2.0f;
-
-    /** @brief Czy hamulec ręczny jest aktywny. */
-    bool Handbrake = false;
-
-    /** @brief Redukcja przyczepności podczas hamulca ręcznego. */
-    float HandbrakeGripReduction = 0.6f;
-
-    /** @brief Współczynnik wytracania prędkości na ręcznym (<1.0 hamuje). */
-    float HandbrakeDeceleration = 0.95f;
-
-    /** @brief Wejście skrętu (np. A/D) w zakresie [-1, 1]. */
-    float SteeringInput = 0.0f;
-
-    /** @brief Wejście gazu/hamulca (np. W/S) w zakresie [-1, 1]. */
-    float ThrottleInput = 0.0f;
-
-    /** @brief Wygładzona wartość przepustnicy (dla płynności). */
-    float Throttle = 0.0f;
-
-    /** @brief Szybkość reakcji `Throttle` na `ThrottleInput`. */
-    float ThrottleResponse = 5.0f;
-
-    /** @brief Pozycja przednich kół na osi X. */
-    float WheelFrontX = 0.45f;
-
-    /** @brief Pozycja tylnych kół na osi X. */
-    float WheelBackX = 0.45f;
-
-    /** @brief Położenie osi kół względem środka na osi Z. */
-    float WheelZ = 0.42f;
+    /** @brief Skala modelu auta w macierzy modelu (modele OBJ są ~6.7× większe niż auto w świecie). */
+    static constexpr float ModelScale = 0.15f;
 
     /**
      * @brief Tworzy instancję samochodu, inicjalizując stan początkowy.
@@ -138,15 +72,32 @@ public:
     bool loadAssets(const std::string& bodyPath, const std::string& wheelFrontPath, const std::string& wheelBackPath = "");
 
     /**
-     * @brief Zwalnia zasoby OpenGL i czyści dane siatek.
+     * @brief Etap CPU ładowania: wczytuje siatki (przez `MeshCache`) i dekoduje teksturę. Nie używa OpenGL.
+     *
+     * Siatki i teksturę obecne już na GPU (inne auto z tym samym modelem) pomija.
+     *
+     * @param bodyPath Ścieżka do pliku OBJ karoserii.
+     * @param wheelFrontPath Ścieżka do pliku OBJ przednich kół.
+     * @param wheelBackPath Ścieżka do pliku OBJ tylnych kół (jeśli puste, używa `wheelFrontPath`).
+     * @param out Dane wynikowe.
+     * @return `true` jeśli wszystkie siatki wczytano poprawnie.
      */
-    void cleanup();
+    static bool LoadAssetData(const std::string& bodyPath, const std::string& wheelFrontPath, const std::string& wheelBackPath, CarAssetData& out);
 
     /**
-     * @brief Aktualizuje fizykę samochodu w czasie.
-     * @param deltaTime Czas między klatkami w sekundach.
+     * @brief Etap GPU ładowania: zastępuje siatki danymi z `data` i tworzy bufory (tylko wątek GL).
+     *
+     * Siatki pobierane są z `MeshRegistry`, a tekstura z `TextureCache`, więc auta z tym samym
+     * modelem dzielą bufory i obiekt tekstury (jeden upload na model).
+     *
+     * @param data Dane z `LoadAssetData()`; siatki są przenoszone.
+     */
+    void UploadAssets(CarAssetData& data);
+
+    /**
+     * @brief Oddaje referencje siatek (`MeshRegistry`) i tekstury (`TextureCache`).
      */
-    void Update(float deltaTime);
+    void cleanup();
 
     /**
      * @brief Rysuje samochód (karoseria + koła).
@@ -157,44 +108,51 @@ public:
     void Draw(const Shader& shader, glm::vec3 pos = glm::vec3(0.0f), float yaw = 0.0f) const;
 
     /**
-     * @brief Zwraca macierz modelu (translacja + rotacja + skala).
+     * @brief Dodaje karoserię i cztery koła jako instancje do `renderer` (rysowanie w `CarRenderer::Flush`).
+     * @param renderer Kolektor instancji klatki.
+     * @param pos Opcjonalna pozycja nadpisująca `Position` (np. podgląd w menu).
+     * @param yaw Opcjonalny obrót nadpisujący `Yaw` (w stopniach).
+     */
+    void Submit(CarRenderer& renderer, glm::vec3 pos = glm::vec3(0.0f), float yaw = 0.0f) const;
+
+    /**
+     * @brief Zwraca macierz modelu (translacja + rotacja + skala) dla interpolowanego stanu renderu.
      * @return Macierz modelu używana w shaderze.
      */
     glm::mat4 GetModelMatrix() const;
 
+    /**
+     * @brief Zwraca kształt kolizyjny auta z prostokąta otaczającego siatkę karoserii (w skali `ModelScale`).
+     * @return Kształt do `CarCollision`; przed wczytaniem siatki domyślny `CarShape`.
+     */
+    CarShape GetCollisionShape() const;
+
 private:
-    /** @brief Siatka karoserii. */
-    CarMesh bodyMesh;
+    /** @brief Siatka karoserii (referencja w `MeshRegistry`; `nullptr` przed wczytaniem). */
+    const CarMesh* bodyMesh = nullptr;
 
-    /** @brief Siatka przednich kół. */
-    CarMesh wheelFrontMesh;
+    /** @brief Siatka przednich kół (referencja w `MeshRegistry`). */
+    const CarMesh* wheelFrontMesh = nullptr;
 
-    /** @brief Siatka tylnych kół. */
-    CarMesh wheelBackMesh;
+    /** @brief Siatka tylnych kół (referencja w `MeshRegistry`; może być tą samą siatką co przednie). */
+    const CarMesh* wheelBackMesh = nullptr;
 
-    /** @brief Identyfikator tekstury wspólnej dla wszystkich części. */
+    /** @brief Identyfikator tekstury wspólnej dla wszystkich części (referencja w `TextureCache`). */
     unsigned int textureID = 0;
 
     /**
-     * @brief Prosta obsługa kolizji z granicami świata.
-     *
-     * Aktualnie realizuje cofnięcie do `PreviousPosition` jeśli auto wyjedzie poza dozwolony obszar.
-     */
-    void HandleCollision();
-
-    /**
-     * @brief Wczytuje plik OBJ i wypełnia strukturę `CarMesh`.
-     * @param path Ścieżka do pliku OBJ.
-     * @param mesh Struktura docelowa na wynik.
-     * @param isBody Jeśli `true`, parser pominie obiekty zawierające „wheel” w nazwie.
-     * @return `true` jeśli wczytanie i konfiguracja buforów zakończyły się sukcesem; inaczej `false`.
+     * @brief Zwraca macierz karoserii: z nadpisanej pozycji/obrotu albo `GetModelMatrix()`.
+     * @param pos Pozycja nadpisująca (długość ~0 = brak).
+     * @param yaw Obrót nadpisujący (w stopniach).
+     * @return Macierz modelu karoserii.
      */
-    bool loadObj(const std::string& path, CarMesh& mesh, bool isBody);
+    glm::mat4 getBodyMatrix(glm::vec3 pos, float yaw) const;
 
     /**
-     * @brief Wczytuje teksturę z pliku i tworzy teksturę OpenGL.
-     * @param path Ścieżka do pliku tekstury.
-     * @return Identyfikator tekstury OpenGL.
+     * @brief Zwraca macierz koła `i` (0–1 przednie, 2–3 tylne) względem macierzy karoserii.
+     * @param body Macierz karoserii.
+     * @param i Indeks koła.
+     * @return Macierz modelu koła.
      */
-    unsigned int loadTexture(const char* path);
+    glm::mat4 getWheelMatrix(const glm::mat4& body, int i) const;
 };
\ No newline at end of file
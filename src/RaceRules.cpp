@@ -0,0 +1,118 @@
+﻿#include "RaceRules.h"
+#include "CarPhysics.h"
+#include "TrackCollision.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file RaceRules.cpp
+ * @brief Implementacja wspólnych reguł wyścigu.
+ */
+
+ /**
+  * @brief Zwraca pozycję startową auta o danym numerze.
+  * @param grid Pole startowe.
+  * @param slot Numer auta (0 = gracz).
+  * @return Pozycja startowa.
+  */
+glm::vec3 RaceRules::GridSlotPosition(const StartGrid& grid, int slot) {
+    glm::vec3 forward = glm::normalize(glm::vec3(sin(glm::radians(grid.Yaw)), 0.0f, cos(glm::radians(grid.Yaw))));
+    glm::vec3 leftVec = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), forward));
+
+    float sideOffset = (slot % 2) * 0.3f;
+    float backOffset = (slot / 2) * 0.6f;
+    return grid.Position + leftVec * sideOffset - forward * backOffset;
+}
+
+/**
+ * @brief Ustawia auto na polu startowym z zerową prędkością.
+ * @param car Auto do ustawienia.
+ * @param grid Pole startowe.
+ * @param slot Numer auta (0 = gracz).
+ */
+void RaceRules::PlaceOnGrid(CarPhysics& car, const StartGrid& grid, int slot) {
+    car.Position = GridSlotPosition(grid, slot);
+    car.PreviousPosition = car.Position;
+    car.Velocity = glm::vec3(0.0f);
+    car.Yaw = grid.Yaw;
+    car.FrontVector = glm::normalize(glm::vec3(sin(glm::radians(grid.Yaw)), 0.0f, cos(glm::radians(grid.Yaw))));
+    car.SnapRenderState();
+}
+
+/**
+ * @brief Porównuje pozycje dwóch aut: ukończone przed jadącymi, potem czas ukończenia albo dystans wzdłuż toru.
+ * @param finishTimeA Czas ukończenia auta A (ujemny = jeszcze jedzie).
+ * @param raceDistanceA Dystans wyścigu auta A.
+ * @param finishTimeB Czas ukończenia auta B (ujemny = jeszcze jedzie).
+ * @param raceDistanceB Dystans wyścigu auta B.
+ * @return `true` jeśli auto A jest przed autem B.
+ */
+bool RaceRules::IsAhead(float finishTimeA, float raceDistanceA, float finishTimeB, float raceDistanceB) {
+    bool finishedA = finishTimeA >= 0.0f;
+    bool finishedB = finishTimeB >= 0.0f;
+    if (finishedA != finishedB) return finishedA;
+    if (finishedA) return finishTimeA < finishTimeB;
+    return raceDistanceA > raceDistanceB;
+}
+
+/**
+ * @brief Reakcja auta na kontakt ze ścianą toru (ciągłe wykrywanie kolizji i ślizg).
+ * @param track Kolizja toru.
+ * @param car Auto po kroku fizyki.
+ * @param lastSafePos Pozycja sprzed kroku fizyki.
+ * @param radius Promień okręgu kolizyjnego.
+ * @return `true` jeśli wykryto kontakt ze ścianą.
+ */
+bool RaceRules::ResolveWallContact(const TrackCollision& track, CarPhysics& car, const glm::vec3& lastSafePos, float radius) {
+    return ResolveWallContact(track, car.Position, car.Velocity, lastSafePos, radius);
+}
+
+/**
+ * @brief Ruch od bezpiecznej pozycji z ciągłym wykrywaniem kolizji i ślizgiem po ścianie.
+ * @param track Kolizja toru.
+ * @param position Pozycja auta po kroku fizyki.
+ * @param velocity Prędkość auta po kroku fizyki.
+ * @param lastSafePos Pozycja sprzed kroku fizyki.
+ * @param radius Promień okręgu kolizyjnego.
+ * @return `true` jeśli wykryto kontakt ze ścianą.
+ */
+bool RaceRules::ResolveWallContact(const TrackCollision& track, glm::vec3& position, glm::vec3& velocity, const glm::vec3& lastSafePos, float radius) {
+    glm::vec3 start(lastSafePos.x, position.y, lastSafePos.z);
+    glm::vec3 target = position;
+    bool contact = false;
+
+    for (int slide = 0; slide < MaxWallSlides; ++slide) {
+        float t;
+        glm::vec2 n;
+        if (!track.SweepCircle(start, target, radius, t, n)) {
+            start = target;
+            break;
+        }
+        contact = true;
+
+        glm::vec3 normal(n.x, 0.0f, n.y);
+        glm::vec3 move = target - start;
+        start += move * t + normal * WallSkin;
+
+        // Pozostała część ruchu bez składowej w głąb ściany.
+        glm::vec3 remaining = move * (1.0f - t);
+        remaining -= normal * std::min(glm::dot(remaining, normal), 0.0f);
+        target = start + remaining;
+
+        float impact = glm::dot(velocity, normal);
+        if (impact < 0.0f) {
+            velocity -= normal * impact;
+            float tangentSpeed = glm::length(velocity);
+            if (tangentSpeed > 1e-6f)
+                velocity *= std::max(0.0f, 1.0f - WallFriction * -impact / tangentSpeed);
+        }
+    }
+    position = start;
+
+    glm::vec2 push;
+    if (track.FindCollisionPush(position, radius, push)) {
+        position += glm::vec3(push.x, 0.0f, push.y) * (1.0f + WallSkin / std::max(glm::length(push), 1e-6f));
+        contact = true;
+    }
+    return contact;
+}
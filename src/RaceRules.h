@@ -0,0 +1,104 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @file RaceRules.h
+ * @brief Wspólne reguły wyścigu (ustawienie na polu startowym, reakcja na ściany) dla gry i symulacji.
+ */
+
+class CarPhysics;
+class TrackCollision;
+
+/**
+ * @brief Pozycja i orientacja pola startowego.
+ */
+struct StartGrid {
+    /** @brief Pozycja pierwszego auta (pole gracza). */
+    glm::vec3 Position = glm::vec3(0.0f);
+
+    /** @brief Yaw startowy (w stopniach). */
+    float Yaw = 0.0f;
+
+    /** @brief Znormalizowany kierunek jazdy na starcie. */
+    glm::vec3 Forward = glm::vec3(0.0f, 0.0f, 1.0f);
+};
+
+/**
+ * @brief Statyczne reguły wyścigu współdzielone przez `main.cpp` i `Racing3D_sim`.
+ */
+class RaceRules {
+public:
+    /** @brief Promień okręgu kolizyjnego auta względem ścian toru kartingowego. */
+    static constexpr float CarWallRadius = 0.35f;
+
+    /** @brief Tarcie o ścianę: utrata prędkości stycznej jako ułamek prędkości uderzenia (wzdłuż normalnej). */
+    static constexpr float WallFriction = 0.3f;
+
+    /** @brief Odstęp od ściany zostawiany po kontakcie (zapobiega zaczynaniu kolejnego kroku w ścianie). */
+    static constexpr float WallSkin = 1e-3f;
+
+    /** @brief Maksymalna liczba odcinków ruchu „zderzenie–ślizg” w jednym kroku (np. w narożniku). */
+    static constexpr int MaxWallSlides = 3;
+
+    /**
+     * @brief Zwraca pozycję startową auta o danym numerze.
+     *
+     * Pole 0 to pozycja gracza; kolejne auta stoją naprzemiennie po lewej stronie
+     * i w kolejnych rzędach za nim.
+     *
+     * @param grid Pole startowe.
+     * @param slot Numer auta (0 = gracz).
+     * @return Pozycja startowa.
+     */
+    static glm::vec3 GridSlotPosition(const StartGrid& grid, int slot);
+
+    /**
+     * @brief Ustawia auto na polu startowym z zerową prędkością.
+     * @param car Auto do ustawienia.
+     * @param grid Pole startowe.
+     * @param slot Numer auta (0 = gracz).
+     */
+    static void PlaceOnGrid(CarPhysics& car, const StartGrid& grid, int slot);
+
+    /**
+     * @brief Porównuje pozycje dwóch aut w wyścigu.
+     *
+     * Auto, które ukończyło wyścig, jest przed tym, które jeszcze jedzie; z dwóch, które ukończyły, wyżej jest
+     * to z krótszym czasem, a z dwóch jadących — to z większym dystansem wzdłuż toru (`TrackProgress::RaceDistance`).
+     *
+     * @param finishTimeA Czas ukończenia auta A (ujemny = jeszcze jedzie).
+     * @param raceDistanceA Dystans wyścigu auta A.
+     * @param finishTimeB Czas ukończenia auta B (ujemny = jeszcze jedzie).
+     * @param raceDistanceB Dystans wyścigu auta B.
+     * @return `true` jeśli auto A jest przed autem B.
+     */
+    static bool IsAhead(float finishTimeA, float raceDistanceA, float finishTimeB, float raceDistanceB);
+
+    /**
+     * @brief Reakcja na kontakt ze ścianą toru: ruch od `lastSafePos` z ciągłym wykrywaniem kolizji i ślizgiem po ścianie.
+     *
+     * Ruch z kroku fizyki (`lastSafePos` → pozycja auta) jest przepuszczany przez `TrackCollision::SweepCircle`.
+     * Przy kontakcie auto zatrzymuje się przy ścianie, pozostała część ruchu jest rzutowana na kierunek
+     * styczny (do `MaxWallSlides` razy), a z prędkości usuwana jest składowa w głąb ściany (styczna traci
+     * `WallFriction` prędkości uderzenia). Jeśli auto mimo to przecina ścianę (np. zaczęło krok w ścianie),
+     * jest wypychane przez `TrackCollision::FindCollisionPush`.
+     *
+     * @param track Kolizja toru, po którym jedzie auto.
+     * @param car Auto po kroku fizyki.
+     * @param lastSafePos Pozycja sprzed kroku fizyki.
+     * @param radius Promień okręgu kolizyjnego.
+     * @return `true` jeśli wykryto kontakt ze ścianą.
+     */
+    static bool ResolveWallContact(const TrackCollision& track, CarPhysics& car, const glm::vec3& lastSafePos, float radius = CarWallRadius);
+
+    /**
+     * @brief Reakcja na kontakt ze ścianą dla stanu trzymanego poza `CarPhysics` (np. w `CarPhysicsWorld`); jak wyżej.
+     * @param track Kolizja toru, po którym jedzie auto.
+     * @param position Pozycja auta po kroku fizyki.
+     * @param velocity Prędkość auta po kroku fizyki.
+     * @param lastSafePos Pozycja sprzed kroku fizyki.
+     * @param radius Promień okręgu kolizyjnego.
+     * @return `true` jeśli wykryto kontakt ze ścianą.
+     */
+    static bool ResolveWallContact(const TrackCollision& track, glm::vec3& position, glm::vec3& velocity, const glm::vec3& lastSafePos, float radius = CarWallRadius);
+};
@@ -0,0 +1,79 @@
+﻿#include "RenderQueue.h"
+#include "Model.h"
+#include <algorithm>
+#include <tuple>
+
+/**
+ * @file RenderQueue.cpp
+ * @brief Implementacja kolejki rysowania z sortowaniem po stanie.
+ */
+
+ /**
+  * @brief Czyści kolejkę.
+  */
+void RenderQueue::Clear() {
+    items.clear();
+}
+
+/**
+ * @brief Dodaje siatkę; kluczem tekstury jest jej pierwsza tekstura (0 = bez tekstur).
+ * @param shader Program.
+ * @param mesh Siatka.
+ */
+void RenderQueue::Add(const Shader& shader, const Mesh& mesh) {
+    if (mesh.GetVAO() == 0) return;
+    unsigned int texture = mesh.textures.empty() ? 0 : mesh.textures[0].id;
+    items.push_back({ shader.ID, texture, mesh.GetVAO(), &shader, &mesh });
+}
+
+/**
+ * @brief Sortuje elementy po (program, tekstura, VAO) i rysuje je, wiążąc tylko zmieniony stan.
+ */
+void RenderQueue::Submit() {
+    stats = RenderQueueStats();
+    if (items.empty()) return;
+
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return std::tie(a.program, a.texture, a.vao) < std::tie(b.program, b.texture, b.vao);
+        });
+
+    unsigned int boundProgram = 0, boundVAO = 0;
+    const std::vector<Texture>* boundTextures = nullptr;
+
+    for (const Item& item : items) {
+        if (item.program != boundProgram) {
+            glUseProgram(item.program);
+            boundProgram = item.program;
+            boundTextures = nullptr;
+            stats.programChanges++;
+        }
+
+        const std::vector<Texture>& textures = item.mesh->textures;
+        bool sameTextures = boundTextures && boundTextures->size() == textures.size() &&
+            std::equal(textures.begin(), textures.end(), boundTextures->begin(),
+                [](const Texture& a, const Texture& b) { return a.id == b.id; });
+        if (!sameTextures) {
+            // Nazwy samplerów zależą od typów tekstur siatki (np. `texture_specular1` na jednostce 1),
+            // więc przy każdej zmianie zestawu ustawiane są uchwyty tej siatki (lokalizacje z cache).
+            for (size_t i = 0; i < textures.size(); i++) {
+                item.shader->setInt(item.mesh->GetSamplerUniform(i), (int)i);
+                glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+                glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            }
+            boundTextures = &textures;
+            stats.textureChanges++;
+        }
+
+        if (item.vao != boundVAO) {
+            glBindVertexArray(item.vao);
+            boundVAO = item.vao;
+            stats.vaoChanges++;
+        }
+
+        glDrawElements(GL_TRIANGLES, (GLsizei)item.mesh->indices.size(), GL_UNSIGNED_INT, 0);
+        stats.drawCalls++;
+    }
+
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+}
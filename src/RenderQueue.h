@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <vector>
+
+/**
+ * @file RenderQueue.h
+ * @brief Kolejka rysowania siatek posortowana po programie, teksturze i VAO, pomijająca zbędne zmiany stanu.
+ */
+
+class Shader;
+class Mesh;
+
+/**
+ * @brief Liczniki zmian stanu OpenGL wykonanych przez ostatnie `RenderQueue::Submit()`.
+ */
+struct RenderQueueStats {
+    /** @brief Liczba wywołań `glDrawElements`. */
+    int drawCalls = 0;
+
+    /** @brief Liczba przełączeń programu. */
+    int programChanges = 0;
+
+    /** @brief Liczba przełączeń zestawu tekstur. */
+    int textureChanges = 0;
+
+    /** @brief Liczba przełączeń VAO. */
+    int vaoChanges = 0;
+};
+
+/**
+ * @brief Zbiera siatki do narysowania w klatce i rysuje je w kolejności minimalizującej zmiany stanu.
+ *
+ * Elementy są sortowane po (program, tekstura, VAO). Przy wysyłaniu program, tekstury i VAO
+ * są wiązane tylko wtedy, gdy różnią się od poprzedniego elementu. Tekstura `i` siatki trafia na
+ * jednostkę `i`, a uniformy samplerów siatki (`Mesh::GetSamplerUniform`) są ustawiane przy każdej
+ * zmianie zestawu tekstur, bo nazwa samplera na danej jednostce zależy od typów tekstur siatki.
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief Usuwa elementy poprzedniej klatki (pamięć zostaje).
+     */
+    void Clear();
+
+    /**
+     * @brief Dodaje siatkę do narysowania programem `shader`.
+     * @param shader Program (musi żyć do `Submit()`).
+     * @param mesh Siatka z utworzonymi buforami (musi żyć do `Submit()`).
+     */
+    void Add(const Shader& shader, const Mesh& mesh);
+
+    /**
+     * @brief Sortuje elementy i rysuje je; na końcu odwiązuje VAO i wraca na jednostkę tekstury 0.
+     */
+    void Submit();
+
+    /** @brief Liczniki z ostatniego `Submit()`. */
+    const RenderQueueStats& GetStats() const { return stats; }
+
+private:
+    /** @brief Element kolejki z kluczami sortowania. */
+    struct Item {
+        unsigned int program;
+        unsigned int texture;
+        unsigned int vao;
+        const Shader* shader;
+        const Mesh* mesh;
+    };
+
+    /** @brief Elementy bieżącej klatki. */
+    std::vector<Item> items;
+
+    /** @brief Liczniki z ostatniego `Submit()`. */
+    RenderQueueStats stats;
+};
@@ -0,0 +1,197 @@
+﻿#include "SectorTimer.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file SectorTimer.cpp
+ * @brief Implementacja bramek sektorów i pomiaru międzyczasów.
+ */
+
+ /**
+  * @brief Iloczyn wektorowy w 2D (składowa prostopadła).
+  * @param a Pierwszy wektor.
+  * @param b Drugi wektor.
+  * @return `a.x * b.y - a.y * b.x`.
+  */
+static float Cross2(const glm::vec2& a, const glm::vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * @brief Wyznacza bramki prostopadłe do linii środkowej w dystansach `k * długość / sectorCount`.
+ * @param centerline Linia środkowa toru.
+ * @param sectorCount Liczba sektorów.
+ * @param outGates Bramki (wynik).
+ */
+void SectorTimer::BuildGates(const TrackCenterline& centerline, int sectorCount, std::vector<SectorGate>& outGates) {
+    outGates.clear();
+    if (centerline.Empty()) return;
+
+    int count = std::clamp(sectorCount, 2, MaxSectors);
+    float length = centerline.GetLength();
+    outGates.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        float distance = length * (float)k / (float)count;
+        glm::vec2 center = centerline.PointAt(distance);
+        glm::vec2 forward = centerline.DirectionAt(distance);
+        glm::vec2 left = glm::vec2(forward.y, -forward.x) * (centerline.HalfWidthAt(distance) * GateWidthScale);
+        outGates.push_back({ center + left, center - left, forward, distance });
+    }
+}
+
+/**
+ * @brief Rozpoczyna pomiar od startu wyścigu.
+ * @param gateList Bramki toru.
+ * @param length Długość okrążenia.
+ * @param startTime Czas startu.
+ */
+void SectorTimer::Reset(const std::vector<SectorGate>& gateList, float length, float startTime) {
+    gates = &gateList;
+    lapLength = length;
+    nextGate = gateList.size() > 1 ? 1 : 0;
+    lapStartTime = startTime;
+    sectorStartTime = startTime;
+
+    current = LapSplits();
+    current.Lap = 1;
+    best = LapSplits();
+    hasBestLap = false;
+    std::fill(bestSectors, bestSectors + MaxSectors, -1.0f);
+    splitDelta = 0.0f;
+    hasSplitDelta = false;
+    historyHead = 0;
+    historyCount = 0;
+}
+
+/**
+ * @brief Test przecięcia ruchu z następną bramką; zapisuje sektor i przy bramce 0 kończy okrążenie.
+ * @param from Pozycja na początku kroku.
+ * @param to Pozycja na końcu kroku.
+ * @param time Czas na końcu kroku.
+ * @param deltaTime Długość kroku.
+ * @return Indeks ukończonego sektora albo -1.
+ */
+int SectorTimer::Update(const glm::vec3& from, const glm::vec3& to, float time, float deltaTime) {
+    if (!gates || gates->empty()) return -1;
+
+    const SectorGate& gate = (*gates)[nextGate];
+    glm::vec2 p(from.x, from.z);
+    glm::vec2 r(to.x - from.x, to.z - from.z);
+    if (glm::dot(r, gate.Forward) <= 0.0f) return -1;
+
+    glm::vec2 s = gate.Right - gate.Left;
+    float denom = Cross2(r, s);
+    if (std::abs(denom) < 1e-12f) return -1;
+    float u = Cross2(gate.Left - p, s) / denom;
+    float v = Cross2(gate.Left - p, r) / denom;
+    if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) return -1;
+
+    float crossTime = time - deltaTime * (1.0f - u);
+    int count = (int)gates->size();
+    int sector = (nextGate + count - 1) % count;
+
+    current.Sectors[sector] = crossTime - sectorStartTime;
+    current.SectorCount = sector + 1;
+    current.LapTime = crossTime - lapStartTime;
+    sectorStartTime = crossTime;
+
+    hasSplitDelta = hasBestLap;
+    if (hasBestLap) splitDelta = current.LapTime - (BestTimeBefore(sector) + best.Sectors[sector]);
+
+    int crossed = nextGate;
+    nextGate = (nextGate + 1) % count;
+    if (crossed != 0) return sector;
+
+    // Bramka 0: koniec okrążenia.
+    for (int i = 0; i < count; ++i)
+        if (bestSectors[i] < 0.0f || current.Sectors[i] < bestSectors[i]) bestSectors[i] = current.Sectors[i];
+    if (!hasBestLap || current.LapTime < best.LapTime) {
+        best = current;
+        hasBestLap = true;
+    }
+
+    history[historyHead] = current;
+    historyHead = (historyHead + 1) % HistorySize;
+    historyCount = std::min(historyCount + 1, HistorySize);
+
+    int lap = current.Lap;
+    current = LapSplits();
+    current.Lap = lap + 1;
+    lapStartTime = crossTime;
+    return sector;
+}
+
+/**
+ * @brief Zwraca sektor, w którym jest auto (między ostatnią przeciętą a następną bramką).
+ * @return Indeks sektora.
+ */
+int SectorTimer::GetCurrentSector() const {
+    int count = GetSectorCount();
+    return count > 0 ? (nextGate + count - 1) % count : 0;
+}
+
+/**
+ * @brief Zwraca najlepszy czas sektora.
+ * @param sector Indeks sektora.
+ * @return Czas lub wartość ujemna.
+ */
+float SectorTimer::GetBestSector(int sector) const {
+    if (sector < 0 || sector >= GetSectorCount()) return -1.0f;
+    return bestSectors[sector];
+}
+
+/**
+ * @brief Zwraca różnicę do wzorca na ostatniej bramce.
+ * @param outDelta Różnica (wynik).
+ * @return `true` jeśli różnica jest dostępna.
+ */
+bool SectorTimer::GetSplitDelta(float& outDelta) const {
+    if (!hasSplitDelta) return false;
+    outDelta = splitDelta;
+    return true;
+}
+
+/**
+ * @brief Zwraca bieżącą różnicę do wzorca (czas wzorca interpolowany po dystansie w sektorze).
+ * @param time Bieżący czas.
+ * @param lapDistance Dystans auta w okrążeniu.
+ * @param outDelta Różnica (wynik).
+ * @return `true` jeśli jest wzorzec.
+ */
+bool SectorTimer::GetLiveDelta(float time, float lapDistance, float& outDelta) const {
+    if (!hasBestLap || !gates || gates->empty()) return false;
+
+    int count = (int)gates->size();
+    int sector = GetCurrentSector();
+    float d0 = (*gates)[sector].Distance;
+    float d1 = sector + 1 < count ? (*gates)[sector + 1].Distance : lapLength;
+
+    // W ostatnim sektorze rzut może przejść przez 0 chwilę przed przecięciem bramki mety.
+    if (sector == count - 1 && lapDistance < d0) lapDistance += lapLength;
+    float f = d1 > d0 ? std::clamp((lapDistance - d0) / (d1 - d0), 0.0f, 1.0f) : 0.0f;
+
+    float reference = BestTimeBefore(sector) + best.Sectors[sector] * f;
+    outDelta = GetCurrentLapTime(time) - reference;
+    return true;
+}
+
+/**
+ * @brief Zwraca okrążenie z bufora cyklicznego.
+ * @param age 0 = ostatnie ukończone.
+ * @return Referencja do międzyczasów.
+ */
+const SectorTimer::LapSplits& SectorTimer::GetHistory(int age) const {
+    int index = ((historyHead - 1 - age) % HistorySize + HistorySize) % HistorySize;
+    return history[index];
+}
+
+/**
+ * @brief Suma czasów początkowych sektorów najlepszego okrążenia.
+ * @param sector Liczba sektorów.
+ * @return Czas.
+ */
+float SectorTimer::BestTimeBefore(int sector) const {
+    float sum = 0.0f;
+    for (int i = 0; i < sector; ++i) sum += best.Sectors[i];
+    return sum;
+}
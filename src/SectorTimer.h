@@ -0,0 +1,222 @@
+﻿#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "TrackCenterline.h"
+
+/**
+ * @file SectorTimer.h
+ * @brief Bramki sektorów w poprzek toru oraz pomiar międzyczasów, najlepszego okrążenia i różnicy do niego.
+ */
+
+ /**
+  * @brief Bramka pomiaru czasu: odcinek w poprzek toru przecinany przez auta.
+  */
+struct SectorGate {
+    /** @brief Koniec bramki po lewej stronie kierunku jazdy (XZ). */
+    glm::vec2 Left;
+
+    /** @brief Koniec bramki po prawej stronie kierunku jazdy (XZ). */
+    glm::vec2 Right;
+
+    /** @brief Kierunek jazdy w miejscu bramki (XZ, jednostkowy). */
+    glm::vec2 Forward;
+
+    /** @brief Dystans bramki wzdłuż linii środkowej (bramka 0 = linia startu/mety). */
+    float Distance;
+};
+
+/**
+ * @brief Pomiar czasów sektorów jednego auta.
+ *
+ * Bramki są przecinane po kolei: co krok sprawdzany jest tylko odcinek ruchu auta względem następnej bramki
+ * (test przecięcia odcinków), a przejazd liczy się tylko w kierunku jazdy. Ominięcie bramki (np. skrót)
+ * zatrzymuje pomiar do czasu jej przejechania. Czas przecięcia jest interpolowany wewnątrz kroku.
+ *
+ * Przecięcie bramki 0 kończy okrążenie: czasy sektorów trafiają do historii (bufor cykliczny o stałym
+ * rozmiarze, bez alokacji w trakcie jazdy), a najszybsze okrążenie staje się wzorcem dla różnicy czasu.
+ * Pierwsze okrążenie liczy się od startu wyścigu (auto stoi na linii startu lub tuż za nią).
+ */
+class SectorTimer {
+public:
+    /** @brief Maksymalna liczba sektorów. */
+    static constexpr int MaxSectors = 8;
+
+    /** @brief Domyślna liczba sektorów toru. */
+    static constexpr int DefaultSectorCount = 3;
+
+    /** @brief Liczba okrążeń przechowywanych w historii. */
+    static constexpr int HistorySize = 16;
+
+    /** @brief Długość bramki względem szerokości toru (zapas na auta przy ścianie). */
+    static constexpr float GateWidthScale = 1.25f;
+
+    /**
+     * @brief Czasy sektorów jednego okrążenia.
+     */
+    struct LapSplits {
+        /** @brief Numer okrążenia (od 1). */
+        int Lap = 0;
+
+        /** @brief Liczba zmierzonych sektorów. */
+        int SectorCount = 0;
+
+        /** @brief Czasy kolejnych sektorów. */
+        float Sectors[MaxSectors] = {};
+
+        /** @brief Czas okrążenia (suma sektorów, dla okrążenia w toku — do ostatniej bramki). */
+        float LapTime = 0.0f;
+    };
+
+    /**
+     * @brief Wyznacza bramki w równych odstępach linii środkowej, prostopadle do niej.
+     * @param centerline Linia środkowa toru.
+     * @param sectorCount Liczba sektorów (przycinana do 2..`MaxSectors`).
+     * @param outGates Bramki w kolejności jazdy (wynik; pusty dla pustej linii).
+     */
+    static void BuildGates(const TrackCenterline& centerline, int sectorCount, std::vector<SectorGate>& outGates);
+
+    /**
+     * @brief Rozpoczyna pomiar od startu wyścigu (historia i najlepsze okrążenie są czyszczone).
+     * @param gateList Bramki toru (muszą żyć dłużej niż licznik).
+     * @param length Długość okrążenia wzdłuż linii środkowej.
+     * @param startTime Czas startu wyścigu.
+     */
+    void Reset(const std::vector<SectorGate>& gateList, float length, float startTime);
+
+    /**
+     * @brief Sprawdza, czy ruch z tego kroku przecina następną bramkę.
+     * @param from Pozycja auta na początku kroku.
+     * @param to Pozycja auta na końcu kroku.
+     * @param time Czas na końcu kroku.
+     * @param deltaTime Długość kroku.
+     * @return Indeks ukończonego sektora albo -1 (`GetSectorCount() - 1` oznacza ukończone okrążenie).
+     */
+    int Update(const glm::vec3& from, const glm::vec3& to, float time, float deltaTime);
+
+    /**
+     * @brief Zwraca liczbę sektorów.
+     * @return Liczba bramek (0 przed `Reset`).
+     */
+    int GetSectorCount() const { return gates ? (int)gates->size() : 0; }
+
+    /**
+     * @brief Zwraca sektor, w którym jest auto.
+     * @return Indeks sektora.
+     */
+    int GetCurrentSector() const;
+
+    /**
+     * @brief Zwraca czasy sektorów bieżącego okrążenia (ukończone sektory).
+     * @return Referencja do międzyczasów.
+     */
+    const LapSplits& GetCurrentLap() const { return current; }
+
+    /**
+     * @brief Zwraca czas bieżącego okrążenia.
+     * @param time Bieżący czas.
+     * @return Czas od początku okrążenia.
+     */
+    float GetCurrentLapTime(float time) const { return time - lapStartTime; }
+
+    /**
+     * @brief Sprawdza, czy jest wzorcowe (najlepsze) okrążenie.
+     * @return `true` po ukończeniu pierwszego okrążenia.
+     */
+    bool HasBestLap() const { return hasBestLap; }
+
+    /**
+     * @brief Zwraca najlepsze okrążenie.
+     * @return Referencja do międzyczasów (puste, gdy `!HasBestLap()`).
+     */
+    const LapSplits& GetBestLap() const { return best; }
+
+    /**
+     * @brief Zwraca najlepszy czas sektora ze wszystkich okrążeń.
+     * @param sector Indeks sektora.
+     * @return Czas lub wartość ujemna, gdy sektor nie był jeszcze mierzony na pełnym okrążeniu.
+     */
+    float GetBestSector(int sector) const;
+
+    /**
+     * @brief Zwraca różnicę czasu do najlepszego okrążenia na ostatniej przeciętej bramce.
+     * @param outDelta Różnica (ujemna = szybciej od wzorca).
+     * @return `false` gdy brak wzorca albo w tym okrążeniu nie przecięto jeszcze bramki.
+     */
+    bool GetSplitDelta(float& outDelta) const;
+
+    /**
+     * @brief Zwraca bieżącą różnicę czasu do najlepszego okrążenia.
+     *
+     * Czas wzorca jest interpolowany liniowo po dystansie wewnątrz bieżącego sektora, więc wynik zmienia się
+     * płynnie i na bramkach równa się różnicy z `GetSplitDelta`.
+     *
+     * @param time Bieżący czas.
+     * @param lapDistance Dystans auta w okrążeniu (`TrackProgress::Distance`).
+     * @param outDelta Różnica (ujemna = szybciej od wzorca).
+     * @return `false` gdy brak wzorca.
+     */
+    bool GetLiveDelta(float time, float lapDistance, float& outDelta) const;
+
+    /**
+     * @brief Zwraca liczbę okrążeń w historii.
+     * @return Liczba okrążeń (najwyżej `HistorySize`).
+     */
+    int GetHistoryCount() const { return historyCount; }
+
+    /**
+     * @brief Zwraca okrążenie z historii.
+     * @param age 0 = ostatnie ukończone, 1 = poprzednie itd. (mniej niż `GetHistoryCount()`).
+     * @return Referencja do międzyczasów.
+     */
+    const LapSplits& GetHistory(int age) const;
+
+private:
+    /** @brief Bramki toru. */
+    const std::vector<SectorGate>* gates = nullptr;
+
+    /** @brief Długość okrążenia. */
+    float lapLength = 0.0f;
+
+    /** @brief Indeks następnej bramki do przecięcia. */
+    int nextGate = 0;
+
+    /** @brief Czas początku bieżącego okrążenia. */
+    float lapStartTime = 0.0f;
+
+    /** @brief Czas przecięcia ostatniej bramki. */
+    float sectorStartTime = 0.0f;
+
+    /** @brief Międzyczasy bieżącego okrążenia. */
+    LapSplits current;
+
+    /** @brief Najlepsze okrążenie. */
+    LapSplits best;
+
+    /** @brief Czy `best` zawiera ukończone okrążenie. */
+    bool hasBestLap = false;
+
+    /** @brief Najlepsze czasy sektorów (ujemne = brak). */
+    float bestSectors[MaxSectors] = {};
+
+    /** @brief Różnica do wzorca na ostatniej bramce. */
+    float splitDelta = 0.0f;
+
+    /** @brief Czy `splitDelta` dotyczy bieżącego okrążenia. */
+    bool hasSplitDelta = false;
+
+    /** @brief Bufor cykliczny ukończonych okrążeń. */
+    LapSplits history[HistorySize];
+
+    /** @brief Indeks, pod który trafi następne okrążenie. */
+    int historyHead = 0;
+
+    /** @brief Liczba zapełnionych wpisów historii. */
+    int historyCount = 0;
+
+    /**
+     * @brief Suma czasów sektorów `0..sector - 1` najlepszego okrążenia.
+     * @param sector Liczba początkowych sektorów.
+     * @return Czas wzorca na początku sektora `sector`.
+     */
+    float BestTimeBefore(int sector) const;
+};
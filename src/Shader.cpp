@@ -1,4 +1,5 @@
-#include "Shader.h"
+﻿#include "Shader.h"
+#include "FrameUniforms.h"
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     std::string vertexCode;
@@ -21,6 +22,11 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
 
         vertexCode = vShaderStream.str();
         fragmentCode = fShaderStream.str();
+
+        // Pliki shaderów zapisane są z BOM UTF-8, którego część sterowników (np. Mesa) nie akceptuje.
+        const std::string bom = "\xEF\xBB\xBF";
+        if (vertexCode.compare(0, bom.size(), bom) == 0) vertexCode.erase(0, bom.size());
+        if (fragmentCode.compare(0, bom.size(), bom) == 0) fragmentCode.erase(0, bom.size());
     }
     catch (std::ifstream::failure& e) {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
@@ -45,40 +51,117 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
+    cacheUniformLocations();
+    FrameUniforms::BindProgram(ID);
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 }
 
+void Shader::cacheUniformLocations() {
+    uniformLocations.clear();
+
+    int count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    if (count <= 0 || maxLength <= 0) return;
+
+    std::string name((size_t)maxLength, '\0');
+    for (int i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, &name[0]);
+
+        std::string uniformName(name.data(), (size_t)length);
+        int location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0) continue; // uniformy w blokach (UBO) nie mają lokalizacji
+
+        uniformLocations[uniformName] = location;
+
+        // Tablice zgłaszane są jako "nazwa[0]" — zapamiętujemy też samą nazwę.
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos) uniformLocations[uniformName.substr(0, bracket)] = location;
+    }
+}
+
+int Shader::GetUniformLocation(const std::string& name) const {
+    auto it = uniformLocations.find(name);
+    return (it != uniformLocations.end()) ? it->second : -1;
+}
+
+int ShaderUniform::Location(const Shader& shader) const {
+    if (program != shader.ID) {
+        program = shader.ID;
+        location = shader.GetUniformLocation(name);
+    }
+    return location;
+}
+
 void Shader::use() {
     glUseProgram(ID);
 }
 
+void Shader::setModelMatrix(const glm::mat4& model) const {
+    static const ShaderUniform uModel("model");
+    static const ShaderUniform uNormalMatrix("normalMatrix");
+    setMat4(uModel, model);
+    setMat3(uNormalMatrix, NormalMatrix(model));
+}
+
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::setMat3(const std::string& name, const glm::mat3& mat) const {
+    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(value));
 }
 
 void Shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(GetUniformLocation(name), value);
 }
 
 void Shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(GetUniformLocation(name), (int)value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(GetUniformLocation(name), value);
 }
 
 void Shader::setVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(GetUniformLocation(name), x, y, z);
+}
+
+void Shader::setMat4(const ShaderUniform& uniform, const glm::mat4& mat) const {
+    glUniformMatrix4fv(uniform.Location(*this), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::setMat3(const ShaderUniform& uniform, const glm::mat3& mat) const {
+    glUniformMatrix3fv(uniform.Location(*this), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::setVec3(const ShaderUniform& uniform, const glm::vec3& value) const {
+    glUniform3fv(uniform.Location(*this), 1, glm::value_ptr(value));
+}
+
+void Shader::setInt(const ShaderUniform& uniform, int value) const {
+    glUniform1i(uniform.Location(*this), value);
+}
+
+void Shader::setBool(const ShaderUniform& uniform, bool value) const {
+    glUniform1i(uniform.Location(*this), (int)value);
+}
+
+void Shader::setFloat(const ShaderUniform& uniform, float value) const {
+    glUniform1f(uniform.Location(*this), value);
 }
 
 void Shader::checkCompileErrors(unsigned int shader, std::string type) {
@@ -5,9 +5,44 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+class Shader;
+
+/**
+ * @brief Zwraca macierz normalnych dla macierzy modelu: `transpose(inverse(mat3(model)))`.
+ * @param model Macierz modelu.
+ * @return Macierz 3x3 przekształcająca normalne do przestrzeni świata.
+ */
+inline glm::mat3 NormalMatrix(const glm::mat4& model) {
+    return glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+/**
+ * @brief Uchwyt uniformu: nazwa rozwiązywana do lokalizacji raz na program.
+ *
+ * Trzymany np. jako `static` w miejscu wywołania — przy kolejnych rysowaniach tym samym
+ * programem nie ma ani pracy na stringach, ani zapytań do sterownika.
+ */
+class ShaderUniform {
+public:
+    explicit ShaderUniform(std::string name) : name(std::move(name)) {}
+
+    /**
+     * @brief Zwraca lokalizację uniformu w programie `shader` (-1 gdy nieaktywny).
+     * @param shader Program, w którym szukamy uniformu.
+     * @return Lokalizacja uniformu.
+     */
+    int Location(const Shader& shader) const;
+
+private:
+    std::string name;
+    mutable unsigned int program = 0;
+    mutable int location = -1;
+};
+
 class Shader {
 public:
     unsigned int ID;
@@ -15,7 +50,28 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     void use();
 
+    /**
+     * @brief Zwraca lokalizację uniformu z cache wypełnionego po linkowaniu (bez zapytania do sterownika).
+     * @param name Nazwa uniformu (dla tablic także bez sufiksu `[0]`).
+     * @return Lokalizacja lub -1, gdy uniform nie jest aktywny.
+     */
+    int GetUniformLocation(const std::string& name) const;
+
+    /**
+     * @brief Ustawia `model` oraz `normalMatrix` wyliczoną z niego raz na CPU (zamiast odwracania macierzy na każdy wierzchołek).
+     * @param model Macierz modelu rysowanego obiektu.
+     */
+    void setModelMatrix(const glm::mat4& model) const;
+
+    void setMat4(const ShaderUniform& uniform, const glm::mat4& mat) const;
+    void setMat3(const ShaderUniform& uniform, const glm::mat3& mat) const;
+    void setVec3(const ShaderUniform& uniform, const glm::vec3& value) const;
+    void setInt(const ShaderUniform& uniform, int value) const;
+    void setBool(const ShaderUniform& uniform, bool value) const;
+    void setFloat(const ShaderUniform& uniform, float value) const;
+
     void setMat4(const std::string& name, const glm::mat4& mat) const;
+    void setMat3(const std::string& name, const glm::mat3& mat) const;
     void setVec3(const std::string& name, const glm::vec3& value) const;
     void setVec3(const std::string& name, float x, float y, float z) const;
 
@@ -24,5 +80,11 @@ public:
     void setFloat(const std::string& name, float value) const;
 
 private:
+    /** @brief Lokalizacje aktywnych uniformów programu (nazwa -> lokalizacja). */
+    std::unordered_map<std::string, int> uniformLocations;
+
+    /** @brief Wypełnia `uniformLocations` na podstawie aktywnych uniformów zlinkowanego programu. */
+    void cacheUniformLocations();
+
     void checkCompileErrors(unsigned int shader, std::string type);
 };
\ No newline at end of file
@@ -0,0 +1,222 @@
+﻿#include "TextureCache.h"
+#include <glad/glad.h>
+#include <filesystem>
+#include <iostream>
+
+/**
+ * @file TextureCache.cpp
+ * @brief Implementacja cache tekstur z licznikiem referencji.
+ */
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::entries;
+std::unordered_map<unsigned int, std::string> TextureCache::keyOf;
+std::mutex TextureCache::mutex;
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+
+/**
+ * @brief Ustawia parametry samplingu wspólne dla wszystkich tekstur cache (REPEAT, filtrowanie trójliniowe).
+ */
+static void SetSamplingParameters() {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+/**
+ * @brief Tworzy teksturę 2D z łańcucha bloków BCn — bez dekompresji i bez `glGenerateMipmap`.
+ *
+ * Łańcuch może kończyć się przed poziomem 1x1 (np. obcięty przy odwracaniu), dlatego ustawiane jest
+ * `GL_TEXTURE_MAX_LEVEL`. Brak obsługi S3TC/RGTC w sterowniku zgłaszany jest przez `glGetError`.
+ *
+ * @param image Obraz skompresowany (niepusty).
+ * @return Id tekstury OpenGL lub 0, gdy sterownik odrzucił format.
+ */
+static unsigned int CreateCompressedTexture(const CompressedImage& image) {
+    GLenum format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    if (image.format == BlockFormat::BC3) format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if (image.format == BlockFormat::BC5) format = GL_COMPRESSED_RG_RGTC2;
+
+    while (glGetError() != GL_NO_ERROR) {}
+
+    unsigned int id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    for (size_t level = 0; level < image.mips.size(); level++) {
+        const CompressedMip& mip = image.mips[level];
+        glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, format, mip.width, mip.height, 0,
+            (GLsizei)mip.size, image.data.data() + mip.offset);
+    }
+    if (glGetError() != GL_NO_ERROR) {
+        glDeleteTextures(1, &id);
+        return 0;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.mips.size() - 1);
+    SetSamplingParameters();
+    return id;
+}
+
+/**
+ * @brief Tworzy teksturę 2D z obrazu (mipmapy, REPEAT, filtrowanie trójliniowe).
+ * @param image Zdekodowany obraz (niepusty).
+ * @return Id tekstury OpenGL (0, gdy nie udało się jej utworzyć).
+ */
+static unsigned int CreateTexture(const ImageData& image) {
+    if (image.compressed) return CreateCompressedTexture(*image.compressed);
+
+    GLenum format = GL_RGB;
+    if (image.channels == 1) format = GL_RED;
+    else if (image.channels == 4) format = GL_RGBA;
+
+    unsigned int id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    SetSamplingParameters();
+    return id;
+}
+
+/**
+ * @brief Szacuje rozmiar tekstury na GPU.
+ * @param image Obraz, z którego powstała tekstura.
+ * @return Liczba bajtów (dla BCn dokładny rozmiar łańcucha).
+ */
+static size_t EstimateTextureBytes(const ImageData& image) {
+    if (image.compressed) return image.compressed->GetByteSize();
+    // Łańcuch mipmap dokłada ~1/3 rozmiaru poziomu 0.
+    return (size_t)image.width * image.height * image.channels * 4 / 3;
+}
+
+/**
+ * @brief Kanonizuje ścieżkę (także nieistniejącą) i dokleja parametry.
+ * @param path Ścieżka do pliku.
+ * @param params Parametry wczytania.
+ * @return Klucz cache.
+ */
+std::string TextureCache::MakeKey(const std::string& path, const TextureParams& params) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::path(path), ec);
+    std::string key = ec ? std::filesystem::path(path).lexically_normal().generic_string() : canonical.generic_string();
+    key += params.flipVertically ? "|flip" : "|noflip";
+    return key;
+}
+
+/**
+ * @brief Sprawdza obecność tekstury pod kluczem.
+ * @param path Ścieżka do pliku.
+ * @param params Parametry wczytania.
+ * @return `true` gdy tekstura jest w cache.
+ */
+bool TextureCache::Contains(const std::string& path, const TextureParams& params) {
+    std::string key = MakeKey(path, params);
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.find(key) != entries.end();
+}
+
+/**
+ * @brief Zwiększa licznik istniejącej tekstury albo tworzy nową.
+ * @param path Ścieżka do pliku.
+ * @param params Parametry wczytania.
+ * @param image Obraz zdekodowany wcześniej (może być pusty).
+ * @return Id tekstury lub 0.
+ */
+unsigned int TextureCache::Acquire(const std::string& path, const TextureParams& params, const ImageData& image) {
+    std::string key = MakeKey(path, params);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->second.refCount++;
+            return it->second.id;
+        }
+    }
+
+    // Wątek roboczy mógł pominąć dekodowanie, bo tekstura była w cache — a zdążyła zostać zwolniona.
+    ImageData decoded = image;
+    if (!decoded.Valid() && !LoadTextureImage(path, params.flipVertically, decoded)) {
+        std::cout << "Texture failed to load at path: " << path << std::endl;
+        return 0;
+    }
+
+    Entry entry;
+    entry.id = CreateTexture(decoded);
+    if (entry.id == 0 && decoded.compressed && !IsCompressedImagePath(path)) {
+        // Sterownik bez S3TC/RGTC: wersja wypieczona jest bezużyteczna, dekodujemy źródło.
+        std::cout << "Compressed texture rejected by driver, decoding source: " << path << std::endl;
+        if (LoadImageFile(path, params.flipVertically, decoded)) entry.id = CreateTexture(decoded);
+    }
+    if (entry.id == 0) {
+        std::cout << "Texture failed to load at path: " << path << std::endl;
+        return 0;
+    }
+    entry.refCount = 1;
+    entry.bytes = EstimateTextureBytes(decoded);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[key] = entry;
+    keyOf[entry.id] = key;
+    return entry.id;
+}
+
+/**
+ * @brief Zmniejsza licznik tekstury i usuwa ją przy zerze.
+ * @param id Id tekstury.
+ */
+void TextureCache::Release(unsigned int id) {
+    if (id == 0) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto k = keyOf.find(id);
+    if (k == keyOf.end()) return;
+
+    auto it = entries.find(k->second);
+    if (it != entries.end() && --it->second.refCount > 0) return;
+
+    glDeleteTextures(1, &id);
+    if (it != entries.end()) entries.erase(it);
+    keyOf.erase(k);
+}
+
+/**
+ * @brief Usuwa wszystkie tekstury.
+ */
+void TextureCache::ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& kv : entries) glDeleteTextures(1, &kv.second.id);
+    entries.clear();
+    keyOf.clear();
+}
+
+/**
+ * @brief Zwraca rozmiar tekstury z wpisu cache.
+ * @param id Id tekstury.
+ * @return Liczba bajtów.
+ */
+size_t TextureCache::GetTextureBytes(unsigned int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto k = keyOf.find(id);
+    if (k == keyOf.end()) return 0;
+    auto it = entries.find(k->second);
+    return (it != entries.end()) ? it->second.bytes : 0;
+}
+
+/**
+ * @brief Zwraca liczbę tekstur w cache.
+ * @return Liczba tekstur.
+ */
+size_t TextureCache::GetTextureCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
@@ -0,0 +1,101 @@
+﻿#pragma once
+#include "ImageData.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file TextureCache.h
+ * @brief Wspólny dla całego procesu cache tekstur 2D z licznikiem referencji.
+ */
+
+ /**
+  * @brief Parametry wczytania tekstury — część klucza cache (ten sam plik z innymi parametrami to inna tekstura).
+  */
+struct TextureParams {
+    /** @brief Czy odwrócić obraz w pionie przy dekodowaniu. */
+    bool flipVertically = false;
+};
+
+/**
+ * @brief Cache tekstur OpenGL kluczowany kanoniczną ścieżką pliku i parametrami wczytania.
+ *
+ * Każde `Acquire()` zwiększa licznik referencji tekstury, a `Release()` go zmniejsza; przy zerze
+ * tekstura jest usuwana. Dzięki temu np. `colormap.png` wszystkich aut istnieje w jednej kopii,
+ * a tekstury mapy kartingowej znikają razem z wyładowaniem trasy.
+ *
+ * Tekstury tworzone są zawsze tak samo: mipmapy, `GL_REPEAT`, filtrowanie trójliniowe. Obrazy wczytywane są
+ * przez `LoadTextureImage()`, więc wersje wypieczone do BC1/BC3/BC5 trafiają na GPU w formie skompresowanej
+ * razem z gotowym łańcuchem mipmap.
+ * `Acquire()` i `Release()` wolno wołać tylko z wątku GL; `Contains()` i `MakeKey()` z dowolnego
+ * (wątki robocze mogą pominąć dekodowanie obrazu, który jest już w cache).
+ */
+class TextureCache {
+public:
+    /**
+     * @brief Buduje klucz cache: kanoniczna ścieżka (`weakly_canonical`, separatory `/`) + parametry.
+     * @param path Ścieżka do pliku obrazu.
+     * @param params Parametry wczytania.
+     * @return Klucz cache.
+     */
+    static std::string MakeKey(const std::string& path, const TextureParams& params);
+
+    /**
+     * @brief Sprawdza, czy tekstura jest już w cache (np. żeby wątek roboczy nie dekodował jej ponownie).
+     * @param path Ścieżka do pliku obrazu.
+     * @param params Parametry wczytania.
+     * @return `true` gdy tekstura istnieje w chwili wywołania.
+     */
+    static bool Contains(const std::string& path, const TextureParams& params);
+
+    /**
+     * @brief Zwraca teksturę z cache albo tworzy ją z obrazu (dekodowanego tutaj, gdy `image` jest pusty).
+     * @param path Ścieżka do pliku obrazu.
+     * @param params Parametry wczytania.
+     * @param image Obraz zdekodowany wcześniej (np. na wątku roboczym); ignorowany, gdy tekstura jest w cache.
+     * @return Id tekstury (referencja do zwolnienia przez `Release()`) lub 0, gdy obrazu nie da się wczytać.
+     */
+    static unsigned int Acquire(const std::string& path, const TextureParams& params = TextureParams(), const ImageData& image = ImageData());
+
+    /**
+     * @brief Oddaje referencję; przy ostatniej usuwa teksturę OpenGL.
+     * @param id Id tekstury zwrócone przez `Acquire()` (0 jest ignorowane).
+     */
+    static void Release(unsigned int id);
+
+    /**
+     * @brief Usuwa wszystkie tekstury niezależnie od liczników (zamknięcie programu).
+     */
+    static void ReleaseAll();
+
+    /**
+     * @brief Zwraca szacowany rozmiar tekstury na GPU (z mipmapami; dla BCn dokładny rozmiar bloków).
+     * @param id Id tekstury.
+     * @return Liczba bajtów lub 0, gdy tekstury nie ma w cache.
+     */
+    static size_t GetTextureBytes(unsigned int id);
+
+    /**
+     * @brief Zwraca liczbę tekstur w cache.
+     * @return Liczba tekstur.
+     */
+    static size_t GetTextureCount();
+
+private:
+    /** @brief Wpis cache. */
+    struct Entry {
+        unsigned int id = 0;
+        int refCount = 0;
+        size_t bytes = 0;
+    };
+
+    /** @brief Tekstury według klucza. */
+    static std::unordered_map<std::string, Entry> entries;
+
+    /** @brief Odwzorowanie id -> klucz (dla `Release()`). */
+    static std::unordered_map<unsigned int, std::string> keyOf;
+
+    /** @brief Chroni mapy przed `Contains()` z wątków roboczych. */
+    static std::mutex mutex;
+};
@@ -8,9 +8,9 @@
  * @brief Implementacja klasy `Track` generującej płaski tor i renderującej go w OpenGL.
  */
 
- /**
-  * @brief Konstruktor toru: inicjalizuje macierz modelu i generuje siatkę.
-  */
+/**
+ * @brief Konstruktor toru: inicjalizuje macierz modelu i generuje siatkę.
+ */
 Track::Track() {
     ModelMatrix = glm::mat4(1.0f);
     ModelMatrix = glm::scale(ModelMatrix, glm::vec3(20.0f, 1.0f, 20.0f));
@@ -87,13 +87,32 @@ void Track::generateFlatTrack(int gridSize) {
 }
 
 /**
- * @brief Renderuje tor, ustawiając macierz modelu i wywołując `glDrawElements`.
+ * @brief Renderuje tor, ustawiając macierz modelu (i normalnych) i wywołując `glDrawElements`.
  * @param shader Shader używany do renderowania.
  */
 void Track::Draw(const Shader& shader) {
-    shader.setMat4("model", ModelMatrix);
+    shader.setModelMatrix(ModelMatrix);
 
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, vertexCount, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Usuwa VAO/VBO/EBO toru.
+ */
+void Track::Release() {
+    if (VAO == 0) return;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+}
+
+/**
+ * @brief Zwraca rozmiar VBO + EBO toru.
+ * @return Liczba bajtów.
+ */
+size_t Track::GetGpuMemoryBytes() const {
+    return (VAO != 0) ? vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int) : 0;
+}
@@ -36,6 +36,17 @@ public:
      */
     void Draw(const Shader& shader);
 
+    /**
+     * @brief Zwalnia bufory OpenGL toru (tylko wątek GL).
+     */
+    void Release();
+
+    /**
+     * @brief Zwraca rozmiar danych toru przesłanych na GPU.
+     * @return Liczba bajtów (VBO + EBO).
+     */
+    size_t GetGpuMemoryBytes() const;
+
 private:
     /**
      * @brief Generuje płaski tor w postaci siatki trójkątów oraz tworzy VAO/VBO/EBO.
@@ -0,0 +1,514 @@
+﻿#include "TrackCenterline.h"
+#include "TrackFile.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @file TrackCenterline.cpp
+ * @brief Implementacja wyznaczania linii środkowej toru i rzutowania pozycji na dystans wzdłuż toru.
+ */
+
+ /**
+  * @brief Parametry siatki zapytań zapisywane w sekcji `TrackSection::CenterlineGrid`.
+  */
+struct CenterlineGridParams {
+    /** @brief Lewy dolny róg siatki (X). */
+    float originX;
+
+    /** @brief Lewy dolny róg siatki (Z). */
+    float originZ;
+
+    /** @brief Rozmiar boku komórki. */
+    float cellSize;
+
+    /** @brief Liczba kolumn. */
+    int32_t cols;
+
+    /** @brief Liczba wierszy. */
+    int32_t rows;
+};
+
+/**
+ * @brief Próbkuje zamkniętą polilinię w równych odstępach długości łuku, zaczynając od pierwszego punktu.
+ *
+ * Składowe `x`, `y` punktu to pozycja w XZ, a `z` to wartość interpolowana wzdłuż linii (np. połowa szerokości).
+ *
+ * @param pts Zamknięta polilinia (ostatni punkt łączy się z pierwszym).
+ * @param spacing Docelowy odstęp próbek.
+ * @param out Wynikowe próbki (co najmniej 3).
+ */
+static void ResampleClosed(const std::vector<glm::vec3>& pts, float spacing, std::vector<glm::vec3>& out) {
+    out.clear();
+    size_t n = pts.size();
+    if (n < 3) return;
+
+    std::vector<float> cumulative(n + 1, 0.0f);
+    for (size_t i = 0; i < n; ++i)
+        cumulative[i + 1] = cumulative[i] + glm::length(glm::vec2(pts[(i + 1) % n]) - glm::vec2(pts[i]));
+
+    float total = cumulative[n];
+    if (total <= 0.0f) return;
+
+    int count = std::max(3, (int)std::round(total / std::max(spacing, 1e-3f)));
+    float step = total / count;
+    out.reserve(count);
+
+    size_t seg = 0;
+    for (int k = 0; k < count; ++k) {
+        float target = k * step;
+        while (seg + 1 < n && cumulative[seg + 1] < target) ++seg;
+        float segLength = cumulative[seg + 1] - cumulative[seg];
+        float t = segLength > 0.0f ? (target - cumulative[seg]) / segLength : 0.0f;
+        out.push_back(glm::mix(pts[seg], pts[(seg + 1) % n], glm::clamp(t, 0.0f, 1.0f)));
+    }
+}
+
+/**
+ * @brief Wygładza zamkniętą polilinię filtrem [1/4, 1/2, 1/4].
+ * @param pts Polilinia (modyfikowana).
+ * @param passes Liczba przebiegów.
+ */
+static void SmoothClosed(std::vector<glm::vec3>& pts, int passes) {
+    size_t n = pts.size();
+    if (n < 3) return;
+
+    std::vector<glm::vec3> tmp(n);
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < n; ++i)
+            tmp[i] = pts[(i + n - 1) % n] * 0.25f + pts[i] * 0.5f + pts[(i + 1) % n] * 0.25f;
+        pts.swap(tmp);
+    }
+}
+
+/**
+ * @brief Szuka najbliższego punktu zamkniętej polilinii wśród `count` odcinków od odcinka `first`.
+ * @param poly Zamknięta polilinia.
+ * @param p Punkt.
+ * @param first Pierwszy sprawdzany odcinek (może być ujemny; indeksy są zawijane).
+ * @param count Liczba sprawdzanych odcinków.
+ * @param outPoint Najbliższy punkt (wynik).
+ * @param outT Parametr najbliższego punktu na odcinku (wynik).
+ * @return Indeks odcinka z najbliższym punktem.
+ */
+static int NearestOnLoop(const std::vector<glm::vec2>& poly, const glm::vec2& p, int first, int count, glm::vec2& outPoint, float& outT) {
+    int n = (int)poly.size();
+    int best = 0;
+    float bestD2 = std::numeric_limits<float>::max();
+    for (int k = 0; k < count; ++k) {
+        int i = ((first + k) % n + n) % n;
+        glm::vec2 a = poly[i];
+        glm::vec2 ab = poly[(i + 1) % n] - a;
+        float len2 = glm::dot(ab, ab);
+        float t = len2 > 0.0f ? glm::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+        glm::vec2 q = a + ab * t;
+        float d2 = glm::dot(p - q, p - q);
+        if (d2 < bestD2) {
+            bestD2 = d2;
+            best = i;
+            outPoint = q;
+            outT = t;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Zamienia punkty strony toru na zamkniętą polilinię (bez powtórzonego punktu zamykającego).
+ * @param raw Punkty strony.
+ * @return Polilinia w XZ.
+ */
+static std::vector<glm::vec2> ToLoop(const std::vector<Point>& raw) {
+    std::vector<glm::vec2> loop;
+    loop.reserve(raw.size());
+    for (const Point& p : raw) {
+        glm::vec2 v(p.x, p.y);
+        if (loop.empty() || glm::length(v - loop.back()) > 1e-4f) loop.push_back(v);
+    }
+    while (loop.size() > 1 && glm::length(loop.front() - loop.back()) <= 1e-4f) loop.pop_back();
+    return loop;
+}
+
+/**
+ * @brief Wyznacza linię środkową ze stron toru, ustawia jej początek i kierunek oraz buduje siatkę.
+ * @param leftRaw Polilinia lewej strony.
+ * @param rightRaw Polilinia prawej strony.
+ * @param start Punkt na linii startu/mety.
+ * @param forward Kierunek jazdy na starcie.
+ * @param spacing Odstęp próbek.
+ * @param gridCellSize Rozmiar komórki siatki.
+ */
+void TrackCenterline::Build(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+    const glm::vec2& start, const glm::vec2& forward, float spacing, float gridCellSize) {
+    Clear();
+    std::vector<glm::vec2> left = ToLoop(leftRaw);
+    std::vector<glm::vec2> right = ToLoop(rightRaw);
+    if (left.size() < 3 || right.size() < 3) return;
+
+    // Punkty lewej strony gęściej niż wynik; dla każdego najbliższy punkt prawej strony, szukany od
+    // poprzedniego dopasowania (obie strony biegną w tym samym kierunku).
+    std::vector<glm::vec3> leftLoop(left.size());
+    for (size_t i = 0; i < left.size(); ++i) leftLoop[i] = glm::vec3(left[i], 0.0f);
+    std::vector<glm::vec3> leftSamples;
+    ResampleClosed(leftLoop, spacing * 0.5f, leftSamples);
+
+    std::vector<glm::vec3> mids;
+    mids.reserve(leftSamples.size());
+    int match = -1;
+    for (const glm::vec3& s : leftSamples) {
+        glm::vec2 p(s), q;
+        float t;
+        match = match < 0
+            ? NearestOnLoop(right, p, 0, (int)right.size(), q, t)
+            : NearestOnLoop(right, p, match - WindowBack, std::min((int)right.size(), WindowBack + 2 * WindowForward), q, t);
+        mids.push_back(glm::vec3((p + q) * 0.5f, glm::length(p - q) * 0.5f));
+    }
+    SmoothClosed(mids, 2);
+
+    // Początek w rzucie punktu startu, kolejność zgodna z kierunkiem jazdy.
+    std::vector<glm::vec2> midLoop(mids.size());
+    for (size_t i = 0; i < mids.size(); ++i) midLoop[i] = glm::vec2(mids[i]);
+    glm::vec2 startPoint;
+    float startT;
+    int startSeg = NearestOnLoop(midLoop, start, 0, (int)midLoop.size(), startPoint, startT);
+
+    int n = (int)mids.size();
+    glm::vec3 first = glm::mix(mids[startSeg], mids[(startSeg + 1) % n], startT);
+    bool reverse = glm::dot(midLoop[(startSeg + 1) % n] - midLoop[startSeg], forward) < 0.0f;
+
+    std::vector<glm::vec3> ordered;
+    ordered.reserve(n + 1);
+    ordered.push_back(first);
+    for (int k = 0; k < n; ++k)
+        ordered.push_back(reverse ? mids[((startSeg - k) % n + n) % n] : mids[(startSeg + 1 + k) % n]);
+
+    std::vector<glm::vec3> resampled;
+    ResampleClosed(ordered, spacing, resampled);
+    if (resampled.size() < 3) return;
+
+    samples.resize(resampled.size());
+    float distance = 0.0f;
+    for (size_t i = 0; i < resampled.size(); ++i) {
+        samples[i] = { glm::vec2(resampled[i]), distance, resampled[i].z };
+        distance += glm::length(glm::vec2(resampled[(i + 1) % resampled.size()]) - glm::vec2(resampled[i]));
+    }
+    length = distance;
+    BuildGrid(gridCellSize);
+}
+
+/**
+ * @brief Buduje siatkę (CSR) przypisującą odcinki do komórek pokrytych przez ich AABB powiększone o `SearchRadius`.
+ *
+ * Jeśli najbliższy odcinek leży bliżej niż `SearchRadius`, na pewno jest zapisany w komórce zapytania.
+ *
+ * @param cellSize Rozmiar boku komórki.
+ */
+void TrackCenterline::BuildGrid(float cellSize) {
+    gridCellStart.clear();
+    gridSegments.clear();
+    gridCols = gridRows = 0;
+    gridCellSize = cellSize > 1e-3f ? cellSize : 2.0f;
+    if (samples.empty()) return;
+
+    int n = (int)samples.size();
+    glm::vec2 minP(std::numeric_limits<float>::max());
+    glm::vec2 maxP(-std::numeric_limits<float>::max());
+    for (const CenterlineSample& s : samples) {
+        minP = glm::min(minP, s.Position);
+        maxP = glm::max(maxP, s.Position);
+    }
+    minP -= glm::vec2(SearchRadius);
+    maxP += glm::vec2(SearchRadius);
+
+    gridOrigin = minP;
+    gridCols = std::max(1, (int)std::ceil((maxP.x - minP.x) / gridCellSize));
+    gridRows = std::max(1, (int)std::ceil((maxP.y - minP.y) / gridCellSize));
+
+    auto cellOf = [&](float v, float origin, int count) {
+        return glm::clamp((int)std::floor((v - origin) / gridCellSize), 0, count - 1);
+        };
+
+    std::vector<unsigned int> counts((size_t)gridCols * gridRows + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < n; ++i) {
+            glm::vec2 a = samples[i].Position;
+            glm::vec2 b = samples[(i + 1) % n].Position;
+            int x0 = cellOf(std::min(a.x, b.x) - SearchRadius, gridOrigin.x, gridCols);
+            int x1 = cellOf(std::max(a.x, b.x) + SearchRadius, gridOrigin.x, gridCols);
+            int z0 = cellOf(std::min(a.y, b.y) - SearchRadius, gridOrigin.y, gridRows);
+            int z1 = cellOf(std::max(a.y, b.y) + SearchRadius, gridOrigin.y, gridRows);
+            for (int z = z0; z <= z1; ++z) {
+                for (int x = x0; x <= x1; ++x) {
+                    size_t cell = (size_t)z * gridCols + x;
+                    if (pass == 0) counts[cell]++;
+                    else gridSegments[counts[cell]++] = (unsigned int)i;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            gridCellStart.assign(counts.size(), 0);
+            unsigned int sum = 0;
+            for (size_t c = 0; c + 1 < counts.size(); ++c) {
+                gridCellStart[c] = sum;
+                sum += counts[c];
+            }
+            gridCellStart.back() = sum;
+            gridSegments.resize(sum);
+            std::copy(gridCellStart.begin(), gridCellStart.end(), counts.begin());
+        }
+    }
+}
+
+/**
+ * @brief Dopisuje próbki, parametry i tablice siatki jako sekcje pliku toru.
+ * @param writer Plik toru w budowie.
+ */
+void TrackCenterline::WriteSections(TrackFileWriter& writer) const {
+    writer.AddVector(TrackSection::CenterlineSamples, samples);
+
+    CenterlineGridParams grid{ gridOrigin.x, gridOrigin.y, gridCellSize, gridCols, gridRows };
+    writer.AddValue(TrackSection::CenterlineGrid, grid);
+    writer.AddVector(TrackSection::CenterlineCellStart, gridCellStart);
+    writer.AddVector(TrackSection::CenterlineSegments, gridSegments);
+}
+
+/**
+ * @brief Wczytuje próbki i siatkę z pliku toru, sprawdzając spójność rozmiarów.
+ * @param reader Otwarty plik toru.
+ * @return `true` jeśli linia została wczytana.
+ */
+bool TrackCenterline::ReadSections(const TrackFileReader& reader) {
+    Clear();
+
+    CenterlineGridParams grid{};
+    if (!reader.ReadVector(TrackSection::CenterlineSamples, samples) ||
+        !reader.ReadValue(TrackSection::CenterlineGrid, grid) ||
+        !reader.ReadVector(TrackSection::CenterlineCellStart, gridCellStart) ||
+        !reader.ReadVector(TrackSection::CenterlineSegments, gridSegments)) {
+        Clear();
+        return false;
+    }
+
+    bool valid = samples.size() >= 3 && grid.cols > 0 && grid.rows > 0 && grid.cellSize > 0.0f
+        && gridCellStart.size() == (size_t)grid.cols * grid.rows + 1
+        && gridCellStart.back() == gridSegments.size();
+    for (unsigned int index : gridSegments)
+        valid = valid && index < samples.size();
+    if (!valid) {
+        Clear();
+        return false;
+    }
+
+    gridOrigin = glm::vec2(grid.originX, grid.originZ);
+    gridCellSize = grid.cellSize;
+    gridCols = grid.cols;
+    gridRows = grid.rows;
+    length = samples.back().Distance + glm::length(samples.front().Position - samples.back().Position);
+    return true;
+}
+
+/**
+ * @brief Usuwa próbki i siatkę (wektory są podmieniane na puste, żeby oddać pojemność).
+ */
+void TrackCenterline::Clear() {
+    std::vector<CenterlineSample>().swap(samples);
+    std::vector<unsigned int>().swap(gridCellStart);
+    std::vector<unsigned int>().swap(gridSegments);
+    length = 0.0f;
+    gridCols = gridRows = 0;
+}
+
+/**
+ * @brief Wyznacza odcinek i parametr dla dystansu zawiniętego do okrążenia.
+ * @param samples Próbki linii.
+ * @param length Długość okrążenia.
+ * @param distance Dystans.
+ * @param outT Parametr na odcinku (wynik).
+ * @return Indeks odcinka.
+ */
+static int SegmentAt(const std::vector<CenterlineSample>& samples, float length, float distance, float& outT) {
+    distance = std::fmod(distance, length);
+    if (distance < 0.0f) distance += length;
+
+    auto it = std::upper_bound(samples.begin(), samples.end(), distance,
+        [](float d, const CenterlineSample& s) { return d < s.Distance; });
+    int i = std::max(0, (int)(it - samples.begin()) - 1);
+    float end = i + 1 < (int)samples.size() ? samples[i + 1].Distance : length;
+    outT = end > samples[i].Distance ? (distance - samples[i].Distance) / (end - samples[i].Distance) : 0.0f;
+    return i;
+}
+
+/**
+ * @brief Zwraca punkt linii dla dystansu.
+ * @param distance Dystans wzdłuż toru.
+ * @return Pozycja w XZ.
+ */
+glm::vec2 TrackCenterline::PointAt(float distance) const {
+    if (samples.empty()) return glm::vec2(0.0f);
+    float t;
+    int i = SegmentAt(samples, length, distance, t);
+    return glm::mix(samples[i].Position, samples[(i + 1) % samples.size()].Position, t);
+}
+
+/**
+ * @brief Zwraca kierunek odcinka dla dystansu.
+ * @param distance Dystans wzdłuż toru.
+ * @return Jednostkowy kierunek w XZ.
+ */
+glm::vec2 TrackCenterline::DirectionAt(float distance) const {
+    if (samples.empty()) return glm::vec2(0.0f, 1.0f);
+    float t;
+    int i = SegmentAt(samples, length, distance, t);
+    glm::vec2 d = samples[(i + 1) % samples.size()].Position - samples[i].Position;
+    float len = glm::length(d);
+    return len > 1e-6f ? d / len : glm::vec2(0.0f, 1.0f);
+}
+
+/**
+ * @brief Zwraca interpolowaną połowę szerokości toru.
+ * @param distance Dystans wzdłuż toru.
+ * @return Połowa szerokości.
+ */
+float TrackCenterline::HalfWidthAt(float distance) const {
+    if (samples.empty()) return 0.0f;
+    float t;
+    int i = SegmentAt(samples, length, distance, t);
+    return glm::mix(samples[i].HalfWidth, samples[(i + 1) % samples.size()].HalfWidth, t);
+}
+
+/**
+ * @brief Rzut punktu na odcinek `i`.
+ * @param i Indeks odcinka.
+ * @param p Punkt.
+ * @param outT Parametr rzutu (wynik).
+ * @return Kwadrat odległości.
+ */
+float TrackCenterline::SegmentDistance2(int i, const glm::vec2& p, float& outT) const {
+    glm::vec2 a = samples[i].Position;
+    glm::vec2 ab = samples[(size_t)(i + 1) % samples.size()].Position - a;
+    float len2 = glm::dot(ab, ab);
+    outT = len2 > 0.0f ? glm::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+    glm::vec2 d = p - (a + ab * outT);
+    return glm::dot(d, d);
+}
+
+/**
+ * @brief Szuka najbliższego odcinka wśród odcinków komórki; przy braku wyniku w `SearchRadius` przegląda wszystkie.
+ * @param p Punkt.
+ * @param outT Parametr rzutu (wynik).
+ * @return Indeks odcinka.
+ */
+int TrackCenterline::FindNearest(const glm::vec2& p, float& outT) const {
+    int best = 0;
+    float bestD2 = std::numeric_limits<float>::max();
+
+    int cx = (int)std::floor((p.x - gridOrigin.x) / gridCellSize);
+    int cz = (int)std::floor((p.y - gridOrigin.y) / gridCellSize);
+    if (cx >= 0 && cz >= 0 && cx < gridCols && cz < gridRows) {
+        size_t cell = (size_t)cz * gridCols + cx;
+        for (unsigned int k = gridCellStart[cell]; k < gridCellStart[cell + 1]; ++k) {
+            float t;
+            int i = (int)gridSegments[k];
+            float d2 = SegmentDistance2(i, p, t);
+            if (d2 < bestD2) { bestD2 = d2; best = i; outT = t; }
+        }
+    }
+    if (bestD2 <= SearchRadius * SearchRadius) return best;
+
+    for (int i = 0; i < (int)samples.size(); ++i) {
+        float t;
+        float d2 = SegmentDistance2(i, p, t);
+        if (d2 < bestD2) { bestD2 = d2; best = i; outT = t; }
+    }
+    return best;
+}
+
+/**
+ * @brief Rzutuje pozycję na linię: najpierw okno odcinków wokół podpowiedzi, w razie potrzeby siatka.
+ *
+ * Wynik z okna jest przyjmowany, gdy najbliższy odcinek nie leży na brzegu okna (auto nie wyjechało
+ * poza okno) i jest bliżej niż `SearchRadius`.
+ *
+ * @param position Pozycja (używane X i Z).
+ * @param segment Podpowiedź i odcinek wyniku.
+ * @param outLateral Opcjonalnie: odsunięcie od linii.
+ * @return Dystans wzdłuż toru.
+ */
+float TrackCenterline::Project(const glm::vec3& position, int& segment, float* outLateral) const {
+    if (samples.empty()) {
+        segment = -1;
+        if (outLateral) *outLateral = 0.0f;
+        return 0.0f;
+    }
+
+    int n = (int)samples.size();
+    glm::vec2 p(position.x, position.z);
+    int best = -1;
+    float bestT = 0.0f;
+
+    if (segment >= 0 && segment < n) {
+        float bestD2 = std::numeric_limits<float>::max();
+        int bestOffset = 0;
+        for (int o = -WindowBack; o <= WindowForward; ++o) {
+            int i = ((segment + o) % n + n) % n;
+            float t;
+            float d2 = SegmentDistance2(i, p, t);
+            if (d2 < bestD2) { bestD2 = d2; best = i; bestT = t; bestOffset = o; }
+        }
+        bool atEdge = (bestOffset == -WindowBack && bestT == 0.0f) || (bestOffset == WindowForward && bestT == 1.0f);
+        if (atEdge || bestD2 > SearchRadius * SearchRadius) best = -1;
+    }
+    if (best < 0) best = FindNearest(p, bestT);
+
+    const CenterlineSample& a = samples[best];
+    const CenterlineSample& b = samples[(size_t)(best + 1) % n];
+    float segLength = (best + 1 < n ? b.Distance : length) - a.Distance;
+
+    if (outLateral) {
+        glm::vec2 dir = b.Position - a.Position;
+        float len = glm::length(dir);
+        dir = len > 1e-6f ? dir / len : glm::vec2(0.0f, 1.0f);
+        glm::vec2 d = p - (a.Position + (b.Position - a.Position) * bestT);
+        *outLateral = d.x * dir.y - d.y * dir.x;
+    }
+
+    segment = best;
+    float distance = a.Distance + segLength * bestT;
+    return distance < length ? distance : 0.0f;
+}
+
+/**
+ * @brief Aktualizuje postęp auta (dystans w okrążeniu, odsunięcie, dystans wyścigu).
+ * @param progress Postęp auta.
+ * @param position Pozycja auta.
+ */
+void TrackCenterline::UpdateProgress(TrackProgress& progress, const glm::vec3& position) const {
+    if (samples.empty()) return;
+
+    bool first = progress.Segment < 0;
+    float lateral;
+    float distance = Project(position, progress.Segment, &lateral);
+
+    if (first) {
+        // Przed linią startu (np. dalsze rzędy pola startowego) dystans wyścigu jest ujemny.
+        progress.RaceDistance = distance > length * 0.5f ? distance - length : distance;
+    }
+    else {
+        float delta = distance - progress.Distance;
+        if (delta > length * 0.5f) delta -= length;
+        else if (delta < -length * 0.5f) delta += length;
+        progress.RaceDistance += delta;
+    }
+    progress.Distance = distance;
+    progress.Lateral = lateral;
+}
+
+/**
+ * @brief Sumuje pojemności wektorów próbek i siatki.
+ * @return Liczba bajtów.
+ */
+size_t TrackCenterline::GetMemoryBytes() const {
+    return samples.capacity() * sizeof(CenterlineSample)
+        + (gridCellStart.capacity() + gridSegments.capacity()) * sizeof(unsigned int);
+}
@@ -0,0 +1,216 @@
+﻿#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "TrackCollision.h"
+
+class TrackFileReader;
+class TrackFileWriter;
+
+/**
+ * @file TrackCenterline.h
+ * @brief Linia środkowa toru sparametryzowana długością łuku i rzutowanie pozycji na dystans wzdłuż toru.
+ */
+
+ /**
+  * @brief Próbka linii środkowej (16 bajtów, zapisywana wprost w pliku toru).
+  */
+struct CenterlineSample {
+    /** @brief Pozycja w płaszczyźnie XZ (`y` = Z). */
+    glm::vec2 Position;
+
+    /** @brief Dystans od linii startu/mety wzdłuż linii środkowej. */
+    float Distance;
+
+    /** @brief Połowa szerokości toru w tym miejscu. */
+    float HalfWidth;
+};
+
+/**
+ * @brief Postęp auta na torze, aktualizowany co krok przez `TrackCenterline::UpdateProgress`.
+ */
+struct TrackProgress {
+    /** @brief Odcinek linii środkowej z poprzedniego zapytania (-1 = brak, pełne wyszukiwanie). */
+    int Segment = -1;
+
+    /** @brief Dystans od linii startu/mety w bieżącym okrążeniu, w [0, długość toru). */
+    float Distance = 0.0f;
+
+    /** @brief Odsunięcie od linii środkowej (dodatnie po lewej stronie kierunku jazdy). */
+    float Lateral = 0.0f;
+
+    /** @brief Dystans przejechany od startu z uwzględnieniem okrążeń (jazda wstecz go zmniejsza). */
+    float RaceDistance = 0.0f;
+};
+
+/**
+ * @brief Zamknięta linia środkowa toru wyznaczona ze stron toru, z równomiernymi próbkami po długości łuku.
+ *
+ * Dystans 0 leży na linii startu/mety, a kolejne próbki idą w kierunku jazdy. `Project` zamienia pozycję
+ * auta na dystans wzdłuż toru: z podpowiedzią (odcinek z poprzedniego kroku) sprawdza tylko kilka sąsiednich
+ * odcinków, a bez niej — odcinki z komórki jednorodnej siatki (jak w `TrackCollision`). Podpowiedź
+ * rozstrzyga też miejsca, w których tor przebiega blisko samego siebie.
+ *
+ * Na tej podstawie liczone są okrążenia (`LapCounter`), kolejność w wyścigu i minimapa.
+ */
+class TrackCenterline {
+public:
+    /** @brief Domyślny odstęp próbek linii środkowej. */
+    static constexpr float DefaultSpacing = 0.5f;
+
+    /** @brief Maksymalna odległość od linii środkowej obsługiwana przez siatkę (dalej pełny przegląd). */
+    static constexpr float SearchRadius = 4.0f;
+
+    /** @brief Liczba odcinków sprawdzanych wstecz od podpowiedzi. */
+    static constexpr int WindowBack = 4;
+
+    /** @brief Liczba odcinków sprawdzanych naprzód od podpowiedzi. */
+    static constexpr int WindowForward = 8;
+
+    /**
+     * @brief Wyznacza linię środkową ze stron toru (obie zamknięte, w tym samym kierunku) i siatkę zapytań.
+     *
+     * Punkty lewej strony są łączone z najbliższymi punktami prawej, środki wygładzane i próbkowane
+     * co `spacing` od rzutu `start`. Kierunek próbek jest zgodny z `forward`.
+     *
+     * @param leftRaw Polilinia lewej strony.
+     * @param rightRaw Polilinia prawej strony.
+     * @param start Punkt na linii startu/mety (XZ).
+     * @param forward Kierunek jazdy na starcie (XZ).
+     * @param spacing Odstęp próbek.
+     * @param gridCellSize Rozmiar komórki siatki zapytań.
+     */
+    void Build(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+        const glm::vec2& start, const glm::vec2& forward, float spacing = DefaultSpacing, float gridCellSize = 2.0f);
+
+    /**
+     * @brief Dopisuje próbki i siatkę jako sekcje pliku toru.
+     * @param writer Plik toru w budowie.
+     */
+    void WriteSections(TrackFileWriter& writer) const;
+
+    /**
+     * @brief Wczytuje próbki i siatkę z pliku toru.
+     * @param reader Otwarty plik toru.
+     * @return `false` gdy brakuje sekcji lub są niespójne (obiekt jest wtedy pusty).
+     */
+    bool ReadSections(const TrackFileReader& reader);
+
+    /**
+     * @brief Usuwa linię i siatkę.
+     */
+    void Clear();
+
+    /**
+     * @brief Sprawdza, czy linia jest zbudowana.
+     * @return `true` gdy brak próbek.
+     */
+    bool Empty() const { return samples.empty(); }
+
+    /**
+     * @brief Zwraca długość okrążenia wzdłuż linii środkowej.
+     * @return Długość (0 dla pustej linii).
+     */
+    float GetLength() const { return length; }
+
+    /**
+     * @brief Zwraca próbki linii (np. do rysowania minimapy).
+     * @return Referencja do próbek.
+     */
+    const std::vector<CenterlineSample>& GetSamples() const { return samples; }
+
+    /**
+     * @brief Zwraca punkt linii środkowej dla dystansu (zawijany do okrążenia).
+     * @param distance Dystans wzdłuż toru.
+     * @return Pozycja w XZ.
+     */
+    glm::vec2 PointAt(float distance) const;
+
+    /**
+     * @brief Zwraca kierunek jazdy dla dystansu (zawijany do okrążenia).
+     * @param distance Dystans wzdłuż toru.
+     * @return Jednostkowy kierunek w XZ.
+     */
+    glm::vec2 DirectionAt(float distance) const;
+
+    /**
+     * @brief Zwraca połowę szerokości toru dla dystansu (interpolacja między próbkami).
+     * @param distance Dystans wzdłuż toru.
+     * @return Połowa szerokości.
+     */
+    float HalfWidthAt(float distance) const;
+
+    /**
+     * @brief Rzutuje pozycję na linię środkową.
+     * @param position Pozycja w 3D (używane X i Z).
+     * @param segment Podpowiedź: odcinek z poprzedniego zapytania lub -1; nadpisywana odcinkiem wyniku.
+     * @param outLateral Opcjonalnie: odsunięcie od linii (dodatnie po lewej stronie kierunku jazdy).
+     * @return Dystans wzdłuż toru w [0, `GetLength()`) (0 dla pustej linii).
+     */
+    float Project(const glm::vec3& position, int& segment, float* outLateral = nullptr) const;
+
+    /**
+     * @brief Aktualizuje postęp auta: dystans w okrążeniu, odsunięcie i dystans wyścigu.
+     *
+     * Zmiana dystansu między krokami jest zawijana do (-długość/2, długość/2], więc przejazd przez linię
+     * startu/mety zwiększa `RaceDistance` w sposób ciągły, a jazda wstecz go zmniejsza.
+     *
+     * @param progress Postęp auta (pierwsze wywołanie z `Segment == -1` ustala punkt wyjścia).
+     * @param position Pozycja auta.
+     */
+    void UpdateProgress(TrackProgress& progress, const glm::vec3& position) const;
+
+    /**
+     * @brief Szacuje pamięć próbek i siatki.
+     * @return Liczba bajtów (pojemności wektorów).
+     */
+    size_t GetMemoryBytes() const;
+
+private:
+    /** @brief Próbki w kolejności jazdy; odcinek `i` łączy próbkę `i` z `(i + 1) % n`. */
+    std::vector<CenterlineSample> samples;
+
+    /** @brief Długość okrążenia. */
+    float length = 0.0f;
+
+    /** @brief Lewy dolny róg siatki (min X, min Z). */
+    glm::vec2 gridOrigin = glm::vec2(0.0f);
+
+    /** @brief Rozmiar boku komórki siatki. */
+    float gridCellSize = 2.0f;
+
+    /** @brief Liczba komórek siatki w osi X. */
+    int gridCols = 0;
+
+    /** @brief Liczba komórek siatki w osi Z. */
+    int gridRows = 0;
+
+    /** @brief Początki list odcinków komórek (CSR, rozmiar `gridCols * gridRows + 1`). */
+    std::vector<unsigned int> gridCellStart;
+
+    /** @brief Indeksy odcinków pogrupowane według komórek. */
+    std::vector<unsigned int> gridSegments;
+
+    /**
+     * @brief Buduje siatkę nad odcinkami powiększonymi o `SearchRadius`.
+     * @param cellSize Rozmiar boku komórki.
+     */
+    void BuildGrid(float cellSize);
+
+    /**
+     * @brief Rzut punktu na odcinek `i`.
+     * @param i Indeks odcinka.
+     * @param p Punkt (XZ).
+     * @param outT Parametr rzutu [0, 1] (wynik).
+     * @return Kwadrat odległości od odcinka.
+     */
+    float SegmentDistance2(int i, const glm::vec2& p, float& outT) const;
+
+    /**
+     * @brief Szuka najbliższego odcinka w siatce (lub wśród wszystkich, gdy komórka jest pusta).
+     * @param p Punkt (XZ).
+     * @param outT Parametr rzutu na wynikowy odcinek (wynik).
+     * @return Indeks odcinka.
+     */
+    int FindNearest(const glm::vec2& p, float& outT) const;
+};
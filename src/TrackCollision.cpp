@@ -1,8 +1,11 @@
 ﻿#define GLM_ENABLE_EXPERIMENTAL
 #include "TrackCollision.h"
+#include "TrackFile.h"
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
 
 /**
@@ -10,399 +13,45 @@
  * @brief Implementacja budowania ścian toru i testów kolizji okrąg–odcinek w płaszczyźnie XZ.
  */
 
-const std::vector<Point> TrackCollision::leftSideRaw = {
-    {-19.124f, 18.8322f},
-    {-18.3621f, 18.8469f},
-    {-17.6714f, 18.8488f},
-    {-16.8747f, 18.8506f},
-    {-16.2283f, 18.8567f},
-    {-15.5062f, 18.858f},
-    {-14.1185f, 18.8603f},
-    {-12.893f, 18.8958f},
-    {-12.0677f, 18.9086f},
-    {-11.2704f, 18.9115f},
-    {-10.6814f, 18.9118f},
-    {-9.85236f, 18.9223f},
-    {-9.63031f, 18.9251f},
-    {-8.4968f, 18.9216f},
-    {-7.26345f, 18.9217f},
-    {-6.1978f, 18.8438f},
-    {-5.73204f, 18.7423f},
-    {-5.402f, 18.6305f},
-    {-5.25867f, 18.5914f},
-    {-5.0577f, 18.4617f},
-
-    {-4.77516f, 18.1089f},
-    {-4.68288f, 17.8622f},
-    {-4.58455f, 17.5147f},
-    {-4.54266f, 17.1048f},
-    {-4.50888f, 16.4617f},
-    {-4.48243f, 15.8646f},
-    {-4.51048f, 15.3542f},
-    {-4.54622f, 14.9129f},
-    {-4.69389f, 14.0208f},
-    {-4.77225f, 13.4978f},
-    {-4.81595f, 13.2626f},
-    {-4.92984f, 12.9069f},
-    {-5.06403f, 12.6799f},
-    {-5.27429f, 12.5007f},
-    {-5.35112f, 12.4434f},
-    {-5.4939f, 12.37f},
-    {-5.68045f, 12.2954f},
-    {-5.95135f, 12.2002f},
-    {-6.34424f, 12.1094f},
-    {-6.82521f, 12.0222f},
-    {-7.55358f, 11.957f},
-    {-8.13267f, 11.9284f},
-    {-8.91564f, 11.9291f},
-    {-9.3021f, 11.9204f},
-    {-9.73761f, 11.9086f},
-    {-10.9278f, 11.9042f},
-    {-11.4305f, 11.8958f},
-    {-11.9022f, 11.888f},
-    {-12.702f, 11.8969f},
-    {-13.191f, 11.9001f},
-    {-13.4825f, 11.902f},
-    {-13.7938f, 11.9156f},
-    {-14.2568f, 12.1599f},
-    {-14.3979f, 12.3703f},
-    {-14.5319f, 12.7511f},
-    {-14.6053f, 13.031f},
-    {-14.7869f, 13.5014f},
-    {-15.1243f, 14.1439f},
-    {-15.3439f, 14.4343f},
-    {-15.5466f, 14.7023f},
-    {-15.8768f, 15.074f},
-    {-16.1012f, 15.3113f},
-    {-16.3495f, 15.5249f},
-    {-16.795f, 15.9261f},
-    {-17.1708f, 16.2141f},
-    {-17.4748f, 16.4357f},
-    {-17.8592f, 16.6934f},
-    {-18.3888f, 17.0483f},
-    {-18.6903f, 17.2504f},
-    {-19.1994f, 17.5572f},
-    {-19.6411f, 17.7864f},
-    {-20.4637f, 18.1701f},
-    {-21.0645f, 18.4191f},
-    {-21.6013f, 18.6457f},
-    {-22.029f, 18.8157f},
-    {-23.2749f, 19.1941f},
-    {-23.8423f, 19.3292f},
-    {-24.3288f, 19.3911f},
-    {-24.9889f, 19.4182f},
-    {-25.2943f, 19.4251f},
-    {-25.909f, 19.3745f},
-    {-26.5054f, 19.2556f},
-    {-26.8851f, 19.1396f},
-    {-27.3622f, 18.9409f},
-    {-27.6447f, 18.7164f},
-    {-27.8374f, 18.5475f},
-    {-28.1196f, 18.1423f},
-    {-28.3207f, 17.7729f},
-    {-28.4852f, 17.1507f},
-    {-28.507f, 16.772f},
-    {-28.4287f, 16.1707f},
-    {-28.2442f, 15.6542f},
-    {-27.9741f, 15.2241f},
-    {-27.6777f, 14.9493f},
-    {-27.5921f, 14.8776f},
-    {-27.0558f, 14.6008f},
-    {-26.8131f, 14.5164f},
-    {-26.3298f, 14.4288f},
-    {-25.9726f, 14.4115f},
-    {-25.7082f, 14.4027f},
-    {-25.4815f, 14.4033f},
-    {-24.8631f, 14.4552f},
-    {-24.3586f, 14.5271f},
-    {-23.8636f, 14.5837f},
-    {-23.3885f, 14.615f},
-    {-23.0965f, 14.6164f},
-    {-22.8236f, 14.6046f},
-    {-22.4854f, 14.5371f},
-    {-22.2302f, 14.4626f},
-    {-21.8112f, 14.2362f},
-    {-21.4991f, 13.9665f},
-    {-21.3626f, 13.7881f},
-    {-21.1947f, 13.4951f},
-    {-21.0055f, 13.0737f},
-    {-20.9304f, 12.8086f},
-    {-20.892f, 12.5106f},
-    {-20.9026f, 12.2051f},
-    {-21.0489f, 11.8393f},
-    {-21.3954f, 11.5123f},
-    {-21.5975f, 11.4632f},
-    {-21.9012f, 11.4293f},
-    {-22.4123f, 11.4359f},
-    {-22.8403f, 11.4617f},
-    {-23.2021f, 11.5264f},
-    {-23.5989f, 11.6106f},
-    {-24.1108f, 11.7336f},
-    {-24.5699f, 11.8615f},
-    {-25.2532f, 12.0575f},
-    {-25.6764f, 12.1896f},
-    {-25.9823f, 12.2863f},
-    {-26.4664f, 12.4543f},
-    {-27.1173f, 12.7034f},
-    {-27.6896f, 12.9433f},
-    {-28.2835f, 13.2663f},
-    {-28.6902f, 13.4864f},
-    {-29.083f, 13.7267f},
-    {-29.2723f, 13.8481f},
-    {-29.7213f, 14.2125f},
-    {-30.0157f, 14.538f},
-    {-30.345f, 15.1541f},
-    {-30.4951f, 15.6302f},
-    {-30.5404f, 16.495f},
-    {-30.5395f, 16.3574f},
-    {-30.4762f, 16.6626f},
-    {-30.4034f, 17.0136f},
-    {-30.3102f, 17.3273f},
-    {-30.1644f, 17.7889f},
-    {-30.0627f, 18.096f},
-    {-29.7879f, 18.6433f},
-    {-29.6163f, 18.9502f},
-    {-29.1521f, 19.5569f},
-    {-28.7327f, 19.9858f},
-    {-28.6744f, 20.0404f},
-    {-28.3386f, 20.2991f},
-    {-27.9476f, 20.5428f},
-    {-27.6145f, 20.6841f},
-    {-27.0821f, 20.8307f},
-    {-26.5616f, 20.9406f},
-    {-26.15f, 21.0091f},
-    {-25.6162f, 21.0194f},
-    {-25.0396f, 20.9904f},
-    {-24.5336f, 20.8864f},
-    {-24.1584f, 20.7799f},
-    {-23.7088f, 20.6305f},
-    {-22.1137f, 19.8101f},
-    {-21.3104f, 19.4231f},
-    {-20.7568f, 19.1936f},
-    {-20.3852f, 19.0498f},
-    {-20.0332f, 18.9383f},
-    {-19.6369f, 18.8733f},
-    {-19.3346f, 18.8403f},
-    {-19.0613f, 18.8139f},
-    {-18.7617f, 18.8101f},
-    {-18.6596f, 18.821f}
-};
+ /**
+  * @brief Wybór wariantu jądra kolizji na etapie kompilacji.
+  *
+  * - `RACING3D_COLLISION_SCALAR` wymusza pętlę skalarną (np. do porównań),
+  * - `__AVX2__` (GCC/Clang `-mavx2`, MSVC `/arch:AVX2`) włącza 8 odcinków na instrukcję,
+  * - SSE2 (zawsze dostępne na x64) włącza 4 odcinki na instrukcję,
+  * - na innych platformach używana jest pętla skalarna.
+  */
+#if defined(RACING3D_COLLISION_SCALAR)
+#define TRACKCOL_SIMD_WIDTH 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define TRACKCOL_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRACKCOL_SIMD_WIDTH 4
+#else
+#define TRACKCOL_SIMD_WIDTH 1
+#endif
 
-const std::vector<Point> TrackCollision::rightSideRaw = {
-{-19.563, 20.7479},
-{ -19.2772, 20.7266 },
-{ -19.0216, 20.7007 },
-{ -18.5008, 20.6983 },
-{ -17.8802, 20.7051 },
-{ -17.2214, 20.7049 },
-{ -16.7152, 20.7048 },
-{ -16.1244, 20.7227 },
-{ -15.3718, 20.7291 },
-{ -14.8953, 20.7291 },
-{ -14.1196, 20.7505 },
-{ -13.4908, 20.7594 },
-{ -13.075, 20.759 },
-{ -12.7121, 20.7586 },
-{ -12.2469, 20.7581 },
-{ -11.595, 20.7709 },
-{ -11.0347, 20.7923 },
-{ -10.4963, 20.7764 },
-{ -10.1131, 20.8033 },
-{ -9.3348, 20.7846 },
-{ -8.79905, 20.7855 },
-{ -8.31909, 20.7864 },
-{ -7.7051, 20.7876 },
-{ -6.95864, 20.7691 },
-{ -6.62954, 20.7509 },
-{ -5.64774, 20.5923 },
-{ -5.23162, 20.5199 },
-{ -4.98464, 20.4339 },
-{ -4.70835, 20.3453 },
-{ -4.46931, 20.2389 },
-{ -4.25381, 20.1431 },
-{ -4.06837, 20.029 },
-{ -3.85239, 19.8597 },
-{ -3.64104, 19.6877 },
-{ -3.56586, 19.6088 },
-{ -3.45311, 19.4568 },
-{ -3.35313, 19.3221 },
-{ -3.20793, 19.0924 },
-{ -3.0409, 18.7752 },
-{ -2.9166, 18.4976 },
-{ -2.76232, 17.9864 },
-{ -2.66695, 17.3816 },
-{ -2.6283, 16.7282 },
-{ -2.64615, 15.9371 },
-{ -2.71154, 14.8986 },
-{ -2.84509, 13.713 },
-{ -2.92453, 13.256 },
-{ -2.96957, 12.9969 },
-{ -3.0341, 12.7821 },
-{ -3.10352, 12.5218 },
-{ -3.32262, 12.0189 },
-{ -3.43282, 11.8334 },
-{ -3.64544, 11.5554 },
-{ -4.20215, 11.0435 },
-{ -4.62532, 10.7589 },
-{ -5.36218, 10.457 },
-{ -5.4288, 10.4108 },
-{ -5.85565, 10.3023 },
-{ -6.41962, 10.1832 },
-{ -6.80617, 10.1579 },
-{ -7.18334, 10.1048 },
-{ -7.67473, 10.0959 },
-{ -8.65258, 10.0776 },
-{ -9.6524, 10.0647 },
-{ -10.2374, 10.0687 },
-{ -11.0211, 10.0498 },
-{ -11.7909, 10.044 },
-{ -12.4136, 10.0604 },
-{ -13.1213, 10.0586 },
-{ -13.6217, 10.0624 },
-{ -13.9874, 10.1001 },
-{ -14.5264, 10.18 },
-{ -14.8839, 10.335 },
-{ -15.2486, 10.5465 },
-{ -15.4396, 10.6924 },
-{ -15.8932, 11.2169 },
-{ -15.8044, 11.0791 },
-{ -16.0235, 11.4162 },
-{ -16.0585, 11.5292 },
-{ -16.2582, 11.9785 },
-{ -16.3366, 12.3208 },
-{ -16.4962, 12.6741 },
-{ -16.8361, 13.3111 },
-{ -17.1268, 13.6648 },
-{ -17.4153, 13.986 },
-{ -17.9392, 14.4611 },
-{ -18.1853, 14.6508 },
-{ -18.5292, 14.9159 },
-{ -18.9823, 15.2393 },
-{ -19.4707, 15.5581 },
-{ -19.7623, 15.7483 },
-{ -19.9737, 15.8863 },
-{ -20.6176, 16.2079 },
-{ -20.9729, 16.3653 },
-{ -21.3622, 16.541 },
-{ -22.0961, 16.8378 },
-{ -22.3575, 16.9408 },
-{ -22.6852, 17.0681 },
-{ -23.3233, 17.2712 },
-{ -24.2617, 17.4677 },
-{ -24.9034, 17.5542 },
-{ -25.6521, 17.5651 },
-{ -26.2893, 17.4069 },
-{ -26.5852, 17.1372 },
-{ -26.6176, 16.9313 },
-{ -26.6401, 16.697 },
-{ -26.4896, 16.3546 },
-{ -26.188, 16.2781 },
-{ -25.9817, 16.256 },
-{ -25.7086, 16.2398 },
-{ -25.4778, 16.2668 },
-{ -25.0148, 16.3078 },
-{ -25.0053, 16.3091 },
-{ -24.4944, 16.3813 },
-{ -24.1747, 16.4264 },
-{ -23.8435, 16.4507 },
-{ -23.4299, 16.482 },
-{ -22.9996, 16.4638 },
-{ -22.5539, 16.4252 },
-{ -22.2442, 16.353 },
-{ -21.8892, 16.2767 },
-{ -21.3995, 16.0899 },
-{ -21.03, 15.9323 },
-{ -20.5591, 15.6164 },
-{ -20.267, 15.3391 },
-{ -19.7947, 14.7851 },
-{ -19.6097, 14.4595 },
-{ -19.4778, 14.1693 },
-{ -19.368, 13.9267 },
-{ -19.2182, 13.5957 },
-{ -19.1068, 13.1937 },
-{ -19.0532, 12.6847 },
-{ -19.0472, 12.4408 },
-{ -19.0834, 11.9565 },
-{ -19.1234, 11.633 },
-{ -19.3004, 11.1728 },
-{ -19.6051, 10.6963 },
-{ -19.9863, 10.1921 },
-{ -20.4111, 9.92814 },
-{ -20.7106, 9.77946 },
-{ -21.1154, 9.65315 },
-{ -21.5703, 9.57718 },
-{ -22.0754, 9.54411 },
-{ -22.6274, 9.59496 },
-{ -23.2368, 9.67248 },
-{ -23.5621, 9.70908 },
-{ -24.0979, 9.83229 },
-{ -24.5347, 9.92592 },
-{ -24.9881, 10.0231 },
-{ -25.3744, 10.1469 },
-{ -25.9343, 10.3206 },
-{ -26.3687, 10.4802 },
-{ -27.0976, 10.7436 },
-{ -27.3857, 10.8477 },
-{ -27.6619, 10.9475 },
-{ -27.9602, 11.0553 },
-{ -28.3686, 11.2468 },
-{ -28.9367, 11.5256 },
-{ -29.5288, 11.8548 },
-{ -29.9706, 12.1212 },
-{ -30.3368, 12.3839 },
-{ -30.6953, 12.6778 },
-{ -31.1968, 13.1448 },
-{ -31.4442, 13.4324 },
-{ -31.7365, 13.8139 },
-{ -31.9514, 14.2228 },
-{ -32.1451, 14.631 },
-{ -32.3478, 15.3621 },
-{ -32.4488, 15.9042 },
-{ -32.427, 16.3068 },
-{ -32.3803, 16.6192 },
-{ -32.2773, 17.2676 },
-{ -32.0689, 17.966 },
-{ -31.5539, 19.2152 },
-{ -31.3037, 19.7416 },
-{ -30.9415, 20.2781 },
-{ -30.6748, 20.6483 },
-{ -30.3747, 20.986 },
-{ -29.7589, 21.5274 },
-{ -29.1988, 21.9715 },
-{ -28.7716, 22.1902 },
-{ -28.3503, 22.3762 },
-{ -27.9872, 22.5194 },
-{ -27.4556, 22.6598 },
-{ -26.7801, 22.7897 },
-{ -26.8391, 22.7903 },
-{ -26.4692, 22.8263 },
-{ -25.9558, 22.8687 },
-{ -25.6035, 22.8715 },
-{ -25.2702, 22.8742 },
-{ -25.0177, 22.8472 },
-{ -24.6023, 22.8106 },
-{ -24.0232, 22.701 },
-{ -23.6134, 22.5849 },
-{ -23.3187, 22.4853 },
-{ -22.9459, 22.356 },
-{ -22.5371, 22.1571 },
-{ -22.1111, 21.95 },
-{ -21.691, 21.7139 },
-{ -21.5459, 21.6379 },
-{ -21.3783, 21.5499 },
-{ -21.073, 21.3898 },
-{ -20.7732, 21.2325 },
-{ -20.576, 21.1609 },
-{ -20.1873, 20.9954 },
-{ -19.7469, 20.8141 },
-{ -19.519, 20.7319 },
-{ -19.29, 20.6897 },
-{ -18.9545, 20.6843 },
-{ -18.5497, 20.6779 },
-{ -18.223, 20.7076 },
-};
+/**
+ * @brief Parametry siatki zapytań zapisywane w sekcji `TrackSection::Grid`.
+ */
+struct GridParams {
+    /** @brief Lewy dolny róg siatki (X). */
+    float originX;
+
+    /** @brief Lewy dolny róg siatki (Z). */
+    float originZ;
 
-std::vector<WallSegment> TrackCollision::walls;
+    /** @brief Rozmiar boku komórki. */
+    float cellSize;
+
+    /** @brief Liczba kolumn. */
+    int32_t cols;
+
+    /** @brief Liczba wierszy. */
+    int32_t rows;
+};
 
 /**
  * @brief Usuwa punkty z polilinii, które są zbyt blisko siebie (filtr dystansu).
@@ -439,33 +88,45 @@ static float PerpDist(const glm::vec2& a, const glm::vec2& b, const glm::vec2& p
 }
 
 /**
- * @brief Uproszczenie polilinii algorytmem Ramer–Douglas–Peucker.
- * @param pts Wejściowa polilinia.
+ * @brief Uproszczenie polilinii algorytmem Ramer–Douglas–Peucker (w miejscu, na indeksach).
+ *
+ * Zamiast rekurencji kopiującej podzakresy używany jest stos par indeksów `[first, last]`
+ * i flagi zachowanych punktów; na końcu polilinia jest zagęszczana w tym samym wektorze.
+ * Wynik jest identyczny z wersją rekurencyjną (podział w pierwszym punkcie o największej odległości).
+ *
+ * @param pts Polilinia (modyfikowana).
  * @param eps Tolerancja uproszczenia (większa = mniej punktów).
- * @param out Wynikowa uproszczona polilinia.
- */
-static void RDP(const std::vector<glm::vec2>& pts, float eps, std::vector<glm::vec2>& out) {
-    if (pts.size() < 2) { out = pts; return; }
-    float maxd = 0.0f;
-    size_t idx = 0;
-    for (size_t i = 1; i + 1 < pts.size(); ++i) {
-        float d = PerpDist(pts.front(), pts.back(), pts[i]);
-        if (d > maxd) { maxd = d; idx = i; }
-    }
-    if (maxd > eps) {
-        std::vector<glm::vec2> left, right;
-        std::vector<glm::vec2> a(pts.begin(), pts.begin() + idx + 1);
-        std::vector<glm::vec2> b(pts.begin() + idx, pts.end());
-        RDP(a, eps, left);
-        RDP(b, eps, right);
-        out = left;
-        out.insert(out.end(), right.begin() + 1, right.end());
-    }
-    else {
-        out.clear();
-        out.push_back(pts.front());
-        out.push_back(pts.back());
+ */
+static void RDP(std::vector<glm::vec2>& pts, float eps) {
+    if (pts.size() < 3) return;
+
+    std::vector<unsigned char> keep(pts.size(), 0);
+    keep.front() = keep.back() = 1;
+
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, pts.size() - 1);
+    while (!stack.empty()) {
+        size_t first = stack.back().first;
+        size_t last = stack.back().second;
+        stack.pop_back();
+
+        float maxd = 0.0f;
+        size_t idx = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            float d = PerpDist(pts[first], pts[last], pts[i]);
+            if (d > maxd) { maxd = d; idx = i; }
+        }
+        if (maxd <= eps) continue;
+
+        keep[idx] = 1;
+        stack.emplace_back(idx, last);
+        stack.emplace_back(first, idx);
     }
+
+    size_t n = 0;
+    for (size_t i = 0; i < pts.size(); ++i)
+        if (keep[i]) pts[n++] = pts[i];
+    pts.resize(n);
 }
 
 /**
@@ -490,6 +151,108 @@ static void SmoothPolyline(std::vector<glm::vec2>& pts, int radius = 1) {
     }
 }
 
+/**
+ * @brief Drzewo k-d (2D) nad punktami polilinii do zapytań o najbliższy punkt.
+ *
+ * Drzewo jest niejawne: węzłem zakresu `[lo, hi)` tablicy `order` jest jego środek, a osie podziału
+ * zmieniają się naprzemiennie (X, Z, X, ...). Budowa to `std::nth_element` na każdym poziomie (O(n log n)),
+ * zapytanie odwiedza zwykle O(log n) węzłów niezależnie od odległości punktu zapytania od polilinii.
+ */
+struct PointKdTree {
+    /** @brief Maksymalny rozmiar liścia przeglądanego liniowo. */
+    static constexpr size_t LeafSize = 8;
+
+    /** @brief Punkty, nad którymi zbudowano drzewo (muszą żyć dłużej niż drzewo). */
+    const std::vector<glm::vec2>* points = nullptr;
+
+    /** @brief Indeksy punktów w kolejności drzewa. */
+    std::vector<unsigned int> order;
+
+    /**
+     * @brief Buduje drzewo nad punktami.
+     * @param pts Punkty.
+     */
+    void Build(const std::vector<glm::vec2>& pts) {
+        points = &pts;
+        order.resize(pts.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = (unsigned int)i;
+        build(0, order.size(), 0);
+    }
+
+    /**
+     * @brief Znajduje najbliższy punkt (przy remisie — o najmniejszym indeksie, jak pełny przegląd).
+     * @param q Punkt zapytania.
+     * @param outIndex Indeks najbliższego punktu (wynik).
+     * @param outDist2 Kwadrat odległości (wynik).
+     * @return `false` gdy drzewo jest puste.
+     */
+    bool Nearest(const glm::vec2& q, size_t& outIndex, float& outDist2) const {
+        if (order.empty()) return false;
+        outIndex = order.size();
+        outDist2 = std::numeric_limits<float>::max();
+        nearest(0, order.size(), 0, q, outIndex, outDist2);
+        return true;
+    }
+
+private:
+    /**
+     * @brief Ustawia medianę zakresu w jego środku i rekurencyjnie dzieli obie połowy.
+     * @param lo Początek zakresu.
+     * @param hi Koniec zakresu.
+     * @param axis Oś podziału (0 = X, 1 = Z).
+     */
+    void build(size_t lo, size_t hi, int axis) {
+        if (hi - lo <= LeafSize) return;
+        size_t mid = (lo + hi) / 2;
+        const std::vector<glm::vec2>& pts = *points;
+        std::nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+            [&](unsigned int a, unsigned int b) { return pts[a][axis] < pts[b][axis]; });
+        build(lo, mid, axis ^ 1);
+        build(mid + 1, hi, axis ^ 1);
+    }
+
+    /**
+     * @brief Uwzględnia punkt jako kandydata.
+     * @param i Indeks punktu.
+     * @param q Punkt zapytania.
+     * @param bestIndex Najlepszy indeks (aktualizowany).
+     * @param bestDist2 Najlepszy kwadrat odległości (aktualizowany).
+     */
+    void consider(size_t i, const glm::vec2& q, size_t& bestIndex, float& bestDist2) const {
+        float d2 = glm::distance2(q, (*points)[i]);
+        if (d2 < bestDist2 || (d2 == bestDist2 && i < bestIndex)) { bestDist2 = d2; bestIndex = i; }
+    }
+
+    /**
+     * @brief Przeszukuje zakres: najpierw stronę podziału z punktem zapytania, drugą tylko gdy może być bliżej.
+     * @param lo Początek zakresu.
+     * @param hi Koniec zakresu.
+     * @param axis Oś podziału zakresu.
+     * @param q Punkt zapytania.
+     * @param bestIndex Najlepszy indeks (aktualizowany).
+     * @param bestDist2 Najlepszy kwadrat odległości (aktualizowany).
+     */
+    void nearest(size_t lo, size_t hi, int axis, const glm::vec2& q, size_t& bestIndex, float& bestDist2) const {
+        if (hi - lo <= LeafSize) {
+            for (size_t k = lo; k < hi; ++k) consider(order[k], q, bestIndex, bestDist2);
+            return;
+        }
+
+        size_t mid = (lo + hi) / 2;
+        consider(order[mid], q, bestIndex, bestDist2);
+
+        float diff = q[axis] - (*points)[order[mid]][axis];
+        if (diff < 0.0f) {
+            nearest(lo, mid, axis ^ 1, q, bestIndex, bestDist2);
+            if (diff * diff <= bestDist2) nearest(mid + 1, hi, axis ^ 1, q, bestIndex, bestDist2);
+        }
+        else {
+            nearest(mid + 1, hi, axis ^ 1, q, bestIndex, bestDist2);
+            if (diff * diff <= bestDist2) nearest(lo, mid, axis ^ 1, q, bestIndex, bestDist2);
+        }
+    }
+};
+
 /**
  * @brief Buduje ściany z dwóch stron toru i odfiltrowuje fragmenty o zbyt małej szerokości.
  *
@@ -500,6 +263,9 @@ static void SmoothPolyline(std::vector<glm::vec2>& pts, int radius = 1) {
  * - uproszczenie RDP,
  * - odfiltrowanie segmentów, gdzie „odległość do przeciwnej strony” jest zbyt mała.
  *
+ * Najbliższy punkt przeciwnej strony (dla środka każdego odcinka) wyszukiwany jest w drzewie k-d,
+ * więc całość kosztuje O((n + m) log(n + m)) zamiast O(n·m).
+ *
  * @param leftRaw Polilinia lewej strony (surowe punkty).
  * @param rightRaw Polilinia prawej strony (surowe punkty).
  * @param outWalls Wynikowe segmenty ścian.
@@ -525,29 +291,20 @@ static void BuildWallsFromSides(
     SmoothPolyline(left, 1);
     SmoothPolyline(right, 1);
 
-    std::vector<glm::vec2> leftS, rightS;
-    RDP(left, 0.02f, leftS);
-    RDP(right, 0.02f, rightS);
+    RDP(left, 0.02f);
+    RDP(right, 0.02f);
 
-    auto avgDistToOther = [&](const glm::vec2& a, const glm::vec2& b, const std::vector<glm::vec2>& other) {
-        glm::vec2 mid = (a + b) * 0.5f;
-        float minD = std::numeric_limits<float>::max();
-        for (const auto& p : other) {
-            float d = glm::distance(mid, p);
-            if (d < minD) minD = d;
-        }
-        return minD;
-        };
+    PointKdTree leftTree, rightTree;
+    leftTree.Build(left);
+    rightTree.Build(right);
 
-    auto nearestPointInPolyline = [&](const glm::vec2& mid, const std::vector<glm::vec2>& other) {
-        glm::vec2 best(0.0f);
-        if (other.empty()) return best;
-        float minD2 = std::numeric_limits<float>::max();
-        for (const auto& p : other) {
-            float d2 = glm::distance2(mid, p);
-            if (d2 < minD2) { minD2 = d2; best = p; }
-        }
-        return best;
+    auto nearestOnOther = [](const PointKdTree& tree, const glm::vec2& mid, glm::vec2& outNearest, float& outDist) {
+        size_t index;
+        float dist2;
+        if (!tree.Nearest(mid, index, dist2)) return false;
+        outNearest = (*tree.points)[index];
+        outDist = std::sqrt(dist2);
+        return true;
         };
 
     const float MIN_TRACK_WIDTH = minTrackWidth;
@@ -555,13 +312,14 @@ static void BuildWallsFromSides(
 
     const float LEFT_SHIFT = 0.30f;
 
-    for (size_t i = 0; i + 1 < leftS.size(); ++i) {
-        glm::vec2 a = leftS[i];
-        glm::vec2 b = leftS[i + 1];
-        float d = avgDistToOther(a, b, rightS);
+    for (size_t i = 0; i + 1 < left.size(); ++i) {
+        glm::vec2 a = left[i];
+        glm::vec2 b = left[i + 1];
+        glm::vec2 mid = (a + b) * 0.5f;
+        glm::vec2 nearest;
+        float d;
+        if (!nearestOnOther(rightTree, mid, nearest, d)) break;
         if (d > (MIN_TRACK_WIDTH * 0.5f) && d < MAX_TRACK_WIDTH) {
-            glm::vec2 mid = (a + b) * 0.5f;
-            glm::vec2 nearest = nearestPointInPolyline(mid, rightS);
             glm::vec2 toOther = nearest - mid;
             glm::vec2 ab = b - a;
             float len = glm::length(ab);
@@ -576,10 +334,12 @@ static void BuildWallsFromSides(
         }
     }
 
-    for (size_t i = 0; i + 1 < rightS.size(); ++i) {
-        glm::vec2 a = rightS[i];
-        glm::vec2 b = rightS[i + 1];
-        float d = avgDistToOther(a, b, leftS);
+    for (size_t i = 0; i + 1 < right.size(); ++i) {
+        glm::vec2 a = right[i];
+        glm::vec2 b = right[i + 1];
+        glm::vec2 nearest;
+        float d;
+        if (!nearestOnOther(leftTree, (a + b) * 0.5f, nearest, d)) break;
         if (d > (MIN_TRACK_WIDTH * 0.5f) && d < MAX_TRACK_WIDTH) {
             outWalls.push_back({ a, b });
         }
@@ -594,99 +354,876 @@ static void BuildWallsFromSides(
 }
 
 /**
- * @brief Inicjalizuje system kolizji i buduje segmenty ścian.
+ * @brief Buduje odcinki ścian z dowolnych polilinii stron toru (bez zmiany stanu klasy).
+ * @param leftRaw Polilinia lewej strony.
+ * @param rightRaw Polilinia prawej strony.
+ * @param minTrackWidth Minimalna szerokość toru używana przy filtracji.
+ * @param outWalls Wynikowe odcinki.
+ */
+void TrackCollision::BuildWalls(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+    float minTrackWidth, std::vector<WallSegment>& outWalls) {
+    BuildWallsFromSides(leftRaw, rightRaw, outWalls, minTrackWidth);
+}
+
+/**
+ * @brief Buduje segmenty ścian z polilinii stron toru i siatkę przestrzenną.
+ * @param leftRaw Polilinia lewej strony.
+ * @param rightRaw Polilinia prawej strony.
  * @param minTrackWidth Minimalna szerokość toru używana do filtrowania.
+ * @param gridCellSize Rozmiar boku komórki siatki.
  */
-void TrackCollision::Init(float minTrackWidth) {
+void TrackCollision::Init(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw, float minTrackWidth, float gridCellSize) {
     walls.clear();
-    BuildWallsFromSides(leftSideRaw, rightSideRaw, walls, minTrackWidth);
+    ReleaseDistanceField();
+    BuildWallsFromSides(leftRaw, rightRaw, walls, minTrackWidth);
+    BuildGrid(gridCellSize);
+}
+
+/**
+ * @brief Zapisuje ściany, parametry i tablice siatki oraz pole odległości jako sekcje pliku toru.
+ * @param writer Plik toru w budowie.
+ */
+void TrackCollision::WriteSections(TrackFileWriter& writer) const {
+    writer.AddVector(TrackSection::Walls, walls);
+
+    GridParams grid{ gridOrigin.x, gridOrigin.y, gridCellSize, gridCols, gridRows };
+    writer.AddValue(TrackSection::Grid, grid);
+    writer.AddVector(TrackSection::GridCellStart, gridCellStart);
+    writer.AddVector(TrackSection::GridSegments, gridSegments);
+
+    std::vector<float> soa;
+    soa.reserve(gridWalls.size() * 4);
+    soa.insert(soa.end(), gridWalls.ax.begin(), gridWalls.ax.end());
+    soa.insert(soa.end(), gridWalls.ay.begin(), gridWalls.ay.end());
+    soa.insert(soa.end(), gridWalls.bx.begin(), gridWalls.bx.end());
+    soa.insert(soa.end(), gridWalls.by.begin(), gridWalls.by.end());
+    writer.AddVector(TrackSection::GridWalls, soa);
+
+    if (HasDistanceField()) {
+        writer.AddValue(TrackSection::DistanceHeader, distanceHeader);
+        writer.AddVector(TrackSection::DistanceSamples, distanceSamples);
+    }
+}
+
+/**
+ * @brief Wczytuje ściany, siatkę i pole odległości z pliku toru, sprawdzając spójność rozmiarów.
+ *
+ * Pole odległości jest pomijane (bez błędu), jeśli ma inną wersję lub nie pasuje do wczytanych ścian.
+ *
+ * @param reader Otwarty plik toru.
+ * @return `true` jeśli ściany i siatka zostały wczytane.
+ */
+bool TrackCollision::ReadSections(const TrackFileReader& reader) {
+    Shutdown();
+
+    GridParams grid{};
+    std::vector<float> soa;
+    if (!reader.ReadVector(TrackSection::Walls, walls) ||
+        !reader.ReadValue(TrackSection::Grid, grid) ||
+        !reader.ReadVector(TrackSection::GridCellStart, gridCellStart) ||
+        !reader.ReadVector(TrackSection::GridSegments, gridSegments) ||
+        !reader.ReadVector(TrackSection::GridWalls, soa)) {
+        Shutdown();
+        return false;
+    }
+
+    bool valid = grid.cols >= 0 && grid.rows >= 0 && grid.cellSize > 0.0f
+        && soa.size() == gridSegments.size() * 4
+        && (walls.empty() ? gridCellStart.empty() : gridCellStart.size() == (size_t)grid.cols * grid.rows + 1)
+        && (gridCellStart.empty() || gridCellStart.back() == gridSegments.size());
+    for (unsigned int index : gridSegments)
+        valid = valid && index < walls.size();
+    if (!valid) {
+        Shutdown();
+        return false;
+    }
+
+    gridOrigin = glm::vec2(grid.originX, grid.originZ);
+    gridCellSize = grid.cellSize;
+    gridCols = grid.cols;
+    gridRows = grid.rows;
+
+    size_t n = gridSegments.size();
+    gridWalls.ax.assign(soa.begin(), soa.begin() + n);
+    gridWalls.ay.assign(soa.begin() + n, soa.begin() + 2 * n);
+    gridWalls.bx.assign(soa.begin() + 2 * n, soa.begin() + 3 * n);
+    gridWalls.by.assign(soa.begin() + 3 * n, soa.end());
+
+    DistanceFieldHeader header{};
+    if (reader.ReadValue(TrackSection::DistanceHeader, header) &&
+        std::memcmp(header.magic, "R3DF", 4) == 0 && header.version == DistanceFieldVersion &&
+        header.cols >= 2 && header.rows >= 2 && header.cellSize > 0.0f && header.maxDistance > 0.0f &&
+        header.wallsHash == HashWalls() &&
+        reader.ReadVector(TrackSection::DistanceSamples, distanceSamples) &&
+        distanceSamples.size() == (size_t)header.cols * header.rows) {
+        distanceHeader = header;
+    }
+    else {
+        ReleaseDistanceField();
+    }
+    return true;
+}
+
+/**
+ * @brief Zwalnia pamięć ścian i siatki (wektory są podmieniane na puste, żeby oddać pojemność).
+ */
+void TrackCollision::Shutdown() {
+    std::vector<WallSegment>().swap(walls);
+    std::vector<unsigned int>().swap(gridCellStart);
+    std::vector<unsigned int>().swap(gridSegments);
+    gridWalls = WallSoA();
+    gridCols = gridRows = 0;
+    ReleaseDistanceField();
+}
+
+/**
+ * @brief Sumuje pojemności wektorów ścian i siatki.
+ * @return Liczba bajtów.
+ */
+size_t TrackCollision::GetMemoryBytes() const {
+    return walls.capacity() * sizeof(WallSegment)
+        + (gridCellStart.capacity() + gridSegments.capacity()) * sizeof(unsigned int)
+        + (gridWalls.ax.capacity() + gridWalls.ay.capacity() + gridWalls.bx.capacity() + gridWalls.by.capacity()) * sizeof(float)
+        + distanceSamples.capacity() * sizeof(DistanceSample);
+}
+
+/**
+ * @brief Buduje siatkę (CSR) przypisującą odcinki do komórek pokrytych przez ich AABB.
+ *
+ * Budowa jest dwuprzebiegowa: najpierw zliczenie odcinków na komórkę, potem wypełnienie
+ * jednej ciągłej tablicy indeksów (bez alokacji per komórka).
+ *
+ * @param cellSize Rozmiar boku komórki.
+ */
+void TrackCollision::BuildGrid(float cellSize) {
+    gridCellStart.clear();
+    gridSegments.clear();
+    gridWalls.clear();
+    gridCols = gridRows = 0;
+    gridCellSize = cellSize > 1e-3f ? cellSize : 1.0f;
+    if (walls.empty()) return;
+
+    glm::vec2 minP(std::numeric_limits<float>::max());
+    glm::vec2 maxP(-std::numeric_limits<float>::max());
+    for (const auto& w : walls) {
+        minP = glm::min(minP, glm::min(w.start, w.end));
+        maxP = glm::max(maxP, glm::max(w.start, w.end));
+    }
+
+    gridOrigin = minP;
+    gridCols = std::max(1, (int)std::ceil((maxP.x - minP.x) / gridCellSize));
+    gridRows = std::max(1, (int)std::ceil((maxP.y - minP.y) / gridCellSize));
+
+    auto cellOf = [&](float v, float origin, int count) {
+        return glm::clamp((int)std::floor((v - origin) / gridCellSize), 0, count - 1);
+        };
+
+    std::vector<unsigned int> counts((size_t)gridCols * gridRows + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < walls.size(); ++i) {
+            const WallSegment& w = walls[i];
+            int x0 = cellOf(std::min(w.start.x, w.end.x), gridOrigin.x, gridCols);
+            int x1 = cellOf(std::max(w.start.x, w.end.x), gridOrigin.x, gridCols);
+            int z0 = cellOf(std::min(w.start.y, w.end.y), gridOrigin.y, gridRows);
+            int z1 = cellOf(std::max(w.start.y, w.end.y), gridOrigin.y, gridRows);
+            for (int z = z0; z <= z1; ++z) {
+                for (int x = x0; x <= x1; ++x) {
+                    size_t cell = (size_t)z * gridCols + x;
+                    if (pass == 0) counts[cell]++;
+                    else gridSegments[counts[cell]++] = (unsigned int)i;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            gridCellStart.assign(counts.size(), 0);
+            unsigned int sum = 0;
+            for (size_t c = 0; c + 1 < counts.size(); ++c) {
+                gridCellStart[c] = sum;
+                sum += counts[c];
+            }
+            gridCellStart.back() = sum;
+            gridSegments.resize(sum);
+            std::copy(gridCellStart.begin(), gridCellStart.end(), counts.begin());
+        }
+    }
+
+    gridWalls.resize(gridSegments.size());
+    for (size_t k = 0; k < gridSegments.size(); ++k) {
+        gridWalls.set(k, walls[gridSegments[k]]);
+    }
+}
+
+/**
+ * @brief Skalarny test okrąg–odcinek (ta sama kolejność działań co wersje SIMD).
+ * @param ax Początek odcinka, X.
+ * @param ay Początek odcinka, Z.
+ * @param bx Koniec odcinka, X.
+ * @param by Koniec odcinka, Z.
+ * @param px Środek okręgu, X.
+ * @param py Środek okręgu, Z.
+ * @param r2 Kwadrat promienia.
+ * @param outDist2 Kwadrat odległości środka od odcinka (wynik).
+ * @return `true` jeśli okrąg przecina odcinek.
+ */
+static inline bool SegmentContact(float ax, float ay, float bx, float by, float px, float py, float r2, float& outDist2) {
+    float abx = bx - ax;
+    float aby = by - ay;
+    float abLen2 = abx * abx + aby * aby;
+    if (abLen2 <= 1e-8f) return false;
+
+    float t = glm::clamp(((px - ax) * abx + (py - ay) * aby) / abLen2, 0.0f, 1.0f);
+    float dx = px - (ax + t * abx);
+    float dy = py - (ay + t * aby);
+    outDist2 = dx * dx + dy * dy;
+    return outDist2 < r2;
+}
+
+/**
+ * @brief Sprawdza, czy okrąg przecina którykolwiek odcinek z zakresu `[begin, end)`.
+ * @param w Odcinki w układzie SoA.
+ * @param begin Pierwszy indeks zakresu.
+ * @param end Indeks za ostatnim elementem zakresu.
+ * @param px Środek okręgu, X.
+ * @param py Środek okręgu, Z.
+ * @param r2 Kwadrat promienia.
+ * @return `true` przy pierwszym znalezionym przecięciu.
+ */
+static bool AnyContact(const WallSoA& w, size_t begin, size_t end, float px, float py, float r2) {
+    size_t i = begin;
+    const float* AX = w.ax.data(); const float* AY = w.ay.data();
+    const float* BX = w.bx.data(); const float* BY = w.by.data();
+
+#if TRACKCOL_SIMD_WIDTH == 8
+    const __m256 vpx = _mm256_set1_ps(px), vpy = _mm256_set1_ps(py), vr2 = _mm256_set1_ps(r2);
+    const __m256 veps = _mm256_set1_ps(1e-8f), zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= end; i += 8) {
+        __m256 ax = _mm256_loadu_ps(AX + i), ay = _mm256_loadu_ps(AY + i);
+        __m256 abx = _mm256_sub_ps(_mm256_loadu_ps(BX + i), ax);
+        __m256 aby = _mm256_sub_ps(_mm256_loadu_ps(BY + i), ay);
+        __m256 len2 = _mm256_add_ps(_mm256_mul_ps(abx, abx), _mm256_mul_ps(aby, aby));
+        __m256 t = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(vpx, ax), abx), _mm256_mul_ps(_mm256_sub_ps(vpy, ay), aby)), len2);
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 dx = _mm256_sub_ps(vpx, _mm256_add_ps(ax, _mm256_mul_ps(t, abx)));
+        __m256 dy = _mm256_sub_ps(vpy, _mm256_add_ps(ay, _mm256_mul_ps(t, aby)));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(d2, vr2, _CMP_LT_OQ), _mm256_cmp_ps(len2, veps, _CMP_GT_OQ));
+        if (_mm256_movemask_ps(hit)) return true;
+    }
+#elif TRACKCOL_SIMD_WIDTH == 4
+    const __m128 vpx = _mm_set1_ps(px), vpy = _mm_set1_ps(py), vr2 = _mm_set1_ps(r2);
+    const __m128 veps = _mm_set1_ps(1e-8f), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= end; i += 4) {
+        __m128 ax = _mm_loadu_ps(AX + i), ay = _mm_loadu_ps(AY + i);
+        __m128 abx = _mm_sub_ps(_mm_loadu_ps(BX + i), ax);
+        __m128 aby = _mm_sub_ps(_mm_loadu_ps(BY + i), ay);
+        __m128 len2 = _mm_add_ps(_mm_mul_ps(abx, abx), _mm_mul_ps(aby, aby));
+        __m128 t = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(vpx, ax), abx), _mm_mul_ps(_mm_sub_ps(vpy, ay), aby)), len2);
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        __m128 dx = _mm_sub_ps(vpx, _mm_add_ps(ax, _mm_mul_ps(t, abx)));
+        __m128 dy = _mm_sub_ps(vpy, _mm_add_ps(ay, _mm_mul_ps(t, aby)));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hit = _mm_and_ps(_mm_cmplt_ps(d2, vr2), _mm_cmpgt_ps(len2, veps));
+        if (_mm_movemask_ps(hit)) return true;
+    }
+#endif
+
+    float d2;
+    for (; i < end; ++i) {
+        if (SegmentContact(AX[i], AY[i], BX[i], BY[i], px, py, r2, d2)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Szuka w zakresie `[begin, end)` przeciętego odcinka o najmniejszej penetracji.
+ *
+ * Najmniejsza penetracja odpowiada największej odległości środka od odcinka (przy `dist2 < r2`).
+ * Wynik jest scalany z dotychczasowym najlepszym kontaktem — przy remisie wygrywa wcześniejszy
+ * odcinek, tak jak w pętli skalarnej.
+ *
+ * @param w Odcinki w układzie SoA.
+ * @param begin Pierwszy indeks zakresu.
+ * @param end Indeks za ostatnim elementem zakresu.
+ * @param px Środek okręgu, X.
+ * @param py Środek okręgu, Z.
+ * @param r2 Kwadrat promienia.
+ * @param bestDist2 Kwadrat odległości najlepszego kontaktu (wejście/wyjście, -1 gdy brak).
+ * @param bestIndex Indeks najlepszego odcinka w `w` (wejście/wyjście, -1 gdy brak).
+ */
+static void ShallowestContact(const WallSoA& w, size_t begin, size_t end, float px, float py, float r2, float& bestDist2, int& bestIndex) {
+    size_t i = begin;
+    const float* AX = w.ax.data(); const float* AY = w.ay.data();
+    const float* BX = w.bx.data(); const float* BY = w.by.data();
+
+#if TRACKCOL_SIMD_WIDTH > 1
+    float laneD[TRACKCOL_SIMD_WIDTH];
+    int laneI[TRACKCOL_SIMD_WIDTH];
+    bool anyBlock = false;
+#endif
+
+#if TRACKCOL_SIMD_WIDTH == 8
+    const __m256 vpx = _mm256_set1_ps(px), vpy = _mm256_set1_ps(py), vr2 = _mm256_set1_ps(r2);
+    const __m256 veps = _mm256_set1_ps(1e-8f), zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    __m256 bestD = _mm256_set1_ps(-1.0f);
+    __m256i bestI = _mm256_set1_epi32(-1);
+    __m256i lane = _mm256_add_epi32(_mm256_set1_epi32((int)begin), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+    for (; i + 8 <= end; i += 8, lane = _mm256_add_epi32(lane, step)) {
+        __m256 ax = _mm256_loadu_ps(AX + i), ay = _mm256_loadu_ps(AY + i);
+        __m256 abx = _mm256_sub_ps(_mm256_loadu_ps(BX + i), ax);
+        __m256 aby = _mm256_sub_ps(_mm256_loadu_ps(BY + i), ay);
+        __m256 len2 = _mm256_add_ps(_mm256_mul_ps(abx, abx), _mm256_mul_ps(aby, aby));
+        __m256 t = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(vpx, ax), abx), _mm256_mul_ps(_mm256_sub_ps(vpy, ay), aby)), len2);
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 dx = _mm256_sub_ps(vpx, _mm256_add_ps(ax, _mm256_mul_ps(t, abx)));
+        __m256 dy = _mm256_sub_ps(vpy, _mm256_add_ps(ay, _mm256_mul_ps(t, aby)));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(d2, vr2, _CMP_LT_OQ), _mm256_cmp_ps(len2, veps, _CMP_GT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(d2, bestD, _CMP_GT_OQ));
+        bestD = _mm256_blendv_ps(bestD, d2, hit);
+        bestI = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestI), _mm256_castsi256_ps(lane), hit));
+        anyBlock = true;
+    }
+    if (anyBlock) {
+        _mm256_storeu_ps(laneD, bestD);
+        _mm256_storeu_si256((__m256i*)laneI, bestI);
+    }
+#elif TRACKCOL_SIMD_WIDTH == 4
+    const __m128 vpx = _mm_set1_ps(px), vpy = _mm_set1_ps(py), vr2 = _mm_set1_ps(r2);
+    const __m128 veps = _mm_set1_ps(1e-8f), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    __m128 bestD = _mm_set1_ps(-1.0f);
+    __m128i bestI = _mm_set1_epi32(-1);
+    __m128i lane = _mm_add_epi32(_mm_set1_epi32((int)begin), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128i step = _mm_set1_epi32(4);
+    for (; i + 4 <= end; i += 4, lane = _mm_add_epi32(lane, step)) {
+        __m128 ax = _mm_loadu_ps(AX + i), ay = _mm_loadu_ps(AY + i);
+        __m128 abx = _mm_sub_ps(_mm_loadu_ps(BX + i), ax);
+        __m128 aby = _mm_sub_ps(_mm_loadu_ps(BY + i), ay);
+        __m128 len2 = _mm_add_ps(_mm_mul_ps(abx, abx), _mm_mul_ps(aby, aby));
+        __m128 t = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(vpx, ax), abx), _mm_mul_ps(_mm_sub_ps(vpy, ay), aby)), len2);
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        __m128 dx = _mm_sub_ps(vpx, _mm_add_ps(ax, _mm_mul_ps(t, abx)));
+        __m128 dy = _mm_sub_ps(vpy, _mm_add_ps(ay, _mm_mul_ps(t, aby)));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hit = _mm_and_ps(_mm_cmplt_ps(d2, vr2), _mm_cmpgt_ps(len2, veps));
+        hit = _mm_and_ps(hit, _mm_cmpgt_ps(d2, bestD));
+        bestD = _mm_or_ps(_mm_and_ps(hit, d2), _mm_andnot_ps(hit, bestD));
+        __m128i hitI = _mm_castps_si128(hit);
+        bestI = _mm_or_si128(_mm_and_si128(hitI, lane), _mm_andnot_si128(hitI, bestI));
+        anyBlock = true;
+    }
+    if (anyBlock) {
+        _mm_storeu_ps(laneD, bestD);
+        _mm_storeu_si128((__m128i*)laneI, bestI);
+    }
+#endif
+
+#if TRACKCOL_SIMD_WIDTH > 1
+    if (anyBlock) {
+        float blockD = -1.0f;
+        int blockI = -1;
+        for (int l = 0; l < TRACKCOL_SIMD_WIDTH; ++l) {
+            if (laneI[l] < 0) continue;
+            if (laneD[l] > blockD || (laneD[l] == blockD && laneI[l] < blockI)) {
+                blockD = laneD[l];
+                blockI = laneI[l];
+            }
+        }
+        if (blockI >= 0 && blockD > bestDist2) {
+            bestDist2 = blockD;
+            bestIndex = blockI;
+        }
+    }
+#endif
+
+    float d2;
+    for (; i < end; ++i) {
+        if (SegmentContact(AX[i], AY[i], BX[i], BY[i], px, py, r2, d2) && d2 > bestDist2) {
+            bestDist2 = d2;
+            bestIndex = (int)i;
+        }
+    }
+}
+
+/**
+ * @brief Liczy wektor wypchnięcia dla wybranego odcinka (skalarnie, jak w pełnej pętli).
+ * @param w Odcinki w układzie SoA.
+ * @param i Indeks odcinka.
+ * @param p Środek okręgu (XZ).
+ * @param radius Promień okręgu.
+ * @return Wektor wypchnięcia (normalna kontaktu * penetracja).
+ */
+static glm::vec2 ContactPush(const WallSoA& w, size_t i, const glm::vec2& p, float radius) {
+    glm::vec2 a(w.ax[i], w.ay[i]);
+    glm::vec2 ab = glm::vec2(w.bx[i], w.by[i]) - a;
+    float abLen2 = glm::dot(ab, ab);
+    float t = glm::clamp(glm::dot(p - a, ab) / abLen2, 0.0f, 1.0f);
+    glm::vec2 diff = p - (a + t * ab);
+    float dist = sqrt(glm::length2(diff));
+    float penetration = radius - dist;
+
+    glm::vec2 normal;
+    if (dist > 1e-6f) normal = diff / dist;
+    else {
+        float len = glm::length(ab);
+        if (len < 1e-6f) return glm::vec2(0.0f);
+        glm::vec2 dir = ab / len;
+        normal = glm::vec2(-dir.y, dir.x);
+    }
+    return normal * penetration;
+}
+
+/**
+ * @brief Wyznacza zakres komórek siatki pokrytych przez AABB okręgu.
+ * @param p Środek okręgu.
+ * @param radius Promień okręgu.
+ * @param x0 Pierwsza kolumna.
+ * @param z0 Pierwszy wiersz.
+ * @param x1 Ostatnia kolumna.
+ * @param z1 Ostatni wiersz.
+ * @return `false` gdy okrąg nie nachodzi na siatkę.
+ */
+bool TrackCollision::GetCellRange(const glm::vec2& p, float radius, int& x0, int& z0, int& x1, int& z1) const {
+    if (gridCols == 0 || gridRows == 0) return false;
+
+    float fx0 = std::floor((p.x - radius - gridOrigin.x) / gridCellSize);
+    float fx1 = std::floor((p.x + radius - gridOrigin.x) / gridCellSize);
+    float fz0 = std::floor((p.y - radius - gridOrigin.y) / gridCellSize);
+    float fz1 = std::floor((p.y + radius - gridOrigin.y) / gridCellSize);
+    if (fx1 < 0.0f || fz1 < 0.0f || fx0 >= (float)gridCols || fz0 >= (float)gridRows) return false;
+
+    x0 = std::max(0, (int)fx0);
+    z0 = std::max(0, (int)fz0);
+    x1 = std::min(gridCols - 1, (int)fx1);
+    z1 = std::min(gridRows - 1, (int)fz1);
+    return true;
 }
 
 /**
- * @brief Sprawdza kolizję okręgu z listą segmentów ścian.
+ * @brief Sprawdza kolizję okręgu z segmentami ścian z komórek siatki pokrytych przez okrąg.
  * @param carPos Pozycja auta (używane X i Z).
  * @param radius Promień okręgu kolizyjnego.
  * @return `true` jeśli nastąpiła kolizja; inaczej `false`.
  */
-bool TrackCollision::CheckCollision(const glm::vec3& carPos, float radius) {
+bool TrackCollision::CheckCollision(const glm::vec3& carPos, float radius) const {
     glm::vec2 p(carPos.x, carPos.z);
     float r2 = radius * radius;
 
-    for (const auto& wall : walls) {
-        glm::vec2 a = wall.start;
-        glm::vec2 b = wall.end;
-        glm::vec2 ab = b - a;
-        float abLen2 = glm::dot(ab, ab);
-        if (abLen2 <= 1e-8f) continue;
+    int verdict = ClassifyByDistance(p, radius);
+    if (verdict != 0) return verdict > 0;
 
-        float t = glm::clamp(glm::dot(p - a, ab) / abLen2, 0.0f, 1.0f);
-        glm::vec2 closest = a + t * ab;
-        float dist2 = glm::length2(p - closest);
-        if (dist2 < r2) return true;
+    int x0, z0, x1, z1;
+    if (!GetCellRange(p, radius, x0, z0, x1, z1)) return false;
+
+    for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+            size_t cell = (size_t)z * gridCols + x;
+            if (AnyContact(gridWalls, gridCellStart[cell], gridCellStart[cell + 1], p.x, p.y, r2)) return true;
+        }
     }
     return false;
 }
 
 /**
  * @brief Wyznacza minimalny wektor wypchnięcia z kolizji okręgu z segmentami ścian.
+ *
+ * Sprawdzane są wyłącznie odcinki z komórek siatki pokrytych przez okrąg. Odcinek leżący
+ * w kilku komórkach może zostać sprawdzony wielokrotnie — nie zmienia to wyniku.
+ * Jądro SIMD wybiera odcinek o najmniejszej penetracji, a wypchnięcie liczone jest skalarnie.
+ *
  * @param carPos Pozycja auta (używane X i Z).
  * @param radius Promień okręgu kolizyjnego.
  * @param outPush Wynikowy wektor wypchnięcia w 2D.
  * @return `true` jeśli wykryto kolizję; inaczej `false`.
  */
-bool TrackCollision::FindCollisionPush(const glm::vec3& carPos, float radius, glm::vec2& outPush) {
+bool TrackCollision::FindCollisionPush(const glm::vec3& carPos, float radius, glm::vec2& outPush) const {
     glm::vec2 p(carPos.x, carPos.z);
     float r2 = radius * radius;
+    outPush = glm::vec2(0.0f);
+    if (ClassifyByDistance(p, radius) < 0) return false;
+
+    int x0, z0, x1, z1;
+    if (!GetCellRange(p, radius, x0, z0, x1, z1)) return false;
+
+    float bestDist2 = -1.0f;
+    int bestIndex = -1;
+    for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+            size_t cell = (size_t)z * gridCols + x;
+            ShallowestContact(gridWalls, gridCellStart[cell], gridCellStart[cell + 1], p.x, p.y, r2, bestDist2, bestIndex);
+        }
+    }
+
+    if (bestIndex < 0) return false;
+    outPush = ContactPush(gridWalls, (size_t)bestIndex, p, radius);
+    return true;
+}
+
+/**
+ * @brief Pierwszy kontakt okręgu poruszającego się po `p + t * d` (t ∈ [0, 1]) z odcinkiem `a`–`b`.
+ * @param a Początek odcinka.
+ * @param b Koniec odcinka.
+ * @param p Środek okręgu na początku ruchu.
+ * @param d Przesunięcie okręgu.
+ * @param radius Promień okręgu.
+ * @param outTime Chwila kontaktu (wynik).
+ * @param outNormal Normalna kontaktu od ściany (wynik).
+ * @return `true` jeśli okrąg dotyka odcinka w trakcie ruchu.
+ */
+static bool SweepSegment(const glm::vec2& a, const glm::vec2& b, const glm::vec2& p, const glm::vec2& d, float radius,
+    float& outTime, glm::vec2& outNormal) {
+    glm::vec2 ab = b - a;
+    float abLen2 = glm::dot(ab, ab);
+    if (abLen2 <= 1e-8f) return false;
+
+    // Okrąg już przecina odcinek: kontakt w t = 0 tylko przy ruchu w głąb ściany.
+    float t0 = glm::clamp(glm::dot(p - a, ab) / abLen2, 0.0f, 1.0f);
+    glm::vec2 diff = p - (a + t0 * ab);
+    float dist2 = glm::length2(diff);
+    if (dist2 < radius * radius) {
+        float dist = std::sqrt(dist2);
+        glm::vec2 normal = dist > 1e-6f ? diff / dist : glm::normalize(glm::vec2(-ab.y, ab.x));
+        if (glm::dot(d, normal) >= 0.0f) return false;
+        outTime = 0.0f;
+        outNormal = normal;
+        return true;
+    }
+
+    bool hit = false;
+    float best = 1.0f;
+
+    // Bok kapsuły: prosta odcinka odsunięta o promień w stronę okręgu.
+    float abLen = std::sqrt(abLen2);
+    glm::vec2 dir = ab / abLen;
+    glm::vec2 side(-dir.y, dir.x);
+    float s0 = glm::dot(p - a, side);
+    if (s0 < 0.0f) { side = -side; s0 = -s0; }
+    float approach = glm::dot(d, side);
+    if (approach < 0.0f) {
+        float t = (s0 - radius) / -approach;
+        float along = glm::dot(p + t * d - a, dir);
+        if (t >= 0.0f && t <= best && along >= 0.0f && along <= abLen) {
+            best = t;
+            outNormal = side;
+            hit = true;
+        }
+    }
+
+    // Końce kapsuły: okręgi o promieniu `radius` wokół `a` i `b`.
+    float dd = glm::dot(d, d);
+    if (dd > 1e-12f) {
+        for (const glm::vec2& c : { a, b }) {
+            glm::vec2 m = p - c;
+            float bq = glm::dot(m, d);
+            float cq = glm::dot(m, m) - radius * radius;
+            float disc = bq * bq - dd * cq;
+            if (bq >= 0.0f || disc < 0.0f) continue;
+            float t = (-bq - std::sqrt(disc)) / dd;
+            if (t >= 0.0f && t <= best) {
+                best = t;
+                outNormal = glm::normalize(p + t * d - c);
+                hit = true;
+            }
+        }
+    }
+
+    if (hit) outTime = best;
+    return hit;
+}
+
+/**
+ * @brief Ciągłe wykrywanie kolizji okręgu przesuwanego od `from` do `to`.
+ * @param from Pozycja początkowa.
+ * @param to Pozycja końcowa.
+ * @param radius Promień okręgu.
+ * @param outTime Ułamek ruchu w chwili kontaktu.
+ * @param outNormal Normalna kontaktu.
+ * @return `true` jeśli ruch napotyka ścianę.
+ */
+bool TrackCollision::SweepCircle(const glm::vec3& from, const glm::vec3& to, float radius, float& outTime, glm::vec2& outNormal) const {
+    glm::vec2 p(from.x, from.z);
+    glm::vec2 d = glm::vec2(to.x, to.z) - p;
+
+    // Okrąg obejmujący cały ruch nie dotyka żadnej ściany.
+    if (ClassifyByDistance(p, radius + glm::length(d)) < 0) return false;
 
-    bool collided = false;
-    float minPenetration = std::numeric_limits<float>::max();
-    glm::vec2 bestPush(0.0f);
+    // Krótki ruch bez kontaktu na końcu nie mógł przejść przez ścianę (co najwyżej ją musnąć).
+    if (glm::length2(d) < 4.0f * radius * radius && !CheckCollision(to, radius)) return false;
 
-    for (const auto& wall : walls) {
-        glm::vec2 a = wall.start;
-        glm::vec2 b = wall.end;
-        glm::vec2 ab = b - a;
+    // Komórki pokryte przez AABB całego ruchu.
+    glm::vec2 center = p + d * 0.5f;
+    float extent = radius + 0.5f * std::max(std::abs(d.x), std::abs(d.y));
+    int x0, z0, x1, z1;
+    if (!GetCellRange(center, extent, x0, z0, x1, z1)) return false;
+
+    bool hit = false;
+    float best = 2.0f;
+    for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+            size_t cell = (size_t)z * gridCols + x;
+            for (size_t i = gridCellStart[cell]; i < gridCellStart[cell + 1]; ++i) {
+                float t;
+                glm::vec2 normal;
+                glm::vec2 a(gridWalls.ax[i], gridWalls.ay[i]), b(gridWalls.bx[i], gridWalls.by[i]);
+                if (SweepSegment(a, b, p, d, radius, t, normal) && t < best) {
+                    best = t;
+                    outNormal = normal;
+                    hit = true;
+                }
+            }
+        }
+    }
+
+    if (hit) outTime = best;
+    return hit;
+}
+
+/**
+ * @brief Wsadowy test kolizji dla wielu pozycji.
+ * @param positions Pozycje aut.
+ * @param radius Promień okręgu kolizyjnego.
+ * @param outCollided Flagi kolizji (1/0) dla kolejnych pozycji.
+ * @return Liczba kolizji.
+ */
+size_t TrackCollision::CheckCollisionBatch(const std::vector<glm::vec3>& positions, float radius, std::vector<unsigned char>& outCollided) const {
+    outCollided.resize(positions.size());
+    size_t hits = 0;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        outCollided[i] = CheckCollision(positions[i], radius) ? 1 : 0;
+        hits += outCollided[i];
+    }
+    return hits;
+}
+
+/**
+ * @brief Wsadowe wyznaczanie wypchnięć dla wielu pozycji.
+ * @param positions Pozycje aut.
+ * @param radius Promień okręgu kolizyjnego.
+ * @param outPush Wektory wypchnięcia dla kolejnych pozycji.
+ * @param outCollided Flagi kolizji (1/0) dla kolejnych pozycji.
+ * @return Liczba kolizji.
+ */
+size_t TrackCollision::FindCollisionPushBatch(const std::vector<glm::vec3>& positions, float radius,
+    std::vector<glm::vec2>& outPush, std::vector<unsigned char>& outCollided) const {
+    outPush.resize(positions.size());
+    outCollided.resize(positions.size());
+    size_t hits = 0;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        outCollided[i] = FindCollisionPush(positions[i], radius, outPush[i]) ? 1 : 0;
+        hits += outCollided[i];
+    }
+    return hits;
+}
+
+/**
+ * @brief Odczytuje pole odległości w punkcie (interpolacja dwuliniowa odległości i kierunku).
+ * @param header Nagłówek pola.
+ * @param samples Próbki pola.
+ * @param p Punkt (XZ).
+ * @param outDistance Odległość (wynik).
+ * @param outGradient Nieznormalizowany kierunek od ściany (wynik, opcjonalny).
+ * @return `false` gdy punkt leży poza obszarem pola.
+ */
+static bool SampleDistanceField(const DistanceFieldHeader& header, const std::vector<DistanceSample>& samples,
+    const glm::vec2& p, float& outDistance, glm::vec2* outGradient) {
+    float fx = (p.x - header.originX) / header.cellSize;
+    float fz = (p.y - header.originZ) / header.cellSize;
+    if (!(fx >= 0.0f && fz >= 0.0f && fx < (float)(header.cols - 1) && fz < (float)(header.rows - 1))) return false;
+
+    int x = (int)fx;
+    int z = (int)fz;
+    float tx = fx - (float)x;
+    float tz = fz - (float)z;
+    const DistanceSample* row0 = &samples[(size_t)z * header.cols + x];
+    const DistanceSample* row1 = row0 + header.cols;
+
+    float w00 = (1.0f - tx) * (1.0f - tz), w10 = tx * (1.0f - tz), w01 = (1.0f - tx) * tz, w11 = tx * tz;
+    float q = w00 * row0[0].distance + w10 * row0[1].distance + w01 * row1[0].distance + w11 * row1[1].distance;
+    outDistance = q * (header.maxDistance / 65535.0f);
+
+    if (outGradient) {
+        outGradient->x = w00 * row0[0].gradX + w10 * row0[1].gradX + w01 * row1[0].gradX + w11 * row1[1].gradX;
+        outGradient->y = w00 * row0[0].gradZ + w10 * row0[1].gradZ + w01 * row1[0].gradZ + w11 * row1[1].gradZ;
+    }
+    return true;
+}
+
+/**
+ * @brief Wypieka pole odległości: każdy odcinek aktualizuje próbki w swoim AABB poszerzonym o zasięg pola.
+ *
+ * Koszt jest proporcjonalny do sumy pól tych prostokątów (a nie do liczby próbek razy liczby odcinków).
+ * Próbki dalsze niż `DistanceFieldRange` od wszystkich ścian mają odległość obciętą do zasięgu i zerowy kierunek.
+ *
+ * @param cellSize Odstęp próbek.
+ */
+void TrackCollision::BakeDistanceField(float cellSize) {
+    ReleaseDistanceField();
+    if (walls.empty()) return;
+
+    const float h = cellSize > 1e-3f ? cellSize : DefaultDistanceCellSize;
+    const float range = DistanceFieldRange;
+
+    glm::vec2 minP(std::numeric_limits<float>::max());
+    glm::vec2 maxP(-std::numeric_limits<float>::max());
+    for (const auto& w : walls) {
+        minP = glm::min(minP, glm::min(w.start, w.end));
+        maxP = glm::max(maxP, glm::max(w.start, w.end));
+    }
+
+    // Margines równy zasięgowi: poza obszarem pola odległość od ścian jest co najmniej `range`.
+    DistanceFieldHeader header{};
+    std::memcpy(header.magic, "R3DF", 4);
+    header.version = DistanceFieldVersion;
+    header.wallsHash = HashWalls();
+    header.originX = minP.x - range;
+    header.originZ = minP.y - range;
+    header.cellSize = h;
+    header.maxDistance = range;
+    header.cols = (int32_t)std::ceil((maxP.x - minP.x + 2.0f * range) / h) + 1;
+    header.rows = (int32_t)std::ceil((maxP.y - minP.y + 2.0f * range) / h) + 1;
+
+    const size_t count = (size_t)header.cols * header.rows;
+    std::vector<float> distance(count, range);
+    std::vector<glm::vec2> direction(count, glm::vec2(0.0f));
+
+    for (const auto& w : walls) {
+        glm::vec2 ab = w.end - w.start;
         float abLen2 = glm::dot(ab, ab);
         if (abLen2 <= 1e-8f) continue;
 
-        float t = glm::clamp(glm::dot(p - a, ab) / abLen2, 0.0f, 1.0f);
-        glm::vec2 closest = a + t * ab;
-        glm::vec2 diff = p - closest;
-        float dist2 = glm::length2(diff);
-
-        if (dist2 < r2) {
-            float dist = sqrt(dist2);
-            float penetration = radius - dist;
-            glm::vec2 normal;
-            if (dist > 1e-6f) normal = diff / dist;
-            else {
-                glm::vec2 dir = ab;
-                float len = glm::length(dir);
-                if (len < 1e-6f) continue;
-                dir /= len;
-                normal = glm::vec2(-dir.y, dir.x);
-            }
-            glm::vec2 push = normal * penetration;
-            if (penetration < minPenetration) {
-                minPenetration = penetration;
-                bestPush = push;
+        int x0 = std::max(0, (int)std::floor((std::min(w.start.x, w.end.x) - range - header.originX) / h));
+        int x1 = std::min(header.cols - 1, (int)std::ceil((std::max(w.start.x, w.end.x) + range - header.originX) / h));
+        int z0 = std::max(0, (int)std::floor((std::min(w.start.y, w.end.y) - range - header.originZ) / h));
+        int z1 = std::min(header.rows - 1, (int)std::ceil((std::max(w.start.y, w.end.y) + range - header.originZ) / h));
+        glm::vec2 side = glm::vec2(-ab.y, ab.x) / std::sqrt(abLen2);
+
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) {
+                glm::vec2 p(header.originX + x * h, header.originZ + z * h);
+                float t = glm::clamp(glm::dot(p - w.start, ab) / abLen2, 0.0f, 1.0f);
+                glm::vec2 diff = p - (w.start + t * ab);
+                float d = std::sqrt(glm::length2(diff));
+
+                size_t k = (size_t)z * header.cols + x;
+                if (d >= distance[k]) continue;
+                distance[k] = d;
+                direction[k] = d > 1e-6f ? diff / d : side;
             }
-            collided = true;
         }
     }
 
-    if (collided) {
-        outPush = bestPush;
-        return true;
+    distanceSamples.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        DistanceSample& s = distanceSamples[k];
+        s.distance = (uint16_t)std::lround(std::min(distance[k], range) / range * 65535.0f);
+        s.gradX = (int8_t)std::lround(direction[k].x * 127.0f);
+        s.gradZ = (int8_t)std::lround(direction[k].y * 127.0f);
     }
-    outPush = glm::vec2(0.0f);
-    return false;
+    distanceHeader = header;
+}
+
+/**
+ * @brief Usuwa pole odległości i oddaje jego pamięć.
+ */
+void TrackCollision::ReleaseDistanceField() {
+    std::vector<DistanceSample>().swap(distanceSamples);
+    distanceHeader = DistanceFieldHeader{};
+}
+
+/**
+ * @brief Sprawdza, czy pole odległości jest dostępne.
+ * @return `true` gdy pole jest wczytane lub wypieczone.
+ */
+bool TrackCollision::HasDistanceField() const {
+    return !distanceSamples.empty();
+}
+
+/**
+ * @brief Zwraca przybliżoną odległość od najbliższej ściany i kierunek od niej.
+ * @param pos Pozycja (używane X i Z).
+ * @param outDistance Odległość (wynik).
+ * @param outNormal Jednostkowy kierunek od ściany (wynik).
+ * @return `false` gdy pole nie jest dostępne.
+ */
+bool TrackCollision::QueryDistance(const glm::vec3& pos, float& outDistance, glm::vec2& outNormal) const {
+    if (!HasDistanceField()) return false;
+
+    glm::vec2 gradient(0.0f);
+    if (!SampleDistanceField(distanceHeader, distanceSamples, glm::vec2(pos.x, pos.z), outDistance, &gradient))
+        outDistance = distanceHeader.maxDistance;
+
+    float len = glm::length(gradient);
+    outNormal = len > 1e-6f ? gradient / len : glm::vec2(0.0f);
+    return true;
+}
+
+/**
+ * @brief Zwraca maksymalny błąd odległości odczytanej z pola.
+ *
+ * Odległość jest 1-lipschitzowska, więc interpolacja dwuliniowa myli się co najwyżej o `cellSize / √2`;
+ * do tego dochodzi połowa kroku kwantyzacji i zapas na zaokrąglenia float.
+ *
+ * @return Tolerancja w jednostkach świata (0 bez pola).
+ */
+float TrackCollision::GetDistanceFieldTolerance() const {
+    if (!HasDistanceField()) return 0.0f;
+    return distanceHeader.cellSize * 0.70711f + distanceHeader.maxDistance / 65535.0f + 1e-4f;
+}
+
+/**
+ * @brief Rozstrzyga test okręgu z pola odległości, jeśli odległość jest dostatecznie daleko od promienia.
+ * @param p Środek okręgu (XZ).
+ * @param radius Promień okręgu.
+ * @return -1 (brak kolizji), 1 (kolizja) lub 0 (potrzebny dokładny test).
+ */
+int TrackCollision::ClassifyByDistance(const glm::vec2& p, float radius) const {
+    if (!HasDistanceField() || radius > distanceHeader.maxDistance) return 0;
+
+    float distance;
+    if (!SampleDistanceField(distanceHeader, distanceSamples, p, distance, nullptr)) return -1;
+
+    float tolerance = GetDistanceFieldTolerance();
+    if (distance - tolerance >= radius) return -1;
+    if (distance + tolerance < radius) return 1;
+    return 0;
+}
+
+/**
+ * @brief Liczy skrót FNV-1a (64 bit) współrzędnych wszystkich odcinków `walls` (klucz zgodności pola z odcinkami).
+ * @return Skrót.
+ */
+uint64_t TrackCollision::HashWalls() const {
+    uint64_t hash = 1469598103934665603ull;
+    for (const auto& w : walls) {
+        float v[4] = { w.start.x, w.start.y, w.end.x, w.end.y };
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(v);
+        for (size_t i = 0; i < sizeof(v); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Zwraca nazwę wariantu jądra kolizji.
+ * @return `"AVX2"`, `"SSE2"` lub `"scalar"`.
+ */
+const char* TrackCollision::GetKernelName() {
+#if TRACKCOL_SIMD_WIDTH == 8
+    return "AVX2";
+#elif TRACKCOL_SIMD_WIDTH == 4
+    return "SSE2";
+#else
+    return "scalar";
+#endif
 }
 
 /**
  * @brief Zwraca listę segmentów ścian toru.
  * @return Referencja do `walls`.
  */
-const std::vector<WallSegment>& TrackCollision::GetWalls() {
+const std::vector<WallSegment>& TrackCollision::GetWalls() const {
     return walls;
 }
\ No newline at end of file
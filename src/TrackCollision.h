@@ -1,7 +1,12 @@
 ﻿#pragma once
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <glm/glm.hpp>
 
+class TrackFileReader;
+class TrackFileWriter;
+
 /**
  * @file TrackCollision.h
  * @brief Deklaracje struktur i funkcji do kolizji samochodu z „ścianami” toru w płaszczyźnie XZ.
@@ -36,39 +41,203 @@ struct WallSegment {
 };
 
 /**
- * @brief Statyczny system kolizji toru: budowanie ścian z polilinii i test kolizji okrąg–odcinek.
+ * @brief Odcinki ścian w układzie SoA (osobne tablice współrzędnych), przygotowane pod SIMD.
+ *
+ * Element `i` opisuje odcinek od `(ax[i], ay[i])` do `(bx[i], by[i])`; `ay`/`by` to oś Z świata.
+ */
+struct WallSoA {
+    /** @brief Współrzędne X początków odcinków. */
+    std::vector<float> ax;
+
+    /** @brief Współrzędne Z początków odcinków. */
+    std::vector<float> ay;
+
+    /** @brief Współrzędne X końców odcinków. */
+    std::vector<float> bx;
+
+    /** @brief Współrzędne Z końców odcinków. */
+    std::vector<float> by;
+
+    /** @brief Usuwa wszystkie odcinki. */
+    void clear() { ax.clear(); ay.clear(); bx.clear(); by.clear(); }
+
+    /**
+     * @brief Zmienia liczbę odcinków.
+     * @param n Nowa liczba odcinków.
+     */
+    void resize(size_t n) { ax.resize(n); ay.resize(n); bx.resize(n); by.resize(n); }
+
+    /**
+     * @brief Zapisuje odcinek pod wskazanym indeksem.
+     * @param i Indeks docelowy.
+     * @param w Odcinek ściany.
+     */
+    void set(size_t i, const WallSegment& w) { ax[i] = w.start.x; ay[i] = w.start.y; bx[i] = w.end.x; by[i] = w.end.y; }
+
+    /** @brief Liczba odcinków. */
+    size_t size() const { return ax.size(); }
+};
+
+/**
+ * @brief Próbka pola odległości: odległość do najbliższej ściany i kierunek od niej (4 bajty).
+ */
+struct DistanceSample {
+    /** @brief Odległość do najbliższego odcinka, skwantowana do `[0, MaxDistance]` (65535 = `MaxDistance`). */
+    uint16_t distance;
+
+    /** @brief Kierunek od najbliższego punktu ściany do próbki (X), skwantowany do [-127, 127]. */
+    int8_t gradX;
+
+    /** @brief Kierunek od najbliższego punktu ściany do próbki (Z), skwantowany do [-127, 127]. */
+    int8_t gradZ;
+};
+
+/**
+ * @brief Nagłówek pola odległości (`cols * rows` próbek `DistanceSample`, wierszami Z); zapisywany w pliku toru.
+ */
+struct DistanceFieldHeader {
+    /** @brief Sygnatura: `R3DF`. */
+    char magic[4];
+
+    /** @brief Wersja układu pola (`TrackCollision::DistanceFieldVersion`). */
+    uint32_t version;
+
+    /** @brief Skrót FNV-1a (64 bit) odcinków `walls`, z których upieczono pole (zmiana ścian = nowe pole). */
+    uint64_t wallsHash;
+
+    /** @brief Lewy dolny róg siatki próbek (X, Z). */
+    float originX, originZ;
+
+    /** @brief Odstęp próbek. */
+    float cellSize;
+
+    /** @brief Odległość odpowiadająca kwantowi 65535 (dalsze odległości są obcinane). */
+    float maxDistance;
+
+    /** @brief Liczba próbek w osi X i Z. */
+    int32_t cols, rows;
+};
+
+/**
+ * @brief System kolizji jednego toru: budowanie ścian z polilinii i test kolizji okrąg–odcinek.
  *
- * System przechowuje dwie surowe polilinie (lewa i prawa strona toru), a następnie buduje z nich
- * listę odcinków (`walls`) wykorzystywanych do testów kolizji.
+ * Każdy tor ma własny obiekt (zwykle w `TrackDefinition`): z dwóch polilinii (lewa i prawa strona toru)
+ * budowana jest lista odcinków (`walls`) wykorzystywanych do testów kolizji. Zbudowane struktury można
+ * zapisać w pliku toru (`WriteSections`) i przy kolejnych uruchomieniach tylko je wczytać (`ReadSections`).
  *
  * Kolizja jest liczona w 2D w płaszczyźnie XZ (pozycja auta: `carPos.x` i `carPos.z`).
+ *
+ * Przyspieszenie zapytań: w `Init` budowana jest jednorodna siatka (uniform grid) nad płaszczyzną XZ.
+ * Każda komórka przechowuje indeksy odcinków, których AABB ją przecina; zapytanie sprawdza tylko
+ * odcinki z komórek pokrytych przez AABB okręgu.
+ *
+ * Współrzędne odcinków każdej komórki są dodatkowo skopiowane w układzie SoA (`WallSoA`), dzięki czemu
+ * test okrąg–odcinek liczony jest wektorowo dla 4 (SSE2) lub 8 (AVX2) odcinków naraz. Bez SIMD
+ * (lub z definicją `RACING3D_COLLISION_SCALAR`) używana jest ta sama pętla skalarna.
+ *
+ * Opcjonalnie (`BakeDistanceField`) nad obszarem toru trzymane jest pole odległości do najbliższej
+ * ściany wraz z kierunkiem od niej, próbkowane co `DefaultDistanceCellSize`. Odległość nie ma znaku —
+ * ściany to otwarte polilinie bez zdefiniowanego „wnętrza”, a kierunek wskazuje stronę wypchnięcia.
+ * Zapytania odczytują pole interpolacją dwuliniową w O(1) i rozstrzygają wynik bez przeglądania odcinków,
+ * gdy odległość jest dalej od promienia niż błąd interpolacji; dokładny test odcinków wykonywany jest
+ * tylko w wąskim pasie przy kontakcie, więc wyniki są identyczne jak bez pola.
+ *
+ * Zapytania są `const` i mogą być wykonywane równolegle z wielu wątków.
  */
 class TrackCollision {
 public:
+    /** @brief Domyślny odstęp próbek pola odległości (w jednostkach świata). */
+    static constexpr float DefaultDistanceCellSize = 0.05f;
+
+    /** @brief Odległość, do której pole jest dokładne (dalej obcinane; margines wokół ścian ma ten sam rozmiar). */
+    static constexpr float DistanceFieldRange = 2.0f;
+
+    /** @brief Wersja układu pola odległości. */
+    static constexpr uint32_t DistanceFieldVersion = 1;
+
     /**
-     * @brief Surowe punkty lewej strony toru.
+     * @brief Buduje `walls` z polilinii stron toru oraz siatkę zapytań (poprzednie dane, także pole odległości, są usuwane).
+     * @param leftRaw Polilinia lewej strony (`Point::x` = X, `Point::y` = Z).
+     * @param rightRaw Polilinia prawej strony.
+     * @param minTrackWidth Minimalna szerokość toru używana do odfiltrowania fragmentów (np. pod „mostem”).
+     * @param gridCellSize Rozmiar boku komórki siatki przestrzennej (w jednostkach świata).
+     */
+    void Init(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+        float minTrackWidth = 2.0f, float gridCellSize = 1.0f);
+
+    /**
+     * @brief Buduje odcinki ścian z polilinii obu stron toru (wygładzenie, RDP, filtr szerokości).
+     *
+     * Ta sama procedura co w `Init`, bez tworzenia obiektu (np. dla gęstych skanów toru).
+     * Koszt O((n + m) log(n + m)) dla n i m punktów stron.
      *
-     * Dane pochodzą z mapy; `Point::x` = X, `Point::y` = Z.
+     * @param leftRaw Polilinia lewej strony.
+     * @param rightRaw Polilinia prawej strony.
+     * @param minTrackWidth Minimalna szerokość toru.
+     * @param outWalls Wynikowe odcinki ścian.
+     */
+    static void BuildWalls(const std::vector<Point>& leftRaw, const std::vector<Point>& rightRaw,
+        float minTrackWidth, std::vector<WallSegment>& outWalls);
+
+    /**
+     * @brief Dopisuje ściany, siatkę i pole odległości jako sekcje pliku toru.
+     * @param writer Plik toru w budowie.
+     */
+    void WriteSections(TrackFileWriter& writer) const;
+
+    /**
+     * @brief Wczytuje ściany, siatkę i (jeśli jest) pole odległości z sekcji pliku toru bez ponownego budowania.
+     * @param reader Otwarty plik toru.
+     * @return `false` gdy brakuje sekcji lub są niespójne (obiekt jest wtedy pusty).
+     */
+    bool ReadSections(const TrackFileReader& reader);
+
+    /**
+     * @brief Wypieka pole odległości nad aktualnymi ścianami (zastępuje poprzednie).
+     * @param cellSize Odstęp próbek.
      */
-    static const std::vector<Point> leftSideRaw;
+    void BakeDistanceField(float cellSize = DefaultDistanceCellSize);
 
     /**
-     * @brief Surowe punkty prawej strony toru.
+     * @brief Usuwa pole odległości (zapytania wracają do samej siatki odcinków).
+     */
+    void ReleaseDistanceField();
+
+    /**
+     * @brief Sprawdza, czy pole odległości jest dostępne.
+     * @return `true` gdy pole jest wczytane lub wypieczone.
+     */
+    bool HasDistanceField() const;
+
+    /**
+     * @brief Przybliżona odległość od najbliższej ściany i kierunek od niej (interpolacja pola, O(1)).
+     *
+     * Błąd odległości nie przekracza `GetDistanceFieldTolerance()`. Poza obszarem pola zwracana jest
+     * dolna granica odległości (`DistanceFieldRange`).
      *
-     * Dane pochodzą z mapy; `Point::x` = X, `Point::y` = Z.
+     * @param pos Pozycja w 3D (używane X i Z).
+     * @param outDistance Odległość (wynik).
+     * @param outNormal Jednostkowy kierunek od ściany w XZ (wynik; zero, gdy nieokreślony).
+     * @return `false` gdy pole nie jest dostępne.
      */
-    static const std::vector<Point> rightSideRaw;
+    bool QueryDistance(const glm::vec3& pos, float& outDistance, glm::vec2& outNormal) const;
 
     /**
-     * @brief Lista odcinków ścian zbudowanych na podstawie surowych polilinii.
+     * @brief Zwraca maksymalny błąd odległości z pola (interpolacja + kwantyzacja).
+     * @return Tolerancja w jednostkach świata (0 bez pola).
      */
-    static std::vector<WallSegment> walls;
+    float GetDistanceFieldTolerance() const;
 
     /**
-     * @brief Inicjalizuje system kolizji i buduje `walls` na podstawie danych surowych.
-     * @param minTrackWidth Minimalna szerokość toru używana do odfiltrowania fragmentów (np. pod „mostem”).
+     * @brief Zwalnia ściany, siatkę zapytań i pole odległości (np. przy wyładowaniu toru). Po wywołaniu brak kolizji.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Szacuje pamięć zajmowaną przez ściany, siatkę zapytań i pole odległości.
+     * @return Liczba bajtów (pojemności wektorów).
      */
-    static void Init(float minTrackWidth = 2.0f);
+    size_t GetMemoryBytes() const;
 
     /**
      * @brief Sprawdza kolizję okręgu (samochodu) z odcinkami ścian.
@@ -79,7 +248,7 @@ public:
      * @param radius Promień okręgu kolizyjnego.
      * @return `true` jeśli okrąg przecina dowolny odcinek ściany; inaczej `false`.
      */
-    static bool CheckCollision(const glm::vec3& carPos, float radius);
+    bool CheckCollision(const glm::vec3& carPos, float radius) const;
 
     /**
      * @brief Wyznacza wektor wypchnięcia (minimalny) usuwający penetrację okręgu ze ścianą.
@@ -92,11 +261,129 @@ public:
      * @param outPush Wektor wypchnięcia w 2D (XZ). Ustawiany tylko gdy wystąpi kolizja.
      * @return `true` jeśli wykryto kolizję i wyznaczono wypchnięcie; inaczej `false`.
      */
-    static bool FindCollisionPush(const glm::vec3& carPos, float radius, glm::vec2& outPush);
+    bool FindCollisionPush(const glm::vec3& carPos, float radius, glm::vec2& outPush) const;
+
+    /**
+     * @brief Ciągłe wykrywanie kolizji: pierwszy kontakt okręgu przesuwanego od `from` do `to` ze ścianą.
+     *
+     * Okrąg poruszający się po odcinku jest testowany jako promień względem „kapsuły” każdego odcinka
+     * ściany (pasy odsunięte o `radius` + okręgi na końcach), więc cienka ściana nie zostanie przeskoczona
+     * niezależnie od prędkości i długości kroku. Normalna jest liczona jak w `FindCollisionPush`
+     * (od najbliższego punktu odcinka do środka okręgu w chwili kontaktu).
+     *
+     * Okrąg, który na starcie już przecina ścianę, zgłasza kontakt w `outTime = 0` tylko wtedy,
+     * gdy ruch prowadzi w głąb ściany — oddalanie się i ruch wzdłuż ściany są dozwolone.
+     *
+     * Przy przesunięciu krótszym niż `2 * radius` okrąg nie może przeskoczyć ściany, więc wystarcza
+     * test pozycji końcowej (`CheckCollision`) — pomijane są jedynie muśnięcia ściany bez kontaktu na końcu
+     * ruchu. Pełne przejście po odcinkach siatki pokrytych przez AABB ruchu wykonywane jest tylko przy
+     * kontakcie lub długim kroku.
+     *
+     * @param from Pozycja początkowa (używane X i Z).
+     * @param to Pozycja końcowa (używane X i Z).
+     * @param radius Promień okręgu kolizyjnego.
+     * @param outTime Ułamek ruchu [0, 1] w chwili pierwszego kontaktu (ustawiany przy kontakcie).
+     * @param outNormal Normalna kontaktu w XZ, skierowana od ściany (ustawiana przy kontakcie).
+     * @return `true` jeśli ruch napotyka ścianę.
+     */
+    bool SweepCircle(const glm::vec3& from, const glm::vec3& to, float radius, float& outTime, glm::vec2& outNormal) const;
+
+    /**
+     * @brief Wsadowa wersja `CheckCollision` dla wielu pozycji (np. wszystkich aut w danym kroku).
+     * @param positions Pozycje aut w 3D (używane są składowe X oraz Z).
+     * @param radius Promień okręgu kolizyjnego (wspólny dla wszystkich aut).
+     * @param outCollided Wynik: 1 gdy auto `i` koliduje ze ścianą, 0 w przeciwnym razie (rozmiar jak `positions`).
+     * @return Liczba pozycji, dla których wykryto kolizję.
+     */
+    size_t CheckCollisionBatch(const std::vector<glm::vec3>& positions, float radius, std::vector<unsigned char>& outCollided) const;
+
+    /**
+     * @brief Wsadowa wersja `FindCollisionPush` dla wielu pozycji.
+     * @param positions Pozycje aut w 3D (używane są składowe X oraz Z).
+     * @param radius Promień okręgu kolizyjnego (wspólny dla wszystkich aut).
+     * @param outPush Wynik: wektor wypchnięcia dla każdej pozycji (zero gdy brak kolizji).
+     * @param outCollided Wynik: 1 gdy auto `i` koliduje ze ścianą, 0 w przeciwnym razie.
+     * @return Liczba pozycji, dla których wykryto kolizję.
+     */
+    size_t FindCollisionPushBatch(const std::vector<glm::vec3>& positions, float radius,
+        std::vector<glm::vec2>& outPush, std::vector<unsigned char>& outCollided) const;
+
+    /**
+     * @brief Zwraca nazwę aktywnego wariantu jądra kolizji (`"AVX2"`, `"SSE2"` lub `"scalar"`).
+     * @return Nazwa wariantu wybranego podczas kompilacji.
+     */
+    static const char* GetKernelName();
 
     /**
      * @brief Zwraca referencję do listy ścian (np. do debugowania lub rysowania minimapy).
      * @return Referencja do wektora `walls`.
      */
-    static const std::vector<WallSegment>& GetWalls();
+    const std::vector<WallSegment>& GetWalls() const;
+
+private:
+    /** @brief Odcinki ścian zbudowane z polilinii stron toru. */
+    std::vector<WallSegment> walls;
+
+    /** @brief Lewy dolny róg siatki (min X, min Z). */
+    glm::vec2 gridOrigin = glm::vec2(0.0f);
+
+    /** @brief Rozmiar boku komórki siatki. */
+    float gridCellSize = 1.0f;
+
+    /** @brief Liczba komórek siatki w osi X. */
+    int gridCols = 0;
+
+    /** @brief Liczba komórek siatki w osi Z. */
+    int gridRows = 0;
+
+    /**
+     * @brief Początki list odcinków dla kolejnych komórek (układ CSR, rozmiar `gridCols * gridRows + 1`).
+     *
+     * Odcinki komórki `c` to `gridSegments[gridCellStart[c] .. gridCellStart[c + 1])`.
+     */
+    std::vector<unsigned int> gridCellStart;
+
+    /** @brief Indeksy odcinków `walls` pogrupowane według komórek. */
+    std::vector<unsigned int> gridSegments;
+
+    /** @brief Współrzędne odcinków w kolejności `gridSegments` (SoA, ciągłe zakresy per komórka). */
+    WallSoA gridWalls;
+
+    /**
+     * @brief Buduje siatkę przestrzenną nad aktualną listą `walls`.
+     * @param cellSize Rozmiar boku komórki.
+     */
+    void BuildGrid(float cellSize);
+
+    /**
+     * @brief Wyznacza zakres komórek pokrytych przez AABB okręgu.
+     * @param p Środek okręgu (XZ).
+     * @param radius Promień okręgu.
+     * @param x0 Pierwsza kolumna (wynik).
+     * @param z0 Pierwszy wiersz (wynik).
+     * @param x1 Ostatnia kolumna (wynik, włącznie).
+     * @param z1 Ostatni wiersz (wynik, włącznie).
+     * @return `false` jeśli okrąg leży całkowicie poza siatką (brak kandydatów).
+     */
+    bool GetCellRange(const glm::vec2& p, float radius, int& x0, int& z0, int& x1, int& z1) const;
+
+    /** @brief Nagłówek aktualnego pola odległości (`cols == 0` = brak pola). */
+    DistanceFieldHeader distanceHeader{};
+
+    /** @brief Próbki pola odległości (wierszami Z). */
+    std::vector<DistanceSample> distanceSamples;
+
+    /**
+     * @brief Wstępna klasyfikacja okręgu na podstawie pola odległości.
+     * @param p Środek okręgu (XZ).
+     * @param radius Promień okręgu.
+     * @return -1 gdy na pewno brak kolizji, 1 gdy na pewno kolizja, 0 gdy potrzebny dokładny test (lub brak pola).
+     */
+    int ClassifyByDistance(const glm::vec2& p, float radius) const;
+
+    /**
+     * @brief Liczy skrót aktualnych ścian (sprawdzenie, czy wczytane pole pasuje do odcinków).
+     * @return Skrót FNV-1a (64 bit).
+     */
+    uint64_t HashWalls() const;
 };
\ No newline at end of file
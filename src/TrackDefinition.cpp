@@ -0,0 +1,267 @@
+﻿#include "TrackDefinition.h"
+#include "MeshCache.h"
+#include "TrackFile.h"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @file TrackDefinition.cpp
+ * @brief Implementacja wczytywania definicji toru z pliku tekstowego i binarnego cache.
+ */
+
+ /**
+  * @brief Zawartość sekcji `TrackSection::Start`: pole startowe i parametry budowy kolizji oraz linii środkowej.
+  */
+struct TrackStartSection {
+    /** @brief Pozycja pola startowego (x, y, z). */
+    float gridPosition[3];
+
+    /** @brief Yaw startowy (w stopniach). */
+    float gridYaw;
+
+    /** @brief Kierunek jazdy na starcie (x, y, z). */
+    float gridForward[3];
+
+    /** @brief Minimalna szerokość toru. */
+    float minTrackWidth;
+
+    /** @brief Rozmiar komórki siatki zapytań. */
+    float gridCellSize;
+
+    /** @brief Odstęp próbek pola odległości. */
+    float distanceCellSize;
+
+    /** @brief Odstęp próbek linii środkowej. */
+    float centerlineSpacing;
+
+    /** @brief Liczba sektorów pomiaru czasu. */
+    int32_t sectorCount;
+};
+
+/**
+ * @brief Dopisuje liczbę w najkrótszej postaci, która po wczytaniu daje tę samą wartość `float`.
+ * @param out Strumień wyjściowy.
+ * @param value Liczba.
+ */
+static void WriteFloat(std::ostream& out, float value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out << ' ';
+    out.write(buffer, result.ptr - buffer);
+}
+
+/**
+ * @brief Wczytuje tor z pliku tekstowego przez cache binarny albo wprost z pliku binarnego.
+ * @param path Ścieżka pliku `.track` lub `.r3dtrack`.
+ * @param fromCache Opcjonalnie: `true` gdy dane pochodzą z pliku binarnego.
+ * @return `true` jeśli tor został wczytany.
+ */
+bool TrackDefinition::Load(const std::string& path, bool* fromCache) {
+    if (fromCache) *fromCache = false;
+
+    if (std::filesystem::path(path).extension() == ".r3dtrack") {
+        if (!LoadBinary(path)) return false;
+        if (fromCache) *fromCache = true;
+        return true;
+    }
+
+    uint64_t hash;
+    if (!MeshCache::HashFile(path, hash)) return false;
+
+    std::string binaryPath = BinaryPath(path);
+    if (LoadBinary(binaryPath, hash)) {
+        if (fromCache) *fromCache = true;
+        return true;
+    }
+
+    if (!LoadText(path)) return false;
+    Bake();
+    if (!SaveBinary(binaryPath, hash))
+        std::cout << "Track cache could not be saved to: " << binaryPath << std::endl;
+    return true;
+}
+
+/**
+ * @brief Parsuje plik tekstowy definicji toru.
+ * @param path Ścieżka pliku `.track`.
+ * @return `true` jeśli plik ma znaną wersję i obie strony toru.
+ */
+bool TrackDefinition::LoadText(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    Clear();
+    int version = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line); std::string key; ss >> key;
+        if (key.empty() || key[0] == '#') continue;
+
+        if (key == "version") ss >> version;
+        else if (key == "name") { std::getline(ss >> std::ws, Name); if (!Name.empty() && Name.back() == '\r') Name.pop_back(); }
+        else if (key == "min_width") ss >> MinTrackWidth;
+        else if (key == "grid_cell") ss >> GridCellSize;
+        else if (key == "sdf_cell") ss >> DistanceCellSize;
+        else if (key == "center_spacing") ss >> CenterlineSpacing;
+        else if (key == "sectors") ss >> SectorCount;
+        else if (key == "start_grid") {
+            ss >> Grid.Position.x >> Grid.Position.y >> Grid.Position.z >> Grid.Yaw
+                >> Grid.Forward.x >> Grid.Forward.y >> Grid.Forward.z;
+        }
+        else if (key == "left") { Point p; if (ss >> p.x >> p.y) LeftSide.push_back(p); }
+        else if (key == "right") { Point p; if (ss >> p.x >> p.y) RightSide.push_back(p); }
+        else if (key == "line") { glm::vec3 p; if (ss >> p.x >> p.y >> p.z) RacingLine.push_back(p); }
+    }
+
+    if (version != TextVersion || LeftSide.size() < 2 || RightSide.size() < 2) {
+        std::cout << "Track file rejected (version or sides): " << path << std::endl;
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Zapisuje definicję w postaci tekstowej.
+ * @param path Ścieżka docelowa.
+ * @return `true` jeśli zapis się powiódł.
+ */
+bool TrackDefinition::SaveText(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out << "version " << TextVersion << "\n";
+    out << "name " << Name << "\n";
+    out << "min_width"; WriteFloat(out, MinTrackWidth); out << "\n";
+    out << "grid_cell"; WriteFloat(out, GridCellSize); out << "\n";
+    out << "sdf_cell"; WriteFloat(out, DistanceCellSize); out << "\n";
+    out << "center_spacing"; WriteFloat(out, CenterlineSpacing); out << "\n";
+    out << "sectors " << SectorCount << "\n";
+
+    out << "start_grid";
+    for (float v : { Grid.Position.x, Grid.Position.y, Grid.Position.z, Grid.Yaw, Grid.Forward.x, Grid.Forward.y, Grid.Forward.z })
+        WriteFloat(out, v);
+    out << "\n";
+
+    for (const Point& p : LeftSide) { out << "left"; WriteFloat(out, p.x); WriteFloat(out, p.y); out << "\n"; }
+    for (const Point& p : RightSide) { out << "right"; WriteFloat(out, p.x); WriteFloat(out, p.y); out << "\n"; }
+    for (const glm::vec3& p : RacingLine) { out << "line"; WriteFloat(out, p.x); WriteFloat(out, p.y); WriteFloat(out, p.z); out << "\n"; }
+    return (bool)out;
+}
+
+/**
+ * @brief Mapuje plik binarny i kopiuje sekcje do pól definicji oraz kolizji.
+ * @param path Ścieżka pliku `.r3dtrack`.
+ * @param expectedSourceHash Wymagany skrót źródła (0 = dowolny).
+ * @return `true` jeśli plik jest poprawny i pasuje do źródła.
+ */
+bool TrackDefinition::LoadBinary(const std::string& path, uint64_t expectedSourceHash) {
+    TrackFileReader reader;
+    if (!reader.Open(path)) return false;
+    if (expectedSourceHash != 0 && reader.GetHeader().sourceHash != expectedSourceHash) return false;
+
+    Clear();
+    std::vector<char> name;
+    TrackStartSection start{};
+    if (!reader.ReadVector(TrackSection::Name, name) ||
+        !reader.ReadVector(TrackSection::LeftSide, LeftSide) ||
+        !reader.ReadVector(TrackSection::RightSide, RightSide) ||
+        !reader.ReadVector(TrackSection::RacingLine, RacingLine) ||
+        !reader.ReadValue(TrackSection::Start, start) ||
+        !Collision.ReadSections(reader) ||
+        !Centerline.ReadSections(reader)) {
+        Clear();
+        return false;
+    }
+
+    Name.assign(name.begin(), name.end());
+    Grid.Position = glm::vec3(start.gridPosition[0], start.gridPosition[1], start.gridPosition[2]);
+    Grid.Yaw = start.gridYaw;
+    Grid.Forward = glm::vec3(start.gridForward[0], start.gridForward[1], start.gridForward[2]);
+    MinTrackWidth = start.minTrackWidth;
+    GridCellSize = start.gridCellSize;
+    DistanceCellSize = start.distanceCellSize;
+    CenterlineSpacing = start.centerlineSpacing;
+    SectorCount = start.sectorCount;
+    SectorTimer::BuildGates(Centerline, SectorCount, SectorGates);
+    return true;
+}
+
+/**
+ * @brief Zapisuje definicję i zbudowaną kolizję jako plik binarny.
+ * @param path Ścieżka docelowa.
+ * @param sourceHash Skrót pliku źródłowego.
+ * @return `true` jeśli zapis się powiódł.
+ */
+bool TrackDefinition::SaveBinary(const std::string& path, uint64_t sourceHash) const {
+    TrackStartSection start{
+        { Grid.Position.x, Grid.Position.y, Grid.Position.z }, Grid.Yaw,
+        { Grid.Forward.x, Grid.Forward.y, Grid.Forward.z },
+        MinTrackWidth, GridCellSize, DistanceCellSize, CenterlineSpacing, SectorCount
+    };
+
+    TrackFileWriter writer;
+    writer.Add(TrackSection::Name, Name.data(), Name.size());
+    writer.AddVector(TrackSection::LeftSide, LeftSide);
+    writer.AddVector(TrackSection::RightSide, RightSide);
+    writer.AddVector(TrackSection::RacingLine, RacingLine);
+    writer.AddValue(TrackSection::Start, start);
+    Collision.WriteSections(writer);
+    Centerline.WriteSections(writer);
+    return writer.Save(path, sourceHash);
+}
+
+/**
+ * @brief Buduje ściany, siatkę, (jeśli `DistanceCellSize > 0`) pole odległości, linię środkową od pola gracza i bramki sektorów.
+ */
+void TrackDefinition::Bake() {
+    Collision.Init(LeftSide, RightSide, MinTrackWidth, GridCellSize);
+    if (DistanceCellSize > 0.0f)
+        Collision.BakeDistanceField(DistanceCellSize);
+    Centerline.Build(LeftSide, RightSide, glm::vec2(Grid.Position.x, Grid.Position.z),
+        glm::vec2(Grid.Forward.x, Grid.Forward.z), CenterlineSpacing);
+    SectorTimer::BuildGates(Centerline, SectorCount, SectorGates);
+}
+
+/**
+ * @brief Usuwa dane toru i kolizję.
+ */
+void TrackDefinition::Clear() {
+    Name.clear();
+    std::vector<Point>().swap(LeftSide);
+    std::vector<Point>().swap(RightSide);
+    std::vector<glm::vec3>().swap(RacingLine);
+    Grid = StartGrid();
+    MinTrackWidth = 2.0f;
+    GridCellSize = 1.0f;
+    DistanceCellSize = TrackCollision::DefaultDistanceCellSize;
+    CenterlineSpacing = TrackCenterline::DefaultSpacing;
+    SectorCount = SectorTimer::DefaultSectorCount;
+    Collision.Shutdown();
+    Centerline.Clear();
+    std::vector<SectorGate>().swap(SectorGates);
+}
+
+/**
+ * @brief Sumuje pamięć danych toru i kolizji.
+ * @return Liczba bajtów.
+ */
+size_t TrackDefinition::GetMemoryBytes() const {
+    return (LeftSide.capacity() + RightSide.capacity()) * sizeof(Point)
+        + RacingLine.capacity() * sizeof(glm::vec3)
+        + Collision.GetMemoryBytes()
+        + Centerline.GetMemoryBytes()
+        + SectorGates.capacity() * sizeof(SectorGate);
+}
+
+/**
+ * @brief Zamienia rozszerzenie pliku tekstowego na `.r3dtrack`.
+ * @param textPath Ścieżka pliku `.track`.
+ * @return Ścieżka pliku binarnego.
+ */
+std::string TrackDefinition::BinaryPath(const std::string& textPath) {
+    return std::filesystem::path(textPath).replace_extension(".r3dtrack").string();
+}
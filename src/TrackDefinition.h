@@ -0,0 +1,140 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RaceRules.h"
+#include "TrackCenterline.h"
+#include "TrackCollision.h"
+#include "SectorTimer.h"
+
+/**
+ * @file TrackDefinition.h
+ * @brief Definicja toru wczytywana z pliku: strony toru, linia jazdy AI, pole startowe, kolizja, linia środkowa i sektory.
+ */
+
+ /**
+  * @brief Dane jednego toru zamiast stałych wpisanych w kod (ściany, trasa AI, start).
+ *
+ * Źródłem jest plik tekstowy `.track` (edytowalny, w repozytorium). Przy pierwszym wczytaniu
+ * budowane są ściany, siatka zapytań, pole odległości i linia środkowa, a wynik trafia do pliku `.r3dtrack` obok źródła.
+ * Kolejne uruchomienia mapują plik binarny i pomijają budowanie, dopóki skrót źródła się zgadza.
+ *
+ * Format tekstowy: jedna komenda na wiersz, `#` rozpoczyna komentarz.
+ * - `version 1`, `name <nazwa>`,
+ * - `min_width <w>`, `grid_cell <c>`, `sdf_cell <c>` — parametry budowy kolizji (`sdf_cell 0` = bez pola),
+ * - `center_spacing <d>` — odstęp próbek linii środkowej,
+ * - `sectors <n>` — liczba sektorów pomiaru czasu (bramki w równych odstępach linii środkowej),
+ * - `start_grid <x> <y> <z> <yaw> <fx> <fy> <fz>` — pole startowe (linia startu/mety przechodzi przez pole gracza),
+ * - `left <x> <z>`, `right <x> <z>` — kolejne punkty stron toru,
+ * - `line <x> <y> <z>` — kolejne punkty linii jazdy AI.
+ */
+class TrackDefinition {
+public:
+    /** @brief Wersja formatu tekstowego. */
+    static constexpr int TextVersion = 1;
+
+    /** @brief Nazwa toru. */
+    std::string Name;
+
+    /** @brief Surowa polilinia lewej strony toru (`Point::y` = Z). */
+    std::vector<Point> LeftSide;
+
+    /** @brief Surowa polilinia prawej strony toru. */
+    std::vector<Point> RightSide;
+
+    /** @brief Punkty linii jazdy AI w kolejności jazdy. */
+    std::vector<glm::vec3> RacingLine;
+
+    /** @brief Pole startowe (pozycja gracza, yaw, kierunek). */
+    StartGrid Grid;
+
+    /** @brief Minimalna szerokość toru przy budowie ścian. */
+    float MinTrackWidth = 2.0f;
+
+    /** @brief Rozmiar komórki siatki zapytań kolizji. */
+    float GridCellSize = 1.0f;
+
+    /** @brief Odstęp próbek pola odległości (0 = bez pola). */
+    float DistanceCellSize = TrackCollision::DefaultDistanceCellSize;
+
+    /** @brief Odstęp próbek linii środkowej. */
+    float CenterlineSpacing = TrackCenterline::DefaultSpacing;
+
+    /** @brief Liczba sektorów pomiaru czasu. */
+    int SectorCount = SectorTimer::DefaultSectorCount;
+
+    /** @brief Ściany i struktury zapytań kolizji tego toru. */
+    TrackCollision Collision;
+
+    /** @brief Linia środkowa (dystans wzdłuż toru: okrążenia, kolejność, minimapa). */
+    TrackCenterline Centerline;
+
+    /** @brief Bramki sektorów (wyznaczane z linii środkowej po budowie lub wczytaniu, bramka 0 = linia startu/mety). */
+    std::vector<SectorGate> SectorGates;
+
+    /**
+     * @brief Wczytuje tor z pliku `.track` (przez cache `.r3dtrack`) albo wprost z pliku `.r3dtrack`.
+     *
+     * Dla pliku tekstowego: jeśli obok leży plik binarny z pasującym skrótem źródła, jest on mapowany;
+     * w przeciwnym razie tekst jest parsowany, kolizja budowana (`Bake`), a plik binarny zapisywany.
+     *
+     * @param path Ścieżka pliku `.track` lub `.r3dtrack`.
+     * @param fromCache Opcjonalnie: `true` gdy dane pochodzą z pliku binarnego.
+     * @return `true` jeśli tor został wczytany.
+     */
+    bool Load(const std::string& path, bool* fromCache = nullptr);
+
+    /**
+     * @brief Parsuje plik tekstowy (bez budowania kolizji).
+     * @param path Ścieżka pliku `.track`.
+     * @return `true` jeśli plik ma znaną wersję i obie strony toru.
+     */
+    bool LoadText(const std::string& path);
+
+    /**
+     * @brief Zapisuje definicję w postaci tekstowej (liczby w najkrótszej postaci odtwarzającej wartość).
+     * @param path Ścieżka docelowa.
+     * @return `true` jeśli zapis się powiódł.
+     */
+    bool SaveText(const std::string& path) const;
+
+    /**
+     * @brief Mapuje plik binarny i wczytuje wszystkie sekcje.
+     * @param path Ścieżka pliku `.r3dtrack`.
+     * @param expectedSourceHash Wymagany skrót źródła (0 = dowolny).
+     * @return `true` jeśli plik jest poprawny i pasuje do źródła.
+     */
+    bool LoadBinary(const std::string& path, uint64_t expectedSourceHash = 0);
+
+    /**
+     * @brief Zapisuje definicję i zbudowaną kolizję jako plik binarny.
+     * @param path Ścieżka docelowa.
+     * @param sourceHash Skrót pliku źródłowego zapisywany w nagłówku.
+     * @return `true` jeśli zapis się powiódł.
+     */
+    bool SaveBinary(const std::string& path, uint64_t sourceHash) const;
+
+    /**
+     * @brief Buduje kolizję (ściany, siatka, pole odległości), linię środkową i bramki sektorów z aktualnych stron toru.
+     */
+    void Bake();
+
+    /**
+     * @brief Usuwa wszystkie dane toru (parametry wracają do domyślnych).
+     */
+    void Clear();
+
+    /**
+     * @brief Szacuje pamięć zajmowaną przez dane toru i kolizję.
+     * @return Liczba bajtów (pojemności wektorów).
+     */
+    size_t GetMemoryBytes() const;
+
+    /**
+     * @brief Zwraca ścieżkę pliku binarnego dla pliku tekstowego.
+     * @param textPath Ścieżka pliku `.track`.
+     * @return Ścieżka pliku `.r3dtrack`.
+     */
+    static std::string BinaryPath(const std::string& textPath);
+};
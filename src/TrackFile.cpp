@@ -0,0 +1,197 @@
+﻿#include "TrackFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file TrackFile.cpp
+ * @brief Implementacja mapowania plików oraz zapisu i odczytu kontenera `.r3dtrack`.
+ */
+
+ /**
+  * @brief Zwalnia mapowanie.
+  */
+MappedFile::~MappedFile() {
+    Close();
+}
+
+/**
+ * @brief Mapuje plik tylko do odczytu.
+ * @param path Ścieżka do pliku.
+ * @return `true` jeśli plik został zmapowany.
+ */
+bool MappedFile::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    HANDLE fileH = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileH == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileH, &fileSize) || fileSize.QuadPart == 0) { CloseHandle(fileH); return false; }
+
+    HANDLE mappingH = CreateFileMappingA(fileH, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingH) { CloseHandle(fileH); return false; }
+
+    void* view = MapViewOfFile(mappingH, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mappingH); CloseHandle(fileH); return false; }
+
+    fileHandle = fileH;
+    mappingHandle = mappingH;
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Mapowanie pozostaje ważne po zamknięciu deskryptora.
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+/**
+ * @brief Zwalnia mapowanie (bezpieczne dla niezmapowanego obiektu).
+ */
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = fileHandle = nullptr;
+#else
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+/**
+ * @brief Dodaje sekcję.
+ * @param id Identyfikator sekcji.
+ * @param data Dane.
+ * @param size Rozmiar danych.
+ */
+void TrackFileWriter::Add(TrackSection id, const void* data, size_t size) {
+    ids.push_back((uint32_t)id);
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    blobs.emplace_back(bytes, bytes + size);
+}
+
+/**
+ * @brief Zapisuje nagłówek, tabelę sekcji i wyrównane dane sekcji.
+ * @param path Ścieżka docelowa.
+ * @param sourceHash Skrót źródła.
+ * @return `true` jeśli zapis się powiódł.
+ */
+bool TrackFileWriter::Save(const std::string& path, uint64_t sourceHash) const {
+    auto align = [](uint64_t v) { return (v + TrackFile::Alignment - 1) / TrackFile::Alignment * TrackFile::Alignment; };
+
+    TrackFileHeader header{};
+    std::memcpy(header.magic, "R3DT", 4);
+    header.version = TrackFile::Version;
+    header.sourceHash = sourceHash;
+    header.sectionCount = (uint32_t)ids.size();
+
+    std::vector<TrackFileSection> table(ids.size());
+    uint64_t offset = align(sizeof(TrackFileHeader) + table.size() * sizeof(TrackFileSection));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        table[i].id = ids[i];
+        table[i].offset = offset;
+        table[i].size = blobs[i].size();
+        offset = align(offset + blobs[i].size());
+    }
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        const char padding[TrackFile::Alignment] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), (std::streamsize)(table.size() * sizeof(TrackFileSection)));
+        uint64_t written = sizeof(header) + table.size() * sizeof(TrackFileSection);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            file.write(padding, (std::streamsize)(table[i].offset - written));
+            file.write(reinterpret_cast<const char*>(blobs[i].data()), (std::streamsize)blobs[i].size());
+            written = table[i].offset + blobs[i].size();
+        }
+        if (!file) {
+            // Nieudany zapis: usuwamy niepełny plik tymczasowy (zamknięty, żeby usunięcie działało także na Windows).
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Mapuje plik i sprawdza nagłówek oraz granice sekcji.
+ * @param path Ścieżka pliku.
+ * @return `true` jeśli plik jest poprawny.
+ */
+bool TrackFileReader::Open(const std::string& path) {
+    sections = nullptr;
+    if (!file.Open(path)) return false;
+    if (file.Size() < sizeof(TrackFileHeader)) return false;
+
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, "R3DT", 4) != 0 || header.version != TrackFile::Version) return false;
+
+    uint64_t tableEnd = sizeof(TrackFileHeader) + (uint64_t)header.sectionCount * sizeof(TrackFileSection);
+    if (tableEnd > file.Size()) return false;
+
+    const TrackFileSection* table = reinterpret_cast<const TrackFileSection*>(file.Data() + sizeof(TrackFileHeader));
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const TrackFileSection& s = table[i];
+        if (s.offset % TrackFile::Alignment != 0 || s.offset < tableEnd || s.offset > file.Size() || s.size > file.Size() - s.offset) return false;
+    }
+    sections = table;
+    return true;
+}
+
+/**
+ * @brief Wyszukuje sekcję w tabeli.
+ * @param id Identyfikator sekcji.
+ * @param outData Początek danych (wynik).
+ * @param outSize Rozmiar danych (wynik).
+ * @return `false` gdy sekcji nie ma.
+ */
+bool TrackFileReader::Find(TrackSection id, const unsigned char*& outData, size_t& outSize) const {
+    if (!sections) return false;
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        if (sections[i].id != (uint32_t)id) continue;
+        outData = file.Data() + sections[i].offset;
+        outSize = (size_t)sections[i].size;
+        return true;
+    }
+    return false;
+}
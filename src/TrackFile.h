@@ -0,0 +1,256 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file TrackFile.h
+ * @brief Kontener binarny `.r3dtrack`: nagłówek, tabela sekcji i odczyt przez mapowanie pliku (bez OpenGL).
+ */
+
+ /**
+  * @brief Nagłówek pliku `.r3dtrack` (za nim `sectionCount` wpisów `TrackFileSection`, potem dane sekcji).
+  */
+struct TrackFileHeader {
+    /** @brief Sygnatura pliku: `R3DT`. */
+    char magic[4];
+
+    /** @brief Wersja formatu (`TrackFile::Version`). */
+    uint32_t version;
+
+    /** @brief Skrót FNV-1a pliku źródłowego (postać tekstowa) lub 0, gdy plik nie ma źródła. */
+    uint64_t sourceHash;
+
+    /** @brief Liczba sekcji. */
+    uint32_t sectionCount;
+
+    /** @brief Zarezerwowane (0). */
+    uint32_t reserved;
+};
+
+/**
+ * @brief Wpis tabeli sekcji: identyfikator i położenie danych w pliku.
+ */
+struct TrackFileSection {
+    /** @brief Identyfikator sekcji (`TrackSection`). */
+    uint32_t id;
+
+    /** @brief Zarezerwowane (0). */
+    uint32_t reserved;
+
+    /** @brief Przesunięcie danych od początku pliku (wyrównane do `TrackFile::Alignment`). */
+    uint64_t offset;
+
+    /** @brief Rozmiar danych w bajtach. */
+    uint64_t size;
+};
+
+/**
+ * @brief Identyfikatory sekcji pliku toru.
+ */
+enum class TrackSection : uint32_t {
+    /** @brief Nazwa toru (znaki bez terminatora). */
+    Name = 1,
+    /** @brief Lewa strona toru (`Point[]`). */
+    LeftSide,
+    /** @brief Prawa strona toru (`Point[]`). */
+    RightSide,
+    /** @brief Linia jazdy AI (`glm::vec3[]`). */
+    RacingLine,
+    /** @brief Pole startowe, parametry budowy kolizji i linii środkowej oraz liczba sektorów. */
+    Start,
+    /** @brief Odcinki ścian (`WallSegment[]`). */
+    Walls,
+    /** @brief Parametry siatki zapytań (początek, rozmiar komórki, wymiary). */
+    Grid,
+    /** @brief Początki list odcinków komórek (CSR, `uint32_t[]`). */
+    GridCellStart,
+    /** @brief Indeksy odcinków pogrupowane według komórek (`uint32_t[]`). */
+    GridSegments,
+    /** @brief Współrzędne odcinków siatki (SoA: ax, ay, bx, by — `float[4 * n]`). */
+    GridWalls,
+    /** @brief Nagłówek pola odległości (`DistanceFieldHeader`). */
+    DistanceHeader,
+    /** @brief Próbki pola odległości (`DistanceSample[]`). */
+    DistanceSamples,
+    /** @brief Próbki linii środkowej (`CenterlineSample[]`). */
+    CenterlineSamples,
+    /** @brief Parametry siatki zapytań linii środkowej. */
+    CenterlineGrid,
+    /** @brief Początki list odcinków linii środkowej w komórkach (CSR, `uint32_t[]`). */
+    CenterlineCellStart,
+    /** @brief Indeksy odcinków linii środkowej pogrupowane według komórek (`uint32_t[]`). */
+    CenterlineSegments
+};
+
+/**
+ * @brief Plik zmapowany w pamięci tylko do odczytu (`mmap` / `MapViewOfFile`).
+ *
+ * Dane są dostępne bez kopiowania całego pliku do bufora; strony wczytuje system przy pierwszym dostępie.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /** @brief Zwalnia mapowanie. */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Mapuje plik (poprzednie mapowanie jest zwalniane).
+     * @param path Ścieżka do pliku.
+     * @return `true` jeśli plik istnieje, jest niepusty i został zmapowany.
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Zwalnia mapowanie.
+     */
+    void Close();
+
+    /** @brief Zwraca początek danych pliku (lub `nullptr`). */
+    const unsigned char* Data() const { return data; }
+
+    /** @brief Zwraca rozmiar pliku w bajtach. */
+    size_t Size() const { return size; }
+
+private:
+    /** @brief Początek mapowania. */
+    const unsigned char* data = nullptr;
+
+    /** @brief Rozmiar mapowania. */
+    size_t size = 0;
+
+#ifdef _WIN32
+    /** @brief Uchwyt pliku (Windows). */
+    void* fileHandle = nullptr;
+
+    /** @brief Uchwyt mapowania (Windows). */
+    void* mappingHandle = nullptr;
+#endif
+};
+
+/**
+ * @brief Stałe formatu `.r3dtrack`.
+ */
+class TrackFile {
+public:
+    /** @brief Wersja formatu (zmiana układu sekcji lub sposobu wypiekania unieważnia stare pliki). */
+    static constexpr uint32_t Version = 3;
+
+    /** @brief Wyrównanie danych sekcji w pliku (tablice `float`/`uint32_t` można czytać wprost z mapowania). */
+    static constexpr size_t Alignment = 16;
+};
+
+/**
+ * @brief Składa sekcje w pamięci i zapisuje je jako plik `.r3dtrack`.
+ */
+class TrackFileWriter {
+public:
+    /**
+     * @brief Dodaje sekcję (dane są kopiowane).
+     * @param id Identyfikator sekcji.
+     * @param data Dane.
+     * @param size Rozmiar danych w bajtach.
+     */
+    void Add(TrackSection id, const void* data, size_t size);
+
+    /**
+     * @brief Dodaje sekcję z zawartością wektora.
+     * @param id Identyfikator sekcji.
+     * @param values Elementy (typ trywialnie kopiowalny).
+     */
+    template <typename T>
+    void AddVector(TrackSection id, const std::vector<T>& values) { Add(id, values.data(), values.size() * sizeof(T)); }
+
+    /**
+     * @brief Dodaje sekcję z jedną wartością.
+     * @param id Identyfikator sekcji.
+     * @param value Wartość (typ trywialnie kopiowalny).
+     */
+    template <typename T>
+    void AddValue(TrackSection id, const T& value) { Add(id, &value, sizeof(T)); }
+
+    /**
+     * @brief Zapisuje plik (plik tymczasowy + zmiana nazwy).
+     * @param path Ścieżka docelowa.
+     * @param sourceHash Skrót źródła zapisywany w nagłówku.
+     * @return `true` jeśli zapis się powiódł.
+     */
+    bool Save(const std::string& path, uint64_t sourceHash) const;
+
+private:
+    /** @brief Identyfikatory sekcji w kolejności dodania. */
+    std::vector<uint32_t> ids;
+
+    /** @brief Dane sekcji. */
+    std::vector<std::vector<unsigned char>> blobs;
+};
+
+/**
+ * @brief Odczyt pliku `.r3dtrack` przez mapowanie pliku.
+ */
+class TrackFileReader {
+public:
+    /**
+     * @brief Mapuje plik i sprawdza nagłówek oraz tabelę sekcji.
+     * @param path Ścieżka pliku.
+     * @return `true` jeśli plik ma właściwą sygnaturę i wersję, a sekcje mieszczą się w pliku.
+     */
+    bool Open(const std::string& path);
+
+    /** @brief Zwraca nagłówek otwartego pliku. */
+    const TrackFileHeader& GetHeader() const { return header; }
+
+    /**
+     * @brief Wyszukuje sekcję.
+     * @param id Identyfikator sekcji.
+     * @param outData Początek danych w mapowaniu (wynik).
+     * @param outSize Rozmiar danych (wynik).
+     * @return `false` gdy sekcji nie ma.
+     */
+    bool Find(TrackSection id, const unsigned char*& outData, size_t& outSize) const;
+
+    /**
+     * @brief Kopiuje sekcję do wektora.
+     * @param id Identyfikator sekcji.
+     * @param out Wynikowe elementy.
+     * @return `false` gdy sekcji nie ma albo jej rozmiar nie jest wielokrotnością `sizeof(T)`.
+     */
+    template <typename T>
+    bool ReadVector(TrackSection id, std::vector<T>& out) const {
+        const unsigned char* data;
+        size_t size;
+        if (!Find(id, data, size) || size % sizeof(T) != 0) return false;
+        out.assign(reinterpret_cast<const T*>(data), reinterpret_cast<const T*>(data + size));
+        return true;
+    }
+
+    /**
+     * @brief Kopiuje sekcję zawierającą jedną wartość.
+     * @param id Identyfikator sekcji.
+     * @param out Wartość (wynik).
+     * @return `false` gdy sekcji nie ma albo ma inny rozmiar.
+     */
+    template <typename T>
+    bool ReadValue(TrackSection id, T& out) const {
+        const unsigned char* data;
+        size_t size;
+        if (!Find(id, data, size) || size != sizeof(T)) return false;
+        out = *reinterpret_cast<const T*>(data);
+        return true;
+    }
+
+private:
+    /** @brief Zmapowany plik. */
+    MappedFile file;
+
+    /** @brief Nagłówek. */
+    TrackFileHeader header{};
+
+    /** @brief Tabela sekcji (wskazuje na mapowanie). */
+    const TrackFileSection* sections = nullptr;
+};
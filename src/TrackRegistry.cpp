@@ -0,0 +1,147 @@
+﻿#include "TrackRegistry.h"
+#include <iostream>
+#include <exception>
+
+/**
+ * @file TrackRegistry.cpp
+ * @brief Implementacja rejestru tras z leniwym wczytywaniem i wyładowywaniem LRU.
+ */
+
+ /**
+  * @brief Konstruktor.
+  * @param loader Loader zasobów.
+  * @param budgetBytes Budżet pamięci w bajtach.
+  */
+TrackRegistry::TrackRegistry(AssetLoader& loader, size_t budgetBytes)
+    : loader(loader), budget(budgetBytes) {
+}
+
+/**
+ * @brief Dodaje trasę do rejestru (bez wczytywania).
+ * @param name Nazwa trasy.
+ * @param load Część CPU wczytywania.
+ * @param unload Zwolnienie zasobów.
+ * @param size Pomiar pamięci.
+ * @return Identyfikator trasy.
+ */
+int TrackRegistry::Register(const std::string& name, AssetLoader::LoadFn load, UnloadFn unload, SizeFn size) {
+    Entry e;
+    e.name = name;
+    e.load = std::move(load);
+    e.unload = std::move(unload);
+    e.size = std::move(size);
+    entries.push_back(std::move(e));
+    return (int)entries.size() - 1;
+}
+
+/**
+ * @brief Ustawia trasę jako bieżącą i zleca jej wczytanie, jeśli nie jest wczytana ani w trakcie.
+ *
+ * Upload trasy ustawia stan `Resident`, mierzy jej pamięć i egzekwuje budżet. Nieudane wczytanie
+ * (wyjątek albo pusty upload) przywraca stan `Unloaded`, więc ponowny wybór trasy ponawia próbę.
+ *
+ * @param id Identyfikator trasy.
+ */
+void TrackRegistry::Request(int id) {
+    if (id < 0 || id >= (int)entries.size()) return;
+
+    current = id;
+    Entry& e = entries[id];
+    e.lastUsed = ++useCounter;
+
+    if (e.state == State::Unloaded) {
+        e.state = State::Loading;
+        AssetLoader::LoadFn load = e.load;
+        loader.Enqueue(e.name, [this, id, load]() -> AssetLoader::UploadFn {
+            // Wyjątek ani pusty upload nie mogą zostawić trasy w stanie `Loading` — zakończenie zawsze wraca do rejestru.
+            AssetLoader::UploadFn upload;
+            try {
+                if (load) upload = load();
+            }
+            catch (const std::exception& ex) {
+                std::cout << "TrackRegistry: blad wczytywania trasy: " << ex.what() << std::endl;
+            }
+            return [this, id, upload]() {
+                Entry& done = entries[id];
+                if (!upload) {
+                    done.state = State::Unloaded;
+                    done.bytes = 0;
+                    std::cout << "Nie wczytano trasy: " << done.name << std::endl;
+                    return;
+                }
+                upload();
+                done.state = State::Resident;
+                done.bytes = done.size ? done.size() : 0;
+                std::cout << "Wczytano trase: " << done.name << " (" << done.bytes / 1024 << " KB)" << std::endl;
+                enforceBudget();
+                };
+            });
+    }
+
+    enforceBudget();
+}
+
+/**
+ * @brief Zwraca stan trasy.
+ * @param id Identyfikator trasy.
+ * @return Stan trasy.
+ */
+TrackRegistry::State TrackRegistry::GetState(int id) const {
+    if (id < 0 || id >= (int)entries.size()) return State::Unloaded;
+    return entries[id].state;
+}
+
+/**
+ * @brief Zmienia budżet pamięci.
+ * @param budgetBytes Nowy budżet w bajtach.
+ */
+void TrackRegistry::SetBudgetBytes(size_t budgetBytes) {
+    budget = budgetBytes;
+    enforceBudget();
+}
+
+/**
+ * @brief Sumuje pamięć wczytanych tras.
+ * @return Liczba bajtów.
+ */
+size_t TrackRegistry::GetResidentBytes() const {
+    size_t total = 0;
+    for (const Entry& e : entries)
+        if (e.state == State::Resident) total += e.bytes;
+    return total;
+}
+
+/**
+ * @brief Wyładowuje wszystkie wczytane trasy.
+ */
+void TrackRegistry::UnloadAll() {
+    for (Entry& e : entries)
+        if (e.state == State::Resident) unload(e);
+}
+
+/**
+ * @brief Wyładowuje trasy LRU (bez bieżącej i tych w trakcie wczytywania), aż suma zmieści się w budżecie.
+ */
+void TrackRegistry::enforceBudget() {
+    while (GetResidentBytes() > budget) {
+        Entry* victim = nullptr;
+        for (int i = 0; i < (int)entries.size(); i++) {
+            Entry& e = entries[i];
+            if (i == current || e.state != State::Resident) continue;
+            if (!victim || e.lastUsed < victim->lastUsed) victim = &e;
+        }
+        if (!victim) break;
+        unload(*victim);
+    }
+}
+
+/**
+ * @brief Zwalnia zasoby trasy i oznacza ją jako niewczytaną.
+ * @param e Wpis trasy.
+ */
+void TrackRegistry::unload(Entry& e) {
+    if (e.unload) e.unload();
+    std::cout << "Wyladowano trase: " << e.name << " (" << e.bytes / 1024 << " KB)" << std::endl;
+    e.state = State::Unloaded;
+    e.bytes = 0;
+}
@@ -0,0 +1,118 @@
+﻿#pragma once
+#include "AssetLoader.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file TrackRegistry.h
+ * @brief Rejestr tras wczytywanych leniwie (przy pierwszym wyborze) i wyładowywanych po przekroczeniu budżetu pamięci.
+ */
+
+ /**
+  * @brief Rejestr tras: każda trasa ma funkcje wczytania (przez `AssetLoader`), wyładowania i pomiaru pamięci.
+  *
+  * `Request()` oznacza trasę jako używaną i — jeśli nie jest wczytana — dodaje jej wczytywanie
+  * do kolejki loadera. Po każdym uploadzie i każdym `Request()` rejestr wyładowuje najdawniej
+  * używane trasy (poza bieżącą), dopóki suma pamięci wczytanych tras przekracza budżet.
+  *
+  * Wszystkie metody wołane są z wątku GL; na wątku roboczym wykonuje się tylko `LoadFn`.
+  */
+class TrackRegistry {
+public:
+    /** @brief Stan trasy w rejestrze. */
+    enum class State {
+        Unloaded,
+        Loading,
+        Resident
+    };
+
+    /** @brief Funkcja mierząca pamięć wczytanej trasy (w bajtach). */
+    using SizeFn = std::function<size_t()>;
+
+    /** @brief Funkcja zwalniająca zasoby trasy (wątek GL). */
+    using UnloadFn = std::function<void()>;
+
+    /**
+     * @brief Tworzy rejestr korzystający z podanego loadera.
+     * @param loader Loader zasobów (musi żyć dłużej niż rejestr).
+     * @param budgetBytes Budżet pamięci wczytanych tras.
+     */
+    TrackRegistry(AssetLoader& loader, size_t budgetBytes);
+
+    /**
+     * @brief Rejestruje trasę.
+     * @param name Nazwa (wyświetlana na ekranie ładowania).
+     * @param load Część CPU wczytywania; zwraca upload tworzący zasoby GPU (pusty upload lub wyjątek = błąd, trasa wraca do `Unloaded`).
+     * @param unload Zwolnienie zasobów trasy.
+     * @param size Pomiar pamięci wczytanej trasy.
+     * @return Identyfikator trasy (kolejne liczby od 0).
+     */
+    int Register(const std::string& name, AssetLoader::LoadFn load, UnloadFn unload, SizeFn size);
+
+    /**
+     * @brief Wybiera trasę jako bieżącą; w razie potrzeby dodaje ją do kolejki wczytywania.
+     * @param id Identyfikator trasy.
+     */
+    void Request(int id);
+
+    /**
+     * @brief Zwraca stan trasy.
+     * @param id Identyfikator trasy.
+     * @return Stan (`Unloaded` dla nieznanego id).
+     */
+    State GetState(int id) const;
+
+    /**
+     * @brief Sprawdza, czy trasa jest wczytana.
+     * @param id Identyfikator trasy.
+     * @return `true` gdy stan to `Resident`.
+     */
+    bool IsResident(int id) const { return GetState(id) == State::Resident; }
+
+    /**
+     * @brief Ustawia budżet pamięci i od razu go egzekwuje.
+     * @param budgetBytes Nowy budżet w bajtach.
+     */
+    void SetBudgetBytes(size_t budgetBytes);
+
+    /** @brief Aktualny budżet pamięci w bajtach. */
+    size_t GetBudgetBytes() const { return budget; }
+
+    /** @brief Suma pamięci wczytanych tras w bajtach. */
+    size_t GetResidentBytes() const;
+
+    /**
+     * @brief Wyładowuje wszystkie wczytane trasy (np. przy zamykaniu programu).
+     */
+    void UnloadAll();
+
+private:
+    /** @brief Wpis rejestru. */
+    struct Entry {
+        std::string name;
+        AssetLoader::LoadFn load;
+        UnloadFn unload;
+        SizeFn size;
+        State state = State::Unloaded;
+        size_t bytes = 0;
+        unsigned long long lastUsed = 0;
+    };
+
+    /**
+     * @brief Wyładowuje najdawniej używane trasy (poza bieżącą), dopóki suma przekracza budżet.
+     */
+    void enforceBudget();
+
+    /**
+     * @brief Wyładowuje trasę.
+     * @param e Wpis trasy.
+     */
+    void unload(Entry& e);
+
+    AssetLoader& loader;
+    std::vector<Entry> entries;
+    size_t budget;
+    int current = -1;
+    unsigned long long useCounter = 0;
+};
@@ -19,6 +19,7 @@
 #pragma comment(lib, "winmm.lib")
 
 #include "ProfileManager.h"
+#include "Garage.h"
 
 /**
  * @file main.cpp
@@ -36,46 +37,6 @@
  * @note Jest to „plik-spoiwo”. W przyszłości warto wydzielić moduły: audio, UI, gameplay, rendering.
  */
 
- /**
-  * @brief Struktura przechowująca pełną konfigurację pojedynczego samochodu.
-  *
-  * W `main.cpp` służy jako baza danych garażu:
-  * - `id` jest kluczem logicznym (zapis w profilu),
-  * - `name` jest nazwą wyświetlaną w UI,
-  * - ścieżki `*.obj` wskazują modele do ładowania przez `RaceCar::loadAssets`,
-  * - `price` i parametry kół wspierają sklep i ustawienia wizualne.
-  */
-struct CarData {
-    std::string id;
-    std::string name;
-    std::string bodyPath;
-    std::string wheelFrontPath;
-    std::string wheelBackPath;
-    int price;
-    float wheelFrontX;
-    float wheelBackX;
-    float wheelZ;
-};
-
-/**
- * @brief Baza danych samochodów w garażu.
- *
- * Wartości `wheelFrontX`, `wheelBackX` i `wheelZ` są wykorzystywane do poprawnego ustawienia
- * pozycji kół względem nadwozia w klasie `RaceCar`.
- *
- * @note `wheelBackPath` może być pusty (np. tylko jeden model koła dla przodu i tyłu).
- */
-std::vector<CarData> garage = {
-    {"race", "Racer GT", "assets/cars/OBJ format/race.obj", "assets/cars/OBJ format/wheel-racing.obj", "", 0, 0.45f, 0.45f, 0.48f},
-    {"police", "Police Car", "assets/cars/OBJ format/police.obj", "assets/cars/OBJ format/wheel-default.obj", "", 1000, 0.48f, 0.48f, 0.83f},
-    {"ambulance", "Ambulance", "assets/cars/OBJ format/ambulance.obj", "assets/cars/OBJ format/wheel-default.obj", "", 1200, 0.52f, 0.52f, 0.95f},
-    {"taxi", "Taxi", "assets/cars/OBJ format/taxi.obj", "assets/cars/OBJ format/wheel-default.obj", "", 800, 0.48f, 0.48f, 0.75f},
-    {"van", "Cargo Van", "assets/cars/OBJ format/van.obj", "assets/cars/OBJ format/wheel-truck.obj", "", 900, 0.52f, 0.52f, 0.78f},
-    {"truck", "Heavy Truck", "assets/cars/OBJ format/truck.obj", "assets/cars/OBJ format/wheel-truck.obj", "", 1500, 0.54f, 0.54f, 0.82f},
-    {"hatchback", "Sport Hatch", "assets/cars/OBJ format/hatchback-sports.obj", "assets/cars/OBJ format/wheel-racing.obj", "", 500, 0.45f, 0.45f, 0.82f},
-    {"tractor", "Tractor 500", "assets/cars/OBJ format/tractor.obj", "assets/cars/OBJ format/wheel-tractor-front.obj", "assets/cars/OBJ format/wheel-tractor-back.obj", 2000, 0.55f, 0.75f, 0.60f}
-};
-
 /**
  * @brief Profil gracza zapisujący stan konta i odblokowania.
  *
@@ -99,9 +60,23 @@ ProfileManager playerProfile;
 #include "Camera.h"
 #include "RaceCar.h"
 #include "Track.h"
-#include "TrackCollision.h"
+#include "TrackDefinition.h"
 #include "City.h"
 #include "Model.h"
+#include "FixedTimestep.h"
+#include "AIDriver.h"
+#include "CarCollision.h"
+#include "LapCounter.h"
+#include "SectorTimer.h"
+#include "RaceRules.h"
+#include "AssetLoader.h"
+#include "TrackRegistry.h"
+#include "FrameUniforms.h"
+#include "CarRenderer.h"
+#include "ImageData.h"
+#include "Frustum.h"
+#include "TextureCache.h"
+#include "MeshRegistry.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -160,7 +135,7 @@ unsigned int skyboxShaderID = 0;
 /**
  * @brief Stany gry.
  *
- * - `SPLASH_SCREEN`: krótki ekran ładowania (2.5s),
+ * - `SPLASH_SCREEN`: ekran ładowania (min. 2.5s, do wczytania wszystkich zasobów),
  * - `MAIN_MENU`: menu główne, ustawienia, garaż, wybór trasy,
  * - `RACING`: właściwa rozgrywka.
  */
@@ -179,16 +154,44 @@ RaceCar* car = nullptr;
 RaceCar* aiCar = nullptr;
 
 /**
- * @brief Nawigacja AI po waypointach.
+ * @brief Nawigacja AI po waypointach (patrz `AIDriver`).
+ */
+AIDriver aiDriver;
+
+/**
+ * @brief Definicja toru kartingowego (`assets/karting/gp.track`): ściany, linia jazdy AI i pole startowe.
  *
- * AI jedzie w kierunku bieżącego punktu:
- * - jeśli jest wystarczająco blisko (`aiWaypointRadius`), przechodzi do następnego,
- * - skręt wynika z różnicy yaw względem celu,
- * - gaz jest redukowany przy ostrych zakrętach.
+ * Wczytywana raz w `main()` (z cache `.r3dtrack`), bo pole startowe i trasa AI są używane dla każdej trasy.
+ */
+TrackDefinition kartingTrack;
+
+/**
+ * @brief Kolizje auto–auto w wyścigu (kolejność broadphase zachowywana między krokami).
+ */
+CarCollision carCollision;
+
+/**
+ * @brief Auta przekazywane co krok do `carCollision` (trzymane między krokami, bez alokacji w pętli fizyki).
+ */
+std::vector<CarPhysics*> collisionCars;
+
+/**
+ * @brief Kształty kolizji aut z `collisionCars` (ta sama kolejność).
  */
-std::vector<glm::vec3> aiWaypoints;
-int aiCurrentWaypoint = 0;
-float aiWaypointRadius = 2.7f;
+std::vector<CarShape> collisionShapes;
+
+/**
+ * @brief Wypełnia `collisionCars` i `collisionShapes` — wołane po wczytaniu lub zmianie siatki auta.
+ */
+static void RefreshCarCollisionShapes() {
+    collisionCars.clear();
+    collisionShapes.clear();
+    for (RaceCar* raceCar : { car, aiCar }) {
+        if (!raceCar) continue;
+        collisionCars.push_back(raceCar);
+        collisionShapes.push_back(raceCar->GetCollisionShape());
+    }
+}
 
 /**
  * @brief Obiekty sceny.
@@ -203,6 +206,16 @@ Track* track = nullptr;
 City* city = nullptr;
 Model* kartingMap = nullptr;
 
+/**
+ * @brief Rejestr tras (leniwe wczytywanie + wyładowywanie po przekroczeniu budżetu).
+ *
+ * Obiekt żyje w `main()`; `track`, `city` i `kartingMap` są `nullptr`, dopóki ich trasa nie jest wczytana.
+ */
+TrackRegistry* trackRegistry = nullptr;
+
+/** @brief Budżet pamięci wczytanych tras w MB (ustawienia). */
+int trackMemoryBudgetMB = 128;
+
 /**
  * @brief Stan wejścia z klawiatury.
  *
@@ -216,6 +229,14 @@ float lastFrame = 0.0f;
 /** @brief Aktualny stan gry. */
 GameState currentState = SPLASH_SCREEN;
 
+/**
+ * @brief Zegar symulacji o stałym kroku (domyślnie 120 Hz, maks. 5 kroków nadrabiania na klatkę).
+ *
+ * Fizyka, AI i logika wyścigu są aktualizowane wyłącznie krokami `simClock`,
+ * niezależnie od liczby klatek renderu.
+ */
+FixedTimestep simClock(120.0f, 5);
+
 /** @brief Timer splash screen (przejście do menu po 2.5s). */
 float splashTimer = 0.0f;
 
@@ -245,6 +266,9 @@ bool showSettings = false;
 bool showCarSelect = false;
 bool showTrackSelect = false;
 
+/** @brief Nakładka ze statystykami renderu (odrzucanie, wywołania rysowania) — przełączana F3. */
+bool showRenderStats = false;
+
 /**
  * @brief Wybory w menu.
  *
@@ -283,10 +307,9 @@ bool raceWon = false;
 /**
  * @brief System okrążeń.
  *
- * - `currentLap` jest licznikiem pomocniczym (w HUD wyświetlane jest `currentLap - 1`),
+ * - `playerLaps.CurrentLap` jest licznikiem pomocniczym (w HUD wyświetlane jest `CurrentLap - 1`),
  * - `totalLaps` jest ustalane w menu (1/3/10).
  */
-int currentLap = 1;
 int selectedLapOption = 0;
 int totalLaps = 1;
 
@@ -298,31 +321,25 @@ int totalLaps = 1;
 int sessionMoney = 0;
 
 /**
- * @brief Logika start/meta.
+ * @brief Logika start/meta (patrz `LapCounter`).
  *
- * `lapStartPosition` oraz `lapFinishRadius` definiują „strefę startu/mety”.
- * Flaga `leftStartZone` zapobiega naliczaniu wielu okrążeń bez opuszczenia strefy.
+ * Obaj kierowcy liczą okrążenia po dystansie wzdłuż linii środkowej toru (`kartingTrack.Centerline`).
  */
-glm::vec3 lapStartPosition;
-float lapFinishRadius = 2.0f;
-bool leftStartZone = false;
+LapCounter playerLaps;
 
 /**
- * @brief Stan wyścigu AI.
- *
- * Zasada podobna jak u gracza: AI musi opuścić strefę startu, aby zaliczyć okrążenie.
+ * @brief Międzyczasy gracza na bramkach sektorów `kartingTrack.SectorGates` (najlepsze okrążenie, różnica do niego).
  */
-int aiCurrentLap = 1;
-bool aiLeftStartZone = false;
-bool aiRaceFinished = false;
-bool aiRaceWon = false;
+SectorTimer playerSectors;
 
 /**
- * @brief Wektor kierunku toru używany do wykrywania jazdy „do przodu”.
+ * @brief Stan wyścigu AI.
  *
- * Obliczany na starcie (`trackForward`) i porównywany z `car->FrontVector`.
+ * Zasada jak u gracza: okrążenie jest zaliczane po przejechaniu pełnej długości toru od linii startu/mety.
  */
-glm::vec3 trackForward = glm::vec3(0.0f, 0.0f, 1.0f);
+LapCounter aiLaps;
+bool aiRaceFinished = false;
+bool aiRaceWon = false;
 
 /**
  * @brief Odliczanie przed startem (3-2-1) oraz animacja „GO!”.
@@ -393,34 +410,18 @@ float skyboxVertices[] = {
 };
 
 /**
- * @brief Ładuje zestaw 6 tekstur do cubemapy.
+ * @brief Tworzy pustą cubemapę z parametrami samplingu skyboxa.
+ *
+ * Ściany wypełnia `uploadCubemapFace()` — każda z osobna, gdy jej obraz zostanie zdekodowany.
  *
- * @param faces Ścieżki do tekstur w kolejności GL_TEXTURE_CUBE_MAP_POSITIVE_X + i.
  * @return Identyfikator tekstury cubemap.
  */
-unsigned int loadCubemap(std::vector<std::string> faces)
+unsigned int createCubemap()
 {
     unsigned int textureID;
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-    int width, height, nrChannels;
-    for (unsigned int i = 0; i < faces.size(); i++)
-    {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data)
-        {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
-            );
-            stbi_image_free(data);
-        }
-        else
-        {
-            std::cout << "Cubemap tex failed to load at path: " << faces[i] << std::endl;
-            stbi_image_free(data);
-        }
-    }
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -430,12 +431,29 @@ unsigned int loadCubemap(std::vector<std::string> faces)
     return textureID;
 }
 
+/**
+ * @brief Przesyła jedną ścianę cubemapy z zdekodowanego obrazu.
+ *
+ * @param cubemap Identyfikator tekstury cubemap.
+ * @param face Indeks ściany (GL_TEXTURE_CUBE_MAP_POSITIVE_X + face).
+ * @param image Obraz ściany (RGB).
+ */
+void uploadCubemapFace(unsigned int cubemap, unsigned int face, const ImageData& image)
+{
+    if (!image.Valid()) return;
+
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+        0, GL_RGB, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.get()
+    );
+}
+
 /**
  * @brief Tworzy prosty shader skyboxa w locie (bez plików).
  *
  * Vertex shader:
  * - przekazuje `aPos` jako `TexCoords`,
- * - usuwa translację z macierzy view (przez rzutowanie na mat3),
+ * - bierze `view`/`projection` ze wspólnego bloku `FrameData` (UBO) i usuwa translację z view (mat3),
  * - ustawia `gl_Position = pos.xyww` aby skybox był „w nieskończoności”.
  *
  * Fragment shader:
@@ -448,12 +466,18 @@ unsigned int createSkyboxShaderProgram() {
         #version 330 core
         layout (location = 0) in vec3 aPos;
         out vec3 TexCoords;
-        uniform mat4 projection;
-        uniform mat4 view;
+        layout(std140) uniform FrameData {
+            mat4 view;
+            mat4 projection;
+            vec4 viewPos;
+            vec4 lightPos;
+            vec4 lightColor;
+            vec4 timeParams;
+        };
         void main()
         {
             TexCoords = aPos;
-            vec4 pos = projection * view * vec4(aPos, 1.0);
+            vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
             gl_Position = pos.xyww;
         }
     )";
@@ -481,6 +505,7 @@ unsigned int createSkyboxShaderProgram() {
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
     glLinkProgram(shaderProgram);
+    FrameUniforms::BindProgram(shaderProgram);
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
@@ -488,50 +513,6 @@ unsigned int createSkyboxShaderProgram() {
     return shaderProgram;
 }
 
-/**
- * @brief Wczytuje teksturę 2D z pliku przy użyciu stb_image.
- *
- * Funkcja:
- * - tworzy obiekt tekstury,
- * - wczytuje obraz (`stbi_load`),
- * - ustawia format (RGB/RGBA),
- * - tworzy mipmapy,
- * - ustawia podstawowe parametry samplingu.
- *
- * @param path Ścieżka do pliku obrazu.
- * @return Id tekstury lub 0 w przypadku błędu.
- */
-unsigned int loadTexture(const char* path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-        return 0;
-    }
-    return textureID;
-}
-
 /**
  * @brief Callback resize okna GLFW.
  *
@@ -602,6 +583,10 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         cockpitView = !cockpitView;
     }
 
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        showRenderStats = !showRenderStats;
+    }
+
     handling = false;
 }
 
@@ -741,9 +726,14 @@ void setupFramebuffer(int width, int height) {
  * @brief Renderuje splash screen (ekran startowy) przez ImGui.
  *
  * Jeśli `splashTextureID` jest poprawny, rysuje tę teksturę na całym ekranie,
- * w przeciwnym razie rysuje tło + napis.
+ * w przeciwnym razie rysuje tło + napis. Na dole rysuje pasek postępu ładowania zasobów.
+ *
+ * @param progress Postęp ładowania w zakresie [0, 1].
+ * @param completed Liczba gotowych zasobów.
+ * @param total Liczba wszystkich zasobów.
+ * @param lastAsset Nazwa ostatnio wczytanego zasobu.
  */
-void RenderSplashScreen() {
+void RenderSplashScreen(float progress, int completed, int total, const std::string& lastAsset) {
     ImGui::SetNextWindowPos(ImVec2(0, 0));
     ImGui::SetNextWindowSize(ImVec2(current_width, current_height));
     ImGui::Begin("Splash Screen", nullptr,
@@ -770,9 +760,17 @@ void RenderSplashScreen() {
         ImGui::SetWindowFontScale(1.0f);
     }
 
-    ImGui::SetCursorPosX((current_width - ImGui::CalcTextSize("Loading...").x) * 0.5f);
+    std::string status = "Loading... " + std::to_string(completed) + "/" + std::to_string(total);
+    if (!lastAsset.empty()) status += " (" + lastAsset + ")";
+
+    float barWidth = current_width * 0.5f;
+    ImGui::SetCursorPosX((current_width - barWidth) * 0.5f);
+    ImGui::SetCursorPosY(current_height * 0.86f);
+    ImGui::ProgressBar(progress, ImVec2(barWidth, 0.0f), "");
+
+    ImGui::SetCursorPosX((current_width - ImGui::CalcTextSize(status.c_str()).x) * 0.5f);
     ImGui::SetCursorPosY(current_height * 0.9f);
-    ImGui::Text("Loading...");
+    ImGui::Text("%s", status.c_str());
     ImGui::End();
 }
 
@@ -817,6 +815,7 @@ void RenderCarSelectMenu() {
                             car->WheelBackX = garage[i].wheelBackX;
                             car->WheelZ = garage[i].wheelZ;
                             car->loadAssets(garage[i].bodyPath, garage[i].wheelFrontPath, garage[i].wheelBackPath);
+                            RefreshCarCollisionShapes();
                         }
 
                         playerProfile.save();
@@ -847,7 +846,9 @@ void RenderCarSelectMenu() {
  * `selectedTrack` wpływa na to, co jest renderowane w świecie:
  * - 0: `Track` (arena),
  * - 1: `City`,
- * - 2: `kartingMap` + `TrackCollision`.
+ * - 2: `kartingMap` + `kartingTrack.Collision`.
+ *
+ * Wybór trasy zleca jej wczytanie w `trackRegistry` (jeśli nie jest wczytana).
  */
 void RenderTrackSelectMenu() {
     ImGui::SetNextWindowPos(ImVec2(current_width * 0.5f, current_height * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
@@ -879,12 +880,23 @@ void RenderTrackSelectMenu() {
     ImGui::Text("Selected Track: %s", trackNames[selectedTrack]);
 
     if (ImGui::BeginListBox("##TrackList", ImVec2(-FLT_MIN, 120))) {
-        if (ImGui::Selectable(trackNames[0], selectedTrack == 0)) selectedTrack = 0;
-        if (ImGui::Selectable(trackNames[1], selectedTrack == 1)) selectedTrack = 1;
-        if (ImGui::Selectable(trackNames[2], selectedTrack == 2)) selectedTrack = 2;
+        for (int i = 0; i < 3; i++) {
+            std::string label = trackNames[i];
+            if (trackRegistry && trackRegistry->GetState(i) == TrackRegistry::State::Loading) label += "  (loading...)";
+            label += "##track" + std::to_string(i);
+            if (ImGui::Selectable(label.c_str(), selectedTrack == i)) {
+                selectedTrack = i;
+                if (trackRegistry) trackRegistry->Request(i);
+            }
+        }
         ImGui::EndListBox();
     }
 
+    if (trackRegistry) {
+        ImGui::Text("Track memory: %.1f / %d MB",
+            trackRegistry->GetResidentBytes() / (1024.0f * 1024.0f), trackMemoryBudgetMB);
+    }
+
     ImGui::Spacing();
     ImGui::Text("Time of Day:");
     const char* timeNames[] = { "Night", "Dawn", "Day", "Dusk" };
@@ -909,11 +921,12 @@ void RenderTrackSelectMenu() {
  * Obejmuje:
  * - głośność audio (miniaudio),
  * - V-Sync (SwapInterval),
+ * - częstotliwość kroków fizyki (`simClock`),
  * - strojenie fizyki `RaceCar` w runtime (slidery).
  */
 void RenderSettingsMenu() {
     ImGui::SetNextWindowPos(ImVec2(current_width * 0.5f, current_height * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
-    ImGui::SetNextWindowSize(ImVec2(400, 360));
+    ImGui::SetNextWindowSize(ImVec2(400, 420));
     ImGui::Begin("Settings Menu", &showSettings,
         ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar);
 
@@ -941,6 +954,17 @@ void RenderSettingsMenu() {
         glfwSwapInterval(vsync ? 1 : 0);
     }
 
+    const int tickRates[] = { 60, 120, 240 };
+    const char* tickRateNames[] = { "60 Hz", "120 Hz", "240 Hz" };
+    static int tickRateIndex = 1;
+    if (ImGui::Combo("Physics Tick Rate", &tickRateIndex, tickRateNames, IM_ARRAYSIZE(tickRateNames))) {
+        simClock.SetTickRate((float)tickRates[tickRateIndex]);
+    }
+
+    if (ImGui::SliderInt("Track Memory (MB)", &trackMemoryBudgetMB, 0, 1024)) {
+        if (trackRegistry) trackRegistry->SetBudgetBytes((size_t)trackMemoryBudgetMB * 1024 * 1024);
+    }
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
@@ -1063,7 +1087,9 @@ void RenderMainMenu() {
     ImGui::PushStyleColor(ImGuiCol_Border, ImVec4(1.0f, 0.5f, 0.2f, 1.0f));
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
 
-    if (ImGui::Button("START RACE", buttonSize)) {
+    // Wyścig można zacząć dopiero po wczytaniu wybranej trasy (kolizje, geometria).
+    bool trackReady = !trackRegistry || trackRegistry->IsResident(selectedTrack);
+    if (ImGui::Button(trackReady ? "START RACE" : "LOADING TRACK...", buttonSize) && trackReady) {
 
         currentState = RACING;
 
@@ -1086,63 +1112,25 @@ void RenderMainMenu() {
 
         if (car && aiCar) {
 
-            glm::vec3 scaleFactor(0.1f);
-
-            glm::vec3 startLeft(-127.81f, 0.0f, 204.38f);
-            glm::vec3 startRight(-58.75f, 0.0f, 203.17f);
+            StartGrid grid = kartingTrack.Grid;
 
-            glm::vec3 startPos = (startLeft + startRight) * 0.5f;
-            glm::vec3 dir = glm::normalize(startRight - startLeft);
-
-            float offsetBack = 95.0f;
-            startPos -= dir * offsetBack;
-
-            glm::vec3 rightVec = glm::normalize(glm::cross(dir, glm::vec3(0.0f, 1.0f, 0.0f)));
-            float offsetSide = 5.0f;
-            startPos -= rightVec * offsetSide;
-
-            startPos *= scaleFactor;
-            startPos -= rightVec * 0.3f;
-
-            float startYaw = glm::degrees(atan2(dir.x, dir.z));
-
-            car->Position = startPos;
-            lapStartPosition = car->Position;
+            RaceRules::PlaceOnGrid(*car, grid, 0);
+            RaceRules::PlaceOnGrid(*aiCar, grid, 1);
 
             raceElapsedTime = 0.0f;
             sessionMoney = 0;
 
             raceFinished = false;
             raceWon = false;
-            leftStartZone = false;
             raceTimerActive = false;
 
-            currentLap = 1;
-
-            aiCurrentLap = 1;
-            aiLeftStartZone = false;
+            playerLaps.Reset(kartingTrack.Centerline, car->Position);
+            playerSectors.Reset(kartingTrack.SectorGates, kartingTrack.Centerline.GetLength(), raceElapsedTime);
+            aiLaps.Reset(kartingTrack.Centerline, aiCar->Position);
             aiRaceFinished = false;
             aiRaceWon = false;
 
-            trackForward = glm::normalize(dir);
-
-            car->Velocity = glm::vec3(0.0f);
-            car->Yaw = startYaw;
-            car->FrontVector = glm::normalize(glm::vec3(sin(glm::radians(startYaw)), 0.0f, cos(glm::radians(startYaw))));
-
-            glm::vec3 forward = glm::normalize(car->FrontVector);
-            glm::vec3 leftVec = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), forward));
-
-            float sideOffset = 0.3f;
-            float backOffset = 0.0f;
-            glm::vec3 aiStartPos = car->Position + leftVec * sideOffset - forward * backOffset;
-
-            aiCar->Position = aiStartPos;
-            aiCar->Velocity = glm::vec3(0.0f);
-            aiCar->Yaw = car->Yaw;
-            aiCar->FrontVector = car->FrontVector;
-
-            aiCurrentWaypoint = 0;
+            aiDriver.Reset();
         }
 
         raceCountdownActive = true;
@@ -1183,36 +1171,98 @@ void RenderMainMenu() {
 }
 
 /**
- * @brief Rysuje minimapę (prosta wersja) na podstawie ścian toru.
+ * @brief Zwraca miejsce gracza w wyścigu (1 lub 2) na podstawie `RaceRules::IsAhead`.
+ *
+ * Zwycięzca (`raceWon` / `aiRaceWon`) jest przed rywalem; w trakcie wyścigu decyduje dystans wzdłuż
+ * linii środkowej toru (`LapCounter::Progress`).
+ *
+ * @return Miejsce gracza.
+ */
+static int GetPlayerRacePosition() {
+    float playerFinish = raceWon ? 0.0f : -1.0f;
+    float aiFinish = aiRaceWon ? 0.0f : -1.0f;
+    bool aiAhead = RaceRules::IsAhead(aiFinish, aiLaps.Progress.RaceDistance, playerFinish, playerLaps.Progress.RaceDistance);
+    return aiAhead ? 2 : 1;
+}
+
+/**
+ * @brief Rysuje w bieżącym oknie ImGui międzyczasy gracza (`playerSectors`).
+ *
+ * Ukończone sektory bieżącego okrążenia są pokazywane jako różnica do tego sektora w najlepszym okrążeniu
+ * (zielony = szybciej), a przed pierwszym ukończonym okrążeniem — jako czas. Niżej: bieżąca różnica do
+ * najlepszego okrążenia, różnica na ostatniej bramce i czas najlepszego okrążenia.
+ */
+static void DrawSectorTelemetry() {
+    const ImVec4 faster(0.3f, 1.0f, 0.4f, 1.0f);
+    const ImVec4 slower(1.0f, 0.35f, 0.3f, 1.0f);
+    const ImVec4 neutral(0.9f, 0.9f, 0.9f, 1.0f);
+    const ImVec4 pending(0.5f, 0.5f, 0.5f, 1.0f);
+
+    const SectorTimer::LapSplits& lap = playerSectors.GetCurrentLap();
+    const SectorTimer::LapSplits& best = playerSectors.GetBestLap();
+    for (int i = 0; i < playerSectors.GetSectorCount(); ++i) {
+        if (i > 0) ImGui::SameLine();
+        if (i >= lap.SectorCount) {
+            ImGui::TextColored(pending, "S%d  --  ", i + 1);
+        }
+        else if (playerSectors.HasBestLap()) {
+            float d = lap.Sectors[i] - best.Sectors[i];
+            ImGui::TextColored(d <= 0.0f ? faster : slower, "S%d %+.2f", i + 1, d);
+        }
+        else {
+            ImGui::TextColored(neutral, "S%d %.2f", i + 1, lap.Sectors[i]);
+        }
+    }
+
+    float delta;
+    if (playerSectors.GetLiveDelta(raceElapsedTime, playerLaps.Progress.Distance, delta))
+        ImGui::TextColored(delta <= 0.0f ? faster : slower, "DELTA %+.2f", delta);
+    else
+        ImGui::TextColored(pending, "DELTA  --");
+
+    ImGui::SameLine();
+    if (playerSectors.GetSplitDelta(delta))
+        ImGui::TextColored(delta <= 0.0f ? faster : slower, "  SPLIT %+.2f", delta);
+    else
+        ImGui::TextColored(pending, "  SPLIT  --");
+
+    if (playerSectors.HasBestLap()) {
+        int minutes = (int)(best.LapTime / 60.0f);
+        ImGui::TextColored(neutral, "BEST %d:%06.3f", minutes, best.LapTime - minutes * 60.0f);
+    }
+    else {
+        ImGui::TextColored(pending, "BEST  --");
+    }
+}
+
+/**
+ * @brief Rysuje minimapę na podstawie linii środkowej toru.
  *
- * Minimapę buduje się z listy `WallSegment` dostarczonej przez `TrackCollision::GetWalls()`.
- * Współrzędne są normalizowane do 0..1 w świecie, a potem obracane o 90° w prawo, żeby uzyskać
- * oczekiwaną orientację na UI.
+ * Tor jest rysowany jako gruba łamana po próbkach `kartingTrack.Centerline`, linia startu/mety jako
+ * odcinek w poprzek toru w dystansie 0, a auta jako znaczniki w punktach linii odpowiadających ich
+ * dystansowi w okrążeniu. Współrzędne są normalizowane do 0..1 w świecie, a potem obracane o 90° w prawo,
+ * żeby uzyskać oczekiwaną orientację na UI.
  *
  * @param draw Lista rysowania ImGui.
  * @param topLeft Lewy górny róg obszaru minimapy.
  * @param size Rozmiar minimapy.
- * @param playerPos Pozycja gracza.
- * @param aiPos Pozycja AI.
+ * @param playerDistance Dystans gracza w okrążeniu.
+ * @param aiDistance Dystans AI w okrążeniu.
  */
-static void DrawMiniMap(ImDrawList* draw, const ImVec2& topLeft, const ImVec2& size, const glm::vec3& playerPos, const glm::vec3& aiPos) {
+static void DrawMiniMap(ImDrawList* draw, const ImVec2& topLeft, const ImVec2& size, float playerDistance, float aiDistance) {
     using namespace glm;
-    const auto& walls = TrackCollision::GetWalls();
-    if (walls.empty()) return;
+    const TrackCenterline& centerline = kartingTrack.Centerline;
+    const auto& samples = centerline.GetSamples();
+    if (samples.size() < 2) return;
 
     float minX = FLT_MAX, maxX = -FLT_MAX, minZ = FLT_MAX, maxZ = -FLT_MAX;
-    for (const auto& w : walls) {
-        minX = std::min({ minX, w.start.x, w.end.x });
-        maxX = std::max({ maxX, w.start.x, w.end.x });
-        minZ = std::min({ minZ, w.start.y, w.end.y });
-        maxZ = std::max({ maxZ, w.start.y, w.end.y });
+    for (const auto& s : samples) {
+        minX = std::min(minX, s.Position.x - s.HalfWidth);
+        maxX = std::max(maxX, s.Position.x + s.HalfWidth);
+        minZ = std::min(minZ, s.Position.y - s.HalfWidth);
+        maxZ = std::max(maxZ, s.Position.y + s.HalfWidth);
     }
 
-    minX = std::min({ minX, playerPos.x, aiPos.x });
-    maxX = std::max({ maxX, playerPos.x, aiPos.x });
-    minZ = std::min({ minZ, playerPos.z, aiPos.z });
-    maxZ = std::max({ maxZ, playerPos.z, aiPos.z });
-
     float worldW = std::max(0.001f, maxX - minX);
     float worldH = std::max(0.001f, maxZ - minZ);
 
@@ -1235,19 +1285,249 @@ static void DrawMiniMap(ImDrawList* draw, const ImVec2& topLeft, const ImVec2& s
         return ImVec2(topLeft.x + rx, topLeft.y + ry);
         };
 
-    for (const auto& w : walls) {
-        ImVec2 a = WorldToScreen(w.start.x, w.start.y);
-        ImVec2 b = WorldToScreen(w.end.x, w.end.y);
-        draw->AddLine(a, b, IM_COL32(180, 180, 180, 220), 2.0f);
+    // Szerokość toru na mapie (co najmniej 2 px, żeby wąski tor był widoczny).
+    float trackThickness = std::max(2.0f, 2.0f * centerline.HalfWidthAt(0.0f) * scale);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& s0 = samples[i];
+        const auto& s1 = samples[(i + 1) % samples.size()];
+        draw->AddLine(WorldToScreen(s0.Position.x, s0.Position.y), WorldToScreen(s1.Position.x, s1.Position.y),
+            IM_COL32(180, 180, 180, 220), trackThickness);
     }
 
-    ImVec2 pPos = WorldToScreen(playerPos.x, playerPos.z);
-    ImVec2 aiP = WorldToScreen(aiPos.x, aiPos.z);
+    // Linia startu/mety w poprzek toru.
+    vec2 start = centerline.PointAt(0.0f);
+    vec2 dir = centerline.DirectionAt(0.0f);
+    vec2 across = vec2(-dir.y, dir.x) * (centerline.HalfWidthAt(0.0f) * 1.5f);
+    draw->AddLine(WorldToScreen(start.x + across.x, start.y + across.y), WorldToScreen(start.x - across.x, start.y - across.y),
+        IM_COL32(255, 255, 255, 255), 2.0f);
+
+    vec2 player = centerline.PointAt(playerDistance);
+    vec2 ai = centerline.PointAt(aiDistance);
+    ImVec2 pPos = WorldToScreen(player.x, player.y);
+    ImVec2 aiP = WorldToScreen(ai.x, ai.y);
 
     float markerR = std::max(3.0f, std::min(size.x, size.y) * 0.03f);
     draw->AddCircleFilled(pPos, markerR, IM_COL32(255, 160, 40, 255));
     draw->AddCircleFilled(aiP, markerR, IM_COL32(40, 220, 100, 220));
 }
+
+/**
+ * @brief Pojedynczy krok symulacji wyścigu o stałej długości.
+ *
+ * Wywoływany przez pętlę główną tyle razy, ile kroków zwróci `FixedTimestep::Advance`.
+ * Obejmuje timer wyścigu, odliczanie, sterowanie gracza, fizykę aut, AI, okrążenia i kolizje toru.
+ * Przed fizyką zapamiętywany jest stan aut (`CarPhysics::BeginTick`), aby render mógł interpolować
+ * między poprzednim a bieżącym krokiem.
+ *
+ * @param deltaTime Stała długość kroku fizyki w sekundach.
+ */
+static void UpdateRaceTick(float deltaTime) {
+    if (car) car->BeginTick();
+    if (aiCar) aiCar->BeginTick();
+
+    /**
+     * @brief Logika timera wyścigu.
+     *
+     * Jeśli timer aktywny, odejmujemy czas i kończymy wyścig przy 0.
+     */
+    if (raceTimerActive && !raceFinished) {
+        raceTimeLeft -= deltaTime;
+        raceElapsedTime += deltaTime;
+
+        if (raceTimeLeft <= 0.0f) {
+            // Koniec czasu = przegrana.
+            raceTimeLeft = 0.0f;
+            raceFinished = true;
+            raceWon = false;
+            raceTimerActive = false;
+
+            // Zapis zarobionej kasy do profilu.
+            if (sessionMoney > 0) {
+                playerProfile.addMoney(sessionMoney);
+                playerProfile.save();
+            }
+        }
+    }
+
+    /**
+     * @brief Logika gry właściwej.
+     *
+     * Jeśli mamy odliczanie lub animację GO, sterowanie jest blokowane.
+     * W przeciwnym razie:
+     * - przetwarzamy input,
+     * - aktualizujemy fizykę gracza,
+     * - aktualizujemy AI,
+     * - obsługujemy okrążenia, meta, kolizje.
+     */
+    if (!raceCountdownActive && !showGoAnimation) {
+        processCarInput(deltaTime);
+
+        // Pozycja „bezpieczna” do cofnięcia, gdy wykryjemy kolizję (np. tor kartingowy).
+        glm::vec3 lastSafePos = car->Position;
+
+        car->Update(deltaTime);
+
+        /**
+         * @brief Aktualizacja AI (wybór waypointu, sterowanie, fizyka, limit prędkości).
+         */
+        if (aiCar && !aiDriver.Waypoints.empty()) {
+            aiDriver.Update(*aiCar, deltaTime);
+        }
+
+        /**
+         * @brief Ograniczenie prędkości gracza (twardy clamp).
+         */
+        float speed = glm::length(car->Velocity);
+        if (speed > car->MaxSpeed) {
+            car->Velocity = glm::normalize(car->Velocity) * car->MaxSpeed;
+        }
+
+        /**
+         * @brief Kolizje auto–auto (gracz i AI) przed kolizjami ze ścianami.
+         */
+        if (collisionCars.size() > 1) {
+            carCollision.Resolve(collisionCars, collisionShapes);
+        }
+
+        /**
+         * @brief Okrążenia AI.
+         *
+         * AI zalicza okrążenie, kiedy jego dystans wzdłuż toru (`aiLaps.Progress.RaceDistance`)
+         * przekroczy kolejną wielokrotność długości toru.
+         */
+        if (aiLaps.Update(aiCar->Position, !aiRaceFinished)) {
+            if (aiLaps.CurrentLap > totalLaps) {
+                aiRaceFinished = true;
+
+                // Jeśli gracz jeszcze nie skończył, przegrywa.
+                if (!raceFinished) {
+                    aiRaceWon = true;
+                    raceWon = false;
+                    raceFinished = true;
+                    raceTimerActive = false;
+
+                    if (sessionMoney > 0) {
+                        playerProfile.addMoney(sessionMoney);
+                        playerProfile.save();
+                    }
+                }
+
+                // Zatrzymanie AI po ukończeniu.
+                aiCar->Velocity = glm::vec3(0.0f);
+            }
+        }
+
+        /**
+         * @brief Bramki sektorów gracza (przed okrążeniem, żeby ostatni sektor wyścigu też został zmierzony).
+         */
+        if (raceTimerActive) {
+            playerSectors.Update(lastSafePos, car->Position, raceElapsedTime, deltaTime);
+        }
+
+        /**
+         * @brief Okrążenia gracza.
+         *
+         * Dodatkowo gracz musi jechać „do przodu” względem lokalnego kierunku toru (anti reverse lap farming).
+         */
+        glm::vec2 trackDirection = kartingTrack.Centerline.DirectionAt(playerLaps.Progress.Distance);
+        bool isMovingForward = car->FrontVector.x * trackDirection.x + car->FrontVector.z * trackDirection.y > 0.0f;
+
+        if (playerLaps.Update(car->Position, raceTimerActive && isMovingForward)) {
+
+            // Nagroda za okrążenie.
+            sessionMoney += 50;
+
+            if (playerLaps.CurrentLap > totalLaps) {
+                raceFinished = true;
+
+                // Jeśli AI nie skończyło, gracz wygrywa i dostaje bonus.
+                if (!aiRaceFinished) {
+                    raceWon = true;
+                    aiRaceWon = false;
+
+                    int bonus = 0;
+                    if (totalLaps == 1) bonus = 100;
+                    else if (totalLaps == 3) bonus = 300;
+                    else if (totalLaps == 10) bonus = 1000;
+                    else bonus = 100 * totalLaps;
+
+                    sessionMoney += bonus;
+                }
+                else {
+                    raceWon = false;
+                    aiRaceWon = true;
+                }
+
+                if (sessionMoney > 0) {
+                    playerProfile.addMoney(sessionMoney);
+                    playerProfile.save();
+                }
+            }
+        }
+
+        /**
+         * @brief Kolizje toru kartingowego.
+         *
+         * W trybie `selectedTrack == 2` ruch z tego kroku jest sprawdzany ciągle (`TrackCollision::SweepCircle` ścian `kartingTrack`),
+         * a auto zatrzymuje się przy ścianie i ślizga wzdłuż niej (`RaceRules::ResolveWallContact`).
+         */
+        if (selectedTrack == 2) {
+            RaceRules::ResolveWallContact(kartingTrack.Collision, *car, lastSafePos);
+        }
+
+        /**
+         * @brief Debug log pozycji (klawisz P).
+         *
+         * `logTimer` ogranicza spam do ~5 logów/s.
+         */
+        static float logTimer = 0.0f;
+        logTimer += deltaTime;
+        if (keys[GLFW_KEY_P] && logTimer > 0.2f) {
+            std::cout << "AKTUALNA POZYCJA: X: " << car->Position.x << " Z: " << car->Position.z << std::endl;
+            logTimer = 0.0f;
+        }
+    }
+    else {
+        /**
+         * @brief Sekcja „pre-start”.
+         *
+         * Odliczanie:
+         * - `raceCountdownActive`: zmniejszamy `raceCountdown`,
+         * - po 0 przechodzimy do `showGoAnimation`.
+         */
+        if (raceCountdownActive) {
+            raceCountdown -= deltaTime;
+            if (raceCountdown <= 0.0f) {
+                raceCountdownActive = false;
+                showGoAnimation = true;
+                goTimer = goDuration;
+
+                // Bezpieczne „zablokowanie” auta na czas animacji GO.
+                if (car) {
+                    car->Velocity = glm::vec3(0.0f);
+                    car->Handbrake = true;
+                }
+            }
+        }
+
+        /**
+         * @brief Animacja „GO!”.
+         *
+         * Po jej zakończeniu:
+         * - zwalniamy hamulec ręczny,
+         * - aktywujemy timer wyścigu.
+         */
+        if (showGoAnimation) {
+            goTimer -= deltaTime;
+            if (goTimer <= 0.0f) {
+                showGoAnimation = false;
+                if (car) car->Handbrake = false;
+                raceTimerActive = true;
+            }
+        }
+    }
+}
+
 /**
  * @brief Entry point aplikacji.
  *
@@ -1378,11 +1658,26 @@ int main() {
      * @note Shader `postProcessShader` oczekuje `screenTexture = 0` (GL_TEXTURE0).
      */
     Shader carTrackShader("shaders/phong.vert", "shaders/phong.frag");
+    Shader carInstancedShader("shaders/phong_instanced.vert", "shaders/phong.frag");
     Shader postProcessShader("shaders/postprocess.vert", "shaders/postprocess.frag");
 
     postProcessShader.use();
     postProcessShader.setInt("screenTexture", 0);
 
+    /**
+     * @brief Wspólny UBO z danymi klatki (blok `FrameData`), aktualizowany raz na klatkę.
+     *
+     * Programy są przypinane do jego punktu wiązania przy linkowaniu (`FrameUniforms::BindProgram`).
+     */
+    FrameUniforms frameUniforms;
+    frameUniforms.Init();
+
+    /**
+     * @brief Instancjonowany rendering aut: jedno wywołanie na unikalną siatkę dla wszystkich aut.
+     */
+    CarRenderer carRenderer;
+    carRenderer.Init();
+
     /**
      * @brief Zasoby post-processingu.
      *
@@ -1393,12 +1688,22 @@ int main() {
     setupFramebuffer(current_width, current_height);
 
     /**
-     * @brief Konfiguracja stb_image.
+     * @brief Wczytanie tekstury tła (splash/menu) — synchronicznie, bo splash ma ją pokazać od razu.
+     *
+     * Obrazy tła i skyboxa nie są odwracane w pionie (`LoadImageFile(..., false, ...)`);
+     * tekstury aut i toru kartingowego są (zależy to od przygotowania UV w modelach).
+     */
+    splashTextureID = TextureCache::Acquire("assets/Tlo.png");
+
+    /**
+     * @brief Asynchroniczny loader zasobów.
      *
-     * Ustawienie `false` oznacza, że obrazki nie są odwracane w pionie przy ładowaniu.
-     * Zależy to od tego, jak są przygotowane UV w modelach / shaderach.
+     * Wątki robocze czytają pliki, dekodują obrazy i parsują siatki; utworzenie VAO i tekstur
+     * odbywa się na tym wątku w `ProcessUploads()`, w budżecie `AssetUploadBudgetMs` na klatkę.
+     * Splash przechodzi do menu dopiero, gdy wszystkie zasoby są gotowe.
      */
-    stbi_set_flip_vertically_on_load(false);
+    AssetLoader assetLoader;
+    const float AssetUploadBudgetMs = 4.0f;
 
     /**
      * @brief Inicjalizacja geometrii skyboxa (kostka).
@@ -1430,15 +1735,22 @@ int main() {
     };
 
     /**
-     * @brief Załadowanie cubemapy i utworzenie programu shaderów skyboxa.
+     * @brief Utworzenie cubemapy i programu shaderów skyboxa.
+     *
+     * Każda ściana jest dekodowana osobnym zadaniem (równolegle) i przesyłana do cubemapy po wczytaniu.
      */
-    skyboxTexture = loadCubemap(faces);
+    skyboxTexture = createCubemap();
     skyboxShaderID = createSkyboxShaderProgram();
 
-    /**
-     * @brief Wczytanie tekstury tła (splash/menu).
-     */
-    splashTextureID = loadTexture("assets/Tlo.png");
+    for (unsigned int i = 0; i < faces.size(); i++) {
+        std::string facePath = faces[i];
+        assetLoader.Enqueue("skybox " + std::to_string(i + 1) + "/6", [facePath, i]() -> AssetLoader::UploadFn {
+            ImageData image;
+            if (!LoadImageFile(facePath, false, image))
+                std::cout << "Cubemap tex failed to load at path: " << facePath << std::endl;
+            return [image, i]() { uploadCubemapFace(skyboxTexture, i, image); };
+            });
+    }
 
     /**
      * @brief Wczytanie profilu gracza (saldo, odblokowane auta, wybrane auto).
@@ -1478,28 +1790,39 @@ int main() {
     car = new RaceCar(glm::vec3(0.0f, 0.1f, 0.0f));
 
     /**
-     * @brief Ładowanie assetów samochodu na podstawie profilu.
+     * @brief Ładowanie assetów samochodu na podstawie profilu (w tle).
      *
      * Szukamy w `garage` auta o id `playerProfile.currentCarId`.
      * Jeśli nie znajdziemy lub ładowanie się nie powiedzie, fallbackujemy na pierwszy wpis.
+     * Parametry kół ustawiane są razem z uploadem siatek.
      */
-    bool loaded = false;
-    for (const auto& c : garage) {
-        if (c.id == playerProfile.currentCarId) {
-            car->WheelFrontX = c.wheelFrontX;
-            car->WheelBackX = c.wheelBackX;
-            car->WheelZ = c.wheelZ;
-            if (car->loadAssets(c.bodyPath, c.wheelFrontPath, c.wheelBackPath)) loaded = true;
-            break;
+    std::string playerCarId = playerProfile.currentCarId;
+    assetLoader.Enqueue("player car", [playerCarId]() -> AssetLoader::UploadFn {
+        auto data = std::make_shared<CarAssetData>();
+        const CarData* chosen = nullptr;
+        for (const auto& c : garage) {
+            if (c.id == playerCarId) {
+                if (RaceCar::LoadAssetData(c.bodyPath, c.wheelFrontPath, c.wheelBackPath, *data)) chosen = &c;
+                break;
+            }
         }
-    }
 
-    if (!loaded && !garage.empty()) {
-        car->WheelFrontX = garage[0].wheelFrontX;
-        car->WheelBackX = garage[0].wheelBackX;
-        car->WheelZ = garage[0].wheelZ;
-        car->loadAssets(garage[0].bodyPath, garage[0].wheelFrontPath, garage[0].wheelBackPath);
-    }
+        if (!chosen && !garage.empty()) {
+            *data = CarAssetData();
+            chosen = &garage[0];
+            RaceCar::LoadAssetData(chosen->bodyPath, chosen->wheelFrontPath, chosen->wheelBackPath, *data);
+        }
+        if (!chosen) return {};
+
+        CarData params = *chosen;
+        return [data, params]() {
+            car->WheelFrontX = params.wheelFrontX;
+            car->WheelBackX = params.wheelBackX;
+            car->WheelZ = params.wheelZ;
+            car->UploadAssets(*data);
+            RefreshCarCollisionShapes();
+            };
+        });
 
     /**
      * @brief Tworzenie samochodu AI.
@@ -1510,94 +1833,31 @@ int main() {
      * @note AI zawsze używa obecnie modelu "race.obj".
      */
     aiCar = new RaceCar(car->Position + glm::vec3(-3.0f, 0.0f, -3.0f));
-    aiCar->loadAssets("assets/cars/OBJ format/race.obj", "assets/cars/OBJ format/wheel-racing.obj");
+    assetLoader.Enqueue("AI car", []() -> AssetLoader::UploadFn {
+        auto data = std::make_shared<CarAssetData>();
+        RaceCar::LoadAssetData("assets/cars/OBJ format/race.obj", "assets/cars/OBJ format/wheel-racing.obj", "", *data);
+        return [data]() {
+            aiCar->UploadAssets(*data);
+            RefreshCarCollisionShapes();
+            };
+        });
 
     /**
-     * @brief Waypointy AI.
+     * @brief Definicja toru kartingowego.
      *
-     * Lista punktów definiuje pętlę jazdy AI (tor). AI przechodzi przez punkty w kolejności,
-     * po osiągnięciu końca zawija do 0.
+     * Przy pierwszym uruchomieniu (lub po zmianie `gp.track`) ściany, siatka i pole odległości są budowane
+     * i zapisywane do `gp.r3dtrack`; kolejne uruchomienia tylko mapują ten plik.
+     */
+    if (!kartingTrack.Load("assets/karting/gp.track"))
+        std::cout << "Failed to load track definition: assets/karting/gp.track" << std::endl;
+
+    /**
+     * @brief Waypointy AI.
      *
-     * @note To jest „twardo wpisana” trasa. Docelowo można to przenieść do pliku/edytora.
+     * Lista punktów definiuje pętlę jazdy AI (linia jazdy z definicji toru). AI przechodzi przez punkty
+     * w kolejności, po osiągnięciu końca zawija do 0.
      */
-    aiWaypoints.clear();
-    aiWaypoints.push_back(glm::vec3(-17.4033f, 0.0f, 19.7189f));
-    aiWaypoints.push_back(glm::vec3(-15.3660f, 0.0f, 19.6832f));
-    aiWaypoints.push_back(glm::vec3(-13.7321f, 0.0f, 19.6545f));
-    aiWaypoints.push_back(glm::vec3(-11.6130f, 0.0f, 19.6174f));
-    aiWaypoints.push_back(glm::vec3(-9.36917f, 0.0f, 19.5781f));
-    aiWaypoints.push_back(glm::vec3(-5.78419f, 0.0f, 19.5153f));
-    aiWaypoints.push_back(glm::vec3(-5.31329f, 0.0f, 19.4698f));
-    aiWaypoints.push_back(glm::vec3(-4.38402f, 0.0f, 19.1239f));
-    aiWaypoints.push_back(glm::vec3(-4.14590f, 0.0f, 18.5770f));
-    aiWaypoints.push_back(glm::vec3(-3.85840f, 0.0f, 17.6733f));
-    aiWaypoints.push_back(glm::vec3(-3.58509f, 0.0f, 16.3736f));
-    aiWaypoints.push_back(glm::vec3(-3.60564f, 0.0f, 15.2653f));
-    aiWaypoints.push_back(glm::vec3(-3.66244f, 0.0f, 13.6701f));
-    aiWaypoints.push_back(glm::vec3(-3.97440f, 0.0f, 12.8013f));
-    aiWaypoints.push_back(glm::vec3(-4.92762f, 0.0f, 11.5202f));
-    aiWaypoints.push_back(glm::vec3(-5.81082f, 0.0f, 11.2623f));
-    aiWaypoints.push_back(glm::vec3(-7.50787f, 0.0f, 11.1497f));
-    aiWaypoints.push_back(glm::vec3(-9.61396f, 0.0f, 11.0101f));
-    aiWaypoints.push_back(glm::vec3(-12.5933f, 0.0f, 10.8900f));
-    aiWaypoints.push_back(glm::vec3(-13.8865f, 0.0f, 11.0711f));
-    aiWaypoints.push_back(glm::vec3(-14.6346f, 0.0f, 11.3402f));
-    aiWaypoints.push_back(glm::vec3(-15.3948f, 0.0f, 12.9190f));
-    aiWaypoints.push_back(glm::vec3(-16.2529f, 0.0f, 13.9903f));
-    aiWaypoints.push_back(glm::vec3(-17.4402f, 0.0f, 15.1772f));
-    aiWaypoints.push_back(glm::vec3(-18.7166f, 0.0f, 16.1678f));
-    aiWaypoints.push_back(glm::vec3(-19.7307f, 0.0f, 16.8484f));
-    aiWaypoints.push_back(glm::vec3(-20.5292f, 0.0f, 17.2504f));
-    aiWaypoints.push_back(glm::vec3(-21.6503f, 0.0f, 17.7823f));
-    aiWaypoints.push_back(glm::vec3(-22.6977f, 0.0f, 18.1117f));
-    aiWaypoints.push_back(glm::vec3(-23.8565f, 0.0f, 18.4450f));
-    aiWaypoints.push_back(glm::vec3(-25.1990f, 0.0f, 18.6440f));
-    aiWaypoints.push_back(glm::vec3(-26.2335f, 0.0f, 18.5330f));
-    aiWaypoints.push_back(glm::vec3(-27.1985f, 0.0f, 17.9697f));
-    aiWaypoints.push_back(glm::vec3(-27.5218f, 0.0f, 17.6096f));
-    aiWaypoints.push_back(glm::vec3(-27.5824f, 0.0f, 16.4448f));
-    aiWaypoints.push_back(glm::vec3(-27.4934f, 0.0f, 16.0380f));
-    aiWaypoints.push_back(glm::vec3(-27.0386f, 0.0f, 15.6751f));
-    aiWaypoints.push_back(glm::vec3(-25.8365f, 0.0f, 15.3164f));
-    aiWaypoints.push_back(glm::vec3(-25.0517f, 0.0f, 15.3764f));
-    aiWaypoints.push_back(glm::vec3(-23.9274f, 0.0f, 15.4929f));
-    aiWaypoints.push_back(glm::vec3(-22.9257f, 0.0f, 15.5876f));
-    aiWaypoints.push_back(glm::vec3(-22.4709f, 0.0f, 15.5126f));
-    aiWaypoints.push_back(glm::vec3(-21.9348f, 0.0f, 15.2519f));
-    aiWaypoints.push_back(glm::vec3(-21.5428f, 0.0f, 14.9263f));
-    aiWaypoints.push_back(glm::vec3(-20.9628f, 0.0f, 14.4443f));
-    aiWaypoints.push_back(glm::vec3(-20.2775f, 0.0f, 13.4949f));
-    aiWaypoints.push_back(glm::vec3(-20.0552f, 0.0f, 12.7826f));
-    aiWaypoints.push_back(glm::vec3(-20.1685f, 0.0f, 11.8938f));
-    aiWaypoints.push_back(glm::vec3(-20.3029f, 0.0f, 11.4411f));
-    aiWaypoints.push_back(glm::vec3(-20.8131f, 0.0f, 10.7798f));
-    aiWaypoints.push_back(glm::vec3(-22.3706f, 0.0f, 10.5592f));
-    aiWaypoints.push_back(glm::vec3(-23.2476f, 0.0f, 10.6864f));
-    aiWaypoints.push_back(glm::vec3(-24.0903f, 0.0f, 10.8968f));
-    aiWaypoints.push_back(glm::vec3(-24.8417f, 0.0f, 11.0843f));
-    aiWaypoints.push_back(glm::vec3(-25.6085f, 0.0f, 11.2758f));
-    aiWaypoints.push_back(glm::vec3(-26.3332f, 0.0f, 11.4567f));
-    aiWaypoints.push_back(glm::vec3(-27.0948f, 0.0f, 11.7497f));
-    aiWaypoints.push_back(glm::vec3(-28.6680f, 0.0f, 12.6275f));
-    aiWaypoints.push_back(glm::vec3(-29.8167f, 0.0f, 13.2684f));
-    aiWaypoints.push_back(glm::vec3(-30.8902f, 0.0f, 14.1717f));
-    aiWaypoints.push_back(glm::vec3(-31.3352f, 0.0f, 15.1534f));
-    aiWaypoints.push_back(glm::vec3(-31.4855f, 0.0f, 16.2787f));
-    aiWaypoints.push_back(glm::vec3(-31.1265f, 0.0f, 17.9219f));
-    aiWaypoints.push_back(glm::vec3(-30.3571f, 0.0f, 19.5993f));
-    aiWaypoints.push_back(glm::vec3(-29.8028f, 0.0f, 20.1476f));
-    aiWaypoints.push_back(glm::vec3(-28.7473f, 0.0f, 20.7893f));
-    aiWaypoints.push_back(glm::vec3(-26.9881f, 0.0f, 21.5204f));
-    aiWaypoints.push_back(glm::vec3(-25.9370f, 0.0f, 21.8000f));
-    aiWaypoints.push_back(glm::vec3(-24.7567f, 0.0f, 21.5176f));
-    aiWaypoints.push_back(glm::vec3(-23.8638f, 0.0f, 21.2952f));
-    aiWaypoints.push_back(glm::vec3(-22.9479f, 0.0f, 21.0669f));
-    aiWaypoints.push_back(glm::vec3(-21.7535f, 0.0f, 20.7136f));
-    aiWaypoints.push_back(glm::vec3(-20.9257f, 0.0f, 20.3663f));
-    aiWaypoints.push_back(glm::vec3(-19.7475f, 0.0f, 19.8974f));
-    aiWaypoints.push_back(glm::vec3(-18.9589f, 0.0f, 19.9399f));
-    aiWaypoints.push_back(glm::vec3(-18.1971f, 0.0f, 19.9258f));
-    aiWaypoints.push_back(glm::vec3(-16.9434f, 0.0f, 19.7359f));
+    aiDriver.Waypoints = kartingTrack.RacingLine;
 
     /**
      * @brief Ograniczenie prędkości AI względem gracza.
@@ -1614,20 +1874,55 @@ int main() {
      * - `city` i `kartingMap` zależą od wyboru trasy.
      */
     camera = new Camera(glm::vec3(0.0f, 3.0f, 5.0f));
-    track = new Track();
-
-    city = new City(glm::vec3(0.0f, 0.0f, 0.0f));
-    city->Scale = glm::vec3(0.3f);
-    (void)city->loadModel();
-
-    kartingMap = new Model("assets/karting/gp.obj");
 
     /**
-     * @brief Inicjalizacja systemu kolizji toru.
+     * @brief Rejestracja tras (kolejność = wartości `selectedTrack`).
      *
-     * Parametr (2.0f) jest skalą/konfiguracją używaną przez `TrackCollision`.
+     * Żadna trasa nie jest wczytywana przy starcie poza aktualnie wybraną; pozostałe
+     * wczytują się po wyborze w `RenderTrackSelectMenu()`. Trasy nieużywane są wyładowywane,
+     * gdy suma ich pamięci przekroczy `trackMemoryBudgetMB`.
      */
-    TrackCollision::Init(2.0f);
+    TrackRegistry tracks(assetLoader, (size_t)trackMemoryBudgetMB * 1024 * 1024);
+    trackRegistry = &tracks;
+
+    tracks.Register("Flat Grass Arena",
+        []() -> AssetLoader::UploadFn {
+            return []() { track = new Track(); };
+        },
+        []() { if (track) { track->Release(); delete track; track = nullptr; } },
+        []() { return track ? track->GetGpuMemoryBytes() : (size_t)0; });
+
+    tracks.Register("Desert Canyon",
+        []() -> AssetLoader::UploadFn {
+            auto data = std::make_shared<CityMeshData>();
+            if (!City::LoadMeshData("", *data)) return {};
+            return [data]() {
+                city = new City(glm::vec3(0.0f, 0.0f, 0.0f));
+                city->Scale = glm::vec3(0.3f);
+                city->UploadMesh(std::move(*data));
+                };
+        },
+        []() { if (city) { city->Release(); delete city; city = nullptr; } },
+        []() { return city ? city->GetGpuMemoryBytes() : (size_t)0; });
+
+    /**
+     * @brief Tor kartingowy: model Assimp (z teksturami). Ściany pochodzą z `kartingTrack` wczytanego wyżej.
+     */
+    tracks.Register("Karting GP",
+        []() -> AssetLoader::UploadFn {
+            auto model = std::make_shared<Model>();
+            if (!model->LoadFromFile("assets/karting/gp.obj")) return {};
+            return [model]() {
+                model->Upload();
+                kartingMap = new Model(std::move(*model));
+                };
+        },
+        []() {
+            if (kartingMap) { kartingMap->Release(); delete kartingMap; kartingMap = nullptr; }
+        },
+        []() { return kartingMap ? kartingMap->GetGpuMemoryBytes() : (size_t)0; });
+
+    tracks.Request(selectedTrack);
 
     /**
      * @brief Główna pętla aplikacji.
@@ -1646,7 +1941,7 @@ int main() {
          * @brief Obliczenie czasu klatki.
          *
          * `deltaTime` jest używany do:
-         * - fizyki (Update samochodu),
+         * - zasilenia zegara symulacji `simClock` (fizyka w stałych krokach),
          * - animacji UI (odliczanie),
          * - animacji menu (obrót auta).
          */
@@ -1654,11 +1949,16 @@ int main() {
         float deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        /**
+         * @brief Upload zasobów wczytanych w tle (VAO/tekstury) w budżecie czasu klatki.
+         */
+        if (!assetLoader.IsDone()) assetLoader.ProcessUploads(AssetUploadBudgetMs);
+
         /**
          * @brief Maszyna stanów gry: logika per-frame.
          *
          * Każdy stan ma własną logikę aktualizacji:
-         * - Splash: odlicza timer i przechodzi do menu,
+         * - Splash: odlicza timer i przechodzi do menu po wczytaniu zasobów,
          * - Menu: animuje obrót samochodu / tła,
          * - Racing: fizyka, AI, timer wyścigu, naliczanie pieniędzy.
          */
@@ -1669,9 +1969,12 @@ int main() {
             }
 
             splashTimer += deltaTime;
-            if (splashTimer > 2.5f) currentState = MAIN_MENU;
+            if (splashTimer > 2.5f && assetLoader.IsDone()) currentState = MAIN_MENU;
+            simClock.Reset();
         }
         else if (currentState == MAIN_MENU) {
+            simClock.Reset();
+
             // Animacja podglądu auta w menu.
             carMenuRotation += 90.0f * deltaTime;
             if (carMenuRotation > 360.0f) carMenuRotation -= 360.0f;
@@ -1697,263 +2000,19 @@ int main() {
             }
 
             /**
-             * @brief Logika timera wyścigu.
+             * @brief Kroki fizyki o stałej długości.
              *
-             * Jeśli timer aktywny, odejmujemy czas i kończymy wyścig przy 0.
+             * Czas klatki trafia do akumulatora `simClock`; fizyka wykonuje się w stałych krokach,
+             * a auta są rysowane w stanie interpolowanym współczynnikiem `GetAlpha()`.
              */
-            if (raceTimerActive && !raceFinished) {
-                raceTimeLeft -= deltaTime;
-                raceElapsedTime += deltaTime;
-
-                if (raceTimeLeft <= 0.0f) {
-                    // Koniec czasu = przegrana.
-                    raceTimeLeft = 0.0f;
-                    raceFinished = true;
-                    raceWon = false;
-                    raceTimerActive = false;
-
-                    // Zapis zarobionej kasy do profilu.
-                    if (sessionMoney > 0) {
-                        playerProfile.addMoney(sessionMoney);
-                        playerProfile.save();
-                    }
-                }
+            int simSteps = simClock.Advance(deltaTime);
+            for (int step = 0; step < simSteps; ++step) {
+                UpdateRaceTick(simClock.GetStepSize());
             }
 
-            /**
-             * @brief Logika gry właściwej.
-             *
-             * Jeśli mamy odliczanie lub animację GO, sterowanie jest blokowane.
-             * W przeciwnym razie:
-             * - przetwarzamy input,
-             * - aktualizujemy fizykę gracza,
-             * - aktualizujemy AI,
-             * - obsługujemy okrążenia, meta, kolizje.
-             */
-            if (!raceCountdownActive && !showGoAnimation) {
-                processCarInput(deltaTime);
-
-                // Pozycja „bezpieczna” do cofnięcia, gdy wykryjemy kolizję (np. tor kartingowy).
-                glm::vec3 lastSafePos = car->Position;
-
-                car->Update(deltaTime);
-
-                /**
-                 * @brief Aktualizacja AI.
-                 *
-                 * AI:
-                 * - wybiera waypoint,
-                 * - steruje skrętem i gazem w zależności od kąta do celu,
-                 * - aktualizuje fizykę,
-                 * - ogranicza prędkość do MaxSpeed.
-                 */
-                if (aiCar && !aiWaypoints.empty()) {
-
-                    glm::vec3 target = aiWaypoints[aiCurrentWaypoint];
-                    glm::vec3 toTarget = target - aiCar->Position;
-                    float distance = glm::length(toTarget);
-
-                    // Gdy AI jest blisko waypointu, przechodzi na następny.
-                    if (distance < aiWaypointRadius) {
-                        aiCurrentWaypoint++;
-                        if (aiCurrentWaypoint >= (int)aiWaypoints.size())
-                            aiCurrentWaypoint = 0;
-                    }
-
-                    float desiredYaw = glm::degrees(atan2(toTarget.x, toTarget.z));
-                    float yawDiff = desiredYaw - aiCar->Yaw;
-
-                    // Normalizacja różnicy yaw do zakresu [-180, 180].
-                    while (yawDiff > 180.0f) yawDiff -= 360.0f;
-                    while (yawDiff < -180.0f) yawDiff += 360.0f;
-
-                    // Sterowanie skrętem.
-                    aiCar->SteeringInput = glm::clamp(yawDiff / 25.0f, -1.0f, 1.0f);
-
-                    // Sterowanie gazem zależnie od „ostrości” zakrętu.
-                    float absYaw = fabs(yawDiff);
-                    if (absYaw > 60.0f)
-                        aiCar->ThrottleInput = 0.4f;
-                    else if (absYaw > 30.0f)
-                        aiCar->ThrottleInput = 0.7f;
-                    else
-                        aiCar->ThrottleInput = 1.0f;
-
-                    // Aktualizacja yaw i front vector (tylko gdy AI ma sensowną prędkość).
-                    float speed = glm::length(aiCar->Velocity);
-                    if (speed > 0.1f) {
-                        float turnAmount = aiCar->TurnRate * deltaTime * 50.0f;
-                        aiCar->Yaw += turnAmount * aiCar->SteeringInput;
-
-                        aiCar->FrontVector = glm::normalize(glm::vec3(
-                            sin(glm::radians(aiCar->Yaw)),
-                            0.0f,
-                            cos(glm::radians(aiCar->Yaw))
-                        ));
-                    }
-
-                    aiCar->Update(deltaTime);
-
-                    float aiSpeed = glm::length(aiCar->Velocity);
-                    if (aiSpeed > aiCar->MaxSpeed)
-                        aiCar->Velocity = glm::normalize(aiCar->Velocity) * aiCar->MaxSpeed;
-                }
-
-                /**
-                 * @brief Ograniczenie prędkości gracza (twardy clamp).
-                 */
-                float speed = glm::length(car->Velocity);
-                if (speed > car->MaxSpeed) {
-                    car->Velocity = glm::normalize(car->Velocity) * car->MaxSpeed;
-                }
-
-                /**
-                 * @brief Okrążenia AI.
-                 *
-                 * AI zalicza okrążenie, kiedy:
-                 * 1) opuści strefę startu (`aiLeftStartZone`),
-                 * 2) wróci do strefy.
-                 */
-                float dist = glm::distance(aiCar->Position, lapStartPosition);
-                if (!aiLeftStartZone && dist > lapFinishRadius * 2.0f) aiLeftStartZone = true;
-
-                if (aiLeftStartZone && dist < lapFinishRadius && !aiRaceFinished) {
-                    aiCurrentLap++;
-
-                    if (aiCurrentLap > totalLaps) {
-                        aiRaceFinished = true;
-
-                        // Jeśli gracz jeszcze nie skończył, przegrywa.
-                        if (!raceFinished) {
-                            aiRaceWon = true;
-                            raceWon = false;
-                            raceFinished = true;
-                            raceTimerActive = false;
-
-                            if (sessionMoney > 0) {
-                                playerProfile.addMoney(sessionMoney);
-                                playerProfile.save();
-                            }
-                        }
-
-                        // Zatrzymanie AI po ukończeniu.
-                        aiCar->Velocity = glm::vec3(0.0f);
-                    }
-
-                    aiLeftStartZone = false;
-                }
-
-                /**
-                 * @brief Okrążenia gracza.
-                 *
-                 * Dodatkowo gracz musi jechać „do przodu” (anti reverse lap farming).
-                 */
-                dist = glm::distance(car->Position, lapStartPosition);
-                if (!leftStartZone && dist > lapFinishRadius * 2.0f) leftStartZone = true;
-
-                bool isMovingForward = glm::dot(car->FrontVector, trackForward) > 0.0f;
-
-                if (leftStartZone && dist < lapFinishRadius && raceTimerActive && isMovingForward) {
-                    currentLap++;
-
-                    // Nagroda za okrążenie.
-                    sessionMoney += 50;
-
-                    if (currentLap > totalLaps) {
-                        raceFinished = true;
-
-                        // Jeśli AI nie skończyło, gracz wygrywa i dostaje bonus.
-                        if (!aiRaceFinished) {
-                            raceWon = true;
-                            aiRaceWon = false;
-
-                            int bonus = 0;
-                            if (totalLaps == 1) bonus = 100;
-                            else if (totalLaps == 3) bonus = 300;
-                            else if (totalLaps == 10) bonus = 1000;
-                            else bonus = 100 * totalLaps;
-
-                            sessionMoney += bonus;
-                        }
-                        else {
-                            raceWon = false;
-                            aiRaceWon = true;
-                        }
-
-                        if (sessionMoney > 0) {
-                            playerProfile.addMoney(sessionMoney);
-                            playerProfile.save();
-                        }
-                    }
-
-                    leftStartZone = false;
-                }
-
-                /**
-                 * @brief Kolizje toru kartingowego.
-                 *
-                 * W trybie `selectedTrack == 2` używamy `TrackCollision` do cofnięcia auta przy kontakcie ze ścianą.
-                 */
-                if (selectedTrack == 2) {
-                    TrackCollision trackCol;
-
-                    if (trackCol.CheckCollision(car->Position, 0.35f)) {
-                        car->Position = lastSafePos;
-                        car->Velocity *= -0.25f;
-                    }
-                }
-
-                /**
-                 * @brief Debug log pozycji (klawisz P).
-                 *
-                 * `logTimer` ogranicza spam do ~5 logów/s.
-                 */
-                static float logTimer = 0.0f;
-                logTimer += deltaTime;
-                if (keys[GLFW_KEY_P] && logTimer > 0.2f) {
-                    std::cout << "AKTUALNA POZYCJA: X: " << car->Position.x << " Z: " << car->Position.z << std::endl;
-                    logTimer = 0.0f;
-                }
-            }
-            else {
-                /**
-                 * @brief Sekcja „pre-start”.
-                 *
-                 * Odliczanie:
-                 * - `raceCountdownActive`: zmniejszamy `raceCountdown`,
-                 * - po 0 przechodzimy do `showGoAnimation`.
-                 */
-                if (raceCountdownActive) {
-                    raceCountdown -= deltaTime;
-                    if (raceCountdown <= 0.0f) {
-                        raceCountdownActive = false;
-                        showGoAnimation = true;
-                        goTimer = goDuration;
-
-                        // Bezpieczne „zablokowanie” auta na czas animacji GO.
-                        if (car) {
-                            car->Velocity = glm::vec3(0.0f);
-                            car->Handbrake = true;
-                        }
-                    }
-                }
-
-                /**
-                 * @brief Animacja „GO!”.
-                 *
-                 * Po jej zakończeniu:
-                 * - zwalniamy hamulec ręczny,
-                 * - aktywujemy timer wyścigu.
-                 */
-                if (showGoAnimation) {
-                    goTimer -= deltaTime;
-                    if (goTimer <= 0.0f) {
-                        showGoAnimation = false;
-                        if (car) car->Handbrake = false;
-                        raceTimerActive = true;
-                    }
-                }
-            }
+            float alpha = simClock.GetAlpha();
+            if (car) car->InterpolateRender(alpha);
+            if (aiCar) aiCar->InterpolateRender(alpha);
         }
 
         /**
@@ -1965,10 +2024,10 @@ int main() {
         if (camera && car) {
             if (currentState == RACING) {
                 if (cockpitView) {
-                    camera->SetFrontCamera(car->Position, car->Yaw);
+                    camera->SetFrontCamera(car->RenderPosition, car->RenderYaw);
                 }
                 else {
-                    camera->FollowCar(car->Position, car->FrontVector);
+                    camera->FollowCar(car->RenderPosition, car->GetRenderFrontVector());
                 }
             }
             else {
@@ -1989,68 +2048,66 @@ int main() {
         glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        carTrackShader.use();
-
+        /**
+         * @brief Dane klatki (kamera, światło, pora dnia) — jeden upload do UBO dla wszystkich programów.
+         */
+        FrameUniformData frameData;
         if (camera) {
-            carTrackShader.setMat4("view", camera->GetViewMatrix());
-            glm::mat4 projection = camera->GetProjectionMatrix((float)current_width / (float)current_height);
-            carTrackShader.setMat4("projection", projection);
+            frameData.view = camera->GetViewMatrix();
+            frameData.projection = camera->GetProjectionMatrix((float)current_width / (float)current_height);
+            frameData.viewPos = glm::vec4(camera->Position, 1.0f);
         }
+        frameData.lightPos = glm::vec4(5.0f, 10.0f, 5.0f, 1.0f);
+        frameData.lightColor = glm::vec4(glm::mix(glm::vec3(0.1f), glm::vec3(1.0f), timeOfDay), 1.0f);
+        frameData.timeParams = glm::vec4(timeOfDay, currentFrame, 0.0f, 0.0f);
+        frameUniforms.Update(frameData);
 
-        glm::vec3 lightPos(5.0f, 10.0f, 5.0f);
-        carTrackShader.setVec3("lightPos", lightPos);
+        /** @brief Ostrosłup kamery do odrzucania fragmentów miasta i siatek mapy kartingowej. */
+        Frustum frustum = camera ? Frustum::FromMatrix(frameData.projection * frameData.view) : Frustum();
+        CullStats sceneCullStats;
 
-        glm::vec3 lightColor = glm::mix(glm::vec3(0.1f), glm::vec3(1.0f), timeOfDay);
-        carTrackShader.setVec3("lightColor", lightColor);
-
-        if (camera)
-            carTrackShader.setVec3("viewPos", camera->Position);
+        carTrackShader.use();
 
         /**
          * @brief Render wybranej trasy (arena/city/karting).
          */
         if (selectedTrack == 0 && track) {
             track->Draw(carTrackShader);
+            sceneCullStats.drawn++;
+            sceneCullStats.drawCalls++;
         }
         else if (selectedTrack == 1 && city) {
-            glm::mat4 model = glm::mat4(1.0f);
-            carTrackShader.setMat4("model", model);
-            city->Draw(carTrackShader);
+            city->Draw(carTrackShader, frustum);
+            sceneCullStats.Add(city->GetCullStats());
         }
         else if (selectedTrack == 2 && kartingMap) {
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
             model = glm::scale(model, glm::vec3(0.1f));
-            carTrackShader.setMat4("model", model);
-            kartingMap->Draw(carTrackShader);
+            kartingMap->Draw(carTrackShader, model, frustum);
+            sceneCullStats.Add(kartingMap->GetCullStats());
         }
 
         /**
-         * @brief Render auta gracza.
+         * @brief Render aut (instancjonowany).
          *
-         * - w menu w garażu auto może być rysowane jako podgląd (z rotacją),
-         * - w wyścigu rysowane jest normalnie.
+         * - w menu w garażu auto gracza może być rysowane jako podgląd (z rotacją),
+         * - w wyścigu rysowane są auto gracza i AI,
+         * - części wszystkich aut trafiają do `carRenderer`, który rysuje każdą unikalną siatkę jednym wywołaniem.
          */
+        carRenderer.Begin();
         if (car) {
-            carTrackShader.setVec3("objectColor", carCustomColor);
-
             if (currentState == MAIN_MENU && showCarSelect) {
-                car->Draw(carTrackShader, menuCarPosition, carMenuRotation);
+                car->Submit(carRenderer, menuCarPosition, carMenuRotation);
             }
             else if (currentState == RACING) {
-                car->Draw(carTrackShader);
+                car->Submit(carRenderer);
             }
         }
-
-        /**
-         * @brief Render auta AI (tylko w wyścigu).
-         */
         if (aiCar && currentState == RACING) {
-            carTrackShader.use();
-            carTrackShader.setVec3("objectColor", glm::vec3(0.2f, 0.8f, 0.2f));
-            aiCar->Draw(carTrackShader);
-            carTrackShader.setVec3("objectColor", carCustomColor);
+            aiCar->Submit(carRenderer);
         }
+        carRenderer.Flush(carInstancedShader);
 
         /**
          * @brief Render skyboxa.
@@ -2061,12 +2118,6 @@ int main() {
             glDepthFunc(GL_LEQUAL);
             glUseProgram(skyboxShaderID);
 
-            glm::mat4 view = glm::mat4(glm::mat3(camera->GetViewMatrix()));
-            glm::mat4 projection = camera->GetProjectionMatrix((float)current_width / (float)current_height);
-
-            glUniformMatrix4fv(glGetUniformLocation(skyboxShaderID, "view"), 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(skyboxShaderID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
             glBindVertexArray(skyboxVAO);
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture);
@@ -2113,7 +2164,9 @@ int main() {
         /**
          * @brief Render UI zależnie od stanu gry.
          */
-        if (currentState == SPLASH_SCREEN) RenderSplashScreen();
+        if (currentState == SPLASH_SCREEN)
+            RenderSplashScreen(assetLoader.GetProgress(), assetLoader.GetCompletedCount(),
+                assetLoader.GetTotalCount(), assetLoader.GetLastCompletedName());
         else if (currentState == MAIN_MENU) RenderMainMenu();
         else if (currentState == RACING && car) {
 
@@ -2202,7 +2255,7 @@ int main() {
             if (!raceCountdownActive && !showGoAnimation) {
 
                 float panelWidth = 320.0f;
-                float panelHeight = 170.0f;
+                float panelHeight = 235.0f;
 
                 ImGui::SetNextWindowPos(ImVec2(current_width - panelWidth - 20.0f, 20.0f), ImGuiCond_Always);
                 ImGui::SetNextWindowSize(ImVec2(panelWidth, panelHeight));
@@ -2247,9 +2300,13 @@ int main() {
                 ImGui::Separator();
 
                 ImGui::SetWindowFontScale(1.4f);
-                ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 1.0f), "LAP %d / %d", currentLap - 1, totalLaps);
+                ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 1.0f), "LAP %d / %d", playerLaps.CurrentLap - 1, totalLaps);
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.15f, 1.0f), "  POS %d / 2", GetPlayerRacePosition());
                 ImGui::SetWindowFontScale(1.0f);
 
+                DrawSectorTelemetry();
+
                 ImGui::Separator();
 
                 ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.8f, 1.0f), "CAMERA: %s", cockpitView ? "COCKPIT" : "CHASE");
@@ -2259,7 +2316,7 @@ int main() {
                 /**
                  * @brief Okno minimapy.
                  *
-                 * `TrackCollision::GetWalls()` dostarcza geometrię do rysowania linii.
+                 * `kartingTrack.Centerline` dostarcza geometrię toru, a `LapCounter::Progress` pozycje aut.
                  */
                 ImGui::SetNextWindowPos(ImVec2(current_width - 220, current_height - 220), ImGuiCond_Always);
                 ImGui::SetNextWindowSize(ImVec2(200, 200));
@@ -2278,8 +2335,8 @@ int main() {
                     mdraw,
                     ImVec2(mpos.x + 8.0f, mpos.y + 8.0f),
                     ImVec2(msize.x - 16.0f, msize.y - 16.0f),
-                    car->Position,
-                    aiCar ? aiCar->Position : glm::vec3(0.0f));
+                    playerLaps.Progress.Distance,
+                    aiLaps.Progress.Distance);
 
                 ImGui::End();
 
@@ -2371,7 +2428,7 @@ int main() {
             ImGui::TextColored(ImVec4(0.6f, 0.9f, 1.0f, alpha), "LAPS");
             ImGui::SameLine(140);
 
-            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, alpha), "%d / %d", std::min(currentLap - 1, totalLaps), totalLaps);
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, alpha), "%d / %d", std::min(playerLaps.CurrentLap - 1, totalLaps), totalLaps);
 
             ImGui::SetCursorPos(ImVec2(40, 180));
             ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.1f, alpha), "MONEY");
@@ -2404,6 +2461,24 @@ int main() {
             ImGui::End();
         }
 
+        /**
+         * @brief Statystyki renderu (F3): fragmenty/siatki trasy narysowane i odrzucone oraz wywołania rysowania.
+         */
+        if (showRenderStats) {
+            ImGui::SetNextWindowPos(ImVec2(10.0f, current_height - 90.0f), ImGuiCond_Always);
+            ImGui::Begin("RenderStats", nullptr,
+                ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove |
+                ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs);
+            ImGui::Text("Trasa: %d narysowanych / %d odrzuconych (%d wywolan)",
+                sceneCullStats.drawn, sceneCullStats.culled, sceneCullStats.drawCalls);
+            if (selectedTrack == 2 && kartingMap) {
+                const RenderQueueStats& queueStats = kartingMap->GetQueueStats();
+                ImGui::Text("Zmiany stanu: %d tekstur, %d VAO", queueStats.textureChanges, queueStats.vaoChanges);
+            }
+            ImGui::Text("Auta: %d instancji (%d wywolan)", carRenderer.GetLastInstances(), carRenderer.GetLastDrawCalls());
+            ImGui::End();
+        }
+
         /**
          * @brief Finalizacja ImGui i prezentacja klatki.
          */
@@ -2432,12 +2507,14 @@ int main() {
      * - programy shaderów,
      * - framebuffer.
      */
-    if (splashTextureID != 0) glDeleteTextures(1, &splashTextureID);
+    TextureCache::Release(splashTextureID);
 
     glDeleteVertexArrays(1, &skyboxVAO);
     glDeleteBuffers(1, &skyboxVBO);
     glDeleteTextures(1, &skyboxTexture);
     glDeleteProgram(skyboxShaderID);
+    frameUniforms.Release();
+    carRenderer.Release();
 
     glDeleteFramebuffers(1, &FBO_Scene);
     glDeleteVertexArrays(1, &quadVAO);
@@ -2448,12 +2525,15 @@ int main() {
      *
      * @note Docelowo można to zastąpić `std::unique_ptr` dla bezpieczeństwa.
      */
+    if (car) car->cleanup();
+    if (aiCar) aiCar->cleanup();
     delete car;
     delete aiCar;
     delete camera;
-    delete track;
-    delete city;
-    delete kartingMap;
+    tracks.UnloadAll();
+    trackRegistry = nullptr;
+    TextureCache::ReleaseAll();
+    MeshRegistry::ReleaseAll();
 
     /**
      * @brief Sprzątanie audio (miniaudio).
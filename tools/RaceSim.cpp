@@ -0,0 +1,353 @@
+﻿#include "AIDriver.h"
+#include "CarCollision.h"
+#include "CarPhysics.h"
+#include "CarPhysicsWorld.h"
+#include "LapCounter.h"
+#include "RaceRules.h"
+#include "SectorTimer.h"
+#include "TrackDefinition.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file RaceSim.cpp
+ * @brief Symulacja wyścigów bez okna i OpenGL (`Racing3D_sim`) — profilowanie fizyki, AI i kolizji.
+ *
+ * Program rozgrywa N wyścigów na torze wczytanym z pliku (`TrackDefinition`, domyślnie kartingowym)
+ * z maksymalną prędkością (bez renderingu i bez czekania na zegar). Wszystkie auta prowadzi `AIDriver`; po kroku fizyki wszystkich aut
+ * rozwiązywane są kolizje auto–auto (`CarCollision`, auta, które ukończyły wyścig, są pomijane),
+ * a potem każde auto jest sprawdzane względem ścian toru (ta sama reakcja co u gracza w grze,
+ * z polem odległości z pliku `.r3dtrack`).
+ * Okrążenia i klasyfikacja wyścigu są liczone z dystansu wzdłuż linii środkowej toru (`LapCounter`, `RaceRules::IsAhead`),
+ * a międzyczasy — na bramkach sektorów (`SectorTimer`); czasy okrążeń z bramek są porównywane z czasami z `LapCounter`.
+ * Na końcu wypisywane są: kroki/s, testy kolizji/s, liczba kontaktów ze ścianą oraz czasy okrążeń.
+ *
+ * Parametr `wątki` > 0 przełącza krok fizyki na `CarPhysicsWorld` (stan SoA, jeden `Step` dla wszystkich aut,
+ * podany rozmiar puli wątków); 0 (domyślnie) to krok każdego `CarPhysics` osobno. Wyniki obu ścieżek są identyczne.
+ *
+ * Użycie: `Racing3D_sim [wyścigi] [okrążenia] [auta] [Hz] [wątki] [tor]` (tor: plik `.track` lub `.r3dtrack`,
+ * domyślnie `assets/karting/gp.track` — uruchamiać z katalogu zawierającego `assets/`).
+ */
+
+ /**
+  * @brief Stan jednego auta w symulowanym wyścigu.
+  */
+struct SimEntrant {
+    /** @brief Fizyka auta. */
+    CarPhysics Car;
+
+    /** @brief Sterowanie AI. */
+    AIDriver Driver;
+
+    /** @brief Licznik okrążeń. */
+    LapCounter Laps;
+
+    /** @brief Międzyczasy na bramkach sektorów. */
+    SectorTimer Sectors;
+
+    /** @brief Czas symulacji na początku bieżącego okrążenia. */
+    float LapStartTime = 0.0f;
+
+    /** @brief Czas ukończenia wyścigu (lub < 0, jeśli nie ukończył). */
+    float FinishTime = -1.0f;
+
+    /** @brief Czasy ukończonych okrążeń. */
+    std::vector<float> LapTimes;
+};
+
+/**
+ * @brief Zbiorcze statystyki wszystkich wyścigów.
+ */
+struct SimStats {
+    /** @brief Liczba kroków symulacji (wszystkie wyścigi). */
+    unsigned long long Ticks = 0;
+
+    /** @brief Liczba kroków fizyki pojedynczych aut. */
+    unsigned long long CarUpdates = 0;
+
+    /** @brief Liczba zapytań o kolizję ze ścianami. */
+    unsigned long long CollisionQueries = 0;
+
+    /** @brief Liczba wykrytych kontaktów ze ścianą. */
+    unsigned long long WallContacts = 0;
+
+    /** @brief Liczba kontaktów auto–auto. */
+    unsigned long long CarContacts = 0;
+
+    /** @brief Liczba par aut testowanych dokładnie (po broadphase). */
+    unsigned long long CarPairTests = 0;
+
+    /** @brief Czasy wszystkich ukończonych okrążeń. */
+    std::vector<float> LapTimes;
+
+    /** @brief Liczba aut, które nie ukończyły wyścigu w limicie czasu. */
+    int DidNotFinish = 0;
+
+    /** @brief Najlepsze czasy sektorów ze wszystkich wyścigów (ujemne = brak). */
+    float BestSectors[SectorTimer::MaxSectors] = { -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
+
+    /** @brief Liczba okrążeń zmierzonych na bramkach i porównanych z `LapCounter`. */
+    unsigned long long GateLaps = 0;
+
+    /** @brief Liczba aut, dla których bramki i `LapCounter` zaliczyły różną liczbę okrążeń. */
+    int GateLapCountMismatches = 0;
+
+    /** @brief Największa różnica czasu okrążenia: bramki względem `LapCounter`. */
+    float MaxGateLapDifference = 0.0f;
+};
+
+/**
+ * @brief Zalicza przejazd linii mety; przy ukończeniu wyścigu zapisuje czas.
+ * @param e Auto.
+ * @param position Pozycja auta po kroku.
+ * @param time Czas symulacji.
+ * @param laps Liczba okrążeń wyścigu.
+ * @return `true` jeśli auto właśnie ukończyło wyścig.
+ */
+static bool UpdateLaps(SimEntrant& e, const glm::vec3& position, float time, int laps) {
+    if (!e.Laps.Update(position)) return false;
+
+    e.LapTimes.push_back(time - e.LapStartTime);
+    e.LapStartTime = time;
+    if (e.Laps.CurrentLap <= laps) return false;
+
+    e.FinishTime = time;
+    return true;
+}
+
+/**
+ * @brief Dopisuje najlepsze sektory auta i porównuje czasy okrążeń z bramek (historia `SectorTimer`) z `LapCounter`.
+ * @param e Auto po wyścigu.
+ * @param stats Statystyki.
+ */
+static void CollectSectorStats(const SimEntrant& e, SimStats& stats) {
+    for (int s = 0; s < e.Sectors.GetSectorCount(); ++s) {
+        float best = e.Sectors.GetBestSector(s);
+        if (best >= 0.0f && (stats.BestSectors[s] < 0.0f || best < stats.BestSectors[s])) stats.BestSectors[s] = best;
+    }
+
+    int gateLaps = e.Sectors.GetCurrentLap().Lap - 1;
+    if (gateLaps != (int)e.LapTimes.size()) {
+        ++stats.GateLapCountMismatches;
+        return;
+    }
+    for (int age = 0; age < e.Sectors.GetHistoryCount(); ++age) {
+        float lapTime = e.LapTimes[e.LapTimes.size() - 1 - age];
+        stats.MaxGateLapDifference = std::max(stats.MaxGateLapDifference, std::abs(e.Sectors.GetHistory(age).LapTime - lapTime));
+        ++stats.GateLaps;
+    }
+}
+
+/**
+ * @brief Rozgrywa jeden wyścig do ukończenia przez wszystkie auta lub do limitu czasu.
+ * @param track Tor (pole startowe, linia jazdy AI, ściany).
+ * @param raceIndex Numer wyścigu (ziarno losowania parametrów aut).
+ * @param laps Liczba okrążeń.
+ * @param carCount Liczba aut.
+ * @param stepSize Długość kroku fizyki w sekundach.
+ * @param world Zbiór aut dla kroku wsadowego lub `nullptr` (krok każdego auta osobno).
+ * @param stats Statystyki uzupełniane o wynik wyścigu.
+ */
+static void RunRace(const TrackDefinition& track, int raceIndex, int laps, int carCount, float stepSize, CarPhysicsWorld* world, SimStats& stats) {
+    const StartGrid& grid = track.Grid;
+    const std::vector<glm::vec3>& waypoints = track.RacingLine;
+
+    // Niewielki rozrzut prędkości maksymalnej, aby wyścigi różniły się między sobą.
+    std::mt19937 rng(1234u + (unsigned)raceIndex);
+    std::uniform_real_distribution<float> speedJitter(0.95f, 1.05f);
+
+    std::vector<SimEntrant> entrants(carCount);
+    for (int i = 0; i < carCount; ++i) {
+        SimEntrant& e = entrants[i];
+        RaceRules::PlaceOnGrid(e.Car, grid, i);
+        e.Car.MaxSpeed *= speedJitter(rng);
+        e.Driver.Waypoints = waypoints;
+        e.Laps.Reset(track.Centerline, RaceRules::GridSlotPosition(grid, i));
+        e.Sectors.Reset(track.SectorGates, track.Centerline.GetLength(), 0.0f);
+    }
+
+    const float timeLimit = 120.0f * laps;
+    float time = 0.0f;
+    int finished = 0;
+
+    if (world) {
+        world->Clear();
+        for (SimEntrant& e : entrants) world->Add(e.Car);
+    }
+    std::vector<glm::vec3> lastSafePos(carCount);
+    std::vector<CarPhysics*> active(carCount);
+    CarCollision collision;
+
+    while (finished < carCount && time < timeLimit) {
+        time += stepSize;
+        ++stats.Ticks;
+
+        if (world) {
+            for (int i = 0; i < carCount; ++i) {
+                if (entrants[i].FinishTime >= 0.0f) continue;
+                lastSafePos[i] = world->GetPosition(i);
+                entrants[i].Driver.Steer(*world, i, stepSize);
+            }
+
+            world->Step(stepSize);
+            for (int i = 0; i < carCount; ++i)
+                if (entrants[i].FinishTime < 0.0f) AIDriver::LimitSpeed(*world, i);
+
+            stats.CarContacts += collision.Resolve(*world);
+            stats.CarPairTests += collision.GetPairTests();
+
+            for (int i = 0; i < carCount; ++i) {
+                SimEntrant& e = entrants[i];
+                if (e.FinishTime >= 0.0f) continue;
+                ++stats.CarUpdates;
+
+                glm::vec3 position = world->GetPosition(i);
+                glm::vec3 velocity = world->GetVelocity(i);
+                ++stats.CollisionQueries;
+                if (RaceRules::ResolveWallContact(track.Collision, position, velocity, lastSafePos[i])) ++stats.WallContacts;
+
+                e.Sectors.Update(lastSafePos[i], position, time, stepSize);
+                if (UpdateLaps(e, position, time, laps)) {
+                    velocity = glm::vec3(0.0f);
+                    world->Enabled[i] = 0;
+                    ++finished;
+                }
+                world->SetPosition(i, position);
+                world->SetVelocity(i, velocity);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < carCount; ++i) {
+            SimEntrant& e = entrants[i];
+            active[i] = e.FinishTime >= 0.0f ? nullptr : &e.Car;
+            if (!active[i]) continue;
+
+            e.Car.BeginTick();
+            lastSafePos[i] = e.Car.Position;
+            e.Driver.Update(e.Car, stepSize);
+        }
+
+        stats.CarContacts += collision.Resolve(active);
+        stats.CarPairTests += collision.GetPairTests();
+
+        for (int i = 0; i < carCount; ++i) {
+            SimEntrant& e = entrants[i];
+            if (!active[i]) continue;
+            ++stats.CarUpdates;
+
+            ++stats.CollisionQueries;
+            if (RaceRules::ResolveWallContact(track.Collision, e.Car, lastSafePos[i])) ++stats.WallContacts;
+
+            e.Sectors.Update(lastSafePos[i], e.Car.Position, time, stepSize);
+            if (UpdateLaps(e, e.Car.Position, time, laps)) {
+                e.Car.Velocity = glm::vec3(0.0f);
+                ++finished;
+            }
+        }
+    }
+
+    std::cout << "Wyscig " << (raceIndex + 1) << ":";
+    for (int i = 0; i < carCount; ++i) {
+        const SimEntrant& e = entrants[i];
+        std::cout << " [auto " << i << ": ";
+        if (e.FinishTime >= 0.0f) std::cout << e.FinishTime << " s]";
+        else std::cout << "DNF, okr. " << (e.Laps.CurrentLap - 1) << ", " << e.Laps.Progress.RaceDistance << " m]";
+
+        stats.LapTimes.insert(stats.LapTimes.end(), e.LapTimes.begin(), e.LapTimes.end());
+        if (e.FinishTime < 0.0f) ++stats.DidNotFinish;
+        CollectSectorStats(e, stats);
+    }
+    std::cout << std::endl;
+
+    // Klasyfikacja: ukończone według czasu, pozostałe według dystansu wzdłuż toru.
+    std::vector<int> order(carCount);
+    for (int i = 0; i < carCount; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        const SimEntrant& ea = entrants[a];
+        const SimEntrant& eb = entrants[b];
+        return RaceRules::IsAhead(ea.FinishTime, ea.Laps.Progress.RaceDistance, eb.FinishTime, eb.Laps.Progress.RaceDistance);
+        });
+    std::cout << "  Klasyfikacja:";
+    for (int i : order) std::cout << " " << i;
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int races = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+    int laps = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+    int carCount = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2;
+    float tickRate = argc > 4 ? (float)std::atof(argv[4]) : 120.0f;
+    if (tickRate <= 0.0f) tickRate = 120.0f;
+    float stepSize = 1.0f / tickRate;
+    int threads = argc > 5 ? std::max(0, std::atoi(argv[5])) : 0;
+
+    std::string trackPath = argc > 6 ? argv[6] : "assets/karting/gp.track";
+
+    TrackDefinition track;
+    if (!track.Load(trackPath)) {
+        std::cout << "Nie mozna wczytac toru: " << trackPath << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Tor: " << track.Name << std::endl;
+    std::cout << "Wyscigi: " << races << ", okrazenia: " << laps << ", auta: " << carCount
+        << ", krok: " << tickRate << " Hz, sciany: " << track.Collision.GetWalls().size()
+        << ", jadro kolizji: " << TrackCollision::GetKernelName() << std::endl;
+
+    CarPhysicsWorld world;
+    if (threads > 0) {
+        world.SetThreadCount((unsigned)threads);
+        std::cout << "Fizyka wsadowa (SoA), watki: " << world.GetThreadCount() << std::endl;
+    }
+
+    SimStats stats;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < races; ++r) RunRace(track, r, laps, carCount, stepSize, threads > 0 ? &world : nullptr, stats);
+    auto t1 = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    if (seconds <= 0.0) seconds = std::numeric_limits<double>::min();
+
+    std::cout << "Czas rzeczywisty: " << seconds << " s, czas symulacji: " << (stats.Ticks * (double)stepSize) << " s" << std::endl;
+    std::cout << "Kroki/s: " << (stats.Ticks / seconds) << " (kroki aut/s: " << (stats.CarUpdates / seconds) << ")" << std::endl;
+    std::cout << "Testy kolizji/s: " << (stats.CollisionQueries / seconds) << ", kontakty ze sciana: " << stats.WallContacts << std::endl;
+    std::cout << "Kontakty auto-auto: " << stats.CarContacts << ", testy par: " << stats.CarPairTests << std::endl;
+
+    if (!stats.LapTimes.empty()) {
+        float best = *std::min_element(stats.LapTimes.begin(), stats.LapTimes.end());
+        float worst = *std::max_element(stats.LapTimes.begin(), stats.LapTimes.end());
+        double sum = 0.0;
+        for (float t : stats.LapTimes) sum += t;
+        std::cout << "Okrazenia: " << stats.LapTimes.size() << ", najlepsze: " << best << " s, srednie: "
+            << (sum / stats.LapTimes.size()) << " s, najgorsze: " << worst << " s" << std::endl;
+    }
+    else {
+        std::cout << "Brak ukonczonych okrazen." << std::endl;
+    }
+    std::cout << "Nieukonczone: " << stats.DidNotFinish << std::endl;
+
+    std::cout << "Sektory (najlepsze):";
+    float bestSum = 0.0f;
+    bool allSectors = !track.SectorGates.empty();
+    for (int s = 0; s < (int)track.SectorGates.size(); ++s) {
+        if (stats.BestSectors[s] < 0.0f) { std::cout << " S" << (s + 1) << " --"; allSectors = false; continue; }
+        std::cout << " S" << (s + 1) << " " << stats.BestSectors[s] << " s";
+        bestSum += stats.BestSectors[s];
+    }
+    if (allSectors) std::cout << ", suma: " << bestSum << " s";
+    std::cout << std::endl;
+    std::cout << "Bramki vs. LapCounter: okrazenia " << stats.GateLaps << ", maks. roznica czasu " << stats.MaxGateLapDifference
+        << " s, auta z rozna liczba okrazen: " << stats.GateLapCountMismatches << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,366 @@
+﻿#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "CompressedTexture.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file TextureBaker.cpp
+ * @brief Offline'owe wypiekanie tekstur PNG do DDS z blokami BCn i łańcuchem mipmap (`Racing3D_texbake`).
+ *
+ * Dla każdego PNG (rekurencyjnie w podanych katalogach) powstaje obok plik `.dds`
+ * (`GetBakedTexturePath()`), który `LoadTextureImage()` wybiera zamiast źródła, dopóki jest nie starszy od PNG:
+ * - BC1 dla obrazów bez przezroczystości,
+ * - BC3, gdy którykolwiek piksel ma alfę < 255,
+ * - BC5 dla map normalnych (nazwa kończy się na `_NM`/`_normal`) — tylko kanały RG, shader musi odtworzyć Z.
+ *
+ * Mipmapy liczone są filtrem pudełkowym 2x2 na RGBA8 (jak `glGenerateMipmap` dla tekstur liniowych),
+ * a bloki kodowane wzdłuż głównej osi kolorów bloku. DDS zapisywany jest od górnego wiersza;
+ * odwrócenie w pionie dla `flipVertically` robi loader.
+ *
+ * Użycie: `Racing3D_texbake [--force] [ścieżki...]` (domyślnie `assets`).
+ */
+
+ /**
+  * @brief Obraz RGBA8 w pamięci (jeden poziom mipmapy).
+  */
+struct RgbaImage {
+    /** @brief Szerokość w pikselach. */
+    int width = 0;
+
+    /** @brief Wysokość w pikselach. */
+    int height = 0;
+
+    /** @brief Piksele RGBA, wiersz po wierszu od góry. */
+    std::vector<unsigned char> pixels;
+};
+
+/**
+ * @brief Zmniejsza obraz o połowę filtrem pudełkowym 2x2 (nieparzyste krawędzie powielają ostatni wiersz/kolumnę).
+ * @param src Obraz źródłowy.
+ * @return Następny poziom mipmapy.
+ */
+static RgbaImage Downsample(const RgbaImage& src) {
+    RgbaImage dst;
+    dst.width = std::max(1, src.width / 2);
+    dst.height = std::max(1, src.height / 2);
+    dst.pixels.resize((size_t)dst.width * dst.height * 4);
+
+    for (int y = 0; y < dst.height; y++) {
+        int y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+        for (int x = 0; x < dst.width; x++) {
+            int x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+            const unsigned char* p00 = &src.pixels[((size_t)y0 * src.width + x0) * 4];
+            const unsigned char* p01 = &src.pixels[((size_t)y0 * src.width + x1) * 4];
+            const unsigned char* p10 = &src.pixels[((size_t)y1 * src.width + x0) * 4];
+            const unsigned char* p11 = &src.pixels[((size_t)y1 * src.width + x1) * 4];
+            unsigned char* out = &dst.pixels[((size_t)y * dst.width + x) * 4];
+            for (int c = 0; c < 4; c++)
+                out[c] = (unsigned char)((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+        }
+    }
+    return dst;
+}
+
+/**
+ * @brief Pakuje kolor do RGB565 (z zaokrągleniem).
+ * @param c Składowe RGB w zakresie 0..255.
+ * @return Kolor 565.
+ */
+static uint16_t PackRgb565(const float c[3]) {
+    int r = std::clamp((int)std::lround(c[0] * 31.0f / 255.0f), 0, 31);
+    int g = std::clamp((int)std::lround(c[1] * 63.0f / 255.0f), 0, 63);
+    int b = std::clamp((int)std::lround(c[2] * 31.0f / 255.0f), 0, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+/**
+ * @brief Rozpakowuje RGB565 do 8 bitów na kanał (tak jak dekoder sprzętowy).
+ * @param c Kolor 565.
+ * @param out Składowe RGB.
+ */
+static void UnpackRgb565(uint16_t c, int out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * @brief Koduje blok 4x4 RGB do BC1 (tryb 4 kolorów) wzdłuż głównej osi kolorów.
+ *
+ * Oś wyznacza kilka iteracji metody potęgowej na macierzy kowariancji, końce odcinka to skrajne
+ * rzuty pikseli; indeksy wybierane są do najbliższego z 4 kolorów palety po kwantyzacji 565.
+ *
+ * @param rgba 16 pikseli RGBA (wiersz po wierszu).
+ * @param out 8 bajtów bloku.
+ */
+static void EncodeBC1Block(const unsigned char rgba[64], unsigned char out[8]) {
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++) mean[c] += rgba[i * 4 + c];
+    for (int c = 0; c < 3; c++) mean[c] /= 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 }; // rr, rg, rb, gg, gb, bb
+    for (int i = 0; i < 16; i++) {
+        float r = rgba[i * 4 + 0] - mean[0], g = rgba[i * 4 + 1] - mean[1], b = rgba[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iter = 0; iter < 4; iter++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float len = std::max({ std::fabs(x), std::fabs(y), std::fabs(z) });
+        if (len < 1e-6f) break;
+        axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+    }
+    float axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+    float tMin = 0.0f, tMax = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (int c = 0; c < 3; c++) t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+        t /= axisLen2;
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    float hi[3], lo[3];
+    for (int c = 0; c < 3; c++) {
+        hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+        lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    }
+
+    uint16_t c0 = PackRgb565(hi), c1 = PackRgb565(lo);
+    if (c0 < c1) std::swap(c0, c1);
+
+    out[0] = (unsigned char)(c0 & 0xFF); out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF); out[3] = (unsigned char)(c1 >> 8);
+    std::memset(out + 4, 0, 4);
+    if (c0 == c1) return; // Jednolity blok: wszystkie indeksy 0.
+
+    int palette[4][3];
+    UnpackRgb565(c0, palette[0]);
+    UnpackRgb565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestDist = 1 << 30;
+        for (int p = 0; p < 4; p++) {
+            int dr = rgba[i * 4 + 0] - palette[p][0], dg = rgba[i * 4 + 1] - palette[p][1], db = rgba[i * 4 + 2] - palette[p][2];
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < bestDist) { bestDist = dist; best = p; }
+        }
+        out[4 + i / 4] |= (unsigned char)(best << ((i % 4) * 2));
+    }
+}
+
+/**
+ * @brief Koduje 16 wartości jednego kanału do bloku BC4 (tryb 8 wartości).
+ * @param values 16 wartości (wiersz po wierszu).
+ * @param out 8 bajtów bloku.
+ */
+static void EncodeBC4Block(const unsigned char values[16], unsigned char out[8]) {
+    int lo = 255, hi = 0;
+    for (int i = 0; i < 16; i++) { lo = std::min<int>(lo, values[i]); hi = std::max<int>(hi, values[i]); }
+
+    out[0] = (unsigned char)hi;
+    out[1] = (unsigned char)lo;
+    std::memset(out + 2, 0, 6);
+    if (hi == lo) return;
+
+    // Kody 0 i 1 to końce, 2..7 to interpolacje od `hi` do `lo`.
+    int palette[8] = { hi, lo };
+    for (int i = 1; i <= 6; i++) palette[i + 1] = ((7 - i) * hi + i * lo) / 7;
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestDist = 256;
+        for (int p = 0; p < 8; p++) {
+            int dist = std::abs(values[i] - palette[p]);
+            if (dist < bestDist) { bestDist = dist; best = p; }
+        }
+        bits |= (uint64_t)best << (3 * i);
+    }
+    for (int i = 0; i < 6; i++) out[2 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+/**
+ * @brief Kompresuje jeden poziom (bloki brzegowe uzupełniane powieleniem ostatniego wiersza/kolumny).
+ * @param format Format bloków.
+ * @param level Poziom RGBA8.
+ * @param out Bufor, do którego dopisywane są bloki.
+ */
+static void CompressLevel(BlockFormat format, const RgbaImage& level, std::vector<unsigned char>& out) {
+    const int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+    unsigned char rgba[64], channel[16];
+    unsigned char block[16];
+
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            for (int i = 0; i < 16; i++) {
+                int x = std::min(bx * 4 + i % 4, level.width - 1);
+                int y = std::min(by * 4 + i / 4, level.height - 1);
+                std::memcpy(rgba + i * 4, &level.pixels[((size_t)y * level.width + x) * 4], 4);
+            }
+
+            size_t blockBytes = GetBlockBytes(format);
+            switch (format) {
+            case BlockFormat::BC1:
+                EncodeBC1Block(rgba, block);
+                break;
+            case BlockFormat::BC3:
+                for (int i = 0; i < 16; i++) channel[i] = rgba[i * 4 + 3];
+                EncodeBC4Block(channel, block);
+                EncodeBC1Block(rgba, block + 8);
+                break;
+            case BlockFormat::BC5:
+                for (int i = 0; i < 16; i++) channel[i] = rgba[i * 4 + 0];
+                EncodeBC4Block(channel, block);
+                for (int i = 0; i < 16; i++) channel[i] = rgba[i * 4 + 1];
+                EncodeBC4Block(channel, block + 8);
+                break;
+            }
+            out.insert(out.end(), block, block + blockBytes);
+        }
+    }
+}
+
+/**
+ * @brief Wybiera format na podstawie nazwy pliku i zawartości kanału alfa.
+ * @param path Ścieżka obrazu.
+ * @param image Poziom 0 (RGBA8).
+ * @return Format bloków.
+ */
+static BlockFormat ChooseFormat(const std::filesystem::path& path, const RgbaImage& image) {
+    std::string stem = path.stem().string();
+    std::transform(stem.begin(), stem.end(), stem.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    auto endsWith = [&](const std::string& suffix) {
+        return stem.size() >= suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (endsWith("_nm") || endsWith("_normal")) return BlockFormat::BC5;
+
+    for (size_t i = 3; i < image.pixels.size(); i += 4)
+        if (image.pixels[i] != 255) return BlockFormat::BC3;
+    return BlockFormat::BC1;
+}
+
+/**
+ * @brief Wypieka jeden plik PNG do DDS obok niego.
+ * @param path Ścieżka PNG.
+ * @param force Czy nadpisać aktualny DDS.
+ * @param sourceBytesTotal Suma rozmiarów RGBA8 (z mipmapami, jak szacuje `TextureCache`) — akumulowana.
+ * @param bakedBytesTotal Suma rozmiarów BCn — akumulowana.
+ * @return `false` przy błędzie wczytania lub zapisu.
+ */
+static bool BakeFile(const std::filesystem::path& path, bool force, size_t& sourceBytesTotal, size_t& bakedBytesTotal) {
+    std::string source = path.string();
+    std::string target = GetBakedTexturePath(source);
+    if (!force && !FindBakedTexture(source).empty()) {
+        std::cout << "  up to date  " << source << "\n";
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int w = 0, h = 0, n = 0;
+    unsigned char* data = stbi_load(source.c_str(), &w, &h, &n, 4);
+    if (!data) {
+        std::cout << "  FAILED      " << source << " (" << stbi_failure_reason() << ")\n";
+        return false;
+    }
+
+    RgbaImage level;
+    level.width = w; level.height = h;
+    level.pixels.assign(data, data + (size_t)w * h * 4);
+    stbi_image_free(data);
+
+    CompressedImage baked;
+    baked.format = ChooseFormat(path, level);
+    baked.width = w; baked.height = h;
+    while (true) {
+        CompressedMip mip;
+        mip.width = level.width; mip.height = level.height;
+        mip.offset = baked.data.size();
+        CompressLevel(baked.format, level, baked.data);
+        mip.size = baked.data.size() - mip.offset;
+        baked.mips.push_back(mip);
+        if (level.width == 1 && level.height == 1) break;
+        level = Downsample(level);
+    }
+
+    if (!SaveDdsFile(target, baked)) {
+        std::cout << "  FAILED      " << target << " (write)\n";
+        return false;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t sourceBytes = (size_t)w * h * n * 4 / 3;
+    static const char* formatNames[] = { "BC1", "BC3", "BC5" };
+    std::cout << "  " << std::left << std::setw(4) << formatNames[(int)baked.format] << std::right
+        << std::setw(6) << w << "x" << std::left << std::setw(5) << h << std::right
+        << std::setw(8) << (sourceBytes >> 10) << " KiB -> " << std::setw(6) << (baked.GetByteSize() >> 10) << " KiB  "
+        << std::fixed << std::setprecision(0) << std::setw(5) << ms << " ms  " << source << "\n";
+    if (h % 4 != 0)
+        std::cout << "              (height not a multiple of 4: flipped loads fall back to the PNG)\n";
+
+    sourceBytesTotal += sourceBytes;
+    bakedBytesTotal += baked.GetByteSize();
+    return true;
+}
+
+/**
+ * @brief Zbiera PNG z podanych ścieżek (pliki lub katalogi, rekurencyjnie) i wypieka je.
+ * @param argc Liczba argumentów.
+ * @param argv Argumenty: opcjonalnie `--force`, potem ścieżki.
+ * @return 0 gdy wszystkie pliki wypieczono, 1 w przeciwnym razie.
+ */
+int main(int argc, char** argv) {
+    bool force = false;
+    std::vector<std::string> roots;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--force") force = true;
+        else roots.push_back(arg);
+    }
+    if (roots.empty()) roots.push_back("assets");
+
+    std::vector<std::filesystem::path> files;
+    for (const std::string& root : roots) {
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(root, ec)) { files.push_back(root); continue; }
+        for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file()) continue;
+            std::string ext = it->path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+            if (ext == ".png") files.push_back(it->path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::cout << "Baking " << files.size() << " PNG file(s) to DDS\n";
+    size_t sourceBytes = 0, bakedBytes = 0;
+    int failures = 0;
+    for (const auto& file : files)
+        if (!BakeFile(file, force, sourceBytes, bakedBytes)) failures++;
+
+    if (bakedBytes > 0)
+        std::cout << "VRAM estimate: " << (sourceBytes >> 10) << " KiB uncompressed -> " << (bakedBytes >> 10) << " KiB BCn ("
+            << std::fixed << std::setprecision(1) << (double)sourceBytes / bakedBytes << "x smaller)\n";
+    return failures == 0 ? 0 : 1;
+}